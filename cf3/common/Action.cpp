@@ -12,6 +12,7 @@
 #include "common/OptionList.hpp"
 #include "common/Action.hpp"
 #include "common/FindComponents.hpp"
+#include "common/Tracer.hpp"
 
 #include "common/LibCommon.hpp"
 
@@ -44,6 +45,7 @@ Action& Action::create_action(const std::string& action_provider,
 
 void Action::signal_execute ( common::SignalArgs& node )
 {
+  TraceScope trace(*this, Tracer::ACTION);
   this->execute();
 }
 
@@ -69,6 +69,7 @@ void AssertionManager::do_assert ( bool condition,
       CFerror.setFilterRankZero(false);
       CFerror << oss.str() << CFendl;
       CFerror << "aborting..." << CFendl;
+      Logger::instance().flushFiles();
       abort ();
     }
   }
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <iostream>
+
 #include "common/Signal.hpp"
 #include "common/OptionT.hpp"
 #include "common/Builder.hpp"
@@ -12,6 +14,7 @@
 #include "common/Log.hpp"
 #include "common/Environment.hpp"
 #include "common/PropertyList.hpp"
+#include "common/Tracer.hpp"
 
 namespace cf3 {
 namespace common {
@@ -91,6 +94,12 @@ Environment::Environment ( const std::string& name) : Component ( name )
       .description("The name if the file in which to put the logging messages.")
       .mark_basic();
 
+  options().add("log_files", false)
+      .pretty_name("Log Files")
+      .description("If true, each process also writes its log messages to output-p<rank>.log, from a background thread. The files are opened once MPI is initialized.")
+      .mark_basic()
+      .attach_trigger(boost::bind(&Environment::trigger_log_files,this));
+
   options().add("exception_log_level", (Uint) ERROR)
       .pretty_name("Exception Log Level")
       .description("The log level for exceptions")
@@ -104,6 +113,22 @@ Environment::Environment ( const std::string& name) : Component ( name )
 
   trigger_log_level();
 
+  options().add("trace_buffer_size", 100000u)
+      .pretty_name("Trace Buffer Size")
+      .description("Maximum number of trace events kept for each thread. When full, the oldest events are overwritten.")
+      .mark_basic();
+
+  options().add("trace_file", std::string("trace.json"))
+      .pretty_name("Trace File")
+      .description("File in which the trace is written in Chrome trace format when tracing is switched off. In parallel, the rank is appended: trace-P0.json, trace-P1.json, ...")
+      .mark_basic();
+
+  options().add("trace", false)
+      .pretty_name("Trace")
+      .description("If true, record the execution of actions, communications and linear solves. Setting it back to false writes the trace file and prints a summary over all processes.")
+      .mark_basic()
+      .attach_trigger(boost::bind(&Environment::trigger_trace,this));
+
   // signals
   signal("create_component")->hidden(true);
   signal("rename_component")->hidden(true);
@@ -126,7 +151,7 @@ void Environment::trigger_only_cpu0_writes()
   CFerror.setFilterRankZero( opt );
   CFwarn.setFilterRankZero( opt );
   CFinfo.setFilterRankZero( opt );
-  CFdebug.setFilterRankZero( opt );
+  Logger::instance().getStream(DEBUG).setFilterRankZero( opt );
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,5 +205,30 @@ void Environment::trigger_log_level()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Environment::trigger_log_files()
+{
+  if(options().value<bool>("log_files"))
+    Logger::instance().openFiles();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Environment::trigger_trace()
+{
+  Tracer& tracer = Tracer::instance();
+  if(options().value<bool>("trace"))
+  {
+    tracer.enable(options().value<Uint>("trace_buffer_size"));
+  }
+  else if(Tracer::is_enabled())
+  {
+    tracer.disable();
+    tracer.write_chrome_trace(options().value<std::string>("trace_file"));
+    tracer.print_summary(std::cout);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // common
 } // cf3
@@ -51,6 +51,10 @@ private: // functions
 
   void trigger_log_level();
 
+  void trigger_log_files();
+
+  void trigger_trace();
+
 }; // Environment
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -61,6 +61,7 @@ Exception::Exception(CodeLocation where, std::string msg, std::string className)
   {
     CFerror << CFendl << CFendl;
     CFerror << "+++ Exception aborting on rank " << PE::Comm::instance().rank() << " ... " << CFendl;
+    Logger::instance().flushFiles();
     abort();
   }
 }
@@ -22,6 +22,7 @@
 #include "common/Core.hpp"
 #include "common/Environment.hpp"
 #include "common/Log.hpp"
+#include "common/LogAsyncFileSink.hpp"
 #include "common/PE/Comm.hpp"
 #include "common/OptionList.hpp"
 
@@ -36,7 +37,8 @@ namespace common {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Logger::Logger()
+Logger::Logger() :
+  m_files_requested(false)
 {
   // streams initialization
   m_streams[ERROR]   = new LogStream("Error",   ERROR);
@@ -75,7 +77,7 @@ void Logger::initiate()
   CFerror.setFilterRankZero( rank0 );
   CFwarn.setFilterRankZero( rank0 );
   CFinfo.setFilterRankZero( rank0 );
-  CFdebug.setFilterRankZero( rank0 );
+  m_streams[DEBUG]->setFilterRankZero( rank0 );
 }
 
 //////////////////////////////////////////////////////////////////////////////
@@ -117,28 +119,34 @@ LogStream & Logger::getStream(LogLevel type)
 
 void Logger::openFiles()
 {
-  if(PE::Comm::instance().is_active())
+  m_files_requested = true;
+  if(PE::Comm::instance().is_active() && is_null(m_file_sink))
   {
     std::ostringstream logFile;
 
-    iostreams::file_descriptor_sink fdLogFile;
-
     int rank = PE::Comm::instance().rank();
 
-    filesystem::remove(logFile.str());
-
     logFile << "output-p" << rank << ".log";
 
-    fdLogFile = iostreams::file_descriptor_sink(logFile.str());
+    // one sink, and thus one writer thread, shared by all streams
+    m_file_sink.reset(new LogAsyncFileSink(logFile.str()));
 
-    // setFiles
-    m_streams[INFO]->setFile(fdLogFile);
-    m_streams[ERROR]->setFile(fdLogFile);
-    m_streams[WARNING]->setFile(fdLogFile);
-    m_streams[DEBUG]->setFile(fdLogFile);
+    // setFiles, errors are on disk before the program continues
+    m_streams[INFO]->setFile(m_file_sink);
+    m_streams[ERROR]->setFile(m_file_sink, true);
+    m_streams[WARNING]->setFile(m_file_sink);
+    m_streams[DEBUG]->setFile(m_file_sink);
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+void Logger::flushFiles()
+{
+  if(is_not_null(m_file_sink))
+    m_file_sink->flush();
+}
+
 void Logger::set_log_level(const Uint log_level)
 {
   std::map<LogLevel, LogStream *>::iterator it;
@@ -7,6 +7,8 @@
 #ifndef cf3_common_Log_hpp
 #define cf3_common_Log_hpp
 
+#include <boost/shared_ptr.hpp>
+
 #include "common/CommonAPI.hpp"
 #include "common/LogLevel.hpp"
 #include "common/LogStream.hpp"
@@ -27,11 +29,9 @@ class LogStream;
 /// default, only streams @c #ERROR, @c #WARNING, @c #INFO will be outputted.
 /// This can be changed using Logger::set_log_level().
 /// By default no file is open.
-/// Once an MPI environment has been initialized, @c #openFiles() can be called.
-/// Two files descriptors are created: one for a @e log file and another one
-/// for a @e trace file; respectively <code>output-p<i>i</i>.log</code> and
-/// <code>output-p<i>i</i>.trace</code>, where <code><i>i</i></code> if the
-/// MPI rank number).
+/// Files are opened by @c #openFiles(), which is called when the Environment option
+/// @e log_files is set. Each process then writes to <code>output-p<i>i</i>.log</code>,
+/// where <code><i>i</i></code> is the MPI rank number.
 
 /// @see LogStream
 /// @author Quentin Gasper
@@ -75,9 +75,27 @@ class Common_API Logger : public boost::noncopyable {
 
   LogStream & getStream(LogLevel type);
 
-  /// @brief Creates file descriptors and gives them to streams.
+  /// @brief Checks whether messages of the given stream are output on this process.
+
+  /// Used by the logging macros to skip formatting messages that are discarded.
+  /// @param type The stream type.
+  /// @return Returns @c true if the stream has an active destination.
+  bool is_enabled(LogLevel type) const { return m_streams.find(type)->second->is_enabled(); }
+
+  /// @brief Creates the per-process log file and gives it to the streams.
+
+  /// The file is written by a background thread, so logging never waits for the disk,
+  /// except for error messages. If MPI is not initialized yet, the file is opened by
+  /// PE::Comm::init.
   void openFiles();
 
+  /// @brief True if openFiles() was called
+  bool files_requested() const { return m_files_requested; }
+
+  /// @brief Waits until everything logged so far is written to the log file, if it is open.
+  /// Called before aborting.
+  void flushFiles();
+
   void set_log_level(const Uint log_level);
 
   private :
@@ -87,6 +105,12 @@ class Common_API Logger : public boost::noncopyable {
   /// The key is the stream type. The value is a pointer to the stream.
   std::map<LogLevel, LogStream *> m_streams;
 
+  /// @brief The log file shared by the streams, if it is open
+  boost::shared_ptr<LogAsyncFileSink> m_file_sink;
+
+  /// @brief Set by openFiles()
+  bool m_files_requested;
+
   /// @brief Constructor
   Logger();
 
@@ -104,7 +128,9 @@ class Common_API Logger : public boost::noncopyable {
 #define CFinfo      cf3::common::Logger::instance().Info (FromHere())
 #define CFerror     cf3::common::Logger::instance().Error(FromHere())
 #define CFwarn      cf3::common::Logger::instance().Warn (FromHere())
-#define CFdebug     cf3::common::Logger::instance().Debug(FromHere())
+/// The arguments of CFdebug are not evaluated when debug output is disabled.
+/// Since it expands to an if-else statement, it can only start a statement.
+#define CFdebug     if(!cf3::common::Logger::instance().is_enabled(cf3::DEBUG)) ; else cf3::common::Logger::instance().Debug(FromHere())
 #define CFflush     cf3::common::LogStream::ENDLINE
 #define CFendl      '\n' << CFflush
 
@@ -128,7 +154,7 @@ class Common_API Logger : public boost::noncopyable {
 /// Definition of a macro for outputing a debug string in the code
 #define CF3_DEBUG_STR(x) CFdebug << "DEBUG : STRING : " << x << " : " << __FILE__ << " : " << __LINE__ << " : " << __FUNCTION__ << "\n" ; CFdebug.flush()
 /// Definition of a macro for debug abort
-#define CF3_DEBUG_ABORT  CFdebug << "DEBUG : ABORT " << __FILE__ << " : " << __LINE__ << " : " << __FUNCTION__ << "\n" ; CFdebug.flush() ; abort()
+#define CF3_DEBUG_ABORT  CFdebug << "DEBUG : ABORT " << __FILE__ << " : " << __LINE__ << " : " << __FUNCTION__ << "\n" ; CFdebug.flush() ; cf3::common::Logger::instance().flushFiles() ; abort()
 
 #else
 
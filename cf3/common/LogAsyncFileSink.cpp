@@ -0,0 +1,125 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <fstream>
+
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "common/LogAsyncFileSink.hpp"
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct LogAsyncFileSink::Implementation
+{
+  Implementation(const std::string& filename) :
+    file(filename.c_str(), std::ios::out | std::ios::trunc),
+    stop(false),
+    nb_queued(0),
+    nb_written(0),
+    writer(boost::bind(&Implementation::run, this))
+  {
+  }
+
+  /// Writer thread: moves the queued data out of the lock and writes it
+  void run()
+  {
+    std::string buffer;
+    boost::unique_lock<boost::mutex> lock(mutex);
+    while(true)
+    {
+      while(queue.empty() && !stop)
+        data_available.wait(lock);
+
+      if(queue.empty())
+        break;
+
+      buffer.swap(queue);
+      lock.unlock();
+
+      file.write(buffer.data(), buffer.size());
+      file.flush();
+      const boost::uint64_t size = buffer.size();
+      buffer.clear();
+
+      lock.lock();
+      nb_written += size;
+      data_written.notify_all();
+    }
+  }
+
+  std::ofstream file;
+
+  boost::mutex mutex;
+  boost::condition_variable data_available;
+  boost::condition_variable data_written;
+
+  /// Data waiting to be written, protected by the mutex
+  std::string queue;
+  bool stop;
+
+  /// Total number of bytes queued and written, to implement flush
+  boost::uint64_t nb_queued;
+  boost::uint64_t nb_written;
+
+  /// Constructed last, since it starts running immediately
+  boost::thread writer;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+LogAsyncFileSink::LogAsyncFileSink(const std::string& filename) :
+  m_implementation(new Implementation(filename))
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LogAsyncFileSink::~LogAsyncFileSink()
+{
+  {
+    boost::lock_guard<boost::mutex> lock(m_implementation->mutex);
+    m_implementation->stop = true;
+  }
+  m_implementation->data_available.notify_one();
+  m_implementation->writer.join();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LogAsyncFileSink::write(const char* data, const std::streamsize size)
+{
+  if(size <= 0)
+    return;
+
+  {
+    boost::lock_guard<boost::mutex> lock(m_implementation->mutex);
+    m_implementation->queue.append(data, size);
+    m_implementation->nb_queued += size;
+  }
+  m_implementation->data_available.notify_one();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void LogAsyncFileSink::flush()
+{
+  boost::unique_lock<boost::mutex> lock(m_implementation->mutex);
+  const boost::uint64_t target = m_implementation->nb_queued;
+  while(m_implementation->nb_written < target)
+    m_implementation->data_written.wait(lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
@@ -0,0 +1,97 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_LogAsyncFileSink_hpp
+#define cf3_common_LogAsyncFileSink_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+
+#include <boost/iostreams/categories.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "common/CommonAPI.hpp"
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Log file that is written by a background thread.
+
+/// Written data is appended to a memory buffer, which a writer thread empties
+/// into the file. Writing a log message therefore never waits for the file system
+/// and involves no communication between processes. Each process uses its own file.
+/// The Device class can be pushed on a boost::iostreams::filtering_ostream, and
+/// several devices can share the same file. Flushing a device only waits for the
+/// data to reach the file if the device was created with wait_on_flush set, which
+/// is used for error messages so they are on disk before the program continues.
+class Common_API LogAsyncFileSink : public boost::noncopyable
+{
+public:
+
+  /// @brief Boost.Iostreams sink that forwards to a shared LogAsyncFileSink
+  class Device
+  {
+  public:
+    typedef char char_type;
+    struct category : boost::iostreams::sink_tag, boost::iostreams::flushable_tag {};
+
+    Device(const boost::shared_ptr<LogAsyncFileSink>& sink, const bool wait_on_flush = false) :
+      m_sink(sink),
+      m_wait_on_flush(wait_on_flush)
+    {
+    }
+
+    std::streamsize write(const char_type* data, std::streamsize size)
+    {
+      m_sink->write(data, size);
+      return size;
+    }
+
+    /// Called by the stream on strict_sync, at the end of each log message
+    bool flush()
+    {
+      if(m_wait_on_flush)
+        m_sink->flush();
+      return true;
+    }
+
+  private:
+    boost::shared_ptr<LogAsyncFileSink> m_sink;
+    bool m_wait_on_flush;
+  };
+
+  /// @brief Opens the file, discarding its contents, and starts the writer thread
+  /// @param filename Name of the file
+  LogAsyncFileSink(const std::string& filename);
+
+  /// @brief Writes the remaining data and stops the writer thread
+  ~LogAsyncFileSink();
+
+  /// @brief Queues data to be written to the file
+  void write(const char* data, const std::streamsize size);
+
+  /// @brief Waits until all data queued so far is written to the file
+  void flush();
+
+private:
+  /// Hides the threading headers
+  struct Implementation;
+  boost::scoped_ptr<Implementation> m_implementation;
+}; // LogAsyncFileSink
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_LogAsyncFileSink_hpp
@@ -80,6 +80,11 @@ class Common_API LogLevelFilter
   /// @code filter.setCurrentLogLevel(filter.getLogLevel()); @endcode
   void resetToDefaultLevel();
 
+  /// @brief Checks whether messages are currently forwarded.
+
+  /// @return Returns @c true if the current level passes the filter.
+  bool is_passing() const { return m_tmp_log_level >= static_cast<Uint>(m_filter); }
+
   /// @brief Forwards a message.
 
   /// Example:@n
@@ -96,7 +101,7 @@ class Common_API LogLevelFilter
   template<typename Sink>
     std::streamsize write(Sink& sink, const char_type * data, std::streamsize size)
   {
-    bool ok = m_tmp_log_level >= static_cast<Uint>(m_filter);
+    bool ok = is_passing();
 
     for(int counter = 0 ; counter < size && ok ; counter++)
     ok = boost::iostreams::put(sink, *data++);
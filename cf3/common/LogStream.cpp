@@ -8,6 +8,7 @@
 
 #include "common/PE/Comm.hpp"
 #include "common/Log.hpp"
+#include "common/LogAsyncFileSink.hpp"
 #include "common/LogStream.hpp"
 #include "common/LogLevelFilter.hpp"
 #include "common/LogStampFilter.hpp"
@@ -21,6 +22,9 @@ using namespace boost;
 
 LogStream::LogStream(const std::string & streamName, LogLevel level)
 : m_buffer(),
+m_sync_buffer(),
+m_enabled_rank_zero(false),
+m_enabled_all_ranks(false),
 m_streamName(streamName),
 m_filter_level(level),
 m_flushed(true)
@@ -49,7 +53,7 @@ m_flushed(true)
   stream = new iostreams::filtering_ostream();
   stream->push(levelFilter);
   stream->push(LogStampFilter(streamName));
-  stream->push(std::cout);
+  stream->push(back_inserter(m_sync_buffer));
   m_destinations[SYNC_SCREEN] = stream;
 
 
@@ -65,6 +69,7 @@ m_flushed(true)
   m_filterRankZero[STRING] = true;
   m_filterRankZero[SYNC_SCREEN] = true;
 
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -94,6 +99,8 @@ LogStream & LogStream::operator << (LogLevel tmp_log_level)
   this->getLevelFilter(STRING).set_tmp_log_level(tmp_log_level);
   this->getLevelFilter(SYNC_SCREEN).set_tmp_log_level(tmp_log_level);
 
+  this->update_enabled();
+
   return *this;
 }
 
@@ -140,6 +147,20 @@ void LogStream::flush()
     }
   }
 
+  // the whole message is written in rank order, with one round of barriers
+  if(this->isDestinationUsed(SYNC_SCREEN) && PE::Comm::instance().is_active())
+  {
+    for(Uint i = 0 ; i < PE::Comm::instance().size(); ++i)
+    {
+      if(!this->getFilterRankZero(SYNC_SCREEN))
+        PE::Comm::instance().barrier();
+
+      if(i == PE::Comm::instance().rank() && !m_sync_buffer.empty())
+        std::cout << m_sync_buffer << std::flush;
+    }
+  }
+  m_sync_buffer.clear();
+
   this->getLevelFilter(SCREEN).resetToDefaultLevel();
 
   if(this->isFileOpen())
@@ -169,6 +190,7 @@ void LogStream::flush()
   }
 
   m_flushed = true;
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -183,6 +205,8 @@ void LogStream::set_log_level(const Uint level)
 
   this->getLevelFilter(STRING).set_log_level(level);
   this->getLevelFilter(SYNC_SCREEN).set_log_level(level);
+
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -191,6 +215,7 @@ void LogStream::set_log_level(const Uint level)
 void LogStream::set_log_level(LogDestination destination, const Uint level)
 {
   this->getLevelFilter(destination).set_log_level(level);
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -206,6 +231,8 @@ void LogStream::set_filter(LogLevel level)
 
   this->getLevelFilter(STRING).set_filter(level);
   this->getLevelFilter(SYNC_SCREEN).set_filter(level);
+
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -214,6 +241,7 @@ void LogStream::set_filter(LogLevel level)
 void LogStream::set_filter(LogDestination destination, LogLevel level)
 {
   this->getLevelFilter(destination).set_filter(level);
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -230,6 +258,7 @@ LogLevel LogStream::get_filter(LogDestination destination) const
 void LogStream::useDestination(LogDestination destination, bool use)
 {
   m_usedDests[destination] = use;
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -283,6 +312,7 @@ void LogStream::setStamp(const std::string & stampFormat)
 void LogStream::setFilterRankZero(LogDestination dest, bool filterRankZero)
 {
   m_filterRankZero[dest] = filterRankZero;
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -302,6 +332,8 @@ void LogStream::setFilterRankZero(bool filterRankZero)
   m_filterRankZero[FILE] = filterRankZero;
   m_filterRankZero[STRING] = filterRankZero;
   m_filterRankZero[SYNC_SCREEN] = filterRankZero;
+
+  this->update_enabled();
 }
 
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -318,6 +350,25 @@ void LogStream::setFile(const iostreams::file_descriptor_sink & fileDescr)
     stream->push(fileDescr);
 
     m_destinations[FILE] = stream;
+    this->update_enabled();
+  }
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+void LogStream::setFile(const boost::shared_ptr<LogAsyncFileSink> & sink, const bool wait_on_flush)
+{
+  if(!this->isFileOpen())
+  {
+    iostreams::filtering_ostream * stream = new iostreams::filtering_ostream();
+
+    stream->push(LogLevelFilter(m_filter_level));
+    stream->push(LogStampFilter(m_streamName));
+    stream->push(LogAsyncFileSink::Device(sink, wait_on_flush));
+
+    m_destinations[FILE] = stream;
+    this->update_enabled();
   }
 }
 
@@ -348,6 +399,31 @@ bool LogStream::isFileOpen() const
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+void LogStream::update_enabled()
+{
+  std::map<LogDestination, iostreams::filtering_ostream *>::iterator it;
+
+  m_enabled_rank_zero = false;
+  m_enabled_all_ranks = false;
+
+  for(it = m_destinations.begin() ; it != m_destinations.end() ; it++)
+  {
+    // the used destinations are not all set while constructing
+    if(m_usedDests.find(it->first) == m_usedDests.end() || !this->isDestinationUsed(it->first))
+      continue;
+
+    if(!this->getLevelFilter(it->first).is_passing())
+      continue;
+
+    m_enabled_rank_zero = true;
+    if(it->first == SYNC_SCREEN || !this->getFilterRankZero(it->first))
+      m_enabled_all_ranks = true;
+  }
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
 void LogStream::addStringForwarder(LogStringForwarder * forwarder)
 {
   std::list<LogStringForwarder *>::iterator begin = m_stringForwarders.begin();
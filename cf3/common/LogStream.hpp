@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/shared_ptr.hpp>
+
 #include "common/BoostIostreams.hpp"
 
 #include "common/PE/Comm.hpp"
@@ -17,6 +19,7 @@ namespace cf3 {
 namespace common {
 
 class CodeLocation;
+class LogAsyncFileSink;
 class LogToStream;
 class LogLevelFilter;
 class LogStampFilter;
@@ -103,6 +106,9 @@ class Common_API LogStream
   /// @return Returns a reference to this object.
   template <typename T> LogStream & operator << (const T & t)
   {
+    if(!is_enabled())
+      return *this;
+
     std::map<LogDestination, boost::iostreams::filtering_ostream *>::iterator it;
 
     for(it = m_destinations.begin() ; it != m_destinations.end() ; it++)
@@ -117,20 +123,11 @@ class Common_API LogStream
             m_flushed = false;
           }
         }
-        else if (PE::Comm::instance().is_active())
+        else
         {
-          for( Uint i = 0 ; i < PE::Comm::instance().size(); ++i )
-          {
-            if (!this->getFilterRankZero(it->first))
-            {
-                      PE::Comm::instance().barrier();
-                  }
-            if (i == PE::Comm::instance().rank())
-            {
-              *(it->second) << t;
-              m_flushed = false;
-            }
-          }
+          // Buffered until the message is flushed, to synchronize once per message
+          *(it->second) << t;
+          m_flushed = false;
         }
       }
     }
@@ -145,6 +142,15 @@ class Common_API LogStream
   /// @see LogLevelFilter
   void set_log_level(const Uint level);
 
+  /// @brief Checks whether messages reach any destination on this process.
+
+  /// This is cheap, so it can be checked before formatting a message.
+  /// @return Returns @c false if everything written to this stream is discarded.
+  bool is_enabled() const
+  {
+    return m_enabled_all_ranks || (m_enabled_rank_zero && PE::Comm::instance().rank() == 0);
+  }
+
   /// @brief Sets new default level to the specified destination.
 
   /// If @c destination is @c #FILE but @c #isFileOpen() returns @c false,
@@ -248,6 +254,13 @@ class Common_API LogStream
   /// @param fileDescr The file descriptor.
   void setFile(const boost::iostreams::file_descriptor_sink & fileDescr);
 
+  /// @brief Sets the file, using a sink that writes from a background thread.
+
+  /// The same restrictions apply as for the file descriptor version.
+  /// @param sink The sink, which can be shared with other streams.
+  /// @param wait_on_flush If @c true, flushing the stream waits until the message is in the file.
+  void setFile(const boost::shared_ptr<LogAsyncFileSink> & sink, const bool wait_on_flush = false);
+
   /// @brief Cheks whether the file is set.
 
   /// @return Returns @c true if the file has already been set.
@@ -302,6 +315,18 @@ class Common_API LogStream
   /// @brief Buffer for @c #STRING destination
   std::string m_buffer;
 
+  /// @brief Buffer for the current message to the @c #SYNC_SCREEN destination
+  std::string m_sync_buffer;
+
+  /// @brief True if messages reach a destination on rank zero
+  bool m_enabled_rank_zero;
+
+  /// @brief True if messages reach a destination on all ranks
+  bool m_enabled_all_ranks;
+
+  /// @brief Recomputes the enabled flags after a change in the destinations or levels
+  void update_enabled();
+
   /// @brief Stream name
 
   /// This attribute is used on @c #FILE stream creation.
@@ -89,6 +89,10 @@ void Comm::init(int argc, char** args)
   }
 
   m_comm = MPI_COMM_WORLD;
+
+  // log files requested before MPI was initialized
+  if(Logger::instance().files_requested())
+    Logger::instance().openFiles();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -117,6 +121,7 @@ void Comm::finalize()
 
 void Comm::barrier()
 {
+  TraceScope trace("PE::barrier", Tracer::COLLECTIVE);
   if ( is_active() ) MPI_CHECK_RESULT(MPI_Barrier,(m_comm));
 }
 
@@ -126,6 +131,7 @@ void Comm::barrier( Communicator comm )
 {
   cf3_assert( comm != MPI_COMM_NULL );
 
+  TraceScope trace("PE::barrier", Tracer::COLLECTIVE);
   if ( is_active() ) MPI_CHECK_RESULT(MPI_Barrier,(comm));
 
 }
@@ -11,6 +11,7 @@
 #include <mpi.h>
 
 #include "common/StringConversion.hpp"
+#include "common/Tracer.hpp"
 #include "common/WorkerStatus.hpp"
 
 #include "common/PE/types.hpp"
@@ -127,30 +128,37 @@ public:
 
   template<typename T> inline T*   all_to_all(const T* in_values, const int in_n, T* out_values, const int stride=1)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
     return PE::all_to_all(communicator(), in_values, in_n, out_values, stride);
   }
   template<typename T> inline void all_to_all(const std::vector<T>& in_values, std::vector<T>& out_values, const int stride=1)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
            PE::all_to_all(communicator(), in_values, out_values, stride);
   }
   template<typename T> inline T*   all_to_all(const T* in_values, const int *in_n, T* out_values, int *out_n, const int stride=1)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
     return PE::all_to_all(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline T*   all_to_all(const T* in_values, const int *in_n, const int *in_map, T* out_values, int *out_n, const int *out_map, const int stride=1)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
     return PE::all_to_all(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_to_all(const std::vector<T>& in_values, const std::vector<int>& in_n, std::vector<T>& out_values, std::vector<int>& out_n, const int stride=1)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
            PE::all_to_all(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline void all_to_all(const std::vector<T>& in_values, const std::vector<int>& in_n, const std::vector<int>& in_map, std::vector<T>& out_values, std::vector<int>& out_n, const std::vector<int>& out_map, const int stride=1)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
            PE::all_to_all(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_to_all( const std::vector<std::vector<T> >& send, std::vector<std::vector<T> >& recv)
   {
+    TraceScope trace("PE::all_to_all", Tracer::COLLECTIVE);
            PE::all_to_all(communicator(), send, recv);
   }
 
@@ -161,26 +169,32 @@ public:
 
   template<typename T> inline T*   gather(const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::gather", Tracer::COLLECTIVE);
     return PE::gather(communicator(), in_values, in_n, out_values, root, stride);
   }
   template<typename T> inline void gather(const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::gather", Tracer::COLLECTIVE);
            PE::gather(communicator(), in_values, out_values, root, stride);
   }
   template<typename T> inline T*   gather(const T* in_values, const int in_n, T* out_values, int *out_n, const int root, const int stride=1)
   {
+    TraceScope trace("PE::gather", Tracer::COLLECTIVE);
     return PE::gather(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline T*   gather(const T* in_values, const int in_n, const int *in_map, T* out_values, int *out_n, const int *out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::gather", Tracer::COLLECTIVE);
     return PE::gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
   template<typename T> inline void gather(const std::vector<T>& in_values, const int in_n, std::vector<T>& out_values, std::vector<int>& out_n, const int root, const int stride=1)
   {
+    TraceScope trace("PE::gather", Tracer::COLLECTIVE);
            PE::gather(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline void gather(const std::vector<T>& in_values, const int in_n, const std::vector<int>& in_map, std::vector<T>& out_values, std::vector<int>& out_n, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::gather", Tracer::COLLECTIVE);
            PE::gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
 
@@ -191,34 +205,42 @@ public:
 
   template<typename T> inline T*   all_gather(const T* in_values, const int in_n, T* out_values, const int stride=1)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
     return PE::all_gather(communicator(), in_values, in_n, out_values, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& in_values, std::vector<T>& out_values, const int stride=1)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
            PE::all_gather(communicator(), in_values, out_values, stride);
   }
   template<typename T> inline void all_gather(const T& in_value, std::vector<T>& out_values)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
            PE::all_gather(communicator(), in_value, out_values);
   }
   template<typename T> inline T*   all_gather(const T* in_values, const int in_n, T* out_values, int *out_n, const int stride=1)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
     return PE::all_gather(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline T*   all_gather(const T* in_values, const int in_n, const int *in_map, T* out_values, int *out_n, const int *out_map, const int stride=1)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
     return PE::all_gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& in_values, const int in_n, std::vector<T>& out_values, std::vector<int>& out_n, const int stride=1)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
            PE::all_gather(communicator(), in_values, in_n, out_values, out_n, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& in_values, const int in_n, const std::vector<int>& in_map, std::vector<T>& out_values, std::vector<int>& out_n, const std::vector<int>& out_map, const int stride=1)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
            PE::all_gather(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, stride);
   }
   template<typename T> inline void all_gather(const std::vector<T>& send, std::vector< std::vector<T> >& recv)
   {
+    TraceScope trace("PE::all_gather", Tracer::COLLECTIVE);
            PE::all_gather(communicator(), send, recv);
   }
 
@@ -229,26 +251,32 @@ public:
 
   template<typename T> inline T*   scatter(const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::scatter", Tracer::COLLECTIVE);
     return PE::scatter(communicator(), in_values, in_n, out_values, root, stride);
   }
   template<typename T> inline void scatter(const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::scatter", Tracer::COLLECTIVE);
            PE::scatter(communicator(), in_values, out_values, root, stride);
   }
   template<typename T> inline T*   scatter(const T* in_values, const int* in_n, T* out_values, int& out_n, const int root, const int stride=1)
   {
+    TraceScope trace("PE::scatter", Tracer::COLLECTIVE);
     return PE::scatter(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline T*   scatter(const T* in_values, const int *in_n, const int *in_map, T* out_values, int& out_n, const int *out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::scatter", Tracer::COLLECTIVE);
     return PE::scatter(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
   template<typename T> inline void scatter(const std::vector<T>& in_values, const std::vector<int>& in_n, std::vector<T>& out_values, int& out_n, const int root, const int stride=1)
   {
+    TraceScope trace("PE::scatter", Tracer::COLLECTIVE);
            PE::scatter(communicator(), in_values, in_n, out_values, out_n, root, stride);
   }
   template<typename T> inline void scatter(const std::vector<T>& in_values, const std::vector<int>& in_n, const std::vector<int>& in_map, std::vector<T>& out_values, int& out_n, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::scatter", Tracer::COLLECTIVE);
            PE::scatter(communicator(), in_values, in_n, in_map, out_values, out_n, out_map, root, stride);
   }
 
@@ -259,18 +287,22 @@ public:
 
   template<typename T, typename Op> inline T*   reduce(const Op& op, const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::reduce", Tracer::COLLECTIVE);
     return PE::reduce(communicator(), op, in_values, in_n, out_values, root, stride);
   }
   template<typename T, typename Op> inline void reduce(const Op& op, const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::reduce", Tracer::COLLECTIVE);
            PE::reduce(communicator(), op, in_values, out_values, root, stride);
   }
   template<typename T, typename Op> inline T*   reduce(const Op& op, const T* in_values, const int in_n, const int *in_map, T* out_values, const int *out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::reduce", Tracer::COLLECTIVE);
     return PE::reduce(communicator(), op, in_values, in_n, in_map, out_values, out_map, root, stride);
   }
   template<typename T, typename Op> inline void reduce(const Op& op, const std::vector<T>& in_values, const std::vector<int>& in_map, std::vector<T>& out_values, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::reduce", Tracer::COLLECTIVE);
            PE::reduce(communicator(), op, in_values, in_map, out_values, out_map, root, stride);
   }
 
@@ -281,18 +313,22 @@ public:
 
   template<typename T, typename Op> inline T*   all_reduce(const Op& op, const T* in_values, const int in_n, T* out_values, const int stride=1)
   {
+    TraceScope trace("PE::all_reduce", Tracer::COLLECTIVE);
     return PE::all_reduce(communicator(), op, in_values, in_n, out_values, stride);
   }
   template<typename T, typename Op> inline void all_reduce(const Op& op, const std::vector<T>& in_values, std::vector<T>& out_values, const int stride=1)
   {
+    TraceScope trace("PE::all_reduce", Tracer::COLLECTIVE);
            PE::all_reduce(communicator(), op, in_values, out_values, stride);
   }
   template<typename T, typename Op> inline T*   all_reduce(const Op& op, const T* in_values, const int in_n, const int *in_map, T* out_values, const int *out_map, const int stride=1)
   {
+    TraceScope trace("PE::all_reduce", Tracer::COLLECTIVE);
     return PE::all_reduce(communicator(), op, in_values, in_n, in_map, out_values, out_map, stride);
   }
   template<typename T, typename Op> inline void all_reduce(const Op& op, const std::vector<T>& in_values, const std::vector<int>& in_map, std::vector<T>& out_values, const std::vector<int>& out_map, const int stride=1)
   {
+    TraceScope trace("PE::all_reduce", Tracer::COLLECTIVE);
            PE::all_reduce(communicator(), op, in_values, in_map, out_values, out_map, stride);
   }
 
@@ -303,18 +339,22 @@ public:
 
   template<typename T> inline T*   broadcast(const T* in_values, const int in_n, T* out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::broadcast", Tracer::COLLECTIVE);
     return PE::broadcast(communicator(), in_values, in_n, out_values, root, stride);
   }
   template<typename T> inline void broadcast(const std::vector<T>& in_values, std::vector<T>& out_values, const int root, const int stride=1)
   {
+    TraceScope trace("PE::broadcast", Tracer::COLLECTIVE);
            PE::broadcast(communicator(), in_values, out_values, root, stride);
   }
   template<typename T> inline T*   broadcast(const T* in_values, const int in_n, const int *in_map, T* out_values, const int *out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::broadcast", Tracer::COLLECTIVE);
     return PE::broadcast(communicator(), in_values, in_n, in_map, out_values, out_map, root, stride);
   }
   template<typename T> inline void broadcast(const std::vector<T>& in_values, const std::vector<int>& in_map, std::vector<T>& out_values, const std::vector<int>& out_map, const int root, const int stride=1)
   {
+    TraceScope trace("PE::broadcast", Tracer::COLLECTIVE);
            PE::broadcast(communicator(), in_values, in_map, out_values, out_map, root, stride);
   }
 
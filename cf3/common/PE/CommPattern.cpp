@@ -38,6 +38,13 @@ namespace PE {
 
 common::ComponentBuilder < CommPattern, Component, LibCommon > CommPattern_Provider;
 
+namespace {
+
+/// tag of the point to point messages used for synchronization
+const int synchronize_tag=4213;
+
+} // namespace
+
 ////////////////////////////////////////////////////////////////////////////////
 // Constructor & destructor
 ////////////////////////////////////////////////////////////////////////////////
@@ -475,6 +482,8 @@ void CommPattern::setup()
     if (global_nelems[i]!=0)
       delete[] global[i];
 
+  setup_neighbours();
+
 #undef COMPUTE_IRANK
 #undef COMPUTE_INODE
 }
@@ -564,53 +573,178 @@ void CommPattern::setup()
 
 ////////////////////////////////////////////////////////////////////////////////
 
-void CommPattern::synchronize_all()
+void CommPattern::setup_neighbours()
 {
-  std::vector<unsigned char> sndbuf(1);
-  std::vector<unsigned char> rcvbuf(1);
-  BOOST_FOREACH( CommWrapper& pobj, find_components_recursively<CommWrapper>(*this) )
+  m_send_neighbours.clear();
+  m_send_neighbour_maps.clear();
+  int displ=0;
+  for (int i=0; i<(const int)m_sendCount.size(); i++)
+  {
+    if (m_sendCount[i]!=0)
+    {
+      m_send_neighbours.push_back(i);
+      m_send_neighbour_maps.push_back(std::vector<int>(m_sendMap.begin()+displ,m_sendMap.begin()+displ+m_sendCount[i]));
+    }
+    displ+=m_sendCount[i];
+  }
+
+  m_recv_neighbours.clear();
+  m_recv_neighbour_maps.clear();
+  displ=0;
+  for (int i=0; i<(const int)m_recvCount.size(); i++)
   {
-    synchronize_this(pobj,sndbuf,rcvbuf);
+    if (m_recvCount[i]!=0)
+    {
+      m_recv_neighbours.push_back(i);
+      m_recv_neighbour_maps.push_back(std::vector<int>(m_recvMap.begin()+displ,m_recvMap.begin()+displ+m_recvCount[i]));
+    }
+    displ+=m_recvCount[i];
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void CommPattern::synchronize_all()
+{
+  std::vector<const CommWrapper*> pobjs;
+  BOOST_FOREACH( CommWrapper& pobj, find_components_recursively<CommWrapper>(*this) )
+    pobjs.push_back(&pobj);
+  start_synchronize_these(pobjs);
+  finish_synchronize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void CommPattern::synchronize( const std::string& name )
 {
-  std::vector<unsigned char> sndbuf(1);
-  std::vector<unsigned char> rcvbuf(1);
-  Handle<CommWrapper> pobj(get_child(name));
-  synchronize_this(*pobj,sndbuf,rcvbuf);
+  start_synchronize(name);
+  finish_synchronize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
 void CommPattern::synchronize( const CommWrapper& pobj )
 {
-  std::vector<unsigned char> sndbuf(1);
-  std::vector<unsigned char> rcvbuf(1);
-  synchronize_this(pobj,sndbuf,rcvbuf);
+  start_synchronize(pobj);
+  finish_synchronize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::start_synchronize( const std::string& name )
+{
+  Handle<CommWrapper> pobj(get_child(name));
+  if (is_null(pobj)) throw common::ValueNotFound(FromHere(),"No data named '" + name + "' is registered in commpattern '" + this->name() + "'.");
+  start_synchronize(*pobj);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::start_synchronize( const CommWrapper& pobj )
+{
+  start_synchronize_these(std::vector<const CommWrapper*>(1,&pobj));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
-// having the vectors for the intermediate buf coming from outside allows keeping them and reuse for all synchronize
-void CommPattern::synchronize_this( const CommWrapper& pobj, std::vector<unsigned char>& sndbuf, std::vector<unsigned char>& rcvbuf )
+void CommPattern::start_synchronize( const std::vector<std::string>& names )
 {
-//  std::cout << PERank << pobj.name() << "\n" << std::flush;
-//  std::cout << PERank << pobj.needs_update() << "\n" << std::flush;
-  if ( pobj.needs_update() )
+  std::vector<const CommWrapper*> pobjs;
+  pobjs.reserve(names.size());
+  BOOST_FOREACH( const std::string& name, names )
   {
-    pobj.pack(sndbuf,m_sendMap);
-    rcvbuf.resize(m_recvMap.size()*pobj.size_of()*pobj.stride());
-    PE::Comm::instance().all_to_all(sndbuf,m_sendCount,rcvbuf,m_recvCount,pobj.size_of()*pobj.stride());
-    pobj.unpack(rcvbuf,m_recvMap);
+    Handle<CommWrapper> pobj(get_child(name));
+    if (is_null(pobj)) throw common::ValueNotFound(FromHere(),"No data named '" + name + "' is registered in commpattern '" + this->name() + "'.");
+    pobjs.push_back(pobj.get());
   }
+  start_synchronize_these(pobjs);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+// the messages of all objects are concatenated per neighbour, so each neighbour gets exactly one message per synchronization
+// all ranks must start the synchronizations of a given commpattern in the same order, since the messages are matched in order
+void CommPattern::start_synchronize_these( const std::vector<const CommWrapper*>& pobjs )
+{
+  if (is_synchronizing()) throw common::ShouldNotBeHere(FromHere(),"Synchronization of commpattern '" + name() + "' started while the previous one is not finished.");
+  TraceScope trace("PE::CommPattern::start_synchronize", Tracer::SYNCHRONIZE);
+
+  Uint item_bytes=0;
+  BOOST_FOREACH( const CommWrapper* pobj, pobjs )
+  {
+    if (pobj->needs_update())
+    {
+      m_sync_objects.push_back(pobj);
+      item_bytes+=pobj->size_of()*pobj->stride();
+    }
+  }
+  if (m_sync_objects.empty()) return;
+
+  const int nb_recv=m_recv_neighbours.size();
+  const int nb_send=m_send_neighbours.size();
+  m_sync_requests.assign(nb_recv+nb_send,MPI_REQUEST_NULL);
+  if (nb_recv+nb_send==0) return;
+
+  Communicator comm=PE::Comm::instance().communicator();
+
+  // post the receives first, so the messages can go straight to their destination
+  m_sync_rcvbuf.resize(m_recvMap.size()*item_bytes);
+  m_sync_rcv_offsets.resize(nb_recv);
+  Uint offset=0;
+  for (int i=0; i<nb_recv; i++)
+  {
+    const Uint nb_bytes=m_recv_neighbour_maps[i].size()*item_bytes;
+    m_sync_rcv_offsets[i]=offset;
+    MPI_CHECK_RESULT(MPI_Irecv,(&m_sync_rcvbuf[offset],(int)nb_bytes,MPI_BYTE,m_recv_neighbours[i],synchronize_tag,comm,&m_sync_requests[i]));
+    offset+=nb_bytes;
+  }
+
+  // pack the objects one after the other for each neighbour, and send
+  m_sync_sndbuf.resize(m_sendMap.size()*item_bytes);
+  offset=0;
+  for (int i=0; i<nb_send; i++)
+  {
+    const Uint begin=offset;
+    BOOST_FOREACH( const CommWrapper* pobj, m_sync_objects )
+    {
+      pobj->pack(m_send_neighbour_maps[i],&m_sync_sndbuf[offset]);
+      offset+=m_send_neighbour_maps[i].size()*pobj->size_of()*pobj->stride();
+    }
+    MPI_CHECK_RESULT(MPI_Isend,(&m_sync_sndbuf[begin],(int)(offset-begin),MPI_BYTE,m_send_neighbours[i],synchronize_tag,comm,&m_sync_requests[nb_recv+i]));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void CommPattern::finish_synchronize()
+{
+  if (!is_synchronizing()) return;
+  TraceScope trace("PE::CommPattern::finish_synchronize", Tracer::SYNCHRONIZE);
+
+  // unpack the ghosts from each neighbour as soon as its message is in
+  const int nb_recv=m_recv_neighbours.size();
+  for (int n=0; n<nb_recv; n++)
+  {
+    int i=MPI_UNDEFINED;
+    MPI_CHECK_RESULT(MPI_Waitany,(nb_recv,&m_sync_requests[0],&i,MPI_STATUS_IGNORE));
+    Uint offset=m_sync_rcv_offsets[i];
+    BOOST_FOREACH( const CommWrapper* pobj, m_sync_objects )
+    {
+      pobj->unpack(&m_sync_rcvbuf[offset],m_recv_neighbour_maps[i]);
+      offset+=m_recv_neighbour_maps[i].size()*pobj->size_of()*pobj->stride();
+    }
+  }
+
+  // the send buffer can only be reused once all sends are complete
+  const int nb_send=m_send_neighbours.size();
+  if (nb_send!=0)
+    MPI_CHECK_RESULT(MPI_Waitall,(nb_send,&m_sync_requests[nb_recv],MPI_STATUSES_IGNORE));
+
+  m_sync_objects.clear();
+}
+
+////////////////
+
 void CommPattern::add_global(Uint gid, Uint rank)
 {
   // later a mechanism could be implemented when commpattern can give gids by calling a "reserve(int num)" beforehand, to optimize performance
@@ -229,6 +229,25 @@ public:
   /// @param name the name of the parallel object
   void synchronize( const CommWrapper& pobj );
 
+  /// start a nonblocking synchronization of the parallel object designated by its name
+  /// only the neighbouring ranks (the ones sharing ghosts with this rank) are involved
+  /// finish_synchronize must be called before the data is accessed again
+  /// @param name the name of the parallel object
+  void start_synchronize( const std::string& name );
+
+  /// start a nonblocking synchronization of the parallel object designated by its commwrapper reference
+  /// @param pobj the parallel object
+  void start_synchronize( const CommWrapper& pobj );
+
+  /// start a nonblocking synchronization of several parallel objects at once
+  /// the data of all objects is batched in a single message per neighbouring rank
+  /// @param names the names of the parallel objects
+  void start_synchronize( const std::vector<std::string>& names );
+
+  /// complete the synchronization started by start_synchronize, unpacking the ghost values as they arrive
+  /// does nothing if no synchronization is in progress
+  void finish_synchronize();
+
   /// add element to the commpattern
   /// when all changes done, all needs to be committed by calling setup
   /// if global id is not on current rank, then a ghost is automatically created on current rank
@@ -284,16 +303,26 @@ public:
   /// Return the rank associated with the given local ID
   int rank(const Uint lid) const { return m_ranks[lid]; }
 
+  /// accessor to check if a synchronization was started and not finished yet
+  bool is_synchronizing() const { return !m_sync_objects.empty(); }
+
+  /// ranks to which this rank sends updatable values during synchronization
+  const std::vector<CPint>& send_neighbours() const { return m_send_neighbours; }
+
+  /// ranks from which this rank receives ghost values during synchronization
+  const std::vector<CPint>& recv_neighbours() const { return m_recv_neighbours; }
+
   //@} END ACCESSORS
 
 protected: // helper function
 
-  /// function to synchronize this object
+  /// post the nonblocking sends and receives for a batch of objects
   /// useful for reusing in the different synchronize functions
-  /// @param pobj reference to commwrapper object to synchronize to
-  /// @param sndbuf vector for intermediate buffer for send
-  /// @param rcvbuf vector for intermediate buffer for recieve
-  void synchronize_this( const CommWrapper& pobj, std::vector<unsigned char>& sndbuf, std::vector<unsigned char>& rcvbuf );
+  /// @param pobjs the commwrapper objects to synchronize, the ones that don't need update are skipped
+  void start_synchronize_these( const std::vector<const CommWrapper*>& pobjs );
+
+  /// split the send and receive maps per neighbouring rank, called at the end of setup
+  void setup_neighbours();
 
 private:
 
@@ -349,6 +378,38 @@ private:
   /// Rank for all the gids in local index space
   std::vector<int> m_ranks;
 
+  /// ranks with a nonzero entry in m_sendCount
+  std::vector< CPint > m_send_neighbours;
+
+  /// the part of m_sendMap going to each of the send neighbours
+  std::vector< std::vector<int> > m_send_neighbour_maps;
+
+  /// ranks with a nonzero entry in m_recvCount
+  std::vector< CPint > m_recv_neighbours;
+
+  /// the part of m_recvMap coming from each of the receive neighbours
+  std::vector< std::vector<int> > m_recv_neighbour_maps;
+
+  /// @name STATE OF A SYNCHRONIZATION IN PROGRESS
+  //@{
+
+  /// objects being synchronized, in the order they are packed in the messages
+  std::vector<const CommWrapper*> m_sync_objects;
+
+  /// send buffer, holding one message per send neighbour
+  std::vector<unsigned char> m_sync_sndbuf;
+
+  /// receive buffer, holding one message per receive neighbour
+  std::vector<unsigned char> m_sync_rcvbuf;
+
+  /// byte offset of each receive neighbour's message in m_sync_rcvbuf
+  std::vector<Uint> m_sync_rcv_offsets;
+
+  /// pending requests: first the receives, then the sends
+  std::vector<MPI_Request> m_sync_requests;
+
+  //@} END STATE OF A SYNCHRONIZATION IN PROGRESS
+
 }; // CommPattern
 
 ////////////////////////////////////////////////////////////////////////////////////////////
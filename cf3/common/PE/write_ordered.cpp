@@ -0,0 +1,120 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <climits>
+#include <fstream>
+
+#include "common/BasicExceptions.hpp"
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/write_ordered.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+namespace PE {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  /// Largest number of bytes passed to a single MPI write call, since counts are ints
+  const Uint max_chunk_size = INT_MAX / 2;
+
+  void write_sequential(const std::string& path, const std::vector<std::string>& segments)
+  {
+    std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+    if(!file)
+      throw FileSystemError(FromHere(), "Could not open file " + path + " for writing");
+    for(Uint i = 0; i != segments.size(); ++i)
+      file.write(segments[i].data(), segments[i].size());
+    if(!file)
+      throw FileSystemError(FromHere(), "Error writing to file " + path);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void write_ordered(const std::string& path, const std::vector<std::string>& segments, const Uint nb_aggregators)
+{
+  Comm& comm = Comm::instance();
+  if(!comm.is_active() || comm.size() == 1)
+  {
+    write_sequential(path, segments);
+    return;
+  }
+
+  const Uint nb_segments = segments.size();
+  const Uint nb_procs = comm.size();
+  const Uint rank = comm.rank();
+
+  std::vector<Uint> my_sizes(nb_segments);
+  for(Uint i = 0; i != nb_segments; ++i)
+    my_sizes[i] = segments[i].size();
+  std::vector< std::vector<Uint> > sizes;
+  comm.all_gather(my_sizes, sizes);
+  for(Uint p = 0; p != nb_procs; ++p)
+  {
+    if(sizes[p].size() != nb_segments)
+      throw ParallelError(FromHere(), "Rank " + to_str(p) + " passed " + to_str(sizes[p].size()) + " segments to write_ordered, while rank " + to_str(rank) + " passed " + to_str(nb_segments));
+  }
+
+  MPI_Info info;
+  MPI_CHECK_RESULT(MPI_Info_create, (&info));
+  MPI_CHECK_RESULT(MPI_Info_set, (info, const_cast<char*>("romio_cb_write"), const_cast<char*>("enable")));
+  if(nb_aggregators != 0)
+  {
+    const std::string cb_nodes = to_str(std::min(nb_aggregators, nb_procs));
+    MPI_CHECK_RESULT(MPI_Info_set, (info, const_cast<char*>("cb_nodes"), const_cast<char*>(cb_nodes.c_str())));
+  }
+
+  MPI_File file;
+  const int open_result = MPI_File_open(comm.communicator(), const_cast<char*>(path.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY, info, &file);
+  MPI_Info_free(&info);
+  if(open_result != MPI_SUCCESS)
+    throw FileSystemError(FromHere(), "Could not open file " + path + " for collective writing");
+
+  // Truncate any previous contents, in case the old file was longer
+  MPI_CHECK_RESULT(MPI_File_set_size, (file, 0));
+
+  MPI_Offset segment_begin = 0;
+  for(Uint i = 0; i != nb_segments; ++i)
+  {
+    // Offset of this rank in the segment, and the number of write calls needed by the largest contribution
+    MPI_Offset offset = segment_begin;
+    Uint segment_size = 0;
+    Uint nb_chunks = 0;
+    for(Uint p = 0; p != nb_procs; ++p)
+    {
+      if(p < rank)
+        offset += sizes[p][i];
+      segment_size += sizes[p][i];
+      nb_chunks = std::max(nb_chunks, (sizes[p][i] + max_chunk_size - 1) / max_chunk_size);
+    }
+
+    // All ranks make the same number of collective calls, possibly writing nothing
+    const std::string& segment = segments[i];
+    for(Uint c = 0; c != nb_chunks; ++c)
+    {
+      const Uint chunk_begin = std::min(c*max_chunk_size, Uint(segment.size()));
+      const Uint chunk_end = std::min(chunk_begin + max_chunk_size, Uint(segment.size()));
+      MPI_Status status;
+      MPI_CHECK_RESULT(MPI_File_write_at_all, (file, offset + MPI_Offset(chunk_begin), const_cast<char*>(segment.data()) + chunk_begin, int(chunk_end - chunk_begin), MPI_BYTE, &status));
+    }
+
+    segment_begin += segment_size;
+  }
+
+  MPI_CHECK_RESULT(MPI_File_close, (&file));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // PE
+} // common
+} // cf3
@@ -0,0 +1,54 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_PE_write_ordered_hpp
+#define cf3_common_PE_write_ordered_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <string>
+#include <vector>
+
+#include "common/CF.hpp"
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file write_ordered.hpp
+  Collective write of text or binary segments from all processes into a single shared file.
+**/
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+  namespace common {
+    namespace PE {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/**
+  Write the segments of all processes into one file, interleaved by segment index: first segment 0 of ranks 0 to nproc-1,
+  then segment 1 of all ranks, and so on. This allows e.g. a header on rank 0, followed by a section that is distributed over
+  all processes, followed by a footer that is again only present on rank 0 (as the first part of the next segment).
+  Every process must pass the same number of segments; segments may be empty.
+  If the communicator is active with more than one process this is collective and uses MPI-IO, otherwise
+  the segments are written sequentially with a normal file stream. Existing files are overwritten.
+  @param path path of the file to write
+  @param segments the data to write for this process
+  @param nb_aggregators number of processes that actually access the file during collective buffering (0 to leave the choice to MPI)
+**/
+Common_API void write_ordered(const std::string& path, const std::vector<std::string>& segments, const Uint nb_aggregators = 0);
+
+////////////////////////////////////////////////////////////////////////////////
+
+    } // end namespace PE
+  } // end namespace common
+} // end namespace cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_PE_write_ordered_hpp
@@ -0,0 +1,69 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+
+#include "common/LibCommon.hpp"
+#include "common/RaggedTable.hpp"
+
+namespace cf3 {
+namespace common {
+
+common::ComponentBuilder < RaggedTable<Uint>, Component, LibCommon > RaggedTable_Uint_Builder;
+
+common::ComponentBuilder < RaggedTable<int>, Component, LibCommon >  RaggedTable_int_Builder;
+
+common::ComponentBuilder < RaggedTable<Real>, Component, LibCommon > RaggedTable_Real_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  template<typename T>
+  void print_table(std::ostream& os, const RaggedTable<T>& table)
+  {
+    if (table.size())
+      os << "\n";
+    for (Uint i=0; i<table.size(); ++i)
+    {
+      os << "  " << i << ":  ";
+      if (table.row_size(i) == 0)
+        os << "~";
+      else
+      {
+        boost_foreach(const T& entry, table[i])
+          os << entry << " ";
+      }
+      os << "\n";
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::ostream& operator<<(std::ostream& os, const RaggedTable<Uint>& table)
+{
+  print_table(os, table);
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const RaggedTable<int>& table)
+{
+  print_table(os, table);
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const RaggedTable<Real>& table)
+{
+  print_table(os, table);
+  return os;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
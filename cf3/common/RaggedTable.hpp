@@ -0,0 +1,177 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_common_RaggedTable_hpp
+#define cf3_common_RaggedTable_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Component.hpp"
+#include "common/StringConversion.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Component holding a table with variable row-size per row, stored in compressed row format:
+/// all values are contiguous, and row i consists of the values in [offsets[i], offsets[i+1]).
+/// Contrary to DynTable, there is no allocation per row, but rows can't be resized once built.
+/// The table is filled in two passes using a RaggedTable::Builder: first the size of each row
+/// is counted, then the values are added.
+template<typename T>
+class RaggedTable : public common::Component {
+
+public:
+
+  typedef std::vector<T> ValuesT;
+  typedef std::vector<Uint> OffsetsT;
+  typedef boost::iterator_range<T*> Row;
+  typedef boost::iterator_range<const T*> ConstRow;
+
+  /// Two-pass construction of the table
+  /// @code
+  /// RaggedTable<Uint>::Builder builder(table, nb_rows);
+  /// for (...) builder.count(row);
+  /// builder.allocate();
+  /// for (...) builder.add(row, value);
+  /// builder.finish();
+  /// @endcode
+  /// The values of a row are stored in the order in which they were added.
+  class Builder
+  {
+  public:
+    /// Start building the table, discarding its previous contents
+    Builder(RaggedTable& table, const Uint nb_rows) :
+      m_table(table),
+      m_allocated(false)
+    {
+      m_table.m_values.clear();
+      m_table.m_offsets.assign(nb_rows+1, 0u);
+    }
+
+    /// First pass: reserve room for nb_values more values in the given row
+    void count(const Uint row, const Uint nb_values = 1)
+    {
+      cf3_assert(!m_allocated);
+      cf3_assert(row+1 < m_table.m_offsets.size());
+      m_table.m_offsets[row+1] += nb_values;
+    }
+
+    /// Allocate the table storage, after all rows were counted
+    void allocate()
+    {
+      cf3_assert(!m_allocated);
+      OffsetsT& offsets = m_table.m_offsets;
+      const Uint nb_rows = offsets.size()-1;
+      for (Uint i=0; i<nb_rows; ++i)
+        offsets[i+1] += offsets[i];
+      m_table.m_values.resize(offsets.back());
+      m_fill.assign(offsets.begin(), offsets.end()-1);
+      m_allocated = true;
+    }
+
+    /// Second pass: add a value to the given row
+    void add(const Uint row, const T& value)
+    {
+      cf3_assert(m_allocated);
+      cf3_assert(m_fill[row] < m_table.m_offsets[row+1]);
+      m_table.m_values[m_fill[row]++] = value;
+    }
+
+    /// Check that every row received the number of values that was counted for it
+    void finish()
+    {
+      cf3_assert(m_allocated);
+      const Uint nb_rows = m_fill.size();
+      for (Uint i=0; i<nb_rows; ++i)
+      {
+        if (m_fill[i] != m_table.m_offsets[i+1])
+          throw BadValue(FromHere(), "Row " + to_str(i) + " of " + m_table.uri().string() + " received " + to_str(m_fill[i]-m_table.m_offsets[i]) + " values, but " + to_str(m_table.m_offsets[i+1]-m_table.m_offsets[i]) + " were counted");
+      }
+      OffsetsT().swap(m_fill);
+    }
+
+  private:
+    RaggedTable& m_table;
+    bool m_allocated;
+    /// Position of the next value to add in each row
+    OffsetsT m_fill;
+  };
+
+  /// Contructor
+  /// @param name of the component
+  RaggedTable ( const std::string& name ) : Component(name), m_offsets(1, 0u) { }
+
+  ~RaggedTable () {}
+
+  /// Get the class name
+  static std::string type_name () { return "RaggedTable<"+common::class_name<T>()+">"; }
+
+  /// Number of rows
+  Uint size() const { return m_offsets.size()-1; }
+
+  Uint row_size(const Uint i) const { return m_offsets[i+1]-m_offsets[i]; }
+
+  /// Total number of values in all rows
+  Uint nb_values() const { return m_values.size(); }
+
+  /// Remove all rows
+  void clear()
+  {
+    ValuesT().swap(m_values);
+    OffsetsT(1, 0u).swap(m_offsets);
+  }
+
+  Row operator[] (const Uint idx)
+  {
+    cf3_assert(idx < size());
+    T* values = m_values.empty() ? 0 : &m_values[0];
+    return Row(values + m_offsets[idx], values + m_offsets[idx+1]);
+  }
+
+  ConstRow operator[] (const Uint idx) const
+  {
+    cf3_assert(idx < size());
+    const T* values = m_values.empty() ? 0 : &m_values[0];
+    return ConstRow(values + m_offsets[idx], values + m_offsets[idx+1]);
+  }
+
+  /// @return The values of all rows, one after the other
+  const ValuesT& values() const { return m_values; }
+
+  /// @return The start of each row in values(), followed by the total number of values
+  const OffsetsT& offsets() const { return m_offsets; }
+
+private: // data
+
+  ValuesT m_values;
+
+  OffsetsT m_offsets;
+
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+std::ostream& operator<<(std::ostream& os, const RaggedTable<Uint>& table);
+std::ostream& operator<<(std::ostream& os, const RaggedTable<int>& table);
+std::ostream& operator<<(std::ostream& os, const RaggedTable<Real>& table);
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_RaggedTable_hpp
@@ -6,6 +6,8 @@
 
 #include <iostream>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
+
 #include "common/BasicExceptions.hpp"
 #include "common/Component.hpp"
 #include "common/FindComponents.hpp"
@@ -64,6 +66,41 @@ double Timer::elapsed() const
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+namespace detail {
+
+/// Current wall clock time in seconds, from an arbitrary origin
+double wall_clock_seconds()
+{
+#ifdef CF3_OS_LINUX
+  timespec now;
+  if (-1 == clock_gettime(CLOCK_MONOTONIC, &now))
+    throw common::NotSupported(FromHere(), "Couldn't get current time from monotonic clock");
+  return double(now.tv_sec) + double(now.tv_nsec) * 1e-9;
+#else
+  static const boost::posix_time::ptime origin = boost::posix_time::microsec_clock::universal_time();
+  return double((boost::posix_time::microsec_clock::universal_time() - origin).total_microseconds()) * 1e-6;
+#endif
+}
+
+} // detail
+
+WallTimer::WallTimer()
+{
+  restart();
+}
+
+void WallTimer::restart()
+{
+  m_start = detail::wall_clock_seconds();
+}
+
+double WallTimer::elapsed() const
+{
+  return detail::wall_clock_seconds() - m_start;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
 } // common
 } // cf3
 
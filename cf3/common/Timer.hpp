@@ -62,4 +62,32 @@ typedef boost::timer Timer;
 
 /////////////////////////////////////////////////////////////////////////////////////
 
+namespace cf3 {
+namespace common {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// Measures elapsed wall clock time, where Timer measures the CPU time used by the process.
+/// Uses a monotonic clock if available, so the result is not affected by changes of the system time.
+class Common_API WallTimer
+{
+public:
+  WallTimer();
+
+  void restart();
+
+  /// Elapsed time in seconds since construction or the last restart
+  double elapsed() const;
+
+private:
+  double m_start;
+}; // WallTimer
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+/////////////////////////////////////////////////////////////////////////////////////
+
 #endif // cf3_common_Timer_hpp
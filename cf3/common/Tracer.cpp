@@ -0,0 +1,473 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Component.hpp"
+#include "common/Foreach.hpp"
+#include "common/StringConversion.hpp"
+#include "common/Timer.hpp"
+#include "common/Tracer.hpp"
+
+#include "common/PE/Comm.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+struct TraceEvent
+{
+  Uint name;
+  Uint category;
+  Real begin;
+  Real end;
+};
+
+/// Chronological order, with enclosing events before the events they contain
+struct TraceEventBefore
+{
+  bool operator()(const TraceEvent& a, const TraceEvent& b) const
+  {
+    return a.begin < b.begin || (a.begin == b.begin && a.end > b.end);
+  }
+};
+
+/// Ring buffer with the events of one thread
+struct TraceBuffer
+{
+  TraceBuffer(const Uint id, const Uint capacity) : thread_id(id)
+  {
+    reset(capacity);
+  }
+
+  void reset(const Uint capacity)
+  {
+    events.resize(std::max(capacity, 1u));
+    next = 0;
+    nb_recorded = 0;
+  }
+
+  void push(const TraceEvent& event)
+  {
+    events[next] = event;
+    next = (next+1) % events.size();
+    ++nb_recorded;
+  }
+
+  Uint size() const { return std::min(nb_recorded, static_cast<Uint>(events.size())); }
+
+  /// The stored events, oldest first
+  void copy_events(std::vector<TraceEvent>& result) const
+  {
+    const Uint first = nb_recorded > events.size() ? next : 0u;
+    const Uint nb_events = size();
+    for(Uint i = 0; i != nb_events; ++i)
+      result.push_back(events[(first+i) % events.size()]);
+  }
+
+  const Uint thread_id;
+  std::vector<TraceEvent> events;
+  Uint next;
+  Uint nb_recorded;
+  /// Name ids already known to this thread, to avoid locking for each event
+  std::map<std::string, Uint> name_ids;
+};
+
+/// The buffers are owned by the tracer, so they outlive the threads
+void keep_buffer(TraceBuffer*)
+{
+}
+
+std::string escape_json(const std::string& str)
+{
+  std::string result;
+  result.reserve(str.size());
+  boost_foreach(const char c, str)
+  {
+    if(c == '"' || c == '\\')
+      result.push_back('\\');
+    if(static_cast<unsigned char>(c) < 0x20)
+      continue;
+    result.push_back(c);
+  }
+  return result;
+}
+
+const char* category_name(const Uint category)
+{
+  switch(category)
+  {
+    case Tracer::ACTION:      return "action";
+    case Tracer::SYNCHRONIZE: return "synchronize";
+    case Tracer::COLLECTIVE:  return "collective";
+    case Tracer::SOLVE:       return "solve";
+  }
+  return "unknown";
+}
+
+bool is_communication(const Uint category)
+{
+  return category == Tracer::SYNCHRONIZE || category == Tracer::COLLECTIVE;
+}
+
+/// Accumulated times for one event name
+struct TraceTotals
+{
+  TraceTotals() : count(0), time(0.), communication(0.) {}
+  Uint count;
+  Real time;
+  Real communication;
+};
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+class Tracer::Implementation
+{
+public:
+  Implementation() : buffer_size(100000u), local_buffer(&detail::keep_buffer)
+  {
+    start_clock = boost::posix_time::microsec_clock::universal_time();
+  }
+
+  detail::TraceBuffer& buffer()
+  {
+    detail::TraceBuffer* result = local_buffer.get();
+    if(is_null(result))
+    {
+      boost::mutex::scoped_lock lock(mutex);
+      buffers.push_back(boost::shared_ptr<detail::TraceBuffer>(new detail::TraceBuffer(buffers.size(), buffer_size)));
+      result = buffers.back().get();
+      local_buffer.reset(result);
+    }
+    return *result;
+  }
+
+  Uint name_id(detail::TraceBuffer& buffer, const std::string& name)
+  {
+    std::map<std::string, Uint>::const_iterator local_it = buffer.name_ids.find(name);
+    if(local_it != buffer.name_ids.end())
+      return local_it->second;
+
+    boost::mutex::scoped_lock lock(mutex);
+    std::map<std::string, Uint>::const_iterator it = name_ids.find(name);
+    Uint id;
+    if(it == name_ids.end())
+    {
+      id = names.size();
+      names.push_back(name);
+      name_ids[name] = id;
+    }
+    else
+    {
+      id = it->second;
+    }
+    buffer.name_ids[name] = id;
+    return id;
+  }
+
+  /// All stored events of a thread, oldest first
+  void thread_events(const detail::TraceBuffer& buffer, std::vector<detail::TraceEvent>& events) const
+  {
+    events.clear();
+    buffer.copy_events(events);
+    std::sort(events.begin(), events.end(), detail::TraceEventBefore());
+  }
+
+  WallTimer timer;
+  boost::posix_time::ptime start_clock;
+  Uint buffer_size;
+
+  boost::mutex mutex;
+  std::vector< boost::shared_ptr<detail::TraceBuffer> > buffers;
+  boost::thread_specific_ptr<detail::TraceBuffer> local_buffer;
+
+  std::vector<std::string> names;
+  std::map<std::string, Uint> name_ids;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+volatile bool Tracer::s_enabled = false;
+
+Tracer::Tracer() : m_implementation(new Implementation())
+{
+}
+
+Tracer::~Tracer()
+{
+  set_enabled(false);
+}
+
+Tracer& Tracer::instance()
+{
+  static Tracer tracer;
+  return tracer;
+}
+
+void Tracer::enable(const Uint buffer_size)
+{
+  set_enabled(false);
+  m_implementation->buffer_size = buffer_size;
+  clear();
+  m_implementation->timer.restart();
+  m_implementation->start_clock = boost::posix_time::microsec_clock::universal_time();
+  set_enabled(true);
+}
+
+void Tracer::disable()
+{
+  set_enabled(false);
+}
+
+void Tracer::set_enabled(const bool enabled)
+{
+#ifdef __GNUC__
+  __atomic_store_n(&s_enabled, enabled, __ATOMIC_RELEASE);
+#else
+  s_enabled = enabled;
+#endif
+}
+
+void Tracer::clear()
+{
+  boost::mutex::scoped_lock lock(m_implementation->mutex);
+  boost_foreach(const boost::shared_ptr<detail::TraceBuffer>& buffer, m_implementation->buffers)
+    buffer->reset(m_implementation->buffer_size);
+}
+
+Real Tracer::time() const
+{
+  return m_implementation->timer.elapsed();
+}
+
+void Tracer::record(const std::string& name, const Tracer::Category category, const Real begin, const Real end)
+{
+  detail::TraceBuffer& buffer = m_implementation->buffer();
+  detail::TraceEvent event;
+  event.name = m_implementation->name_id(buffer, name);
+  event.category = category;
+  event.begin = begin;
+  event.end = end;
+  buffer.push(event);
+}
+
+Uint Tracer::nb_events() const
+{
+  boost::mutex::scoped_lock lock(m_implementation->mutex);
+  Uint result = 0;
+  boost_foreach(const boost::shared_ptr<detail::TraceBuffer>& buffer, m_implementation->buffers)
+    result += buffer->size();
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tracer::write_chrome_trace(const std::string& file_name) const
+{
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint rank = PE::Comm::instance().rank();
+
+  std::string path = file_name;
+  if(parallel)
+  {
+    const std::string::size_type dot = path.rfind('.');
+    const std::string suffix = "-P" + to_str(rank);
+    if(dot == std::string::npos || path.find('/', dot) != std::string::npos)
+      path += suffix;
+    else
+      path.insert(dot, suffix);
+  }
+
+  std::ofstream file(path.c_str());
+  if(!file)
+    throw FileSystemError(FromHere(), "Could not open trace file " + path);
+
+  // Timestamps are in microseconds since the epoch, so the files of different ranks line up
+  const Real start_us = static_cast<Real>((m_implementation->start_clock - boost::posix_time::ptime(boost::gregorian::date(1970,1,1))).total_microseconds());
+
+  file << std::fixed << std::setprecision(3);
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  file << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+
+  boost::mutex::scoped_lock lock(m_implementation->mutex);
+  std::vector<detail::TraceEvent> events;
+  boost_foreach(const boost::shared_ptr<detail::TraceBuffer>& buffer, m_implementation->buffers)
+  {
+    m_implementation->thread_events(*buffer, events);
+    boost_foreach(const detail::TraceEvent& event, events)
+    {
+      file << ",\n{\"name\":\"" << detail::escape_json(m_implementation->names[event.name])
+           << "\",\"cat\":\"" << detail::category_name(event.category)
+           << "\",\"ph\":\"X\",\"ts\":" << start_us + event.begin*1e6
+           << ",\"dur\":" << (event.end - event.begin)*1e6
+           << ",\"pid\":" << rank
+           << ",\"tid\":" << buffer->thread_id << "}";
+    }
+  }
+  file << "\n]}\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Tracer::print_summary(std::ostream& out) const
+{
+  // Local totals per name. Communication time counts towards every enclosing action,
+  // but communication nested inside other communication is only counted once.
+  std::map<std::string, detail::TraceTotals> totals;
+  {
+    boost::mutex::scoped_lock lock(m_implementation->mutex);
+    std::vector<detail::TraceEvent> events;
+    std::vector<detail::TraceTotals*> open_actions;
+    std::vector<Real> open_ends;
+    boost_foreach(const boost::shared_ptr<detail::TraceBuffer>& buffer, m_implementation->buffers)
+    {
+      m_implementation->thread_events(*buffer, events);
+      open_actions.clear();
+      open_ends.clear();
+      Real communication_end = -1.;
+      boost_foreach(const detail::TraceEvent& event, events)
+      {
+        while(!open_ends.empty() && open_ends.back() <= event.begin)
+        {
+          open_ends.pop_back();
+          open_actions.pop_back();
+        }
+
+        if(detail::is_communication(event.category))
+        {
+          if(event.begin >= communication_end)
+          {
+            communication_end = event.end;
+            boost_foreach(detail::TraceTotals* action, open_actions)
+              action->communication += event.end - event.begin;
+          }
+          continue;
+        }
+
+        detail::TraceTotals& action = totals[m_implementation->names[event.name]];
+        ++action.count;
+        action.time += event.end - event.begin;
+        open_actions.push_back(&action);
+        open_ends.push_back(event.end);
+      }
+    }
+  }
+
+  // Combine over all ranks, using the union of the names seen on each rank
+  PE::Comm& comm = PE::Comm::instance();
+  const bool parallel = comm.is_active() && comm.size() > 1;
+  std::vector<std::string> names;
+  if(parallel)
+  {
+    std::string local_names;
+    for(std::map<std::string, detail::TraceTotals>::const_iterator it = totals.begin(); it != totals.end(); ++it)
+      local_names += it->first + "\n";
+    std::vector<char> send(local_names.begin(), local_names.end());
+    std::vector< std::vector<char> > recv;
+    comm.all_gather(send, recv);
+    std::set<std::string> all_names;
+    boost_foreach(const std::vector<char>& rank_names, recv)
+    {
+      std::istringstream stream(std::string(rank_names.begin(), rank_names.end()));
+      std::string name;
+      while(std::getline(stream, name))
+        all_names.insert(name);
+    }
+    names.assign(all_names.begin(), all_names.end());
+  }
+  else
+  {
+    for(std::map<std::string, detail::TraceTotals>::const_iterator it = totals.begin(); it != totals.end(); ++it)
+      names.push_back(it->first);
+  }
+
+  const Uint nb_names = names.size();
+  std::vector<Real> time(nb_names, 0.), communication(nb_names, 0.);
+  std::vector<Uint> count(nb_names, 0u);
+  for(Uint i = 0; i != nb_names; ++i)
+  {
+    std::map<std::string, detail::TraceTotals>::const_iterator it = totals.find(names[i]);
+    if(it == totals.end())
+      continue;
+    time[i] = it->second.time;
+    communication[i] = it->second.communication;
+    count[i] = it->second.count;
+  }
+
+  std::vector<Real> time_sum(time), time_max(time), communication_sum(communication), communication_max(communication);
+  std::vector<Uint> count_max(count);
+  if(parallel && nb_names != 0)
+  {
+    comm.all_reduce(PE::plus(), &time[0], nb_names, &time_sum[0]);
+    comm.all_reduce(PE::max(), &time[0], nb_names, &time_max[0]);
+    comm.all_reduce(PE::plus(), &communication[0], nb_names, &communication_sum[0]);
+    comm.all_reduce(PE::max(), &communication[0], nb_names, &communication_max[0]);
+    comm.all_reduce(PE::max(), &count[0], nb_names, &count_max[0]);
+  }
+
+  if(comm.rank() != 0)
+    return;
+
+  const Real nb_procs = parallel ? static_cast<Real>(comm.size()) : 1.;
+  out << "Trace summary in seconds, over " << nb_procs << " ranks. Imbalance is the maximum over the mean time, communication is the time spent in synchronizations and collectives\n";
+  out << std::setw(12) << "count" << std::setw(14) << "mean" << std::setw(14) << "max" << std::setw(10) << "imbalance"
+      << std::setw(14) << "comm mean" << std::setw(14) << "comm max" << "  name\n";
+  for(Uint i = 0; i != nb_names; ++i)
+  {
+    const Real mean = time_sum[i] / nb_procs;
+    out << std::setw(12) << count_max[i]
+        << std::setw(14) << mean
+        << std::setw(14) << time_max[i]
+        << std::setw(10) << (mean > 0. ? time_max[i] / mean : 1.)
+        << std::setw(14) << communication_sum[i] / nb_procs
+        << std::setw(14) << communication_max[i]
+        << "  " << names[i] << "\n";
+  }
+  out << std::flush;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TraceScope::begin(const std::string& name)
+{
+  m_name = name;
+  m_begin = Tracer::instance().time();
+}
+
+void TraceScope::begin(const Component& component)
+{
+  begin(component.uri().path());
+}
+
+void TraceScope::end()
+{
+  Tracer::instance().record(m_name, m_category, m_begin, Tracer::instance().time());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
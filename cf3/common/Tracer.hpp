@@ -0,0 +1,149 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+/// @file Tracer.hpp
+/// @note This header gets included in common/PE/Comm.hpp
+///       It should be as lean as possible!
+
+#ifndef cf3_common_Tracer_hpp
+#define cf3_common_Tracer_hpp
+
+#include <iosfwd>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+
+#include "common/CF.hpp"
+#include "common/CommonAPI.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common {
+
+class Component;
+
+/// @brief Records when actions, communications and linear solves start and end, at runtime
+///
+/// Tracing is switched on and off while running, using the "trace" option of the Environment.
+/// Each thread records its events in its own ring buffer, so the memory use is bounded and only
+/// the most recent events are kept for long runs. The events of a rank can be written in the
+/// Chrome trace format, to be viewed in chrome://tracing or https://ui.perfetto.dev, and a summary
+/// over all ranks shows the load imbalance and the time spent in communication for each action.
+/// When tracing is disabled, a TraceScope only costs the test of a boolean.
+class Common_API Tracer : public boost::noncopyable
+{
+public:
+
+  /// Kind of traced event
+  enum Category { ACTION=0, SYNCHRONIZE=1, COLLECTIVE=2, SOLVE=3 };
+
+  /// Gets the instance of the tracer
+  static Tracer& instance();
+
+  /// True if events are being recorded. Safe to call from any thread while tracing is switched on or off.
+  static bool is_enabled()
+  {
+#ifdef __GNUC__
+    return __atomic_load_n(&s_enabled, __ATOMIC_ACQUIRE);
+#else
+    return s_enabled; // volatile accesses have acquire and release semantics with MSVC
+#endif
+  }
+
+  /// Start recording, discarding previously recorded events
+  /// @param buffer_size The maximum number of events kept for each thread
+  void enable(const Uint buffer_size = 100000u);
+
+  /// Stop recording, keeping the recorded events
+  void disable();
+
+  /// Discard all recorded events
+  void clear();
+
+  /// Wall clock time in seconds since tracing was enabled
+  Real time() const;
+
+  /// Record an event of the calling thread, with begin and end as given by time()
+  void record(const std::string& name, const Category category, const Real begin, const Real end);
+
+  /// Number of events currently stored, over all threads
+  Uint nb_events() const;
+
+  /// Write the events of this rank in the Chrome trace format.
+  /// When running in parallel, the rank is appended to the file name, i.e. trace.json becomes trace-P1.json
+  /// Must not be called while other threads are recording.
+  void write_chrome_trace(const std::string& file_name) const;
+
+  /// Print, for each traced action and linear solve, the time over all ranks, the load imbalance (maximum over mean)
+  /// and the time spent in communication inside it. Collective over all ranks, only rank 0 prints.
+  void print_summary(std::ostream& out) const;
+
+private:
+
+  Tracer();
+  ~Tracer();
+
+  /// Atomically change s_enabled
+  static void set_enabled(const bool enabled);
+
+  static volatile bool s_enabled;
+
+  class Implementation;
+  boost::scoped_ptr<Implementation> m_implementation;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Records an event covering the lifetime of the object, if tracing is enabled
+class Common_API TraceScope : public boost::noncopyable
+{
+public:
+  TraceScope(const char* name, const Tracer::Category category) : m_enabled(Tracer::is_enabled()), m_category(category)
+  {
+    if(m_enabled)
+      begin(name);
+  }
+
+  TraceScope(const std::string& name, const Tracer::Category category) : m_enabled(Tracer::is_enabled()), m_category(category)
+  {
+    if(m_enabled)
+      begin(name);
+  }
+
+  /// The event is named after the path of the component
+  TraceScope(const Component& component, const Tracer::Category category) : m_enabled(Tracer::is_enabled()), m_category(category)
+  {
+    if(m_enabled)
+      begin(component);
+  }
+
+  ~TraceScope()
+  {
+    if(m_enabled)
+      end();
+  }
+
+private:
+  void begin(const std::string& name);
+  void begin(const Component& component);
+  void end();
+
+  const bool m_enabled;
+  const Tracer::Category m_category;
+  std::string m_name;
+  Real m_begin;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // common
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_common_Tracer_hpp
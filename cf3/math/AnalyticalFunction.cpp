@@ -121,6 +121,7 @@ void AnalyticalFunction::parse (const std::string& function)
     msg += " Vars     [" + ss.str() + "]\n";
     throw common::ParsingFailed (FromHere(),msg);
   }
+  m_parser->Optimize();
   m_is_parsed = true;
 }
 
@@ -149,6 +150,7 @@ void AnalyticalFunction::parse_and_deduce_variables (const std::string& function
     msg += " Vars     [" + ss.str() + "]\n";
     throw common::ParsingFailed (FromHere(),msg);
   }
+  m_parser->Optimize();
   m_is_parsed = true;
 }
 
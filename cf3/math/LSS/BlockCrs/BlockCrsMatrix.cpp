@@ -0,0 +1,774 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <boost/bind.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "coolfluid-packages.hpp"
+
+#include "common/Assertions.hpp"
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+#include "math/LSS/BlockCrs/BlockCrsMatrix.hpp"
+#include "math/LSS/BlockCrs/BlockCrsVector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file BlockCrsMatrix.cpp implementation of LSS::BlockCrsMatrix
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::math;
+using namespace cf3::math::LSS;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+#if !defined(CF3_HAVE_OPENMP) && !defined(__GNUC__)
+/// Serializes atomic_add when neither OpenMP nor the GCC atomic builtins are available
+boost::mutex atomic_add_mutex;
+#endif
+
+/// Atomically add value to dst. Without OpenMP, GCC compatible compilers use a compare and swap loop on the bits of
+/// the double, other compilers a global lock.
+inline void atomic_add(Real& dst, const Real value)
+{
+#if defined(CF3_HAVE_OPENMP)
+  #pragma omp atomic
+  dst += value;
+#elif defined(__GNUC__)
+  BOOST_STATIC_ASSERT(sizeof(Real) == sizeof(boost::uint64_t));
+  boost::uint64_t* const dst_bits = reinterpret_cast<boost::uint64_t*>(&dst);
+  boost::uint64_t expected = __atomic_load_n(dst_bits, __ATOMIC_RELAXED);
+  while(true)
+  {
+    Real sum;
+    std::memcpy(&sum, &expected, sizeof(Real));
+    sum += value;
+    boost::uint64_t desired;
+    std::memcpy(&desired, &sum, sizeof(Real));
+    // On failure, expected is updated with the current bits
+    if(__atomic_compare_exchange_n(dst_bits, &expected, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      return;
+  }
+#else
+  boost::lock_guard<boost::mutex> lock(atomic_add_mutex);
+  dst += value;
+#endif
+}
+
+/// Block sparse matrix-vector product y = alpha*A*x + beta*y, with the block size fixed at compile time if N is not Eigen::Dynamic
+template<int N>
+void block_spmv(const Uint nb_rows, const Uint neq, const Uint* row_offsets, const Uint* columns, const Real* values, const Real* x, Real* y, const Real alpha, const Real beta)
+{
+  typedef Eigen::Matrix<Real, N, N, Eigen::RowMajor> BlockT;
+  typedef Eigen::Matrix<Real, N, 1> BlockVectorT;
+
+  const Uint block_size = neq*neq;
+  const int nb_rows_int = nb_rows;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static) if(nb_rows_int > 1000)
+#endif
+  for(int row = 0; row < nb_rows_int; ++row)
+  {
+    BlockVectorT row_sum = BlockVectorT::Zero(neq);
+    const Uint row_end = row_offsets[row+1];
+    for(Uint pos = row_offsets[row]; pos != row_end; ++pos)
+    {
+      row_sum.noalias() += Eigen::Map<const BlockT>(values + pos*block_size, neq, neq) * Eigen::Map<const BlockVectorT>(x + columns[pos]*neq, neq);
+    }
+
+    Eigen::Map<BlockVectorT> y_row(y + row*neq, neq);
+    if(beta == 0.)
+      y_row = alpha*row_sum;
+    else
+      y_row = alpha*row_sum + beta*y_row;
+  }
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < LSS::BlockCrsMatrix, LSS::Matrix, LSS::LibLSS > BlockCrsMatrix_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+BlockCrsMatrix::BlockCrsMatrix(const std::string& name) :
+  LSS::Matrix(name),
+  m_is_created(false),
+  m_neq(0),
+  m_nb_rows(0),
+  m_atomic_assembly(false)
+{
+  properties().add("vector_type", std::string("cf3.math.LSS.BlockCrsVector"));
+
+  options().add("atomic_assembly", m_atomic_assembly)
+    .pretty_name("Atomic Assembly")
+    .description("Use atomic additions, so elements that share nodes can be assembled concurrently. Not needed for colored element loops.")
+    .link_to(&m_atomic_assembly);
+
+  options().add("scatter_cache_size", 512u)
+    .pretty_name("Scatter Cache Size")
+    .description("Maximum memory in MB used to cache the block positions of the assembled elements. Set to 0 to disable the cache.")
+    .attach_trigger(boost::bind(&BlockCrsMatrix::trigger_scatter_cache_size, this));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::trigger_scatter_cache_size()
+{
+  m_scatter_cache.set_max_memory(static_cast<std::size_t>(options().value<Uint>("scatter_cache_size"))*1024*1024);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::create(cf3::common::PE::CommPattern& cp, const Uint neq, const std::vector<Uint>& node_connectivity, const std::vector<Uint>& starting_indices, LSS::Vector& solution, LSS::Vector& rhs, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active)
+{
+  boost::shared_ptr<VariablesDescriptor> single_var_descriptor = common::allocate_component<VariablesDescriptor>("SingleVariableDescriptor");
+  single_var_descriptor->options().set(common::Tags::dimension(), neq);
+  single_var_descriptor->push_back("LSSvars", VariablesDescriptor::Dimensionalities::VECTOR);
+  create_blocked(cp, *single_var_descriptor, node_connectivity, starting_indices, solution, rhs, periodic_links_nodes, periodic_links_active);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector< Uint >& node_connectivity, const std::vector< Uint >& starting_indices, Vector& solution, Vector& rhs, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active)
+{
+  if (m_is_created) destroy();
+
+  m_nb_rows = LSS::detail::create_block_row_map(cp, periodic_links_nodes, periodic_links_active, m_node_to_row);
+  m_neq = vars.size();
+
+  const Uint nb_nodes = m_node_to_row.size();
+  cf3_assert(starting_indices.size() == nb_nodes+1);
+
+  // Non-linked nodes own their row
+  m_row_to_node.resize(m_nb_rows);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    if(periodic_links_active.empty() || !periodic_links_active[i])
+      m_row_to_node[m_node_to_row[i]] = i;
+  }
+
+  // Collect the columns for each row, merging the rows of periodically linked nodes
+  std::vector< std::vector<Uint> > row_columns(m_nb_rows);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    std::vector<Uint>& columns = row_columns[m_node_to_row[i]];
+    columns.push_back(m_node_to_row[i]);
+    for(Uint j = starting_indices[i]; j != starting_indices[i+1]; ++j)
+      columns.push_back(m_node_to_row[node_connectivity[j]]);
+  }
+
+  m_row_offsets.assign(m_nb_rows+1, 0);
+  for(Uint row = 0; row != m_nb_rows; ++row)
+  {
+    std::vector<Uint>& columns = row_columns[row];
+    std::sort(columns.begin(), columns.end());
+    columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+    m_row_offsets[row+1] = m_row_offsets[row] + columns.size();
+  }
+
+  m_columns.clear();
+  m_columns.reserve(m_row_offsets.back());
+  m_diagonal_positions.resize(m_nb_rows);
+  for(Uint row = 0; row != m_nb_rows; ++row)
+  {
+    const std::vector<Uint>& columns = row_columns[row];
+    m_diagonal_positions[row] = m_columns.size() + (std::lower_bound(columns.begin(), columns.end(), row) - columns.begin());
+    m_columns.insert(m_columns.end(), columns.begin(), columns.end());
+  }
+
+  m_values.assign(m_columns.size()*m_neq*m_neq, 0.);
+  m_symmetric_dirichlet_values.clear();
+  m_scatter_cache.reset(nb_nodes);
+
+  m_is_created = true;
+  CFdebug << "Created a " << m_nb_rows*m_neq << " x " << m_nb_rows*m_neq << " block CRS matrix with " << m_columns.size() << " blocks of size " << m_neq << " x " << m_neq << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::destroy()
+{
+  m_node_to_row.clear();
+  m_row_to_node.clear();
+  m_row_offsets.clear();
+  m_columns.clear();
+  m_diagonal_positions.clear();
+  m_values.clear();
+  m_symmetric_dirichlet_values.clear();
+  m_scatter_cache.clear();
+  m_neq = 0;
+  m_nb_rows = 0;
+  m_is_created = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Uint BlockCrsMatrix::block_position(const Uint row, const Uint col) const
+{
+  cf3_assert(row < m_nb_rows);
+  const std::vector<Uint>::const_iterator row_begin = m_columns.begin() + m_row_offsets[row];
+  const std::vector<Uint>::const_iterator row_end = m_columns.begin() + m_row_offsets[row+1];
+  const std::vector<Uint>::const_iterator it = std::lower_bound(row_begin, row_end, col);
+  if(it == row_end || *it != col)
+    return m_columns.size();
+  return it - m_columns.begin();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Real* BlockCrsMatrix::block(const Uint row, const Uint col)
+{
+  const Uint pos = block_position(row, col);
+  if(pos == m_columns.size())
+    throw common::BadValue(FromHere(),"Trying to access an illegal entry.");
+  return &m_values[pos*m_neq*m_neq];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::add_block(const Uint pos, const Real* src, const Uint src_stride)
+{
+  Real* dst = &m_values[pos*m_neq*m_neq];
+  if(m_atomic_assembly)
+  {
+    for(Uint i = 0; i != m_neq; ++i)
+    {
+      for(Uint j = 0; j != m_neq; ++j)
+        atomic_add(dst[i*m_neq+j], src[i*src_stride+j]);
+    }
+  }
+  else
+  {
+    for(Uint i = 0; i != m_neq; ++i)
+    {
+      for(Uint j = 0; j != m_neq; ++j)
+        dst[i*m_neq+j] += src[i*src_stride+j];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::set_value(const Uint icol, const Uint irow, const Real value)
+{
+  cf3_assert(m_is_created);
+  block(m_node_to_row[irow/m_neq], m_node_to_row[icol/m_neq])[(irow%m_neq)*m_neq + icol%m_neq] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::add_value(const Uint icol, const Uint irow, const Real value)
+{
+  cf3_assert(m_is_created);
+  Real& entry = block(m_node_to_row[irow/m_neq], m_node_to_row[icol/m_neq])[(irow%m_neq)*m_neq + icol%m_neq];
+  if(m_atomic_assembly)
+    atomic_add(entry, value);
+  else
+    entry += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::get_value(const Uint icol, const Uint irow, Real& value)
+{
+  cf3_assert(m_is_created);
+  value = block(m_node_to_row[irow/m_neq], m_node_to_row[icol/m_neq])[(irow%m_neq)*m_neq + icol%m_neq];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::compute_scatter_map(const std::vector<Uint>& indices, std::vector<Uint>& scatter_map) const
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = indices.size();
+  scatter_map.resize(nb_nodes*nb_nodes);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Uint row = m_node_to_row[indices[i]];
+    for(Uint j = 0; j != nb_nodes; ++j)
+    {
+      const Uint pos = block_position(row, m_node_to_row[indices[j]]);
+      if(pos == m_columns.size())
+        throw common::BadValue(FromHere(),"Trying to access an illegal entry.");
+      scatter_map[i*nb_nodes+j] = pos;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::set_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  const Uint stride = nb_nodes*m_neq;
+  cf3_assert(values.mat.rows() == stride);
+  const Real* src = values.mat.data();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Uint row = m_node_to_row[values.indices[i]];
+    for(Uint j = 0; j != nb_nodes; ++j)
+    {
+      Real* dst = block(row, m_node_to_row[values.indices[j]]);
+      const Real* src_block = src + i*m_neq*stride + j*m_neq;
+      for(Uint k = 0; k != m_neq; ++k)
+        for(Uint l = 0; l != m_neq; ++l)
+          dst[k*m_neq+l] = src_block[k*stride+l];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::add_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  if(values.indices.empty())
+    return;
+
+  const std::vector<Uint>* scatter_map = m_scatter_cache.find(values.indices);
+  if(is_not_null(scatter_map))
+  {
+    add_values(values, *scatter_map);
+    return;
+  }
+
+  // Not cached yet, or the cache is full: use the computed map directly
+  std::vector<Uint> new_scatter_map;
+  compute_scatter_map(values.indices, new_scatter_map);
+  m_scatter_cache.insert(values.indices, new_scatter_map);
+  add_values(values, new_scatter_map);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::add_values(const BlockAccumulator& values, const std::vector<Uint>& scatter_map)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  const Uint stride = nb_nodes*m_neq;
+  cf3_assert(values.mat.rows() == stride);
+  cf3_assert(scatter_map.size() == nb_nodes*nb_nodes);
+  const Real* src = values.mat.data();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    for(Uint j = 0; j != nb_nodes; ++j)
+      add_block(scatter_map[i*nb_nodes+j], src + i*m_neq*stride + j*m_neq, stride);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::get_values(BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  values.mat.setZero();
+  const Uint nb_nodes = values.indices.size();
+  const Uint stride = nb_nodes*m_neq;
+  cf3_assert(values.mat.rows() == stride);
+  Real* dst = values.mat.data();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Uint row = m_node_to_row[values.indices[i]];
+    for(Uint j = 0; j != nb_nodes; ++j)
+    {
+      const Uint pos = block_position(row, m_node_to_row[values.indices[j]]);
+      if(pos == m_columns.size())
+        continue;
+      const Real* src_block = &m_values[pos*m_neq*m_neq];
+      Real* dst_block = dst + i*m_neq*stride + j*m_neq;
+      for(Uint k = 0; k != m_neq; ++k)
+        for(Uint l = 0; l != m_neq; ++l)
+          dst_block[k*stride+l] = src_block[k*m_neq+l];
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval)
+{
+  cf3_assert(m_is_created);
+  const Uint row = m_node_to_row[iblockrow];
+  const Uint diag_pos = m_diagonal_positions[row];
+  for(Uint pos = m_row_offsets[row]; pos != m_row_offsets[row+1]; ++pos)
+  {
+    Real* row_values = &m_values[pos*m_neq*m_neq + ieq*m_neq];
+    for(Uint k = 0; k != m_neq; ++k)
+      row_values[k] = (pos == diag_pos && k == ieq) ? diagval : offdiagval;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values)
+{
+  cf3_assert(m_is_created);
+  values.assign(m_node_to_row.size()*m_neq, 0.);
+  const Uint col = m_node_to_row[iblockcol];
+  for(Uint row = 0; row != m_nb_rows; ++row)
+  {
+    const Uint pos = block_position(row, col);
+    if(pos == m_columns.size())
+      continue;
+    Real* block_values = &m_values[pos*m_neq*m_neq];
+    const Uint node = m_row_to_node[row];
+    for(Uint k = 0; k != m_neq; ++k)
+    {
+      values[node*m_neq+k] = block_values[k*m_neq+ieq];
+      block_values[k*m_neq+ieq] = 0.;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, Vector& rhs)
+{
+  cf3_assert(m_is_created);
+  BlockCrsVector* crs_rhs = dynamic_cast<BlockCrsVector*>(&rhs);
+  if(is_null(crs_rhs))
+    throw common::SetupError(FromHere(), "symmetric_dirichlet method of BlockCrsMatrix needs a BlockCrsVector, but a " + rhs.derived_type_name() + " was supplied instead.");
+  std::vector<Real>& rhs_data = crs_rhs->data();
+
+  const Uint bc_row = m_node_to_row[blockrow];
+  DirichletEntryT& cached_col_values = m_symmetric_dirichlet_values[bc_row*m_neq+ieq];
+
+  if(cached_col_values.empty())
+  {
+    // The sparsity pattern is structurally symmetric, so the rows that have a block in column bc_row are the columns of row bc_row
+    for(Uint row_pos = m_row_offsets[bc_row]; row_pos != m_row_offsets[bc_row+1]; ++row_pos)
+    {
+      const Uint other_row = m_columns[row_pos];
+      const Uint pos = block_position(other_row, bc_row);
+      if(pos == m_columns.size())
+        continue;
+      Real* block_values = &m_values[pos*m_neq*m_neq];
+      for(Uint k = 0; k != m_neq; ++k)
+      {
+        if(other_row == bc_row && k == ieq)
+          continue;
+        Real& entry = block_values[k*m_neq+ieq];
+        cached_col_values[other_row*m_neq+k] = entry;
+        rhs_data[other_row*m_neq+k] -= entry * value;
+        entry = 0.;
+      }
+    }
+    set_row(blockrow, ieq, 1., 0.);
+  }
+  else // Reuse the cached values, if the matrix wasn't reset since the previous BC application
+  {
+    for(DirichletEntryT::const_iterator it = cached_col_values.begin(); it != cached_col_values.end(); ++it)
+    {
+      rhs_data[it->first] -= it->second * value;
+    }
+  }
+
+  rhs.set_value(blockrow, ieq, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from)
+{
+  cf3_assert(m_is_created);
+  const Uint row_to = m_node_to_row[iblockrow_to];
+  const Uint row_from = m_node_to_row[iblockrow_from];
+
+  const Uint nb_row_blocks = m_row_offsets[row_from+1] - m_row_offsets[row_from];
+  if(m_row_offsets[row_to+1] - m_row_offsets[row_to] != nb_row_blocks)
+    throw common::BadValue(FromHere(),"Number of entries do not match for the two block rows to be tied together.");
+  if(!std::equal(m_columns.begin() + m_row_offsets[row_from], m_columns.begin() + m_row_offsets[row_from+1], m_columns.begin() + m_row_offsets[row_to]))
+    throw common::BadValue(FromHere(),"Indices of the entries do not match for the two block rows to be tied together.");
+  if(block_position(row_from, row_to) == m_columns.size())
+    throw common::BadValue(FromHere(),"The two block rows to be tied together are not coupled in the sparsity pattern.");
+
+  const Uint block_size = m_neq*m_neq;
+  const Uint from_begin = m_row_offsets[row_from];
+  const Uint to_begin = m_row_offsets[row_to];
+
+  // Move the from row into the to row
+  for(Uint i = 0; i != nb_row_blocks; ++i)
+  {
+    Real* from_values = &m_values[(from_begin+i)*block_size];
+    Real* to_values = &m_values[(to_begin+i)*block_size];
+    for(Uint k = 0; k != block_size; ++k)
+    {
+      to_values[k] += from_values[k];
+      from_values[k] = 0.;
+    }
+  }
+
+  // The from row now ties the from unknowns to the to unknowns
+  const Uint from_col_pos = block_position(row_from, row_from);
+  const Uint to_col_pos = block_position(row_from, row_to);
+  for(Uint k = 0; k != m_neq; ++k)
+  {
+    m_values[from_col_pos*block_size + k*m_neq + k] = 1.;
+    m_values[to_col_pos*block_size + k*m_neq + k] = -1.;
+  }
+
+  // In the to row, the contributions for the from unknowns are added to the to unknowns
+  Real* to_diag_values = &m_values[block_position(row_to, row_to)*block_size];
+  Real* to_from_values = &m_values[block_position(row_to, row_from)*block_size];
+  for(Uint k = 0; k != block_size; ++k)
+  {
+    to_diag_values[k] += to_from_values[k];
+    to_from_values[k] = 0.;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::set_diagonal(const std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(diag.size() == m_node_to_row.size()*m_neq);
+  const Uint nb_nodes = m_node_to_row.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    Real* diag_block = &m_values[m_diagonal_positions[m_node_to_row[i]]*m_neq*m_neq];
+    for(Uint k = 0; k != m_neq; ++k)
+      diag_block[k*m_neq+k] = diag[i*m_neq+k];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::add_diagonal(const std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(diag.size() == m_node_to_row.size()*m_neq);
+  const Uint nb_nodes = m_node_to_row.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    Real* diag_block = &m_values[m_diagonal_positions[m_node_to_row[i]]*m_neq*m_neq];
+    for(Uint k = 0; k != m_neq; ++k)
+      diag_block[k*m_neq+k] += diag[i*m_neq+k];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::get_diagonal(std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = m_node_to_row.size();
+  diag.resize(nb_nodes*m_neq);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Real* diag_block = &m_values[m_diagonal_positions[m_node_to_row[i]]*m_neq*m_neq];
+    for(Uint k = 0; k != m_neq; ++k)
+      diag[i*m_neq+k] = diag_block[k*m_neq+k];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::reset(Real reset_to)
+{
+  cf3_assert(m_is_created);
+  std::fill(m_values.begin(), m_values.end(), reset_to);
+  m_symmetric_dirichlet_values.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::clone_to(Matrix &other)
+{
+  if(!m_is_created)
+    throw common::SetupError(FromHere(), "Matrix to clone " + uri().string() + " is not created");
+
+  BlockCrsMatrix* other_ptr = dynamic_cast<BlockCrsMatrix*>(&other);
+  if(is_null(other_ptr))
+    throw common::SetupError(FromHere(), "clone_to method of BlockCrsMatrix needs another BlockCrsMatrix, but a " + other.derived_type_name() + " was supplied instead.");
+
+  other_ptr->m_is_created = m_is_created;
+  other_ptr->m_neq = m_neq;
+  other_ptr->m_nb_rows = m_nb_rows;
+  other_ptr->m_node_to_row = m_node_to_row;
+  other_ptr->m_row_to_node = m_row_to_node;
+  other_ptr->m_row_offsets = m_row_offsets;
+  other_ptr->m_columns = m_columns;
+  other_ptr->m_diagonal_positions = m_diagonal_positions;
+  other_ptr->m_values = m_values;
+  other_ptr->m_symmetric_dirichlet_values = m_symmetric_dirichlet_values;
+  other_ptr->m_scatter_cache.reset(m_node_to_row.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+template<typename StreamT>
+void BlockCrsMatrix::print_entries(StreamT& stream)
+{
+  const Uint block_size = m_neq*m_neq;
+  for(Uint row = 0; row != m_nb_rows; ++row)
+  {
+    for(Uint pos = m_row_offsets[row]; pos != m_row_offsets[row+1]; ++pos)
+    {
+      const Uint col = m_columns[pos];
+      for(Uint k = 0; k != m_neq; ++k)
+        for(Uint l = 0; l != m_neq; ++l)
+          stream << m_row_to_node[col]*m_neq+l << " " << -(int)(m_row_to_node[row]*m_neq+k) << " " << m_values[pos*block_size + k*m_neq + l] << "\n";
+    }
+  }
+  stream << "# name:                 " << name() << "\n";
+  stream << "# type_name:            " << type_name() << "\n";
+  stream << "# number of equations:  " << m_neq << "\n";
+  stream << "# number of rows:       " << m_nb_rows*m_neq << "\n";
+  stream << "# number of cols:       " << m_node_to_row.size()*m_neq << "\n";
+  stream << "# number of block rows: " << m_nb_rows << "\n";
+  stream << "# number of block cols: " << m_node_to_row.size() << "\n";
+  stream << "# number of entries:    " << m_values.size() << "\n";
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::print(common::LogStream& stream)
+{
+  if (m_is_created)
+  {
+    print_entries(stream);
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::print(std::ostream& stream)
+{
+  if (m_is_created)
+  {
+    print_entries(stream);
+    stream << std::flush;
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::print(const std::string& filename, std::ios_base::openmode mode )
+{
+  std::ofstream stream(filename.c_str(),mode);
+  stream << "VARIABLES=COL,ROW,VAL\n" << std::flush;
+  stream << "ZONE T=\"" << type_name() << "::" << name() <<  "\"\n" << std::flush;
+  print(stream);
+  stream.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::print_native(std::ostream& stream)
+{
+  const Uint block_size = m_neq*m_neq;
+  for(Uint row = 0; row != m_nb_rows; ++row)
+  {
+    for(Uint pos = m_row_offsets[row]; pos != m_row_offsets[row+1]; ++pos)
+    {
+      stream << "block (" << row << ", " << m_columns[pos] << "):";
+      for(Uint k = 0; k != block_size; ++k)
+        stream << " " << m_values[pos*block_size + k];
+      stream << "\n";
+    }
+  }
+  stream << std::flush;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::debug_data(std::vector<Uint>& row_indices, std::vector<Uint>& col_indices, std::vector<Real>& values)
+{
+  row_indices.clear(); col_indices.clear(); values.clear();
+  row_indices.reserve(m_values.size()); col_indices.reserve(m_values.size()); values.reserve(m_values.size());
+  const Uint block_size = m_neq*m_neq;
+  for(Uint row = 0; row != m_nb_rows; ++row)
+  {
+    for(Uint pos = m_row_offsets[row]; pos != m_row_offsets[row+1]; ++pos)
+    {
+      const Uint col = m_columns[pos];
+      for(Uint k = 0; k != m_neq; ++k)
+      {
+        for(Uint l = 0; l != m_neq; ++l)
+        {
+          row_indices.push_back(m_row_to_node[row]*m_neq+k);
+          col_indices.push_back(m_row_to_node[col]*m_neq+l);
+          values.push_back(m_values[pos*block_size + k*m_neq + l]);
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::multiply(const Real* x, Real* y, const Real alpha, const Real beta) const
+{
+  cf3_assert(m_is_created);
+  if(m_nb_rows == 0)
+    return;
+
+  const Uint* offsets = &m_row_offsets[0];
+  const Uint* columns = &m_columns[0];
+  const Real* values = &m_values[0];
+  switch(m_neq)
+  {
+    case 1: block_spmv<1>(m_nb_rows, m_neq, offsets, columns, values, x, y, alpha, beta); break;
+    case 2: block_spmv<2>(m_nb_rows, m_neq, offsets, columns, values, x, y, alpha, beta); break;
+    case 3: block_spmv<3>(m_nb_rows, m_neq, offsets, columns, values, x, y, alpha, beta); break;
+    case 4: block_spmv<4>(m_nb_rows, m_neq, offsets, columns, values, x, y, alpha, beta); break;
+    default: block_spmv<Eigen::Dynamic>(m_nb_rows, m_neq, offsets, columns, values, x, y, alpha, beta);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsMatrix::apply(const Handle<Vector>& y, const Handle<Vector const>& x, const Real alpha, const Real beta)
+{
+  Handle<BlockCrsVector> y_crs(y);
+  Handle<BlockCrsVector const> x_crs(x);
+  if(is_null(y_crs) || is_null(x_crs))
+    throw common::SetupError(FromHere(), "apply method of BlockCrsMatrix needs BlockCrsVector arguments");
+
+  cf3_assert(x_crs->data().size() == m_nb_rows*m_neq);
+  cf3_assert(y_crs->data().size() == m_nb_rows*m_neq);
+
+  if(y_crs.get() == x_crs.get())
+  {
+    const std::vector<Real> x_copy(x_crs->data());
+    multiply(x_copy.empty() ? 0 : &x_copy[0], y_crs->data().empty() ? 0 : &y_crs->data()[0], alpha, beta);
+  }
+  else
+  {
+    multiply(x_crs->data().empty() ? 0 : &x_crs->data()[0], y_crs->data().empty() ? 0 : &y_crs->data()[0], alpha, beta);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,259 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_BlockCrsMatrix_hpp
+#define cf3_Math_LSS_BlockCrsMatrix_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+
+#include "math/LSS/LibLSS.hpp"
+#include "math/LSS/BlockAccumulator.hpp"
+#include "math/LSS/Matrix.hpp"
+#include "math/LSS/ScatterCache.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file BlockCrsMatrix.hpp Native block compressed row storage matrix, that does not depend on Trilinos.
+
+  Each node of the mesh is a block row, and each non-zero is a dense neq x neq block stored in row-major order.
+  Assembly translates the node indices of a BlockAccumulator into block positions using a binary search in the
+  sorted block columns of each row. The positions are cached for each set of indices on first use, so repeated
+  assembly of the same elements skips the search. Callers can also precompute the positions using
+  compute_scatter_map and pass them to the add_values overload that takes a scatter map.
+
+  Concurrent calls to add_values are safe if they touch different rows, as is the case for the colored element loops
+  in Proto. When the "atomic_assembly" option is set, all additions are atomic, so any concurrent assembly is safe.
+
+  Only a single process is supported.
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+class LSS_API BlockCrsMatrix : public LSS::Matrix {
+public:
+
+  /// @name CREATION, DESTRUCTION AND COMPONENT SYSTEM
+  //@{
+
+  /// name of the type
+  static std::string type_name () { return "BlockCrsMatrix"; }
+
+  /// Accessor to solver type
+  const std::string solvertype() { return "BlockCrs"; }
+
+  /// Accessor to the flag if matrix, solution and rhs are tied together or not
+  const bool is_swappable(const LSS::Vector& solution, const LSS::Vector& rhs) { return true; }
+
+  /// Default constructor
+  BlockCrsMatrix(const std::string& name);
+
+  /// Setup sparsity structure
+  void create(cf3::common::PE::CommPattern& cp, const Uint neq, const std::vector<Uint>& node_connectivity, const std::vector<Uint>& starting_indices, LSS::Vector& solution, LSS::Vector& rhs, const std::vector<Uint>& periodic_links_nodes = std::vector<Uint>(), const std::vector<bool>& periodic_links_active = std::vector<bool>());
+  void create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector< Uint >& node_connectivity, const std::vector< Uint >& starting_indices, Vector& solution, Vector& rhs, const std::vector<Uint>& periodic_links_nodes = std::vector<Uint>(), const std::vector<bool>& periodic_links_active = std::vector<bool>());
+
+  /// Deallocate underlying data
+  void destroy();
+
+  //@} END CREATION, DESTRUCTION AND COMPONENT SYSTEM
+
+  /// @name INDIVIDUAL ACCESS
+  //@{
+
+  /// Set value at given location in the matrix
+  void set_value(const Uint icol, const Uint irow, const Real value);
+
+  /// Add value at given location in the matrix
+  void add_value(const Uint icol, const Uint irow, const Real value);
+
+  /// Get value at given location in the matrix
+  void get_value(const Uint icol, const Uint irow, Real& value);
+
+  //@} END INDIVIDUAL ACCESS
+
+  /// @name EFFICCIENT ACCESS
+  //@{
+
+  /// Set a list of values
+  void set_values(const BlockAccumulator& values);
+
+  /// Add a list of values
+  void add_values(const BlockAccumulator& values);
+
+  /// Add a list of values, using block positions obtained from compute_scatter_map for the same indices
+  void add_values(const BlockAccumulator& values, const std::vector<Uint>& scatter_map);
+
+  /// Get a list of values
+  void get_values(BlockAccumulator& values);
+
+  /// Set a row, diagonal and off-diagonals values separately (dirichlet-type boundaries)
+  void set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval);
+
+  /// Get a column and replace it to zero (dirichlet-type boundaries, when trying to preserve symmetry)
+  /// Note that sparsity info is lost, values will contain zeros where no matrix entry is present
+  void get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values);
+
+  void symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, Vector& rhs);
+
+  /// Add one line to another and tie to it via dirichlet-style (applying periodicity)
+  void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from);
+
+  /// Set the diagonal
+  void set_diagonal(const std::vector<Real>& diag);
+
+  /// Add to the diagonal
+  void add_diagonal(const std::vector<Real>& diag);
+
+  /// Get the diagonal
+  void get_diagonal(std::vector<Real>& diag);
+
+  /// Reset Matrix
+  void reset(Real reset_to=0.);
+
+  //@} END EFFICCIENT ACCESS
+
+  /// @name MISCELLANEOUS
+  //@{
+
+  /// Print to wherever
+  void print(common::LogStream& stream);
+
+  /// Print to wherever
+  void print(std::ostream& stream);
+
+  /// Print to file given by filename
+  void print(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out );
+
+  void print_native(std::ostream& stream);
+
+  /// Accessor to the state of create
+  const bool is_created() { return m_is_created; }
+
+  /// Accessor to the number of equations
+  const Uint neq() { cf3_assert(m_is_created); return m_neq; }
+
+  /// Accessor to the number of block rows
+  const Uint blockrow_size() { cf3_assert(m_is_created); return m_nb_rows; }
+
+  /// Accessor to the number of block columns
+  const Uint blockcol_size() { cf3_assert(m_is_created); return m_node_to_row.size(); }
+
+  void clone_to(Matrix &other);
+
+  //@} END MISCELLANEOUS
+
+  /// @name LINEAR ALGEBRA
+  //@{
+
+  /// Compute y = alpha*A*x + beta*y
+  void apply(const Handle<Vector>& y, const Handle<Vector const>& x, const Real alpha = 1., const Real beta = 0.);
+
+  /// Compute y = alpha*A*x + beta*y on raw arrays of size blockrow_size()*neq(), ordered by block row. x and y must not overlap.
+  void multiply(const Real* x, Real* y, const Real alpha = 1., const Real beta = 0.) const;
+
+  //@} END LINEAR ALGEBRA
+
+  /// @name NATIVE ACCESS
+  //@{
+
+  /// Block positions for each pair of nodes in indices, so that scatter_map[i*indices.size()+j] is the position of the block
+  /// coupling node indices[i] to node indices[j]. Throws if one of the blocks is not in the sparsity pattern.
+  void compute_scatter_map(const std::vector<Uint>& indices, std::vector<Uint>& scatter_map) const;
+
+  /// Position of the block on row row and column col in the block arrays, or the number of blocks if there is no such block.
+  /// Rows and columns are in matrix numbering, i.e. after applying periodic links
+  Uint block_position(const Uint row, const Uint col) const;
+
+  /// Start of each block row in columns(), with one extra entry at the end
+  const std::vector<Uint>& row_offsets() const { return m_row_offsets; }
+
+  /// Sorted block column indices for each block row
+  const std::vector<Uint>& columns() const { return m_columns; }
+
+  /// Position of the diagonal block for each block row
+  const std::vector<Uint>& diagonal_positions() const { return m_diagonal_positions; }
+
+  /// Block values, neq*neq row-major values per block
+  const std::vector<Real>& values() const { return m_values; }
+
+  /// Matrix block row for each process-local node
+  const std::vector<Uint>& node_to_row() const { return m_node_to_row; }
+
+  //@} END NATIVE ACCESS
+
+  /// @name TEST ONLY
+  //@{
+
+  /// exports the matrix into big linear arrays
+  /// @attention only for debug and utest purposes
+  void debug_data(std::vector<Uint>& row_indices, std::vector<Uint>& col_indices, std::vector<Real>& values);
+
+  //@} END TEST ONLY
+
+private:
+  /// Apply the scatter_cache_size option
+  void trigger_scatter_cache_size();
+
+  /// Pointer to the block values for the given matrix row and column, throwing if the block is not in the sparsity pattern
+  Real* block(const Uint row, const Uint col);
+
+  /// Add the block starting at src, with src_stride values between rows, to the block at position pos
+  void add_block(const Uint pos, const Real* src, const Uint src_stride);
+
+  /// Write the matrix entries as col, -row, value lines, using the process-local numbering
+  template<typename StreamT>
+  void print_entries(StreamT& stream);
+
+  /// state of creation
+  bool m_is_created;
+
+  /// number of equations
+  Uint m_neq;
+
+  /// number of block rows
+  Uint m_nb_rows;
+
+  /// Use atomic additions in add_values and add_value
+  bool m_atomic_assembly;
+
+  /// Matrix block row for each process-local node
+  std::vector<Uint> m_node_to_row;
+
+  /// Process-local node for each block row
+  std::vector<Uint> m_row_to_node;
+
+  /// Block CRS structure
+  std::vector<Uint> m_row_offsets;
+  std::vector<Uint> m_columns;
+  std::vector<Uint> m_diagonal_positions;
+
+  /// The values
+  std::vector<Real> m_values;
+
+  /// Block positions for the BlockAccumulators passed to add_values, reset when the matrix is created
+  ScatterCache<Uint> m_scatter_cache;
+
+  /// Cache matrix values in case of symmetric dirichlet, so they can be applied multiple times even if the matrix is not changed
+  typedef std::map<Uint, Real> DirichletEntryT;
+  typedef std::map<Uint, DirichletEntryT> DirichletMapT;
+  DirichletMapT m_symmetric_dirichlet_values;
+}; // end of class BlockCrsMatrix
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_BlockCrsMatrix_hpp
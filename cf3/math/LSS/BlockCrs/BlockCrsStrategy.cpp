@@ -0,0 +1,278 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <Eigen/LU>
+
+#include "coolfluid-packages.hpp"
+
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+
+#include "math/LSS/BlockCrs/BlockCrsMatrix.hpp"
+#include "math/LSS/BlockCrs/BlockCrsStrategy.hpp"
+#include "math/LSS/BlockCrs/BlockCrsVector.hpp"
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+Real dot(const std::vector<Real>& a, const std::vector<Real>& b)
+{
+  const int size = a.size();
+  Real result = 0.;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static) reduction(+:result) if(size > 10000)
+#endif
+  for(int i = 0; i < size; ++i)
+    result += a[i]*b[i];
+  return result;
+}
+
+Real norm(const std::vector<Real>& a)
+{
+  return std::sqrt(dot(a, a));
+}
+
+/// y = x + alpha*y
+void xpay(const std::vector<Real>& x, const Real alpha, std::vector<Real>& y)
+{
+  const int size = x.size();
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static) if(size > 10000)
+#endif
+  for(int i = 0; i < size; ++i)
+    y[i] = x[i] + alpha*y[i];
+}
+
+/// y += alpha*x
+void axpy(const Real alpha, const std::vector<Real>& x, std::vector<Real>& y)
+{
+  const int size = x.size();
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static) if(size > 10000)
+#endif
+  for(int i = 0; i < size; ++i)
+    y[i] += alpha*x[i];
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder<BlockCrsStrategy, SolutionStrategy, LibLSS> BlockCrsStrategy_builder;
+
+BlockCrsStrategy::BlockCrsStrategy(const std::string& name) :
+  SolutionStrategy(name),
+  m_max_iterations(1000),
+  m_tolerance(1e-8)
+{
+  options().add("max_iterations", m_max_iterations)
+    .pretty_name("Maximum Iterations")
+    .description("Maximum number of BiCGStab iterations")
+    .link_to(&m_max_iterations)
+    .mark_basic();
+
+  options().add("tolerance", m_tolerance)
+    .pretty_name("Tolerance")
+    .description("Convergence tolerance, relative to the norm of the right hand side")
+    .link_to(&m_tolerance)
+    .mark_basic();
+
+  properties().add("iterations", Uint(0));
+  properties().add("residual", Real(0.));
+}
+
+BlockCrsStrategy::~BlockCrsStrategy()
+{
+}
+
+void BlockCrsStrategy::set_matrix(const Handle< Matrix >& matrix)
+{
+  m_matrix = Handle<BlockCrsMatrix>(matrix);
+  if(is_null(m_matrix))
+    throw common::SetupError(FromHere(), "BlockCrsStrategy needs a BlockCrsMatrix, but a " + matrix->derived_type_name() + " was supplied instead.");
+}
+
+void BlockCrsStrategy::set_rhs(const Handle< Vector >& rhs)
+{
+  m_rhs = Handle<BlockCrsVector>(rhs);
+  if(is_null(m_rhs))
+    throw common::SetupError(FromHere(), "BlockCrsStrategy needs a BlockCrsVector, but a " + rhs->derived_type_name() + " was supplied instead.");
+}
+
+void BlockCrsStrategy::set_solution(const Handle< Vector >& solution)
+{
+  m_solution = Handle<BlockCrsVector>(solution);
+  if(is_null(m_solution))
+    throw common::SetupError(FromHere(), "BlockCrsStrategy needs a BlockCrsVector, but a " + solution->derived_type_name() + " was supplied instead.");
+}
+
+void BlockCrsStrategy::compute_preconditioner()
+{
+  const Uint neq = m_matrix->neq();
+  const Uint block_size = neq*neq;
+  const Uint nb_rows = m_matrix->blockrow_size();
+  const std::vector<Uint>& diagonal_positions = m_matrix->diagonal_positions();
+  const std::vector<Real>& values = m_matrix->values();
+
+  typedef Eigen::Matrix<Real, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> BlockT;
+  m_inverse_diagonal.resize(nb_rows*block_size);
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    Eigen::Map<const BlockT> diag_block(&values[diagonal_positions[row]*block_size], neq, neq);
+    Eigen::Map<BlockT> inverse_block(&m_inverse_diagonal[row*block_size], neq, neq);
+    const Eigen::FullPivLU<BlockT> lu(diag_block);
+    if(lu.isInvertible())
+      inverse_block = lu.inverse();
+    else
+      inverse_block.setIdentity(); // Leave rows without a usable diagonal unpreconditioned
+  }
+}
+
+void BlockCrsStrategy::apply_preconditioner(const std::vector<Real>& x, std::vector<Real>& y) const
+{
+  const int neq = m_matrix->neq();
+  const int block_size = neq*neq;
+  const int nb_rows = m_inverse_diagonal.size() / block_size;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static) if(nb_rows > 1000)
+#endif
+  for(int row = 0; row < nb_rows; ++row)
+  {
+    const Real* inverse_block = &m_inverse_diagonal[row*block_size];
+    for(int i = 0; i != neq; ++i)
+    {
+      Real result = 0.;
+      for(int j = 0; j != neq; ++j)
+        result += inverse_block[i*neq+j]*x[row*neq+j];
+      y[row*neq+i] = result;
+    }
+  }
+}
+
+void BlockCrsStrategy::solve()
+{
+  if(is_null(m_matrix))
+    throw common::SetupError(FromHere(), "Null matrix for " + uri().path());
+
+  if(is_null(m_rhs))
+    throw common::SetupError(FromHere(), "Null RHS for " + uri().path());
+
+  if(is_null(m_solution))
+    throw common::SetupError(FromHere(), "Null solution vector for " + uri().path());
+
+  const std::vector<Real>& b = m_rhs->data();
+  std::vector<Real>& x = m_solution->data();
+  const Uint size = b.size();
+  if(size == 0)
+    return;
+
+  compute_preconditioner();
+
+  std::vector<Real> r(b);
+  m_matrix->multiply(&x[0], &r[0], -1., 1.);
+
+  const Real b_norm = norm(b);
+  const Real threshold = m_tolerance * (b_norm > 0. ? b_norm : 1.);
+  Real r_norm = norm(r);
+
+  const std::vector<Real> r_hat(r);
+  std::vector<Real> p(size, 0.), v(size, 0.), p_hat(size), s(size), s_hat(size), t(size);
+  Real rho = 1., alpha = 1., omega = 1.;
+
+  Uint iteration = 0;
+  while(r_norm > threshold && iteration != m_max_iterations)
+  {
+    ++iteration;
+    const Real rho_new = dot(r_hat, r);
+    if(rho_new == 0.)
+    {
+      CFwarn << "BiCGStab breakdown in " << uri().path() << " after " << iteration << " iterations" << CFendl;
+      break;
+    }
+
+    // p = r + beta*(p - omega*v)
+    const Real beta = (rho_new/rho)*(alpha/omega);
+    axpy(-omega, v, p);
+    xpay(r, beta, p);
+
+    apply_preconditioner(p, p_hat);
+    m_matrix->multiply(&p_hat[0], &v[0]);
+    alpha = rho_new / dot(r_hat, v);
+
+    // s = r - alpha*v
+    s = r;
+    axpy(-alpha, v, s);
+    if(norm(s) <= threshold)
+    {
+      axpy(alpha, p_hat, x);
+      r.swap(s);
+      r_norm = norm(r);
+      break;
+    }
+
+    apply_preconditioner(s, s_hat);
+    m_matrix->multiply(&s_hat[0], &t[0]);
+    const Real tt = dot(t, t);
+    omega = tt == 0. ? 0. : dot(t, s) / tt;
+
+    axpy(alpha, p_hat, x);
+    axpy(omega, s_hat, x);
+
+    // r = s - omega*t
+    r.swap(s);
+    axpy(-omega, t, r);
+    r_norm = norm(r);
+
+    rho = rho_new;
+    if(omega == 0.)
+    {
+      CFwarn << "BiCGStab stagnation in " << uri().path() << " after " << iteration << " iterations" << CFendl;
+      break;
+    }
+  }
+
+  properties()["iterations"] = iteration;
+  properties()["residual"] = r_norm;
+
+  if(r_norm > threshold)
+    CFwarn << "BiCGStab in " << uri().path() << " did not converge after " << iteration << " iterations, residual is " << r_norm << CFendl;
+  else
+    CFdebug << "BiCGStab in " << uri().path() << " converged after " << iteration << " iterations, residual is " << r_norm << CFendl;
+}
+
+Real BlockCrsStrategy::compute_residual()
+{
+  if(is_null(m_matrix) || is_null(m_rhs) || is_null(m_solution))
+    throw common::SetupError(FromHere(), "Linear system not set for " + uri().path());
+
+  std::vector<Real> r(m_rhs->data());
+  if(r.empty())
+    return 0.;
+  m_matrix->multiply(&m_solution->data()[0], &r[0], -1., 1.);
+  return norm(r);
+}
+
+void BlockCrsStrategy::set_coordinates(common::PE::CommPattern& cp, const common::Table< Real >& coords, const common::List< Uint >& used_nodes, const std::vector< bool >& periodic_links_active)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
@@ -0,0 +1,76 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_BlockCrsStrategy_hpp
+#define cf3_Math_LSS_BlockCrsStrategy_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "math/LSS/SolutionStrategy.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  @file BlockCrsStrategy.hpp Built-in iterative solver for the BlockCrs linear system
+ **/
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+class BlockCrsMatrix;
+class BlockCrsVector;
+
+/// BiCGStab, right-preconditioned with the inverse of the diagonal blocks of a BlockCrsMatrix.
+/// Iterations stop when the residual norm drops below tolerance times the norm of the right hand side.
+class LSS_API BlockCrsStrategy : public SolutionStrategy
+{
+public:
+
+  /// Default constructor
+  BlockCrsStrategy(const std::string& name);
+
+  ~BlockCrsStrategy();
+
+  /// name of the type
+  static std::string type_name () { return "BlockCrsStrategy"; }
+
+  void set_matrix(const Handle<LSS::Matrix>& matrix);
+  void set_rhs(const Handle<LSS::Vector>& rhs);
+  void set_solution(const Handle<LSS::Vector>& solution);
+  void solve();
+  Real compute_residual();
+  virtual void set_coordinates(common::PE::CommPattern& cp, const common::Table< Real >& coords, const common::List< Uint >& used_nodes, const std::vector< bool >& periodic_links_active);
+
+private:
+  /// Compute the inverse of each diagonal block of the matrix
+  void compute_preconditioner();
+
+  /// y = M^-1 x, with M the block diagonal of the matrix
+  void apply_preconditioner(const std::vector<Real>& x, std::vector<Real>& y) const;
+
+  Handle<BlockCrsMatrix> m_matrix;
+  Handle<BlockCrsVector> m_rhs;
+  Handle<BlockCrsVector> m_solution;
+
+  /// Maximum number of iterations
+  Uint m_max_iterations;
+
+  /// Relative tolerance
+  Real m_tolerance;
+
+  /// Inverse diagonal blocks
+  std::vector<Real> m_inverse_diagonal;
+}; // end of class BlockCrsStrategy
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_BlockCrsStrategy_hpp
@@ -0,0 +1,458 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <limits>
+
+#include "coolfluid-packages.hpp"
+
+#include "common/Assertions.hpp"
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/StringConversion.hpp"
+
+#include "math/VariablesDescriptor.hpp"
+#include "math/LSS/BlockCrs/BlockCrsVector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file BlockCrsVector.cpp implementation of LSS::BlockCrsVector
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::math;
+using namespace cf3::math::LSS;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < LSS::BlockCrsVector, LSS::Vector, LSS::LibLSS > BlockCrsVector_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Uint LSS::detail::create_block_row_map(common::PE::CommPattern& cp, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active, std::vector<Uint>& node_to_row)
+{
+  common::PE::Comm& comm = common::PE::Comm::instance();
+  if(comm.is_active() && comm.size() > 1)
+    throw common::NotSupported(FromHere(), "The BlockCrs linear system only supports a single process, use a Trilinos matrix when running in parallel");
+
+  const Uint nb_nodes = cp.isUpdatable().size();
+  const Uint not_numbered = std::numeric_limits<Uint>::max();
+  node_to_row.assign(nb_nodes, not_numbered);
+
+  // Nodes that are not periodically linked get consecutive rows
+  Uint nb_rows = 0;
+  const bool has_periodic = !periodic_links_active.empty();
+  cf3_assert(!has_periodic || periodic_links_active.size() == nb_nodes);
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    if(!(has_periodic && periodic_links_active[i]))
+      node_to_row[i] = nb_rows++;
+  }
+
+  // Linked nodes share the row of the node at the end of their chain of links
+  if(has_periodic)
+  {
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      Uint target = i;
+      Uint nb_links = 0;
+      while(periodic_links_active[target])
+      {
+        target = periodic_links_nodes[target];
+        if(++nb_links > nb_nodes)
+          throw common::BadValue(FromHere(), "Cyclic periodic links for node " + common::to_str(i));
+      }
+      node_to_row[i] = node_to_row[target];
+    }
+  }
+
+  return nb_rows;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+BlockCrsVector::BlockCrsVector(const std::string& name) :
+  LSS::Vector(name),
+  m_neq(0),
+  m_blockrow_size(0),
+  m_nb_rows(0),
+  m_is_created(false)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::create(common::PE::CommPattern& cp, Uint neq, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active)
+{
+  if (m_is_created) destroy();
+
+  m_nb_rows = LSS::detail::create_block_row_map(cp, periodic_links_nodes, periodic_links_active, m_node_to_row);
+  m_neq = neq;
+  m_blockrow_size = m_node_to_row.size();
+  m_data.assign(m_nb_rows*m_neq, 0.);
+  m_is_created = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active)
+{
+  // Variables are stored interleaved per node, so only the total size matters
+  create(cp, vars.size(), periodic_links_nodes, periodic_links_active);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::destroy()
+{
+  m_data.clear();
+  m_node_to_row.clear();
+  m_neq = 0;
+  m_blockrow_size = 0;
+  m_nb_rows = 0;
+  m_is_created = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::set_value(const Uint irow, const Real value)
+{
+  cf3_assert(m_is_created);
+  m_data[data_index(irow / m_neq, irow % m_neq)] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::add_value(const Uint irow, const Real value)
+{
+  cf3_assert(m_is_created);
+  m_data[data_index(irow / m_neq, irow % m_neq)] += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::get_value(const Uint irow, Real& value)
+{
+  cf3_assert(m_is_created);
+  value = m_data[data_index(irow / m_neq, irow % m_neq)];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::set_value(const Uint iblockrow, const Uint ieq, const Real value)
+{
+  cf3_assert(m_is_created);
+  m_data[data_index(iblockrow, ieq)] = value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::add_value(const Uint iblockrow, const Uint ieq, const Real value)
+{
+  cf3_assert(m_is_created);
+  m_data[data_index(iblockrow, ieq)] += value;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::get_value(const Uint iblockrow, const Uint ieq, Real& value)
+{
+  cf3_assert(m_is_created);
+  value = m_data[data_index(iblockrow, ieq)];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::set_rhs_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    Real* block = &m_data[data_index(values.indices[i], 0)];
+    for(Uint j = 0; j != m_neq; ++j)
+      block[j] = values.rhs[i*m_neq+j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::add_rhs_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    Real* block = &m_data[data_index(values.indices[i], 0)];
+    for(Uint j = 0; j != m_neq; ++j)
+      block[j] += values.rhs[i*m_neq+j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::get_rhs_values(BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Real* block = &m_data[data_index(values.indices[i], 0)];
+    for(Uint j = 0; j != m_neq; ++j)
+      values.rhs[i*m_neq+j] = block[j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::set_sol_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    Real* block = &m_data[data_index(values.indices[i], 0)];
+    for(Uint j = 0; j != m_neq; ++j)
+      block[j] = values.sol[i*m_neq+j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::add_sol_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    Real* block = &m_data[data_index(values.indices[i], 0)];
+    for(Uint j = 0; j != m_neq; ++j)
+      block[j] += values.sol[i*m_neq+j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::get_sol_values(BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const Real* block = &m_data[data_index(values.indices[i], 0)];
+    for(Uint j = 0; j != m_neq; ++j)
+      values.sol[i*m_neq+j] = block[j];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::reset(Real reset_to)
+{
+  cf3_assert(m_is_created);
+  m_data.assign(m_data.size(), reset_to);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::get( boost::multi_array<Real, 2>& data)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(data.shape()[0]==m_blockrow_size);
+  cf3_assert(data.shape()[1]==m_neq);
+  for(Uint i = 0; i != m_blockrow_size; ++i)
+    for(Uint j = 0; j != m_neq; ++j)
+      data[i][j] = m_data[data_index(i, j)];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::set( boost::multi_array<Real, 2>& data)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(data.shape()[0]==m_blockrow_size);
+  cf3_assert(data.shape()[1]==m_neq);
+  for(Uint i = 0; i != m_blockrow_size; ++i)
+    for(Uint j = 0; j != m_neq; ++j)
+      m_data[data_index(i, j)] = data[i][j];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::print(common::LogStream& stream)
+{
+  if (m_is_created)
+  {
+    for(Uint i = 0; i != m_blockrow_size; ++i)
+      for(Uint j = 0; j != m_neq; ++j)
+        stream << 0 << " " << -(int)(i*m_neq+j) << " " << m_data[data_index(i, j)] << "\n";
+    stream << "# name:                 " << name() << "\n";
+    stream << "# type_name:            " << type_name() << "\n";
+    stream << "# number of equations:  " << m_neq << "\n";
+    stream << "# number of rows:       " << m_blockrow_size*m_neq << "\n";
+    stream << "# number of block rows: " << m_blockrow_size << "\n";
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::print(std::ostream& stream)
+{
+  if (m_is_created)
+  {
+    for(Uint i = 0; i != m_blockrow_size; ++i)
+      for(Uint j = 0; j != m_neq; ++j)
+        stream << 0 << " " << -(int)(i*m_neq+j) << " " << m_data[data_index(i, j)] << "\n";
+    stream << "# name:                 " << name() << "\n";
+    stream << "# type_name:            " << type_name() << "\n";
+    stream << "# number of equations:  " << m_neq << "\n";
+    stream << "# number of rows:       " << m_blockrow_size*m_neq << "\n";
+    stream << "# number of block rows: " << m_blockrow_size << "\n" << std::flush;
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::print(const std::string& filename, std::ios_base::openmode mode)
+{
+  std::ofstream stream(filename.c_str(),mode);
+  stream << "VARIABLES=COL,ROW,VAL\n" << std::flush;
+  stream << "ZONE T=\"" << type_name() << "::" << name() <<  "\"\n" << std::flush;
+  print(stream);
+  stream.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::print_native(std::ostream& stream)
+{
+  const Uint size = m_data.size();
+  for(Uint i = 0; i != size; ++i)
+    stream << i << " " << m_data[i] << "\n";
+  stream << std::flush;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::debug_data(std::vector<Real>& values)
+{
+  cf3_assert(m_is_created);
+  values.clear();
+  values.reserve(m_blockrow_size*m_neq);
+  for(Uint i = 0; i != m_blockrow_size; ++i)
+    for(Uint j = 0; j != m_neq; ++j)
+      values.push_back(m_data[data_index(i, j)]);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::clone_to(Vector &other)
+{
+  if(!m_is_created)
+    throw common::SetupError(FromHere(), "Vector to clone " + uri().string() + " is not created");
+
+  BlockCrsVector* other_ptr = dynamic_cast<BlockCrsVector*>(&other);
+  if(is_null(other_ptr))
+    throw common::SetupError(FromHere(), "clone_to method of BlockCrsVector needs another BlockCrsVector, but a " + other.derived_type_name() + " was supplied instead.");
+
+  other_ptr->m_data = m_data;
+  other_ptr->m_node_to_row = m_node_to_row;
+  other_ptr->m_neq = m_neq;
+  other_ptr->m_blockrow_size = m_blockrow_size;
+  other_ptr->m_nb_rows = m_nb_rows;
+  other_ptr->m_is_created = m_is_created;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::assign(const Vector& source)
+{
+  BlockCrsVector const* source_ptr = dynamic_cast<BlockCrsVector const*>(&source);
+
+  if(is_null(source_ptr))
+    throw common::SetupError(FromHere(), "assign method of BlockCrsVector needs another BlockCrsVector, but a " + source.derived_type_name() + " was supplied instead.");
+
+  if(source_ptr->m_data.size() != m_data.size())
+    throw common::SetupError(FromHere(), "assign method of BlockCrsVector got a vector with incorrect size");
+
+  m_data.assign(source_ptr->m_data.begin(), source_ptr->m_data.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::update ( const Vector& source, const Real alpha )
+{
+  BlockCrsVector const* source_ptr = dynamic_cast<BlockCrsVector const*>(&source);
+
+  if(is_null(source_ptr))
+    throw common::SetupError(FromHere(), "update method of BlockCrsVector needs another BlockCrsVector, but a " + source.derived_type_name() + " was supplied instead.");
+
+  if(source_ptr->m_data.size() != m_data.size())
+    throw common::SetupError(FromHere(), "update method of BlockCrsVector got a vector with incorrect size");
+
+  const int size = m_data.size();
+  Real* data = m_data.empty() ? 0 : &m_data[0];
+  const Real* source_data = source_ptr->m_data.empty() ? 0 : &source_ptr->m_data[0];
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < size; ++i)
+    data[i] += alpha*source_data[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void BlockCrsVector::scale ( const Real alpha )
+{
+  if(alpha == 1.)
+    return;
+
+  const int size = m_data.size();
+  Real* data = m_data.empty() ? 0 : &m_data[0];
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static)
+#endif
+  for(int i = 0; i < size; ++i)
+    data[i] *= alpha;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Real BlockCrsVector::dot ( const Vector& other )
+{
+  BlockCrsVector const* other_ptr = dynamic_cast<BlockCrsVector const*>(&other);
+
+  if(is_null(other_ptr))
+    throw common::SetupError(FromHere(), "dot method of BlockCrsVector needs another BlockCrsVector, but a " + other.derived_type_name() + " was supplied instead.");
+
+  if(other_ptr->m_data.size() != m_data.size())
+    throw common::SetupError(FromHere(), "dot method of BlockCrsVector got a vector with incorrect size");
+
+  const int size = m_data.size();
+  const Real* data = m_data.empty() ? 0 : &m_data[0];
+  const Real* other_data = other_ptr->m_data.empty() ? 0 : &other_ptr->m_data[0];
+  Real result = 0.;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(static) reduction(+:result)
+#endif
+  for(int i = 0; i < size; ++i)
+    result += data[i]*other_data[i];
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
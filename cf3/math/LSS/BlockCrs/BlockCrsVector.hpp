@@ -0,0 +1,213 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_BlockCrsVector_hpp
+#define cf3_Math_LSS_BlockCrsVector_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "math/LSS/LibLSS.hpp"
+#include "math/LSS/BlockAccumulator.hpp"
+#include "math/LSS/Vector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file BlockCrsVector.hpp Vector belonging to the native block CRS matrix
+
+  The vector stores one block of neq values per matrix block row. Nodes that are periodically
+  linked share the storage of the node they link to, so they are numbered like in the Trilinos backend.
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+namespace detail
+{
+  /// Build the mapping from process-local node index to block row, following periodic links.
+  /// Only a single process is supported, this throws NotSupported when running in parallel.
+  /// @return the number of block rows
+  LSS_API Uint create_block_row_map(common::PE::CommPattern& cp, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active, std::vector<Uint>& node_to_row);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+class LSS_API BlockCrsVector : public LSS::Vector {
+public:
+
+  /// @name CREATION, DESTRUCTION AND COMPONENT SYSTEM
+  //@{
+
+  /// name of the type
+  static std::string type_name () { return "BlockCrsVector"; }
+
+  /// Accessor to solver type
+  const std::string solvertype() { return "BlockCrs"; }
+
+  /// Default constructor
+  BlockCrsVector(const std::string& name);
+
+  /// Setup sparsity structure
+  void create(common::PE::CommPattern& cp, Uint neq, const std::vector<Uint>& periodic_links_nodes = std::vector<Uint>(), const std::vector<bool>& periodic_links_active = std::vector<bool>());
+  void create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector<Uint>& periodic_links_nodes = std::vector<Uint>(), const std::vector<bool>& periodic_links_active = std::vector<bool>());
+
+  /// Deallocate underlying data
+  void destroy();
+
+  //@} END CREATION, DESTRUCTION AND COMPONENT SYSTEM
+
+  /// @name INDIVIDUAL ACCESS
+  //@{
+
+  /// Set value at given location in the vector
+  void set_value(const Uint irow, const Real value);
+
+  /// Add value at given location in the vector
+  void add_value(const Uint irow, const Real value);
+
+  /// Get value at given location in the vector
+  void get_value(const Uint irow, Real& value);
+
+  /// Set value at given location in the vector
+  void set_value(const Uint iblockrow, const Uint ieq, const Real value);
+
+  /// Add value at given location in the vector
+  void add_value(const Uint iblockrow, const Uint ieq, const Real value);
+
+  /// Get value at given location in the vector
+  void get_value(const Uint iblockrow, const Uint ieq, Real& value);
+
+  //@} END INDIVIDUAL ACCESS
+
+  /// @name EFFICCIENT ACCESS
+  //@{
+
+  /// Set a list of values to rhs
+  void set_rhs_values(const BlockAccumulator& values);
+
+  /// Add a list of values to rhs
+  void add_rhs_values(const BlockAccumulator& values);
+
+  /// Get a list of values from rhs
+  void get_rhs_values(BlockAccumulator& values);
+
+  /// Set a list of values to sol
+  void set_sol_values(const BlockAccumulator& values);
+
+  /// Add a list of values to sol
+  void add_sol_values(const BlockAccumulator& values);
+
+  /// Get a list of values from sol
+  void get_sol_values(BlockAccumulator& values);
+
+  /// Reset Vector
+  void reset(Real reset_to=0.);
+
+  /// Copies the contents out of the LSS::Vector to table.
+  void get( boost::multi_array<Real, 2>& data);
+
+  /// Copies the contents of the table into the LSS::Vector.
+  void set( boost::multi_array<Real, 2>& data);
+
+  //@} END EFFICCIENT ACCESS
+
+  /// @name MISCELLANEOUS
+  //@{
+
+  /// Print to wherever
+  void print(common::LogStream& stream);
+
+  /// Print to wherever
+  void print(std::ostream& stream);
+
+  /// Print to file given by filename
+  void print(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out );
+
+  void print_native(std::ostream& stream);
+
+  /// Accessor to the state of create
+  const bool is_created() { return m_is_created; }
+
+  /// Accessor to the number of equations
+  const Uint neq() { return m_neq; }
+
+  /// Accessor to the number of block rows
+  const Uint blockrow_size() { return m_blockrow_size; }
+
+  void clone_to(Vector &other);
+
+  void assign(const Vector& source);
+
+  void update ( const Vector& source, const Real alpha = 1. );
+
+  void scale ( const Real alpha );
+
+  Real dot ( const Vector& other );
+
+  /// Nothing to do, since only a single process is supported
+  void sync() {}
+
+  //@} END MISCELLANEOUS
+
+  /// @name NATIVE ACCESS
+  //@{
+
+  /// Raw storage, ordered by matrix block row
+  std::vector<Real>& data() { return m_data; }
+  const std::vector<Real>& data() const { return m_data; }
+
+  /// Number of matrix block rows, i.e. the number of nodes that are not periodically linked
+  Uint nb_rows() const { return m_nb_rows; }
+
+  //@} END NATIVE ACCESS
+
+  /// @name TEST ONLY
+  //@{
+
+  /// exports the vector into big linear array
+  /// @attention only for debug and utest purposes
+  void debug_data(std::vector<Real>& values);
+
+  //@} END TEST ONLY
+
+private:
+  /// Index in m_data for the given process-local node and equation
+  Uint data_index(const Uint iblockrow, const Uint ieq) const
+  {
+    cf3_assert(iblockrow < m_blockrow_size);
+    cf3_assert(ieq < m_neq);
+    return m_node_to_row[iblockrow]*m_neq + ieq;
+  }
+
+  /// The values
+  std::vector<Real> m_data;
+
+  /// Block row for each process-local node
+  std::vector<Uint> m_node_to_row;
+
+  /// number of equations
+  Uint m_neq;
+
+  /// number of blocks, i.e. the number of process-local nodes
+  Uint m_blockrow_size;
+
+  /// number of stored block rows
+  Uint m_nb_rows;
+
+  /// flag if created
+  bool m_is_created;
+}; // end of class BlockCrsVector
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_BlockCrsVector_hpp
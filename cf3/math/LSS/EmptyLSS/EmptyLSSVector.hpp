@@ -184,6 +184,8 @@ public:
   
   void scale ( const Real alpha ) {}
 
+  Real dot ( const Vector& other ) { return 0.; }
+
   void sync() {}
 
   //@} END MISCELLANEOUS
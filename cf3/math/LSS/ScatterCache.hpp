@@ -0,0 +1,220 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_ScatterCache_hpp
+#define cf3_Math_LSS_ScatterCache_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "common/Assertions.hpp"
+#include "math/LSS/LibLSS.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file ScatterCache.hpp Cache of the matrix storage offsets for the node indices of a BlockAccumulator.
+
+  The sparsity of a matrix does not change between assemblies, so the position of each entry of an element matrix
+  in the matrix storage only needs to be looked up the first time the element is assembled. Entries are stored in
+  a list per node, selected using the first index of the element. Lookups take no lock, so they don't contend
+  when several threads assemble at once: entries are never changed or removed once they are published at the head
+  of their list, which is done atomically. Only inserts, which happen once per element, are serialized.
+  The memory used by the entries is limited to a maximum, beyond which new entries are no longer stored.
+  A maximum of zero disables the cache.
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Maps the node indices of a BlockAccumulator to the offsets of its entries in the storage of a matrix.
+/// OffsetT is the offset type used by the matrix. The meaning of the offsets is up to the matrix.
+/// find and insert may be called concurrently. reset, clear and set_max_memory may not be called while other
+/// threads use the cache, i.e. during an assembly.
+template<typename OffsetT>
+class ScatterCache : boost::noncopyable
+{
+public:
+  typedef std::vector<OffsetT> OffsetsT;
+
+  /// Construct an empty cache, using at most max_memory bytes
+  ScatterCache(const std::size_t max_memory = 512*1024*1024) :
+    m_max_memory(max_memory),
+    m_memory(0)
+  {
+  }
+
+  ~ScatterCache()
+  {
+    clear_entries();
+  }
+
+  /// Remove all entries and prepare for indices below nb_nodes. Must be called whenever the matrix structure changes.
+  void reset(const Uint nb_nodes)
+  {
+    boost::lock_guard<boost::mutex> lock(m_insert_mutex);
+    clear_entries();
+    m_heads.assign(nb_nodes, static_cast<Entry*>(0));
+  }
+
+  /// Remove all entries
+  void clear()
+  {
+    boost::lock_guard<boost::mutex> lock(m_insert_mutex);
+    clear_entries();
+    m_heads.clear();
+  }
+
+  /// Set the maximum number of bytes used by the entries. Existing entries are removed if they use more.
+  void set_max_memory(const std::size_t max_memory)
+  {
+    boost::lock_guard<boost::mutex> lock(m_insert_mutex);
+    m_max_memory = max_memory;
+    if(m_memory > m_max_memory)
+    {
+      clear_entries();
+      m_heads.assign(m_heads.size(), static_cast<Entry*>(0));
+    }
+  }
+
+  /// Maximum number of bytes used by the entries
+  std::size_t max_memory() const
+  {
+    return m_max_memory;
+  }
+
+  /// Number of bytes used by the entries
+  std::size_t memory() const
+  {
+    boost::lock_guard<boost::mutex> lock(m_insert_mutex);
+    return m_memory;
+  }
+
+  /// The offsets stored for the given indices, or a null pointer if there are none. Takes no lock.
+  /// The returned pointer stays valid until the cache is reset or cleared.
+  const OffsetsT* find(const std::vector<Uint>& indices) const
+  {
+    if(indices.empty() || indices.front() >= m_heads.size())
+      return 0;
+
+    return find_in_list(load_head(indices.front()), indices);
+  }
+
+  /// Store the offsets for the given indices, returning the stored copy, or a null pointer if the cache is full.
+  /// If the indices were stored in the mean time by an other thread, the existing entry is returned.
+  /// The returned pointer stays valid until the cache is reset or cleared.
+  const OffsetsT* insert(const std::vector<Uint>& indices, const OffsetsT& offsets)
+  {
+    cf3_assert(!indices.empty());
+    boost::lock_guard<boost::mutex> lock(m_insert_mutex);
+    cf3_assert(indices.front() < m_heads.size());
+
+    Entry* const head = m_heads[indices.front()];
+    const OffsetsT* existing = find_in_list(head, indices);
+    if(existing != 0)
+      return existing;
+
+    const std::size_t entry_memory = sizeof(Entry) + indices.size()*sizeof(Uint) + offsets.size()*sizeof(OffsetT);
+    if(m_memory + entry_memory > m_max_memory)
+      return 0;
+
+    // The entry is complete before it is published, and never changes afterwards
+    Entry* entry = new Entry();
+    entry->indices = indices;
+    entry->offsets = offsets;
+    entry->next = head;
+    store_head(indices.front(), entry);
+    m_memory += entry_memory;
+    return &entry->offsets;
+  }
+
+private:
+  struct Entry
+  {
+    std::vector<Uint> indices;
+    OffsetsT offsets;
+    /// Next entry in the list of the same node, fixed when the entry is published
+    Entry* next;
+  };
+
+  /// Head of the list for the given node, read with acquire semantics so the entries it links to are complete
+  Entry* load_head(const Uint node) const
+  {
+#ifdef __GNUC__
+    return __atomic_load_n(&m_heads[node], __ATOMIC_ACQUIRE);
+#else
+    return *static_cast<Entry* const volatile*>(&m_heads[node]);
+#endif
+  }
+
+  /// Publish a new head for the given node, with release semantics
+  void store_head(const Uint node, Entry* entry)
+  {
+#ifdef __GNUC__
+    __atomic_store_n(&m_heads[node], entry, __ATOMIC_RELEASE);
+#else
+    *static_cast<Entry* volatile*>(&m_heads[node]) = entry;
+#endif
+  }
+
+  /// Search the list starting at entry
+  static const OffsetsT* find_in_list(const Entry* entry, const std::vector<Uint>& indices)
+  {
+    for(; entry != 0; entry = entry->next)
+    {
+      if(entry->indices == indices)
+        return &entry->offsets;
+    }
+    return 0;
+  }
+
+  /// Delete all entries, keeping the list heads. Must be called with m_insert_mutex locked or from the destructor.
+  void clear_entries()
+  {
+    const typename std::vector<Entry*>::iterator heads_end = m_heads.end();
+    for(typename std::vector<Entry*>::iterator head = m_heads.begin(); head != heads_end; ++head)
+    {
+      Entry* entry = *head;
+      while(entry != 0)
+      {
+        Entry* next = entry->next;
+        delete entry;
+        entry = next;
+      }
+      *head = 0;
+    }
+    m_memory = 0;
+  }
+
+  /// First entry of the list of each node. Only modified through store_head while lookups may be running.
+  std::vector<Entry*> m_heads;
+
+  /// Maximum and current memory used by the entries, in bytes
+  std::size_t m_max_memory;
+  std::size_t m_memory;
+
+  /// Serializes inserts
+  mutable boost::mutex m_insert_mutex;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_ScatterCache_hpp
@@ -4,9 +4,17 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cmath>
+
+#include <boost/bind.hpp>
+
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
 #include "common/Builder.hpp"
+#include "common/StringConversion.hpp"
 
 #include "math/LSS/System.hpp"
 
@@ -23,7 +31,11 @@ common::ComponentBuilder < SolveLSS, common::Action, LibLSS > SolveLSS_Builder;
 ////////////////////////////////////////////////////////////////////////////////
 
 SolveLSS::SolveLSS( const std::string& name  ) :
-  Action ( name )
+  Action ( name ),
+  m_initial_guess("none"),
+  m_history_size(3),
+  m_nb_stored(0),
+  m_nb_created_vectors(0)
 {
   mark_basic();
 
@@ -36,7 +48,20 @@ SolveLSS::SolveLSS( const std::string& name  ) :
       .description("Linear System solver that gets executed")
       .pretty_name("LSS")
       .mark_basic()
-      .link_to(&m_lss);
+      .link_to(&m_lss)
+      .attach_trigger(boost::bind(&SolveLSS::clear_history, this));
+
+  options().add("initial_guess", m_initial_guess)
+      .description("Initial guess for the solve: none (use the solution vector as it is), extrapolation (polynomial extrapolation of the previous solutions) or projection (projection onto the previous solutions, for symmetric positive definite matrices)")
+      .pretty_name("Initial Guess")
+      .link_to(&m_initial_guess)
+      .attach_trigger(boost::bind(&SolveLSS::clear_history, this));
+
+  options().add("history_size", m_history_size)
+      .description("Number of previous solutions used to build the initial guess")
+      .pretty_name("History Size")
+      .link_to(&m_history_size)
+      .attach_trigger(boost::bind(&SolveLSS::clear_history, this));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,7 +76,161 @@ void SolveLSS::execute ()
   if(!lss.is_created())
     throw SetupError(FromHere(), "LSS at " + lss.uri().string() + " is not created!");
 
+  if(m_initial_guess == "none")
+  {
+    lss.solve();
+    return;
+  }
+
+  if(m_initial_guess != "extrapolation" && m_initial_guess != "projection")
+    throw BadValue(FromHere(), "Unknown initial guess " + m_initial_guess + " for " + uri().string() + ", expected none, extrapolation or projection");
+
+  if(m_history_size == 0)
+    throw BadValue(FromHere(), "history_size must be at least 1 for " + uri().string());
+
+  // The stored vectors are copies of the solution, so they are no longer valid when the system is created again
+  if(m_history_source.get() != lss.solution().get())
+  {
+    discard_history_vectors();
+    m_history_source = lss.solution();
+  }
+
+  compute_initial_guess(lss);
   lss.solve();
+  update_history(lss);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::clear_history()
+{
+  m_nb_stored = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::compute_initial_guess(System& lss)
+{
+  if(m_nb_stored == 0)
+    return;
+
+  LSS::Vector& solution = *lss.solution();
+  solution.reset(0.);
+
+  if(m_initial_guess == "extrapolation")
+  {
+    // Polynomial through the stored solutions, evaluated at the next step. The coefficient of the k-th newest solution is (-1)^k binomial(n, k+1)
+    Real coefficient = m_nb_stored;
+    for(Uint k = 0; k != m_nb_stored; ++k)
+    {
+      solution.update(*m_history[k], k % 2 == 0 ? coefficient : -coefficient);
+      coefficient = coefficient * Real(m_nb_stored - k - 1) / Real(k + 2);
+    }
+  }
+  else
+  {
+    // The basis is A-orthonormal, so the projection of the solution is sum_i (q_i . b) q_i
+    LSS::Vector& rhs = *lss.rhs();
+    for(Uint i = 0; i != m_nb_stored; ++i)
+      solution.update(*m_history[i], m_history[i]->dot(rhs));
+
+    if(is_null(m_guess))
+      m_guess = create_history_vector("guess", solution);
+    m_guess->assign(solution);
+  }
+
+  CFdebug << "Initial guess for " << lss.uri().path() << " from " << m_nb_stored << " previous solutions using " << m_initial_guess << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::update_history(System& lss)
+{
+  LSS::Vector& solution = *lss.solution();
+
+  if(m_initial_guess == "extrapolation")
+  {
+    if(m_nb_stored < m_history_size)
+    {
+      history_vector(m_history, m_nb_stored, "history", solution);
+      ++m_nb_stored;
+    }
+    // Move the oldest solution to the front and overwrite it with the newest one
+    std::rotate(m_history.begin(), m_history.begin() + m_nb_stored - 1, m_history.begin() + m_nb_stored);
+    m_history[0]->assign(solution);
+    return;
+  }
+
+  // Projection: add the part of the solution that the basis could not represent. When the basis is full, restart with only the new solution.
+  const bool restart = m_nb_stored == m_history_size;
+  const bool use_guess = m_nb_stored != 0 && !restart;
+  if(restart)
+    m_nb_stored = 0;
+
+  LSS::Vector& q = history_vector(m_history, m_nb_stored, "history", solution);
+  LSS::Vector& aq = history_vector(m_products, m_nb_stored, "product", solution);
+  q.assign(solution);
+  if(use_guess)
+    q.update(*m_guess, -1.);
+
+  lss.matrix()->apply(m_products[m_nb_stored], m_history[m_nb_stored]);
+  const Real initial_norm = q.dot(aq);
+
+  // Modified Gram-Schmidt in the inner product defined by the matrix
+  for(Uint i = 0; i != m_nb_stored; ++i)
+  {
+    const Real c = m_history[i]->dot(aq);
+    q.update(*m_history[i], -c);
+    aq.update(*m_products[i], -c);
+  }
+
+  const Real norm = q.dot(aq);
+  if(!(norm > 1e-12*initial_norm && norm > 0.))
+  {
+    CFdebug << "Solution of " << lss.uri().path() << " is already represented by the projection basis, it is not added" << CFendl;
+    return;
+  }
+
+  const Real scale_factor = 1. / std::sqrt(norm);
+  q.scale(scale_factor);
+  aq.scale(scale_factor);
+  ++m_nb_stored;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Handle<LSS::Vector> SolveLSS::create_history_vector(const std::string& prefix, LSS::Vector& solution)
+{
+  Handle<LSS::Vector> result(create_component(name() + "_" + prefix + "_" + to_str(m_nb_created_vectors++), solution.derived_type_name()));
+  solution.clone_to(*result);
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+LSS::Vector& SolveLSS::history_vector(std::vector< Handle<LSS::Vector> >& vectors, const Uint i, const std::string& prefix, LSS::Vector& solution)
+{
+  while(vectors.size() <= i)
+    vectors.push_back(create_history_vector(prefix, solution));
+
+  return *vectors[i];
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void SolveLSS::discard_history_vectors()
+{
+  boost_foreach(const Handle<LSS::Vector>& vector, m_history)
+    remove_component(*vector);
+  boost_foreach(const Handle<LSS::Vector>& vector, m_products)
+    remove_component(*vector);
+  if(is_not_null(m_guess))
+    remove_component(*m_guess);
+
+  m_history.clear();
+  m_products.clear();
+  m_guess.reset();
+  m_nb_stored = 0;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
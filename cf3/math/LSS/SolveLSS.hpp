@@ -18,10 +18,21 @@ namespace math {
 namespace LSS {
 
 class System;
+class Vector;
 
 ////////////////////////////////////////////////////////////////////////////////
 
 /// SolveLSS wraps a linear system math in an action that will execute the solve
+///
+/// The option initial_guess allows starting the solve from a guess built from the previous solutions,
+/// instead of from the contents of the solution vector:
+/// - extrapolation: polynomial extrapolation of the last history_size solutions. This assumes that each
+///   solve is the next step in time of the same problem.
+/// - projection: the Galerkin projection of the solution onto the space spanned by the previous solutions,
+///   using a basis that is orthonormal with respect to the matrix (Fischer's method). This requires a symmetric
+///   positive definite matrix that changes little between solves, such as a pressure Poisson matrix.
+///   The basis is restarted when it contains history_size vectors.
+/// The history is kept until the linear system is created again.
 /// @author Bart Janssens
 class LSS_API SolveLSS : public common::Action
 {
@@ -37,8 +48,50 @@ public: // functions
   /// Run the underlying linear system math
   void execute();
 
+  /// Forget the previous solutions, so the next solve starts from the solution vector as it is
+  void clear_history();
+
 private:
+  /// Overwrite the solution with the initial guess
+  void compute_initial_guess(LSS::System& lss);
+
+  /// Add the new solution to the history
+  void update_history(LSS::System& lss);
+
+  /// Create a vector that is a copy of the solution
+  Handle<LSS::Vector> create_history_vector(const std::string& prefix, LSS::Vector& solution);
+
+  /// Get vector i from the given list, creating it as a copy of the solution if needed
+  LSS::Vector& history_vector(std::vector< Handle<LSS::Vector> >& vectors, const Uint i, const std::string& prefix, LSS::Vector& solution);
+
+  /// Remove all stored vectors
+  void discard_history_vectors();
+
   Handle<math::LSS::System> m_lss;
+
+  /// Type of initial guess
+  std::string m_initial_guess;
+
+  /// Maximum number of stored solutions
+  Uint m_history_size;
+
+  /// Previous solutions, newest first, or the basis vectors for projection
+  std::vector< Handle<LSS::Vector> > m_history;
+
+  /// Matrix times each basis vector, for projection
+  std::vector< Handle<LSS::Vector> > m_products;
+
+  /// Guess used for the last solve, for projection
+  Handle<LSS::Vector> m_guess;
+
+  /// Number of valid entries in m_history
+  Uint m_nb_stored;
+
+  /// The solution vector from which the history vectors were copied
+  Handle<LSS::Vector const> m_history_source;
+
+  /// Number of vectors created so far, to give each one a unique name in the communication pattern of the solution
+  Uint m_nb_created_vectors;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
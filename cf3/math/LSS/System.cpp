@@ -16,6 +16,7 @@
 #include "common/OptionT.hpp"
 #include "common/PE/CommPattern.hpp"
 #include "common/Signal.hpp"
+#include "common/Tracer.hpp"
 
 #include "common/XML/Protocol.hpp"
 #include "common/XML/SignalOptions.hpp"
@@ -202,6 +203,7 @@ void LSS::System::destroy()
 void LSS::System::solve()
 {
   cf3_assert(is_created());
+  common::TraceScope trace(*this, common::Tracer::SOLVE);
   m_solution_strategy->solve();
 }
 
@@ -0,0 +1,90 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "common/Component.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+
+#include "PreconditionerReusePolicy.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+PreconditionerReusePolicy::PreconditionerReusePolicy(common::Component& strategy, const Uint default_reset) :
+  m_strategy(strategy),
+  m_preconditioner_reset(default_reset),
+  m_max_iterations(0),
+  m_nb_solves(0),
+  m_last_iterations(0),
+  m_needs_recompute(true)
+{
+  m_strategy.options().add("preconditioner_reset", m_preconditioner_reset)
+    .pretty_name("Preconditioner Reset")
+    .description("Number of solves after which the preconditioner is recomputed. 0 means it is only recomputed based on the iteration count")
+    .mark_basic()
+    .link_to(&m_preconditioner_reset);
+
+  m_strategy.options().add("preconditioner_max_iterations", m_max_iterations)
+    .pretty_name("Preconditioner Max Iterations")
+    .description("Recompute the preconditioner before the next solve if a solve needed more iterations than this. 0 disables this check")
+    .link_to(&m_max_iterations);
+
+  m_strategy.properties().add("preconditioner_setup_time", Real(0.));
+  m_strategy.properties().add("solve_time", Real(0.));
+  m_strategy.properties().add("nb_preconditioner_setups", Uint(0));
+  m_strategy.properties().add("iterations", Uint(0));
+}
+
+bool PreconditionerReusePolicy::recompute() const
+{
+  if(m_needs_recompute)
+    return true;
+
+  if(m_preconditioner_reset != 0 && m_nb_solves >= m_preconditioner_reset)
+    return true;
+
+  return m_max_iterations != 0 && m_last_iterations > m_max_iterations;
+}
+
+void PreconditionerReusePolicy::reset()
+{
+  m_needs_recompute = true;
+}
+
+void PreconditionerReusePolicy::setup_done(const bool recomputed, const Real time)
+{
+  common::PropertyList& props = m_strategy.properties();
+  props["preconditioner_setup_time"] = props.value<Real>("preconditioner_setup_time") + time;
+  if(recomputed)
+  {
+    props["nb_preconditioner_setups"] = props.value<Uint>("nb_preconditioner_setups") + 1u;
+    m_nb_solves = 0;
+    m_last_iterations = 0;
+    m_needs_recompute = false;
+    CFdebug << "Recomputed preconditioner for " << m_strategy.uri().path() << " in " << time << " s" << CFendl;
+  }
+}
+
+void PreconditionerReusePolicy::solve_done(const Uint iterations, const Real time)
+{
+  common::PropertyList& props = m_strategy.properties();
+  props["solve_time"] = props.value<Real>("solve_time") + time;
+  props["iterations"] = iterations;
+  m_last_iterations = iterations;
+  ++m_nb_solves;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
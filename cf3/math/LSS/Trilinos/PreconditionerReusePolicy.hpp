@@ -0,0 +1,73 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_PreconditionerReusePolicy_hpp
+#define cf3_Math_LSS_PreconditionerReusePolicy_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "common/CF.hpp"
+
+#include "math/LSS/LibLSS.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file PreconditionerReusePolicy.hpp Decides when a solution strategy recomputes its preconditioner
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace common { class Component; }
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Keeps track of when the preconditioner of a solution strategy needs to be recomputed. The preconditioner is kept
+/// across solves, and its numerical values are recomputed every preconditioner_reset solves, or on the next solve when
+/// the last one needed more than preconditioner_max_iterations iterations. Setting either option to 0 disables that criterion.
+/// The time spent in setting up the preconditioner and in the solves is reported in properties of the strategy.
+class LSS_API PreconditionerReusePolicy
+{
+public:
+  /// Add the options and properties to the given strategy
+  /// @param default_reset Default value for the preconditioner_reset option
+  PreconditionerReusePolicy(common::Component& strategy, const Uint default_reset);
+
+  /// True if the preconditioner must be recomputed before the next solve
+  bool recompute() const;
+
+  /// Force a recompute on the next solve, e.g. because the solver was set up again
+  void reset();
+
+  /// Report the time spent setting up the operator and preconditioner before a solve
+  /// @param recomputed True if the preconditioner was recomputed
+  void setup_done(const bool recomputed, const Real time);
+
+  /// Report the result of a solve
+  void solve_done(const Uint iterations, const Real time);
+
+private:
+  common::Component& m_strategy;
+
+  Uint m_preconditioner_reset;
+  Uint m_max_iterations;
+
+  /// Solves since the last recompute
+  Uint m_nb_solves;
+  Uint m_last_iterations;
+  bool m_needs_recompute;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_PreconditionerReusePolicy_hpp
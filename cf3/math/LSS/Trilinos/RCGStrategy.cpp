@@ -40,10 +40,12 @@
 #include "common/Builder.hpp"
 #include "common/EventHandler.hpp"
 #include "common/OptionList.hpp"
+#include "common/Timer.hpp"
 #include <common/Table.hpp>
 #include <common/List.hpp>
 
 #include "ParameterList.hpp"
+#include "PreconditionerReusePolicy.hpp"
 #include "TrilinosVector.hpp"
 #include "TrilinosCrsMatrix.hpp"
 #include "RCGStrategy.hpp"
@@ -64,6 +66,7 @@ struct RCGStrategy::Implementation
     m_self(self),
     m_ml_parameter_list(Teuchos::createParameterList()),
     m_solver_parameter_list(Teuchos::createParameterList()),
+    m_reuse_policy(self, 0),
     m_xcoords(0),
     m_dim(0)
   {
@@ -137,15 +140,26 @@ struct RCGStrategy::Implementation
 
   void solve()
   {
+    common::WallTimer timer;
+    const bool recompute = m_reuse_policy.recompute();
     if(is_null(m_solver.get()))
     {
       setup_solver();
     }
+    else if(recompute)
+    {
+      // Keeps the multigrid hierarchy and only recomputes the numerical values
+      if(m_ml_prec->ReComputePreconditioner() != 0)
+        throw common::SetupError(FromHere(), "Error recomputing the ML preconditioner for " + m_self.uri().path());
+    }
+    m_reuse_policy.setup_done(recompute, timer.elapsed());
 
     if(!m_problem->setProblem())
       throw common::SetupError(FromHere(), "Error setting up Belos problem");
 
+    timer.restart();
     m_solver->solve();
+    m_reuse_policy.solve_done(m_solver->getNumIters(), timer.elapsed());
   }
 
   Real compute_residual()
@@ -175,11 +189,16 @@ struct RCGStrategy::Implementation
     m_solver.reset();
     m_problem.reset();
     m_ml_prec.reset();
+    m_reuse_policy.reset();
   }
 
   common::Component& m_self;
   Teuchos::RCP<Teuchos::ParameterList> m_ml_parameter_list;
   Teuchos::RCP<Teuchos::ParameterList> m_solver_parameter_list;
+
+  /// Decides when the preconditioner is recomputed
+  PreconditionerReusePolicy m_reuse_policy;
+
   Teuchos::RCP<ML_Epetra::MultiLevelPreconditioner> m_ml_prec;
   Teuchos::RCP< Belos::LinearProblem<Real,MV,OP> > m_problem;
   Teuchos::RCP< Belos::RCGSolMgr<double,MV,OP> > m_solver;
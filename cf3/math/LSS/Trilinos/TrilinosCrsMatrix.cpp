@@ -6,9 +6,11 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 #include <set>
 
+#include <boost/bind.hpp>
 #include <boost/pointer_cast.hpp>
 
 #include "Teuchos_ConfigDefs.hpp"
@@ -68,10 +70,21 @@ TrilinosCrsMatrix::TrilinosCrsMatrix(const std::string& name) :
   m_neq(0),
   m_num_my_elements(0),
   m_p2m(0),
-  m_converted_indices(0),
   m_comm(common::PE::Comm::instance().communicator())
 {
   properties().add("vector_type", std::string("cf3.math.LSS.TrilinosVector"));
+
+  options().add("scatter_cache_size", 512u)
+    .pretty_name("Scatter Cache Size")
+    .description("Maximum memory in MB used to cache the value offsets of the assembled elements. Set to 0 to disable the cache.")
+    .attach_trigger(boost::bind(&TrilinosCrsMatrix::trigger_scatter_cache_size, this));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::trigger_scatter_cache_size()
+{
+  m_scatter_cache.set_max_memory(static_cast<std::size_t>(options().value<Uint>("scatter_cache_size"))*1024*1024);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -108,7 +121,7 @@ void TrilinosCrsMatrix::create_blocked(common::PE::CommPattern& cp, const Variab
   std::vector<int> indices_per_row;
   create_indices_per_row(cp, vars, node_connectivity, starting_indices, m_p2m, num_indices_per_row, indices_per_row, periodic_links_nodes, periodic_links_active);
 
-  m_converted_indices.resize(*std::max_element(num_indices_per_row.begin(), num_indices_per_row.end()));
+  m_scatter_cache.reset(m_p2m.size() / total_nb_eq);
 
   // rowmap, ghosts not present
   Epetra_Map rowmap(-1,m_num_my_elements,&my_global_elements[0],0,m_comm);
@@ -155,6 +168,7 @@ void TrilinosCrsMatrix::destroy()
   }
   m_p2m.resize(0);
   m_p2m.reserve(0);
+  m_scatter_cache.clear();
   m_neq=0;
   m_num_my_elements=0;
   m_is_created=false;
@@ -198,53 +212,104 @@ void TrilinosCrsMatrix::get_value(const Uint icol, const Uint irow, Real& value)
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void TrilinosCrsMatrix::set_values(const BlockAccumulator& values)
+void TrilinosCrsMatrix::compute_offsets(const std::vector<Uint>& indices, std::vector<int>& offsets)
 {
-  cf3_assert(m_is_created);
-  const Uint nb_nodes = values.indices.size();
+  cf3_assert(m_mat->StorageOptimized());
+  const Uint nb_nodes = indices.size();
   const int num_entries = nb_nodes*m_neq;
-  cf3_assert(values.mat.rows() == num_entries);
+
+  int* index_offsets;
+  int* all_indices;
+  Real* all_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(index_offsets, all_indices, all_values));
+
   // Convert the index vector
+  std::vector<int> converted_indices(num_entries);
   for(Uint i = 0; i != nb_nodes; ++i)
   {
-    const Uint local_start_idx = values.indices[i]*m_neq;
+    const Uint local_start_idx = indices[i]*m_neq;
     for(int j = 0; j != m_neq; ++j)
-      m_converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
+      converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
   }
-  // insert the values
-  for(Uint i = 0; i != nb_nodes; ++i)
+
+  offsets.assign(num_entries*num_entries, -1);
+  for(int i = 0; i != num_entries; ++i)
   {
-    for(int j = 0; j != m_neq; ++j)
+    const int row = converted_indices[i];
+    if(row >= m_num_my_elements)
+      continue;
+    const int* row_begin = all_indices + index_offsets[row];
+    const int* row_end = all_indices + index_offsets[row+1];
+    for(int j = 0; j != num_entries; ++j)
     {
-      if(m_converted_indices[i*m_neq+j] < m_num_my_elements)
-        TRILINOS_THROW(m_mat->ReplaceMyValues(m_converted_indices[i*m_neq+j], num_entries, values.mat.data()+(num_entries*(i*m_neq+j)),&m_converted_indices[0]));
+      const int* col = std::find(row_begin, row_end, converted_indices[j]);
+      if(col == row_end)
+        throw common::BadValue(FromHere(),"Trying to access an illegal entry.");
+      offsets[i*num_entries+j] = col - all_indices;
     }
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
-void TrilinosCrsMatrix::add_values(const BlockAccumulator& values)
+const std::vector<int>& TrilinosCrsMatrix::cached_offsets(const std::vector<Uint>& indices, std::vector<int>& buffer)
+{
+  const std::vector<int>* offsets = m_scatter_cache.find(indices);
+  if(is_not_null(offsets))
+    return *offsets;
+
+  compute_offsets(indices, buffer);
+  m_scatter_cache.insert(indices, buffer);
+  return buffer;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::set_values(const BlockAccumulator& values)
 {
   cf3_assert(m_is_created);
-  const Uint nb_nodes = values.indices.size();
-  const int num_entries = nb_nodes*m_neq;
+  const int num_entries = values.indices.size()*m_neq;
   cf3_assert(values.mat.rows() == num_entries);
-  // Convert the index vector
-  for(Uint i = 0; i != nb_nodes; ++i)
+  if(num_entries == 0)
+    return;
+
+  std::vector<int> offsets_buffer;
+  const std::vector<int>& offsets = cached_offsets(values.indices, offsets_buffer);
+  int* index_offsets;
+  int* all_indices;
+  Real* all_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(index_offsets, all_indices, all_values));
+  const Real* src = values.mat.data();
+  const int nb_offsets = offsets.size();
+  for(int i = 0; i != nb_offsets; ++i)
   {
-    const Uint local_start_idx = values.indices[i]*m_neq;
-    for(int j = 0; j != m_neq; ++j)
-      m_converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
+    if(offsets[i] >= 0)
+      all_values[offsets[i]] = src[i];
   }
-  // insert the values
-  for(Uint i = 0; i != nb_nodes; ++i)
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosCrsMatrix::add_values(const BlockAccumulator& values)
+{
+  cf3_assert(m_is_created);
+  const int num_entries = values.indices.size()*m_neq;
+  cf3_assert(values.mat.rows() == num_entries);
+  if(num_entries == 0)
+    return;
+
+  std::vector<int> offsets_buffer;
+  const std::vector<int>& offsets = cached_offsets(values.indices, offsets_buffer);
+  int* index_offsets;
+  int* all_indices;
+  Real* all_values;
+  TRILINOS_THROW(m_mat->ExtractCrsDataPointers(index_offsets, all_indices, all_values));
+  const Real* src = values.mat.data();
+  const int nb_offsets = offsets.size();
+  for(int i = 0; i != nb_offsets; ++i)
   {
-    for(int j = 0; j != m_neq; ++j)
-    {
-      if(m_converted_indices[i*m_neq+j] < m_num_my_elements)
-        TRILINOS_THROW(m_mat->SumIntoMyValues(m_converted_indices[i*m_neq+j], num_entries, values.mat.data()+(num_entries*(i*m_neq+j)),&m_converted_indices[0]));
-    }
+    if(offsets[i] >= 0)
+      all_values[offsets[i]] += src[i];
   }
 }
 
@@ -261,13 +326,14 @@ void TrilinosCrsMatrix::get_values(BlockAccumulator& values)
   int* extracted_indices;
   cf3_assert(values.mat.rows() == num_entries);
   std::map<int, int> reverse_idx_map;
-  // Convert the index vector
+  // Convert the index vector, using a local buffer so concurrent calls for different elements are safe
+  std::vector<int> converted_indices(num_entries);
   for(Uint i = 0; i != nb_nodes; ++i)
   {
     const Uint local_start_idx = values.indices[i]*m_neq;
     for(int j = 0; j != m_neq; ++j)
     {
-      m_converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
+      converted_indices[i*m_neq+j] = m_p2m[local_start_idx+j];
       reverse_idx_map[m_p2m[local_start_idx+j]] = i*m_neq + j;
     }
   }
@@ -276,9 +342,9 @@ void TrilinosCrsMatrix::get_values(BlockAccumulator& values)
   {
     for(int j = 0; j != m_neq; ++j)
     {
-      if(m_converted_indices[i*m_neq+j] >= m_num_my_elements)
+      if(converted_indices[i*m_neq+j] >= m_num_my_elements)
         continue;
-      TRILINOS_THROW(m_mat->ExtractMyRowView(m_converted_indices[i*m_neq+j], extracted_num_entries, extracted_values, extracted_indices));
+      TRILINOS_THROW(m_mat->ExtractMyRowView(converted_indices[i*m_neq+j], extracted_num_entries, extracted_values, extracted_indices));
       for(int k = 0; k != extracted_num_entries; ++k)
       {
         const std::map<int,int>::const_iterator it = reverse_idx_map.find(extracted_indices[k]);
@@ -524,11 +590,12 @@ void TrilinosCrsMatrix::clone_to(Matrix &other)
     throw common::SetupError(FromHere(), "clone_to method of TrilinosCrsMatrix needs another TrilinosCrsMatrix, but a " + other.derived_type_name() + " was supplied instead.");
 
   other_ptr->m_mat = Teuchos::rcp(new Epetra_CrsMatrix(*m_mat));
+  TRILINOS_THROW(other_ptr->m_mat->OptimizeStorage());
   other_ptr->m_is_created = m_is_created;
   other_ptr->m_neq = m_neq;
   other_ptr->m_num_my_elements = m_num_my_elements;
   other_ptr->m_p2m = m_p2m;
-  other_ptr->m_converted_indices = m_converted_indices;
+  other_ptr->m_scatter_cache.reset(m_p2m.size() / m_neq);
   other_ptr->m_node_connectivity = m_node_connectivity;
   other_ptr->m_starting_indices = m_starting_indices;
   other_ptr->m_symmetric_dirichlet_values = m_symmetric_dirichlet_values;
@@ -17,6 +17,7 @@
 #include "math/LSS/BlockAccumulator.hpp"
 #include "math/LSS/Vector.hpp"
 #include "math/LSS/Matrix.hpp"
+#include "math/LSS/ScatterCache.hpp"
 
 #include "ThyraOperator.hpp"
 
@@ -202,6 +203,16 @@ public:
 
 private:
 
+  /// Offsets into the value array of the matrix for each entry of a BlockAccumulator with the given indices, or -1 for entries in ghost rows
+  void compute_offsets(const std::vector<Uint>& indices, std::vector<int>& offsets);
+
+  /// Offsets for the given indices, computed and stored in the scatter cache on first use.
+  /// If the cache is full, the offsets are computed into buffer, which is returned.
+  const std::vector<int>& cached_offsets(const std::vector<Uint>& indices, std::vector<int>& buffer);
+
+  /// Apply the scatter_cache_size option
+  void trigger_scatter_cache_size();
+
   /// teuchos style smart pointer wrapping the matrix
   Teuchos::RCP<Epetra_CrsMatrix> m_mat;
 
@@ -220,8 +231,8 @@ private:
   /// mapper array, maps from process local numbering to matrix local numbering (because ghost nodes need to be ordered to the back)
   std::vector<int> m_p2m;
 
-  /// a helper array used in set/add/get_values to avoid frequent new+free combo
-  std::vector<int> m_converted_indices;
+  /// Value offsets for the BlockAccumulators passed to set_values and add_values, reset when the matrix is created
+  ScatterCache<int> m_scatter_cache;
 
   /// Copy of the connectivity data
   std::vector<int> m_node_connectivity, m_starting_indices;
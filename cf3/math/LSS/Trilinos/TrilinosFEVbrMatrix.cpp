@@ -6,8 +6,10 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <iostream>
 
+#include <boost/bind.hpp>
 #include <boost/pointer_cast.hpp>
 
 #include "Stratimikos_DefaultLinearSolverBuilder.hpp"
@@ -60,10 +62,21 @@ TrilinosFEVbrMatrix::TrilinosFEVbrMatrix(const std::string& name) :
   m_blockrow_size(0),
   m_blockcol_size(0),
   m_p2m(0),
-  m_converted_indices(0),
   m_comm(common::PE::Comm::instance().communicator())
 {
   properties().add("vector_type", std::string("cf3.math.LSS.TrilinosVector"));
+
+  options().add("scatter_cache_size", 512u)
+    .pretty_name("Scatter Cache Size")
+    .description("Maximum memory in MB used to cache the block positions of the assembled elements. Set to 0 to disable the cache.")
+    .attach_trigger(boost::bind(&TrilinosFEVbrMatrix::trigger_scatter_cache_size, this));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosFEVbrMatrix::trigger_scatter_cache_size()
+{
+  m_scatter_cache.set_max_memory(static_cast<std::size_t>(options().value<Uint>("scatter_cache_size"))*1024*1024);
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -130,6 +143,7 @@ void TrilinosFEVbrMatrix::create(cf3::common::PE::CommPattern& cp, const Uint ne
   m_neq=neq;
   m_blockrow_size=nmyglobalelements;
   m_blockcol_size=cp.gid()->size();
+  m_scatter_cache.reset(m_p2m.size());
   CFdebug << "Created a " << m_mat->NumGlobalCols() << " x " << m_mat->NumGlobalRows() << " trilinos matrix with " << m_mat->NumGlobalNonzeros() << " non-zero elements. CrsGraph rows: " << m_mat->Graph().NumGlobalRows() << CFendl;
 }
 
@@ -146,6 +160,7 @@ void TrilinosFEVbrMatrix::destroy()
   if (m_is_created) m_mat.reset();
   m_p2m.resize(0);
   m_p2m.reserve(0);
+  m_scatter_cache.clear();
   m_neq=0;
   m_blockrow_size=0;
   m_blockcol_size=0;
@@ -223,6 +238,36 @@ void TrilinosFEVbrMatrix::get_value(const Uint icol, const Uint irow, Real& valu
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
+const std::vector<int>& TrilinosFEVbrMatrix::cached_block_positions(const std::vector<Uint>& indices, std::vector<int>& positions)
+{
+  const std::vector<int>* cached_positions = m_scatter_cache.find(indices);
+  if (is_not_null(cached_positions)) return *cached_positions;
+
+  Epetra_SerialDenseMatrix **val;
+  int* colindices;
+  int blockrowsize;
+  int dummyneq;
+  const int numblocks=indices.size();
+  positions.assign(numblocks*numblocks,-1);
+  for (int irow=0; irow<(const int)numblocks; irow++)
+  {
+    const int blockrow=m_p2m[indices[irow]];
+    if (blockrow<m_blockrow_size)
+    {
+      TRILINOS_ASSERT(m_mat->ExtractMyBlockRowView(blockrow,dummyneq,blockrowsize,colindices,val));
+      for (int icol=0; icol<(const int)numblocks; icol++)
+      {
+        const int* colindex=std::find(colindices,colindices+blockrowsize,m_p2m[indices[icol]]);
+        if (colindex!=colindices+blockrowsize) positions[irow*numblocks+icol]=colindex-colindices;
+      }
+    }
+  }
+  m_scatter_cache.insert(indices,positions);
+  return positions;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
 void TrilinosFEVbrMatrix::set_values(const BlockAccumulator& values)
 {
   cf3_assert(m_is_created);
@@ -230,37 +275,24 @@ void TrilinosFEVbrMatrix::set_values(const BlockAccumulator& values)
   int* colindices;
   int blockrowsize;
   int dummyneq;
-  int hits=0;
   const int numblocks=values.indices.size();
-  const int rowoffset=(numblocks-1)*m_neq;
-  const int neqneq=m_neq*m_neq;
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  for (int i=0; i<(const int)numblocks; i++) m_converted_indices[i]=m_p2m[values.indices[i]];
-  int* idxs=(int*)&m_converted_indices[0];
+  if (numblocks==0) return;
+  std::vector<int> positions_buffer;
+  const std::vector<int>& positions=cached_block_positions(values.indices,positions_buffer);
   for (int irow=0; irow<(const int)numblocks; irow++)
   {
-    if (idxs[irow]<m_blockrow_size)
+    const int blockrow=m_p2m[values.indices[irow]];
+    if (blockrow<m_blockrow_size)
     {
-      hits=0;
-      TRILINOS_ASSERT(m_mat->ExtractMyBlockRowView(idxs[irow],dummyneq,blockrowsize,colindices,val));
-      for (int j=0; j<(const int)blockrowsize; j++)
+      TRILINOS_ASSERT(m_mat->ExtractMyBlockRowView(blockrow,dummyneq,blockrowsize,colindices,val));
+      for (int icol=0; icol<(const int)numblocks; icol++)
       {
-        for (int icol=0; icol<(const int)numblocks; icol++)
-          if (colindices[j]==idxs[icol])
-          {
-            double *emv=val[j][0].A();
-            int col_idx = icol*m_neq;
-            for (double* l=emv; emv<(const double*)(l+neqneq); ++col_idx)
-            {
-              int row_idx = irow*m_neq;
-              for (double* m=emv; emv<(const double*)(m+m_neq);)
-                *emv++ = values.mat(row_idx++, col_idx);
-            }
-
-            hits++;
-            //break; // this is arguable, can be that the blockaccumulator fills to the same id more than once (repetitive same id entries in values.indices)
-          }
-        if (hits==numblocks) break;
+        const int j=positions[irow*numblocks+icol];
+        if (j<0) continue;
+        double *emv=val[j][0].A();
+        for (int col_idx=icol*m_neq; col_idx<(const int)((icol+1)*m_neq); ++col_idx)
+          for (int row_idx=irow*m_neq; row_idx<(const int)((irow+1)*m_neq); ++row_idx)
+            *emv++ = values.mat(row_idx, col_idx);
       }
     }
   }
@@ -312,43 +344,30 @@ void TrilinosFEVbrMatrix::add_values(const BlockAccumulator& values)
     }
   }
 */
-/* FINAL OPTIMIZED */
+/* FINAL OPTIMIZED, block positions cached per set of indices */
   cf3_assert(m_is_created);
   Epetra_SerialDenseMatrix **val;
   int* colindices;
   int blockrowsize;
   int dummyneq;
-  int hits=0;
   const int numblocks=values.indices.size();
-  const int rowoffset=(numblocks-1)*m_neq;
-  const int neqneq=m_neq*m_neq;
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  for (int i=0; i<(const int)numblocks; i++) m_converted_indices[i]=m_p2m[values.indices[i]];
-  int* idxs=(int*)&m_converted_indices[0];
+  if (numblocks==0) return;
+  std::vector<int> positions_buffer;
+  const std::vector<int>& positions=cached_block_positions(values.indices,positions_buffer);
   for (int irow=0; irow<(const int)numblocks; irow++)
   {
-    if (idxs[irow]<m_blockrow_size)
+    const int blockrow=m_p2m[values.indices[irow]];
+    if (blockrow<m_blockrow_size)
     {
-      hits=0;
-      TRILINOS_ASSERT(m_mat->ExtractMyBlockRowView(idxs[irow],dummyneq,blockrowsize,colindices,val));
-      for (int j=0; j<(const int)blockrowsize; j++)
+      TRILINOS_ASSERT(m_mat->ExtractMyBlockRowView(blockrow,dummyneq,blockrowsize,colindices,val));
+      for (int icol=0; icol<(const int)numblocks; icol++)
       {
-        for (int icol=0; icol<(const int)numblocks; icol++)
-          if (colindices[j]==idxs[icol])
-          {
-            double *emv=val[j][0].A();
-            int col_idx = icol*m_neq;
-            for (double* l=emv; emv<(const double*)(l+neqneq); ++col_idx)
-            {
-              int row_idx = irow*m_neq;
-              for (double* m=emv; emv<(const double*)(m+m_neq);)
-                *emv++ += values.mat(row_idx++, col_idx);
-            }
-
-            hits++;
-            //break; // this is arguable, can be that the blockaccumulator fills to the same id more than once (repetitive same id entries in values.indices)
-          }
-        if (hits==numblocks) break;
+        const int j=positions[irow*numblocks+icol];
+        if (j<0) continue;
+        double *emv=val[j][0].A();
+        for (int col_idx=icol*m_neq; col_idx<(const int)((icol+1)*m_neq); ++col_idx)
+          for (int row_idx=irow*m_neq; row_idx<(const int)((irow+1)*m_neq); ++row_idx)
+            *emv++ += values.mat(row_idx, col_idx);
       }
     }
   }
@@ -367,9 +386,10 @@ void TrilinosFEVbrMatrix::get_values(BlockAccumulator& values)
   const int numblocks=values.indices.size();
   const int rowoffset=(numblocks-1)*m_neq;
   const int neqneq=m_neq*m_neq;
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  for (int i=0; i<(const int)numblocks; i++) m_converted_indices[i]=m_p2m[values.indices[i]];
-  int* idxs=(int*)&m_converted_indices[0];
+  // local buffer, so concurrent calls for different elements are safe
+  std::vector<int> converted_indices(numblocks);
+  for (int i=0; i<(const int)numblocks; i++) converted_indices[i]=m_p2m[values.indices[i]];
+  int* idxs=numblocks ? &converted_indices[0] : 0;
   values.mat.setConstant(0.);
   for (int irow=0; irow<(const int)numblocks; irow++)
   {
@@ -17,6 +17,7 @@
 #include "math/LSS/BlockAccumulator.hpp"
 #include "math/LSS/Vector.hpp"
 #include "math/LSS/Matrix.hpp"
+#include "math/LSS/ScatterCache.hpp"
 
 #include "ThyraOperator.hpp"
 
@@ -171,6 +172,13 @@ public:
 
 private:
 
+  /// Position of each block of a BlockAccumulator with the given indices in its block row, or -1 for ghost rows and blocks outside the sparsity.
+  /// Computed into positions and stored in the scatter cache on first use. Returns either the cached entry or positions.
+  const std::vector<int>& cached_block_positions(const std::vector<Uint>& indices, std::vector<int>& positions);
+
+  /// Apply the scatter_cache_size option
+  void trigger_scatter_cache_size();
+
   /// teuchos style smart pointer wrapping an epetra fevbrmatrix
   Teuchos::RCP<Epetra_FEVbrMatrix> m_mat;
 
@@ -192,8 +200,8 @@ private:
   /// mapper array, maps from process local numbering to matrix local numbering (because ghost nodes need to be ordered to the back)
   std::vector<int> m_p2m;
 
-  /// a helper array used in set/add/get_values to avoid frequent new+free combo
-  std::vector<int> m_converted_indices;
+  /// Block positions for the BlockAccumulators passed to set_values and add_values, reset when the matrix is created
+  ScatterCache<int> m_scatter_cache;
 
   /// Copy of the connectivity data
   std::vector<int> m_node_connectivity, m_starting_indices;
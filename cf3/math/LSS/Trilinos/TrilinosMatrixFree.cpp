@@ -0,0 +1,576 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <boost/foreach.hpp>
+
+#include "Epetra_Import.h"
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+#include "Epetra_Operator.h"
+#include "Epetra_Vector.h"
+
+#include "Thyra_EpetraLinearOp.hpp"
+
+#include "common/Assertions.hpp"
+#include "common/BasicExceptions.hpp"
+#include "common/Builder.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/PropertyList.hpp"
+#include "math/LSS/Trilinos/TrilinosMatrixFree.hpp"
+#include "math/LSS/Trilinos/TrilinosDetail.hpp"
+#include "math/LSS/Trilinos/TrilinosVector.hpp"
+#include "math/VariablesDescriptor.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file TrilinosMatrixFree.cpp implementation of LSS::TrilinosMatrixFree
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::math;
+using namespace cf3::math::LSS;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < LSS::TrilinosMatrixFree, LSS::Matrix, LSS::LibLSS > TrilinosMatrixFree_Builder;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+namespace detail
+{
+
+/// Epetra view of a TrilinosMatrixFree, so it can be wrapped as Thyra operator
+class MatrixFreeEpetraOperator : public Epetra_Operator
+{
+public:
+  MatrixFreeEpetraOperator(TrilinosMatrixFree& matrix, const Teuchos::RCP<Epetra_Map>& map, const Epetra_Comm& comm) :
+    m_matrix(matrix),
+    m_map(map),
+    m_comm(comm)
+  {
+  }
+
+  int SetUseTranspose(bool use_transpose)
+  {
+    // The element matrices are not transposed
+    return use_transpose ? -1 : 0;
+  }
+
+  int Apply(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const
+  {
+    m_matrix.multiply(X, Y);
+    return 0;
+  }
+
+  int ApplyInverse(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const
+  {
+    return -1;
+  }
+
+  double NormInf() const
+  {
+    return 0.;
+  }
+
+  const char* Label() const
+  {
+    return "cf3::math::LSS::TrilinosMatrixFree";
+  }
+
+  bool UseTranspose() const
+  {
+    return false;
+  }
+
+  bool HasNormInf() const
+  {
+    return false;
+  }
+
+  const Epetra_Comm& Comm() const
+  {
+    return m_comm;
+  }
+
+  const Epetra_Map& OperatorDomainMap() const
+  {
+    return *m_map;
+  }
+
+  const Epetra_Map& OperatorRangeMap() const
+  {
+    return *m_map;
+  }
+
+private:
+  TrilinosMatrixFree& m_matrix;
+  Teuchos::RCP<Epetra_Map> m_map;
+  const Epetra_Comm& m_comm;
+};
+
+} // namespace detail
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+TrilinosMatrixFree::TrilinosMatrixFree(const std::string& name) :
+  LSS::Matrix(name),
+  m_comm(common::PE::Comm::instance().communicator()),
+  m_is_created(false),
+  m_neq(0),
+  m_num_my_elements(0),
+  m_mode(IGNORE_VALUES),
+  m_result(0),
+  m_x_values(0)
+{
+  properties().add("vector_type", std::string("cf3.math.LSS.TrilinosVector"));
+
+  options().add("assembly", m_assembly)
+    .pretty_name("Assembly")
+    .description("Action that adds the element matrices to this matrix, and leaves the RHS untouched. It is executed for each matrix-vector product.")
+    .link_to(&m_assembly)
+    .mark_basic();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::create(cf3::common::PE::CommPattern& cp, const Uint neq, const std::vector<Uint>& node_connectivity, const std::vector<Uint>& starting_indices, LSS::Vector& solution, LSS::Vector& rhs, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active)
+{
+  boost::shared_ptr<VariablesDescriptor> single_var_descriptor = common::allocate_component<VariablesDescriptor>("SingleVariableDescriptor");
+  single_var_descriptor->options().set(common::Tags::dimension(), neq);
+  single_var_descriptor->push_back("LSSvars", VariablesDescriptor::Dimensionalities::VECTOR);
+  create_blocked(cp, *single_var_descriptor, node_connectivity, starting_indices, solution, rhs, periodic_links_nodes, periodic_links_active);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector< Uint >& node_connectivity, const std::vector< Uint >& starting_indices, Vector& solution, Vector& rhs, const std::vector<Uint>& periodic_links_nodes, const std::vector<bool>& periodic_links_active)
+{
+  // if already created
+  if (m_is_created) destroy();
+
+  std::vector<int> my_global_elements;
+  std::vector<Uint> my_ranks;
+  create_map_data(cp, vars, m_p2m, my_global_elements, my_ranks, m_num_my_elements, periodic_links_nodes, periodic_links_active);
+
+  // rowmap, ghosts not present
+  m_row_map = Teuchos::rcp(new Epetra_Map(-1, m_num_my_elements, &my_global_elements[0], 0, m_comm));
+
+  // colmap, has ghosts at the end
+  m_col_map = Teuchos::rcp(new Epetra_Map(-1, my_global_elements.size(), &my_global_elements[0], 0, m_comm));
+
+  m_importer = Teuchos::rcp(new Epetra_Import(*m_col_map, *m_row_map));
+  m_x_col = Teuchos::rcp(new Epetra_Vector(*m_col_map));
+  m_epetra_operator = Teuchos::rcp(new detail::MatrixFreeEpetraOperator(*this, m_row_map, m_comm));
+
+  m_is_created=true;
+  m_neq=vars.size();
+  CFdebug << "Rank " << common::PE::Comm::instance().rank() << ": Created a matrix-free trilinos operator with " << m_num_my_elements << " local rows" << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::destroy()
+{
+  m_epetra_operator.reset();
+  m_x_col.reset();
+  m_importer.reset();
+  m_col_map.reset();
+  m_row_map.reset();
+  m_p2m.resize(0);
+  m_p2m.reserve(0);
+  m_dirichlet_rows.clear();
+  m_dirichlet_columns.clear();
+  m_pending_dirichlet_values.clear();
+  m_added_diagonal.clear();
+  m_neq=0;
+  m_num_my_elements=0;
+  m_is_created=false;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::set_value(const Uint icol, const Uint irow, const Real value)
+{
+  throw common::NotSupported(FromHere(), "set_value is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::add_value(const Uint icol, const Uint irow, const Real value)
+{
+  throw common::NotSupported(FromHere(), "add_value is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::get_value(const Uint icol, const Uint irow, Real& value)
+{
+  throw common::NotSupported(FromHere(), "get_value is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::set_values(const BlockAccumulator& values)
+{
+  throw common::NotSupported(FromHere(), "set_values is not supported for " + type_name() + ", element matrices can only be added");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::add_values(const BlockAccumulator& values)
+{
+  if(m_mode == IGNORE_VALUES)
+    return;
+
+  cf3_assert(m_is_created);
+  const Uint nb_nodes = values.indices.size();
+  const int num_entries = nb_nodes*m_neq;
+  cf3_assert(values.mat.rows() == num_entries);
+
+  // Elements of the same color may be assembled concurrently, but they don't share any rows
+  const Real* mat = values.mat.data();
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    const int* rows = &m_p2m[values.indices[i]*m_neq];
+    for(Uint ieq = 0; ieq != m_neq; ++ieq)
+    {
+      const int row = rows[ieq];
+      if(row >= m_num_my_elements)
+        continue;
+
+      const Real* mat_row = mat + (i*m_neq + ieq)*num_entries;
+      Real sum = 0.;
+      for(Uint j = 0; j != nb_nodes; ++j)
+      {
+        const int* cols = &m_p2m[values.indices[j]*m_neq];
+        for(Uint jeq = 0; jeq != m_neq; ++jeq)
+        {
+          if(m_mode == PRODUCT)
+            sum += mat_row[j*m_neq + jeq] * m_x_values[cols[jeq]];
+          else if(cols[jeq] == row)
+            sum += mat_row[j*m_neq + jeq];
+        }
+      }
+      m_result[row] += sum;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::get_values(BlockAccumulator& values)
+{
+  throw common::NotSupported(FromHere(), "get_values is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval)
+{
+  cf3_assert(m_is_created);
+  if(offdiagval != 0.)
+    throw common::NotSupported(FromHere(), "set_row with a non-zero off-diagonal value is not supported for " + type_name());
+
+  const int row = m_p2m[iblockrow*m_neq+ieq];
+  if(row >= m_num_my_elements)
+    return;
+
+  m_dirichlet_rows[row] = diagval;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values)
+{
+  throw common::NotSupported(FromHere(), "get_column_and_replace_to_zero is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, Vector& rhs)
+{
+  cf3_assert(m_is_created);
+  const int bc_col = m_p2m[blockrow*m_neq+ieq];
+
+  m_dirichlet_columns.insert(bc_col);
+  if(bc_col < m_num_my_elements)
+    m_dirichlet_rows[bc_col] = 1.;
+
+  // The RHS is corrected for all conditions at once, when the operator is needed
+  m_pending_dirichlet_values[bc_col] += value;
+  m_dirichlet_rhs = rhs.handle<Vector>();
+
+  rhs.set_value(blockrow, ieq, value);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from)
+{
+  throw common::NotSupported(FromHere(), "tie_blockrow_pairs is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::set_diagonal(const std::vector<Real>& diag)
+{
+  throw common::NotSupported(FromHere(), "set_diagonal is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::add_diagonal(const std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(diag.size() == m_p2m.size());
+  if(m_added_diagonal.empty())
+    m_added_diagonal.assign(m_num_my_elements, 0.);
+
+  const Uint nb_col_entries = m_p2m.size();
+  for(Uint i = 0; i != nb_col_entries; ++i)
+  {
+    if(m_p2m[i] < m_num_my_elements)
+      m_added_diagonal[m_p2m[i]] += diag[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::get_diagonal(std::vector<Real>& diag)
+{
+  cf3_assert(m_is_created);
+  std::vector<Real> local_diag(m_num_my_elements);
+  if(m_num_my_elements != 0)
+    assemble(&local_diag[0], DIAGONAL);
+
+  if(!m_added_diagonal.empty())
+  {
+    for(int i = 0; i != m_num_my_elements; ++i)
+      local_diag[i] += m_added_diagonal[i];
+  }
+
+  for(std::map<int, Real>::const_iterator it = m_dirichlet_rows.begin(); it != m_dirichlet_rows.end(); ++it)
+    local_diag[it->first] = it->second;
+
+  const int nb_col_entries = m_p2m.size();
+  diag.resize(nb_col_entries);
+  for(Uint i = 0; i != nb_col_entries; ++i)
+  {
+    diag[i] = m_p2m[i] < m_num_my_elements ? local_diag[m_p2m[i]] : 0.;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::reset(Real reset_to)
+{
+  cf3_assert(m_is_created);
+  if(reset_to != 0.)
+    throw common::NotSupported(FromHere(), "Reset to a non-zero value is not supported for " + type_name());
+
+  m_dirichlet_rows.clear();
+  m_dirichlet_columns.clear();
+  m_pending_dirichlet_values.clear();
+  m_added_diagonal.clear();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::print(common::LogStream& stream)
+{
+  if (m_is_created)
+  {
+    stream << "# name:                 " << name() << "\n";
+    stream << "# type_name:            " << type_name() << "\n";
+    stream << "# process:              " << m_comm.MyPID() << "\n";
+    stream << "# number of equations:  " << m_neq << "\n";
+    stream << "# number of rows:       " << m_num_my_elements << "\n";
+    stream << "# number of cols:       " << m_p2m.size() << "\n";
+    stream << "# dirichlet rows:       " << m_dirichlet_rows.size() << "\n";
+    stream << "# assembly:             " << (is_null(m_assembly) ? std::string("none") : m_assembly->uri().path()) << "\n";
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::print(std::ostream& stream)
+{
+  if (m_is_created)
+  {
+    stream << "# name:                 " << name() << "\n";
+    stream << "# type_name:            " << type_name() << "\n";
+    stream << "# process:              " << m_comm.MyPID() << "\n";
+    stream << "# number of equations:  " << m_neq << "\n";
+    stream << "# number of rows:       " << m_num_my_elements << "\n";
+    stream << "# number of cols:       " << m_p2m.size() << "\n";
+    stream << "# dirichlet rows:       " << m_dirichlet_rows.size() << "\n";
+    stream << "# assembly:             " << (is_null(m_assembly) ? std::string("none") : m_assembly->uri().path()) << "\n";
+  } else {
+    stream << name() << " of type " << type_name() << "::is_created() is false, nothing is printed.";
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::print(const std::string& filename, std::ios_base::openmode mode )
+{
+  std::ofstream stream(filename.c_str(),mode);
+  print(stream);
+  stream.close();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::print_native(ostream& stream)
+{
+  print(stream);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::debug_data(std::vector<Uint>& row_indices, std::vector<Uint>& col_indices, std::vector<Real>& values)
+{
+  throw common::NotSupported(FromHere(), "debug_data is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Teuchos::RCP< const Thyra::LinearOpBase< Real > > TrilinosMatrixFree::thyra_operator() const
+{
+  cf3_assert(m_is_created);
+  return Thyra::epetraLinearOp(m_epetra_operator);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Teuchos::RCP< Thyra::LinearOpBase< Real > > TrilinosMatrixFree::thyra_operator()
+{
+  cf3_assert(m_is_created);
+  apply_pending_dirichlet();
+  return Thyra::nonconstEpetraLinearOp(m_epetra_operator);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::clone_to(Matrix &other)
+{
+  throw common::NotSupported(FromHere(), "clone_to is not supported for " + type_name());
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::apply ( const Handle< Vector >& y, const cf3::Handle< const Vector >& x, const Real alpha, const Real beta )
+{
+  cf3_assert(m_is_created);
+  apply_pending_dirichlet();
+  apply_matrix(*m_epetra_operator, y, x, alpha, beta);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::multiply(const Epetra_MultiVector& X, Epetra_MultiVector& Y)
+{
+  cf3_assert(m_is_created);
+  cf3_assert(X.NumVectors() == Y.NumVectors());
+  cf3_assert(X.MyLength() == m_num_my_elements);
+
+  const int nb_vectors = X.NumVectors();
+  for(int k = 0; k != nb_vectors; ++k)
+  {
+    const Epetra_Vector& x = *X(k);
+    Epetra_Vector& y = *Y(k);
+
+    TRILINOS_THROW(m_x_col->Import(x, *m_importer, Insert));
+    BOOST_FOREACH(const int col, m_dirichlet_columns)
+    {
+      (*m_x_col)[col] = 0.;
+    }
+
+    if(m_num_my_elements != 0)
+      assemble(y.Values(), PRODUCT);
+
+    if(!m_added_diagonal.empty())
+    {
+      for(int i = 0; i != m_num_my_elements; ++i)
+        y[i] += m_added_diagonal[i] * x[i];
+    }
+
+    for(std::map<int, Real>::const_iterator it = m_dirichlet_rows.begin(); it != m_dirichlet_rows.end(); ++it)
+      y[it->first] = it->second * x[it->first];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::assemble(Real* result, const AssemblyMode mode)
+{
+  if(is_null(m_assembly))
+    throw common::SetupError(FromHere(), "No assembly action set for matrix-free matrix " + uri().path());
+
+  std::fill(result, result + m_num_my_elements, 0.);
+  m_result = result;
+  m_x_values = m_x_col->Values();
+  m_mode = mode;
+  try
+  {
+    m_assembly->execute();
+  }
+  catch(...)
+  {
+    m_mode = IGNORE_VALUES;
+    throw;
+  }
+  m_mode = IGNORE_VALUES;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+void TrilinosMatrixFree::apply_pending_dirichlet()
+{
+  if(m_pending_dirichlet_values.empty())
+    return;
+
+  cf3_assert(is_not_null(m_dirichlet_rhs));
+  Epetra_Vector& epetra_rhs = *dynamic_cast<TrilinosVector&>(*m_dirichlet_rhs).epetra_vector();
+
+  // Product of the unconstrained operator with a vector containing only the prescribed values
+  m_x_col->PutScalar(0.);
+  for(std::map<int, Real>::const_iterator it = m_pending_dirichlet_values.begin(); it != m_pending_dirichlet_values.end(); ++it)
+    (*m_x_col)[it->first] = it->second;
+  m_pending_dirichlet_values.clear();
+
+  std::vector<Real> correction(m_num_my_elements);
+  if(m_num_my_elements != 0)
+    assemble(&correction[0], PRODUCT);
+
+  for(int i = 0; i != m_num_my_elements; ++i)
+  {
+    if(m_dirichlet_rows.count(i) == 0)
+      epetra_rhs[i] -= correction[i];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,255 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_Math_LSS_TrilinosMatrixFree_hpp
+#define cf3_Math_LSS_TrilinosMatrixFree_hpp
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <set>
+
+#include <Epetra_MpiComm.h>
+#include <Teuchos_RCP.hpp>
+
+#include "common/Action.hpp"
+
+#include "math/LSS/LibLSS.hpp"
+#include "math/LSS/BlockAccumulator.hpp"
+#include "math/LSS/Vector.hpp"
+#include "math/LSS/Matrix.hpp"
+
+#include "ThyraOperator.hpp"
+
+class Epetra_Import;
+class Epetra_Map;
+class Epetra_MultiVector;
+class Epetra_Operator;
+class Epetra_Vector;
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+  @file TrilinosMatrixFree.hpp definition of LSS::TrilinosMatrixFree
+**/
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace math {
+namespace LSS {
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+/// Matrix that stores no coefficients, but computes its product with a vector by running an assembly action.
+/// The action set in the "assembly" option is an element expression that adds the element matrices to this
+/// matrix, i.e. something like "system_matrix += _A". While the operator is applied, each call to add_values
+/// computes the product of the element matrix with the gathered values of the input vector, and scatters
+/// the result into the output vector, so the global matrix is never formed.
+/// The assembly action must not touch the RHS, since it is executed for every matrix-vector product.
+/// Outside of these products, add_values does nothing, so the normal assembly of the system only fills the RHS.
+/// Dirichlet conditions are applied on the fly as well. The RHS correction for symmetric Dirichlet conditions
+/// is computed with a single product, when the operator is requested for the solve.
+/// Since there are no coefficients, only solvers that just use the operator apply work, i.e. Krylov methods
+/// without preconditioner or with a preconditioner that only needs the diagonal.
+class LSS_API TrilinosMatrixFree : public LSS::Matrix, public ThyraOperator {
+public:
+
+  /// @name CREATION, DESTRUCTION AND COMPONENT SYSTEM
+  //@{
+
+  /// name of the type
+  static std::string type_name () { return "TrilinosMatrixFree"; }
+
+  /// Accessor to solver type
+  const std::string solvertype() { return "Trilinos"; }
+
+  /// Accessor to the flag if matrix, solution and rhs are tied together or not
+  const bool is_swappable(const LSS::Vector& solution, const LSS::Vector& rhs) { return true; }
+
+  /// Default constructor
+  TrilinosMatrixFree(const std::string& name);
+
+  /// Setup the row and column maps. The connectivity is not needed, since no sparsity structure is stored.
+  void create(cf3::common::PE::CommPattern& cp, const Uint neq, const std::vector<Uint>& node_connectivity, const std::vector<Uint>& starting_indices, LSS::Vector& solution, LSS::Vector& rhs, const std::vector<Uint>& periodic_links_nodes = std::vector<Uint>(), const std::vector<bool>& periodic_links_active = std::vector<bool>());
+  virtual void create_blocked(common::PE::CommPattern& cp, const VariablesDescriptor& vars, const std::vector< Uint >& node_connectivity, const std::vector< Uint >& starting_indices, Vector& solution, Vector& rhs, const std::vector<Uint>& periodic_links_nodes = std::vector<Uint>(), const std::vector<bool>& periodic_links_active = std::vector<bool>());
+
+  /// Deallocate underlying data
+  void destroy();
+
+  //@} END CREATION, DESTRUCTION AND COMPONENT SYSTEM
+
+  /// @name INDIVIDUAL ACCESS
+  /// Not supported, since there are no stored values
+  //@{
+
+  void set_value(const Uint icol, const Uint irow, const Real value);
+  void add_value(const Uint icol, const Uint irow, const Real value);
+  void get_value(const Uint icol, const Uint irow, Real& value);
+
+  //@} END INDIVIDUAL ACCESS
+
+  /// @name EFFICIENT ACCESS
+  //@{
+
+  /// Not supported, element matrices can only be added
+  void set_values(const BlockAccumulator& values);
+
+  /// Multiply the element matrix with the input vector and add it to the output vector, while the operator is applied.
+  /// Does nothing otherwise.
+  void add_values(const BlockAccumulator& values);
+
+  /// Not supported
+  void get_values(BlockAccumulator& values);
+
+  /// Replace the row with the diagonal value. Only a zero off-diagonal value is supported.
+  void set_row(const Uint iblockrow, const Uint ieq, Real diagval, Real offdiagval);
+
+  /// Not supported
+  void get_column_and_replace_to_zero(const Uint iblockcol, Uint ieq, std::vector<Real>& values);
+
+  /// Zero the row and column of the given equation, with 1 on the diagonal. The contribution of the column to the RHS
+  /// is subtracted when the operator is requested for the solve, for all Dirichlet conditions at once.
+  virtual void symmetric_dirichlet(const Uint blockrow, const Uint ieq, const Real value, Vector& rhs);
+
+  /// Not supported
+  void tie_blockrow_pairs (const Uint iblockrow_to, const Uint iblockrow_from);
+
+  /// Not supported
+  void set_diagonal(const std::vector<Real>& diag);
+
+  /// Add a diagonal, which is stored separately
+  void add_diagonal(const std::vector<Real>& diag);
+
+  /// Get the diagonal, by running the assembly once
+  void get_diagonal(std::vector<Real>& diag);
+
+  /// Remove the Dirichlet conditions and the added diagonal. Only a reset to zero is supported.
+  void reset(Real reset_to=0.);
+
+  //@} END EFFICIENT ACCESS
+
+  /// @name MISCELLANEOUS
+  //@{
+
+  /// Print a summary to wherever
+  void print(common::LogStream& stream);
+
+  /// Print a summary to wherever
+  void print(std::ostream& stream);
+
+  /// Print a summary to the file given by filename
+  void print(const std::string& filename, std::ios_base::openmode mode = std::ios_base::out );
+
+  void print_native(ostream& stream);
+
+  /// Accessor to the state of create
+  const bool is_created() { return m_is_created; }
+
+  /// Accessor to the number of equations
+  const Uint neq() { cf3_assert(m_is_created); return m_neq; }
+
+  /// Accessor to the number of block rows
+  const Uint blockrow_size() {  cf3_assert(m_is_created); return m_num_my_elements/neq(); }
+
+  /// Accessor to the number of block columns
+  const Uint blockcol_size() {  cf3_assert(m_is_created); return m_p2m.size()/neq(); }
+
+  //@} END MISCELLANEOUS
+
+  /// @name LINEAR ALGEBRA
+  //@{
+
+  /// Compute y = alpha*A*x + beta*y
+  void apply(const Handle<Vector>& y, const Handle<Vector const>& x, const Real alpha = 1., const Real beta = 0.);
+
+  //@} END LINEAR ALGEBRA
+
+  /// Not supported
+  void debug_data(std::vector<Uint>& row_indices, std::vector<Uint>& col_indices, std::vector<Real>& values);
+
+  /// Operator as it is, without applying the pending symmetric Dirichlet RHS corrections
+  virtual Teuchos::RCP< const Thyra::LinearOpBase< Real > > thyra_operator() const;
+
+  /// Operator for the solve. Applies the pending symmetric Dirichlet RHS corrections first.
+  virtual Teuchos::RCP< Thyra::LinearOpBase< Real > > thyra_operator();
+
+  /// Not supported
+  virtual void clone_to(Matrix &other);
+
+  /// Compute Y = A*X, for each vector in X. Used by the Epetra operator wrapping this matrix.
+  void multiply(const Epetra_MultiVector& X, Epetra_MultiVector& Y);
+
+private:
+
+  /// What add_values has to do
+  enum AssemblyMode { IGNORE_VALUES, PRODUCT, DIAGONAL };
+
+  /// Run the assembly action, storing the product with m_x_col or the diagonal in result, which has one entry per local row
+  void assemble(Real* result, const AssemblyMode mode);
+
+  /// Subtract the columns of the symmetric Dirichlet conditions, multiplied with the prescribed values, from the RHS
+  void apply_pending_dirichlet();
+
+  /// Action that adds the element matrices to this matrix
+  Handle<common::Action> m_assembly;
+
+  /// epetra mpi environment
+  Epetra_MpiComm m_comm;
+
+  /// Row map, ghosts not present
+  Teuchos::RCP<Epetra_Map> m_row_map;
+
+  /// Column map, has ghosts at the end
+  Teuchos::RCP<Epetra_Map> m_col_map;
+
+  /// Import from the row map to the column map, to get the ghost values of the input vector
+  Teuchos::RCP<Epetra_Import> m_importer;
+
+  /// Input vector including ghosts
+  Teuchos::RCP<Epetra_Vector> m_x_col;
+
+  /// Epetra operator calling multiply
+  Teuchos::RCP<Epetra_Operator> m_epetra_operator;
+
+  /// state of creation
+  bool m_is_created;
+
+  /// number of equations
+  Uint m_neq;
+
+  /// number of local elements (rows)
+  int m_num_my_elements;
+
+  /// mapper array, maps from process local numbering to matrix local numbering (because ghost nodes need to be ordered to the back)
+  std::vector<int> m_p2m;
+
+  /// Current behavior of add_values, and the data it uses
+  AssemblyMode m_mode;
+  Real* m_result;
+  const Real* m_x_values;
+
+  /// Diagonal values for the rows replaced by Dirichlet conditions, indexed by local matrix row
+  std::map<int, Real> m_dirichlet_rows;
+
+  /// Columns that are zeroed by symmetric Dirichlet conditions, indexed by local matrix column
+  std::set<int> m_dirichlet_columns;
+
+  /// Values of the symmetric Dirichlet conditions for which the RHS is not corrected yet, and the RHS to correct
+  std::map<int, Real> m_pending_dirichlet_values;
+  Handle<Vector> m_dirichlet_rhs;
+
+  /// Diagonal added using add_diagonal, indexed by local matrix row. Empty if nothing was added.
+  std::vector<Real> m_added_diagonal;
+}; // end of class TrilinosMatrixFree
+
+////////////////////////////////////////////////////////////////////////////////////////////
+
+} // namespace LSS
+} // namespace math
+} // namespace cf3
+
+#endif // cf3_Math_LSS_TrilinosMatrixFree_hpp
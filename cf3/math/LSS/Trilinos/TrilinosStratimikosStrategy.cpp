@@ -27,12 +27,14 @@
 #include "common/Builder.hpp"
 #include "common/EventHandler.hpp"
 #include "common/OptionList.hpp"
+#include "common/Timer.hpp"
 
 #include "ParameterList.hpp"
 #include "ThyraVector.hpp"
 #include "ThyraOperator.hpp"
 #include "TrilinosStratimikosStrategy.hpp"
 #include "ParameterListDefaults.hpp"
+#include "PreconditionerReusePolicy.hpp"
 #include "TrilinosVector.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////////////////
@@ -54,8 +56,7 @@ struct TrilinosStratimikosStrategy::Implementation
   Implementation(common::Component& self) :
     m_self(self),
     m_parameter_list(Teuchos::createParameterList()),
-    m_preconditioner_reset(1),
-    m_iteration_count(0),
+    m_reuse_policy(self, 1),
     m_xcoords(0)
   {
     Teko::addTekoToStratimikosBuilder(m_linear_solver_builder);
@@ -76,12 +77,6 @@ struct TrilinosStratimikosStrategy::Implementation
       .pretty_name("Print Settings")
       .description("Print out the solver settings upon first solve")
       .mark_basic();
-      
-    m_self.options().add("preconditioner_reset", m_preconditioner_reset)
-      .pretty_name("Preconditioner Reset")
-      .description("Number of iterations after which the preconditioner is reset")
-      .mark_basic()
-      .link_to(&m_preconditioner_reset);
 
     m_self.options().add("settings_file", common::URI("", cf3::common::URI::Scheme::FILE))
       .supported_protocol(cf3::common::URI::Scheme::FILE)
@@ -129,7 +124,7 @@ struct TrilinosStratimikosStrategy::Implementation
 
     // Update the component tree that represents the parameters. This automatically exposes available options
     update_parameters();
-    m_iteration_count = 0;
+    m_reuse_policy.reset();
   }
 
   void solve()
@@ -143,16 +138,19 @@ struct TrilinosStratimikosStrategy::Implementation
     if(is_null(m_solution))
       throw common::SetupError(FromHere(), "Null solution vector for " + m_self.uri().path());
 
+    bool recompute = m_reuse_policy.recompute();
     if(m_lows.is_null())
     {
       if(m_self.options().option("print_settings").value<bool>())
         m_parameter_list->print();
 
       m_lows = m_lows_factory->createOp();
+      recompute = true;
     }
 
-    
-    if(m_iteration_count % m_preconditioner_reset == 0)
+    // Recomputing keeps the preconditioner structure where the preconditioner factory supports it, and only updates the numerical values
+    common::WallTimer timer;
+    if(recompute)
     {
       Thyra::initializeOp(*m_lows_factory, m_matrix->thyra_operator(), m_lows.ptr());
     }
@@ -160,24 +158,43 @@ struct TrilinosStratimikosStrategy::Implementation
     {
       Thyra::initializeAndReuseOp(*m_lows_factory, m_matrix->thyra_operator(), m_lows.ptr());
     }
+    m_reuse_policy.setup_done(recompute, timer.elapsed());
 
     Teuchos::RCP< Thyra::VectorBase<Real> const > b = m_rhs->thyra_vector();
     Teuchos::RCP< Thyra::VectorBase<Real> > x = m_solution->thyra_vector();
     
+    timer.restart();
+    Uint iterations = 0;
     try
     {
       Thyra::SolveStatus<double> status = Thyra::solve<double>(*m_lows, Thyra::NOTRANS, *b, x.ptr());
       CFinfo << "Thyra::solve finished with status " << status.message << CFendl;
+      iterations = iteration_count(status);
     }
     catch(std::exception& e)
     {
       std::cout << e.what() << std::endl;
     }
+    m_reuse_policy.solve_done(iterations, timer.elapsed());
     
     if(m_self.options().option("compute_residual").value<bool>())
       CFinfo << "Solver residual: " << compute_residual() << CFendl;
-    
-    ++m_iteration_count;
+  }
+
+  /// Number of iterations reported by the solver, or 0 if it is unknown
+  static Uint iteration_count(const Thyra::SolveStatus<double>& status)
+  {
+    if(status.extraParameters.is_null())
+      return 0;
+
+    static const char* count_names[] = { "Belos/Iteration Count", "AztecOO/Iteration Count" };
+    for(Uint i = 0; i != 2; ++i)
+    {
+      if(status.extraParameters->isType<int>(count_names[i]))
+        return status.extraParameters->get<int>(count_names[i]);
+    }
+
+    return 0;
   }
 
   Real compute_residual()
@@ -247,8 +264,8 @@ struct TrilinosStratimikosStrategy::Implementation
   Teuchos::RCP< Thyra::VectorBase<Real> > m_residual_vec;
   Handle<ParameterList> m_parameters;
   
-  Uint m_preconditioner_reset;
-  Uint m_iteration_count;
+  /// Decides when the preconditioner is recomputed
+  PreconditionerReusePolicy m_reuse_policy;
   
   Real* m_xcoords;
   Real* m_ycoords;
@@ -47,7 +47,6 @@ TrilinosVector::TrilinosVector(const std::string& name) :
   m_blockrow_size(0),
   m_is_created(false),
   m_vec(0),
-  m_converted_indices(0),
   m_comm(common::PE::Comm::instance().communicator())
 {
   regist_signal( "print_native" )
@@ -172,8 +171,6 @@ void TrilinosVector::set_rhs_values(const BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.rhs[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -189,8 +186,6 @@ void TrilinosVector::add_rhs_values(const BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.rhs[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -208,8 +203,6 @@ void TrilinosVector::get_rhs_values(BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.rhs[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -227,8 +220,6 @@ void TrilinosVector::set_sol_values(const BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.sol[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -246,8 +237,6 @@ void TrilinosVector::add_sol_values(const BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.sol[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -265,8 +254,6 @@ void TrilinosVector::get_sol_values(BlockAccumulator& values)
   /// @note looked up the code and access mechanism is a mess, much less cpu to access here in a for loop and directly do whats desired
   cf3_assert(m_is_created);
   const int numblocks=values.indices.size();
-  if (m_converted_indices.size()<numblocks) m_converted_indices.resize(numblocks);
-  int *conv=&m_converted_indices[0];
   double *vals=(double*)&values.sol[0];
   for (int i=0; i<(const int)numblocks; i++)
   {
@@ -420,7 +407,6 @@ void TrilinosVector::clone_to(Vector &other)
   other_ptr->m_blockrow_size = m_blockrow_size;
   other_ptr->m_is_created = m_is_created;
   other_ptr->m_p2m = m_p2m;
-  other_ptr->m_converted_indices = m_converted_indices;
   other_ptr->m_comm_pattern = m_comm_pattern;
   m_comm_pattern->insert(other_ptr->name(), other_ptr->m_data, true);
 }
@@ -482,6 +468,24 @@ void TrilinosVector::scale ( const Real alpha )
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////
+
+Real TrilinosVector::dot ( const Vector& other )
+{
+  TrilinosVector const* other_ptr = dynamic_cast<TrilinosVector const*>(&other);
+
+  if(is_null(other_ptr))
+    throw common::SetupError(FromHere(), "dot method of TrilinosVector needs another TrilinosVector, but a " + other.derived_type_name() + " was supplied instead.");
+
+  if(other_ptr->m_data.size() != m_data.size())
+    throw common::SetupError(FromHere(), "dot method of TrilinosVector got a vector with incorrect size");
+
+  // The epetra vectors only contain the owned rows, and Dot sums over all processes
+  Real result = 0.;
+  m_vec->Dot(*other_ptr->m_vec, &result);
+  return result;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////
 
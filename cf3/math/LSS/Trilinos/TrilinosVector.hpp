@@ -163,6 +163,8 @@ public:
   
   void scale ( const Real alpha );
 
+  Real dot ( const Vector& other );
+
   void sync();
 
   //@} END MISCELLANEOUS
@@ -206,9 +208,6 @@ private:
   /// mapper array, maps from process local numbering to matrix local numbering (because ghost nodes need to be ordered to the back)
   std::vector<int> m_p2m;
 
-  /// a helper array used in set/add/get_values to avoid frequent new+free combo
-  std::vector<int> m_converted_indices;
-
   /// The comm pattern is kept as shared ptr, so it can be shared between any clones of this vector.
   boost::shared_ptr<common::PE::CommPattern> m_comm_pattern;
 };
@@ -153,6 +153,9 @@ public:
   /// this *= alpha
   virtual void scale(const Real alpha) = 0;
 
+  /// Dot product with another vector, summed over all processes. Ghost rows are not counted.
+  virtual Real dot(const Vector& other) = 0;
+
   /// Update any stored ghost nodes
   virtual void sync() = 0;
 
@@ -6,6 +6,12 @@
 
 #include <boost/tokenizer.hpp>
 
+#include "coolfluid-packages.hpp"
+
+#ifdef CF3_HAVE_OPENMP
+  #include <omp.h>
+#endif
+
 #include "common/Log.hpp"
 #include "common/BasicExceptions.hpp"
 #include "common/StringConversion.hpp"
@@ -171,6 +177,9 @@ void VectorialFunction::parse()
       msg += " Vars: ["    + m_vars + "]";
       throw common::ParsingFailed (FromHere(),msg);
     }
+
+    // Reduce the bytecode, e.g. by folding constants, since functions are typically evaluated for every node
+    ptr->Optimize();
   }
 
   m_result.resize(m_functions.size());
@@ -179,6 +188,64 @@ void VectorialFunction::parse()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void VectorialFunction::evaluate_batch(const ArrayT& var_values, const VariablesT& constant_values, ArrayT& ret_values) const
+{
+  cf3_assert(m_is_parsed);
+
+  const Uint nb_points = var_values.size();
+  const Uint nb_point_vars = var_values.shape()[1];
+  const Uint nb_funcs = m_parsers.size();
+
+  if(nb_point_vars + constant_values.size() != m_nbvars)
+    throw BadValue(FromHere(), "Batch evaluation of [" + m_vars + "] with " + to_str(nb_point_vars) + " variables per point and " + to_str(constant_values.size()) + " constant variables");
+  if(ret_values.size() != nb_points || (nb_points != 0 && ret_values.shape()[1] != nb_funcs))
+    throw BadValue(FromHere(), "Batch evaluation of " + to_str(nb_funcs) + " functions for " + to_str(nb_points) + " points can't be stored in an array of shape "
+                   + to_str(ret_values.size()) + "x" + to_str(ret_values.shape()[1]));
+
+  const int nb_points_int = nb_points;
+
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel if(nb_points > 1000)
+#endif
+  {
+    // FunctionParser::Eval uses a stack that is stored in the parser, so each thread needs its own copy
+    std::vector<FunctionParser> parsers;
+#ifdef CF3_HAVE_OPENMP
+    if(omp_get_num_threads() > 1)
+    {
+      parsers.reserve(nb_funcs);
+      for(Uint f = 0; f != nb_funcs; ++f)
+      {
+        parsers.push_back(*m_parsers[f]);
+        parsers.back().ForceDeepCopy();
+      }
+    }
+#endif
+
+    VariablesT variables(std::max(m_nbvars, 1u));
+    std::copy(constant_values.begin(), constant_values.end(), variables.begin() + nb_point_vars);
+
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp for schedule(static)
+#endif
+    for(int pt = 0; pt < nb_points_int; ++pt)
+    {
+      ArrayT::const_reference point_values = var_values[pt];
+      for(Uint v = 0; v != nb_point_vars; ++v)
+        variables[v] = point_values[v];
+
+      ArrayT::reference result = ret_values[pt];
+      for(Uint f = 0; f != nb_funcs; ++f)
+      {
+        // It is possible this function signals a FloatingPointException (FPE)
+        result[f] = parsers.empty() ? m_parsers[f]->Eval(&variables[0]) : parsers[f].Eval(&variables[0]);
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 RealVector& VectorialFunction::operator()( const VariablesT& var_values)
 {
   cf3_assert(m_is_parsed);
@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <boost/multi_array.hpp>
+
 #include "fparser/fparser.hh"
 
 #include "common/BasicExceptions.hpp"
@@ -34,6 +36,9 @@ public: // functions
   /// Variable storage
   typedef std::vector<Real> VariablesT;
 
+  /// Storage for batch evaluation, one row per point. This is the array type of common::Table<Real>.
+  typedef boost::multi_array<Real,2> ArrayT;
+
   /// Empty constructor
   VectorialFunction();
 
@@ -59,6 +64,16 @@ public: // functions
   template <typename var_t, typename ret_t>
   void evaluate( const var_t& var_values, ret_t& ret_value) const;
 
+  /// Evaluate the Vectorial Function for a batch of points, e.g. all nodes of a field.
+  /// The values of the first variables are given by the columns of var_values, one row per point.
+  /// The remaining variables (e.g. the time) have the same values for all points, given by constant_values.
+  /// The points are divided over the threads if OpenMP is enabled.
+  /// @param var_values values of the point-dependent variables, one row per point
+  /// @param constant_values values of the variables that are the same for all points
+  /// @param ret_values the placeholder for the result, with one row per point and one column per function
+  /// @throw BadValue if the sizes don't match the number of variables and functions
+  void evaluate_batch(const ArrayT& var_values, const VariablesT& constant_values, ArrayT& ret_values) const;
+
   /// Evaluate the Vectorial Function given the values of the variables
   /// and return it in the stored result. This function allows this class to work
   /// as a functor.
@@ -87,6 +102,7 @@ public: // functions
   void variables( const std::string& vars );
 
   /// Parse the strings to extract the functions for each line of the vector.
+  /// The parsed functions are simplified by the function parser optimizer, so repeated evaluation is cheaper.
   /// @throw ParsingFailed if there is an error while parsing
   void parse ();
 
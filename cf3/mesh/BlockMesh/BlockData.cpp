@@ -737,7 +737,7 @@ struct BlockArrays::Implementation
   /// Copy back data from a partitioning structure
   void update_blocks(const BlocksPartitioning& blocks_partitioning)
   {
-    print_vector(CFdebug << "Printing partitioning data for block distribution ", blocks_partitioning.block_distribution);
+    print_vector(Logger::instance().Debug(FromHere()) << "Printing partitioning data for block distribution ", blocks_partitioning.block_distribution);
     CFdebug << CFendl;
     const Uint nb_points = blocks_partitioning.points.size();
     points->resize(nb_points);
@@ -746,7 +746,7 @@ struct BlockArrays::Implementation
     {
       points->set_row(i, blocks_partitioning.points[i]);
 
-      print_vector(CFdebug << "  " << i << ": ", blocks_partitioning.points[i]);
+      print_vector(Logger::instance().Debug(FromHere()) << "  " << i << ": ", blocks_partitioning.points[i]);
       CFdebug << CFendl;
     }
 
@@ -761,8 +761,8 @@ struct BlockArrays::Implementation
       block_subdivisions->set_row(i, blocks_partitioning.block_subdivisions[i]);
       block_gradings->set_row(i, blocks_partitioning.block_gradings[i]);
 
-      print_vector(CFdebug << "  " << i << ": ", blocks_partitioning.block_points[i]);
-      print_vector(CFdebug << " (", blocks_partitioning.block_subdivisions[i]);
+      print_vector(Logger::instance().Debug(FromHere()) << "  " << i << ": ", blocks_partitioning.block_points[i]);
+      print_vector(Logger::instance().Debug(FromHere()) << " (", blocks_partitioning.block_subdivisions[i]);
       CFdebug  << ")" << CFendl;
     }
 
@@ -778,7 +778,7 @@ struct BlockArrays::Implementation
         (*patch_tbl) << blocks_partitioning.patch_points[i][j];
       patch_tbl->seekp(0);
 
-      print_vector(CFdebug << "  " << blocks_partitioning.patch_names[i] << ": ", blocks_partitioning.patch_points[i]);
+      print_vector(Logger::instance().Debug(FromHere()) << "  " << blocks_partitioning.patch_names[i] << ": ", blocks_partitioning.patch_points[i]);
       CFdebug << CFendl;
     }
 
@@ -993,7 +993,7 @@ struct BlockArrays::Implementation
       BlockLayer layer;
       build_block_layer(direction, start_direction, transverse_directions, existing_partition, layer);
 
-      print_vector(CFdebug << "Examining block layer: ", layer.local_layer); CFdebug << CFendl;
+      print_vector(Logger::instance().Debug(FromHere()) << "Examining block layer: ", layer.local_layer); CFdebug << CFendl;
 
       // Size of one partition
       const Uint partition_size = static_cast<Uint>( ceil( static_cast<Real>(global_nb_elements) / static_cast<Real>(nb_partitions) ) );
@@ -1146,7 +1146,7 @@ struct BlockArrays::Implementation
           {
             block_layer_offset = 0;
             build_block_layer(direction, start_direction, transverse_directions, existing_partition, layer);
-            print_vector(CFdebug << "Examining block layer: ", layer.local_layer); CFdebug << CFendl;
+            print_vector(Logger::instance().Debug(FromHere()) << "Examining block layer: ", layer.local_layer); CFdebug << CFendl;
           }
         }
       }
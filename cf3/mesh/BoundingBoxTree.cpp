@@ -0,0 +1,433 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+#include "common/FindComponents.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/OptionComponent.hpp"
+
+#include "math/Consts.hpp"
+
+#include "mesh/BoundingBoxTree.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/ElementType.hpp"
+#include "mesh/Space.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+cf3::common::ComponentBuilder < BoundingBoxTree, Component, LibMesh > BoundingBoxTree_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  /// Tolerance added to the element bounding boxes, consistent with ElementType::is_coord_in_element
+  const Real box_tolerance = 1e-6;
+
+  /// Maximum depth of the tree, which is far more than needed for a median split
+  const Uint max_depth = 128;
+
+  /// Number of bits per direction used for the Hilbert sort of queries
+  const Uint hilbert_bits[4] = { 0, 21, 21, 21 };
+
+  /// Orders element indices by their centroid in one direction
+  struct CentroidLess
+  {
+    CentroidLess(const std::vector<Real>& centroids, const Uint dim, const Uint direction) :
+      m_centroids(centroids), m_dim(dim), m_direction(direction) {}
+
+    bool operator()(const Uint a, const Uint b) const
+    {
+      return m_centroids[a*m_dim+m_direction] < m_centroids[b*m_dim+m_direction];
+    }
+
+    const std::vector<Real>& m_centroids;
+    const Uint m_dim;
+    const Uint m_direction;
+  };
+
+  /// Range of elements still to be assigned to a node during construction
+  struct BuildTask
+  {
+    BuildTask(const Uint n, const Uint b, const Uint e) : node(n), begin(b), end(e) {}
+    Uint node;
+    Uint begin;
+    Uint end;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BoundingBoxTree::BoundingBoxTree( const std::string& name )
+  : Component(name), m_dim(0)
+{
+  options().add("mesh", m_mesh)
+      .description("Mesh to create the tree from")
+      .pretty_name("Mesh")
+      .mark_basic()
+      .link_to(&m_mesh);
+
+  options().add( "nb_elems_per_leaf", 8u )
+      .description("The maximum number of elements in a leaf of the tree")
+      .pretty_name("Number of Elements per Leaf");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void BoundingBoxTree::create_tree()
+{
+  if (is_null(m_mesh))
+    throw SetupError(FromHere(), "Option \"mesh\" has not been configured");
+
+  m_dim = m_mesh->dimension();
+  cf3_assert(m_dim <= 3);
+  const Uint nb_elems_per_leaf = std::max(1u, options().value<Uint>("nb_elems_per_leaf"));
+
+  // Collect the elements with their bounding box and centroid
+  std::vector<Entity> elements;
+  std::vector<Real> boxes;
+  std::vector<Real> centroids;
+  RealVector centroid(m_dim);
+  boost_foreach (Elements& elements_comp, find_components_recursively_with_filter<Elements>(*m_mesh,IsElementsVolume()))
+  {
+    RealMatrix coordinates;
+    elements_comp.geometry_space().allocate_coordinates(coordinates);
+    for (Uint elem_idx=0; elem_idx<elements_comp.size(); ++elem_idx)
+    {
+      elements_comp.geometry_space().put_coordinates(coordinates,elem_idx);
+      elements_comp.element_type().compute_centroid(coordinates,centroid);
+      elements.push_back(Entity(elements_comp,elem_idx));
+      for (Uint d=0; d<m_dim; ++d)
+        boxes.push_back(coordinates.col(d).minCoeff() - box_tolerance);
+      for (Uint d=0; d<m_dim; ++d)
+        boxes.push_back(coordinates.col(d).maxCoeff() + box_tolerance);
+      for (Uint d=0; d<m_dim; ++d)
+        centroids.push_back(centroid[d]);
+    }
+  }
+
+  const Uint nb_elems = elements.size();
+  std::vector<Uint> order(nb_elems);
+  for (Uint e=0; e<nb_elems; ++e)
+    order[e] = e;
+
+  m_nodes.clear();
+  if (nb_elems == 0)
+  {
+    m_elements.clear();
+    m_element_boxes.clear();
+    m_centroids.clear();
+    return;
+  }
+  m_nodes.reserve(2*(nb_elems/nb_elems_per_leaf+1));
+  m_nodes.push_back(Node());
+
+  std::vector<BuildTask> tasks(1, BuildTask(0, 0, nb_elems));
+  while (!tasks.empty())
+  {
+    const BuildTask task = tasks.back();
+    tasks.pop_back();
+
+    // Bounding box of the node, and of the centroids in it
+    Node& node = m_nodes[task.node];
+    std::vector<Real> cmin(m_dim, math::Consts::real_max());
+    std::vector<Real> cmax(m_dim, -math::Consts::real_max());
+    for (Uint d=0; d<3; ++d)
+    {
+      node.min[d] = d<m_dim ?  math::Consts::real_max() : 0.;
+      node.max[d] = d<m_dim ? -math::Consts::real_max() : 0.;
+    }
+    for (Uint i=task.begin; i<task.end; ++i)
+    {
+      const Uint e = order[i];
+      for (Uint d=0; d<m_dim; ++d)
+      {
+        node.min[d] = std::min(node.min[d], boxes[2*m_dim*e+d]);
+        node.max[d] = std::max(node.max[d], boxes[2*m_dim*e+m_dim+d]);
+        cmin[d] = std::min(cmin[d], centroids[m_dim*e+d]);
+        cmax[d] = std::max(cmax[d], centroids[m_dim*e+d]);
+      }
+    }
+
+    Uint direction = 0;
+    for (Uint d=1; d<m_dim; ++d)
+    {
+      if (cmax[d]-cmin[d] > cmax[direction]-cmin[direction])
+        direction = d;
+    }
+
+    // Make a leaf if the node is small enough, or if the elements can't be separated
+    if (task.end-task.begin <= nb_elems_per_leaf || cmax[direction] <= cmin[direction])
+    {
+      node.first = task.begin;
+      node.nb_elements = task.end-task.begin;
+      continue;
+    }
+
+    const Uint middle = task.begin + (task.end-task.begin)/2;
+    std::nth_element(order.begin()+task.begin, order.begin()+middle, order.begin()+task.end, CentroidLess(centroids, m_dim, direction));
+
+    const Uint first_child = m_nodes.size();
+    node.first = first_child;
+    node.nb_elements = 0;
+    // node is invalidated from here on
+    m_nodes.push_back(Node());
+    m_nodes.push_back(Node());
+    tasks.push_back(BuildTask(first_child,   task.begin, middle));
+    tasks.push_back(BuildTask(first_child+1, middle,     task.end));
+  }
+
+  // Store the elements in the order of the leaves
+  m_elements.resize(nb_elems);
+  m_element_boxes.resize(2*m_dim*nb_elems);
+  m_centroids.resize(m_dim*nb_elems);
+  for (Uint i=0; i<nb_elems; ++i)
+  {
+    const Uint e = order[i];
+    m_elements[i] = elements[e];
+    std::copy(boxes.begin()+2*m_dim*e, boxes.begin()+2*m_dim*(e+1), m_element_boxes.begin()+2*m_dim*i);
+    std::copy(centroids.begin()+m_dim*e, centroids.begin()+m_dim*(e+1), m_centroids.begin()+m_dim*i);
+  }
+
+  CFdebug << "BoundingBoxTree: " << m_nodes.size() << " nodes for " << nb_elems << " elements" << CFendl;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool BoundingBoxTree::find_element(const RealVector& target_coord, Entity& element) const
+{
+  cf3_assert(is_created());
+  cf3_assert(target_coord.size() >= static_cast<int>(m_dim));
+
+  Uint stack[max_depth+1];
+  Uint stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size)
+  {
+    const Uint node_idx = stack[--stack_size];
+    if (distance_to_node(target_coord, node_idx) > 0.)
+      continue;
+
+    const Node& node = m_nodes[node_idx];
+    if (node.nb_elements == 0)
+    {
+      cf3_assert(stack_size+2 <= max_depth+1);
+      stack[stack_size++] = node.first+1;
+      stack[stack_size++] = node.first;
+      continue;
+    }
+
+    for (Uint e=node.first; e<node.first+node.nb_elements; ++e)
+    {
+      const Real* box = &m_element_boxes[2*m_dim*e];
+      bool in_box = true;
+      for (Uint d=0; d<m_dim && in_box; ++d)
+        in_box = target_coord[d] >= box[d] && target_coord[d] <= box[m_dim+d];
+      if (!in_box)
+        continue;
+
+      const Entity& candidate = m_elements[e];
+      if (candidate.element_type().is_coord_in_element(target_coord,candidate.get_coordinates()))
+      {
+        element = candidate;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool BoundingBoxTree::find_closest_element(const RealVector& target_coord, Entity& element) const
+{
+  cf3_assert(is_created());
+  if (distance_to_node(target_coord, 0) > 0.)
+    return false;
+
+  // Depth-first search, skipping nodes that are further away than the closest centroid so far.
+  // The element bounding boxes contain their centroid, so the distance to a node is a lower bound.
+  Real closest = math::Consts::real_max();
+  int closest_idx = -1;
+  Uint stack[max_depth+1];
+  Uint stack_size = 0;
+  stack[stack_size++] = 0;
+  while (stack_size)
+  {
+    const Uint node_idx = stack[--stack_size];
+    if (distance_to_node(target_coord, node_idx) >= closest)
+      continue;
+
+    const Node& node = m_nodes[node_idx];
+    if (node.nb_elements == 0)
+    {
+      // Visit the nearest child first
+      Uint near = node.first, far = node.first+1;
+      if (distance_to_node(target_coord, far) < distance_to_node(target_coord, near))
+        std::swap(near, far);
+      cf3_assert(stack_size+2 <= max_depth+1);
+      stack[stack_size++] = far;
+      stack[stack_size++] = near;
+      continue;
+    }
+
+    for (Uint e=node.first; e<node.first+node.nb_elements; ++e)
+    {
+      Real distance = 0.;
+      for (Uint d=0; d<m_dim; ++d)
+        distance += (target_coord[d]-m_centroids[m_dim*e+d])*(target_coord[d]-m_centroids[m_dim*e+d]);
+      if (distance < closest)
+      {
+        closest = distance;
+        closest_idx = e;
+      }
+    }
+  }
+
+  if (closest_idx < 0)
+    return false;
+  element = m_elements[closest_idx];
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Uint BoundingBoxTree::find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<Entity>& elements, const bool closest) const
+{
+  const Uint nb_coords = coordinates.size();
+  elements.assign(nb_coords, Entity());
+  if (nb_coords == 0 || !is_created())
+    return 0;
+
+  const Uint coord_dim = std::min(m_dim, Uint(coordinates.shape()[1]));
+
+  // Sort the coordinates along a Hilbert curve through the root bounding box
+  const Node& root = m_nodes[0];
+  const Uint bits = hilbert_bits[m_dim];
+  const Real max_int = Real((1u << bits) - 1u);
+  std::vector< std::pair<boost::uint64_t,Uint> > order(nb_coords);
+  std::vector<Uint> point(m_dim, 0u);
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    for (Uint d=0; d<coord_dim; ++d)
+    {
+      const Real extent = root.max[d]-root.min[d];
+      const Real s = extent > 0. ? (coordinates[i][d]-root.min[d])/extent : 0.;
+      point[d] = Uint(std::min(std::max(s, 0.), 1.)*max_int);
+    }
+    order[i] = std::make_pair(hilbert_key(point, bits), i);
+  }
+  std::sort(order.begin(), order.end());
+
+  const int nb_coords_int = static_cast<int>(nb_coords);
+  int nb_found = 0;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 64) reduction(+:nb_found)
+#endif
+  for (int k=0; k<nb_coords_int; ++k)
+  {
+    const Uint i = order[k].second;
+    RealVector coord = RealVector::Zero(m_dim);
+    for (Uint d=0; d<coord_dim; ++d)
+      coord[d] = coordinates[i][d];
+    Entity element;
+    if (find_element(coord, element) || (closest && find_closest_element(coord, element)))
+    {
+      elements[i] = element;
+      ++nb_found;
+    }
+  }
+  return nb_found;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+boost::uint64_t BoundingBoxTree::hilbert_key(const std::vector<Uint>& point, const Uint bits)
+{
+  // Transpose form of the Hilbert index, following J. Skilling, "Programming the Hilbert curve",
+  // AIP Conference Proceedings 707, 2004
+  const Uint dim = point.size();
+  cf3_assert(dim*bits <= 64u);
+  std::vector<Uint> x(point);
+  if (dim == 0 || bits == 0)
+    return 0;
+
+  const Uint M = 1u << (bits-1);
+
+  // Inverse undo
+  for (Uint Q=M; Q>1; Q>>=1)
+  {
+    const Uint P = Q-1;
+    for (Uint i=0; i<dim; ++i)
+    {
+      if (x[i] & Q)
+      {
+        x[0] ^= P;
+      }
+      else
+      {
+        const Uint t = (x[0] ^ x[i]) & P;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+
+  // Gray encode
+  for (Uint i=1; i<dim; ++i)
+    x[i] ^= x[i-1];
+  Uint t = 0;
+  for (Uint Q=M; Q>1; Q>>=1)
+  {
+    if (x[dim-1] & Q)
+      t ^= Q-1;
+  }
+  for (Uint i=0; i<dim; ++i)
+    x[i] ^= t;
+
+  // Interleave the bits, most significant first
+  boost::uint64_t key = 0;
+  for (int b=int(bits)-1; b>=0; --b)
+  {
+    for (Uint i=0; i<dim; ++i)
+      key = (key << 1) | ((x[i] >> b) & 1u);
+  }
+  return key;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Real BoundingBoxTree::distance_to_node(const RealVector& target_coord, const Uint node_idx) const
+{
+  const Node& node = m_nodes[node_idx];
+  Real distance = 0.;
+  for (Uint d=0; d<m_dim; ++d)
+  {
+    if (target_coord[d] < node.min[d])
+      distance += (node.min[d]-target_coord[d])*(node.min[d]-target_coord[d]);
+    else if (target_coord[d] > node.max[d])
+      distance += (target_coord[d]-node.max[d])*(target_coord[d]-node.max[d]);
+  }
+  return distance;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
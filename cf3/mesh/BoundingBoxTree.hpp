@@ -0,0 +1,119 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_BoundingBoxTree_hpp
+#define cf3_mesh_BoundingBoxTree_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <boost/cstdint.hpp>
+
+#include "common/Component.hpp"
+#include "common/BoostArray.hpp"
+
+#include "mesh/Entities.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  class Mesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Bounding volume hierarchy over the bounding boxes of the volume elements of a mesh
+///
+/// The tree is built by recursively splitting the elements at the median of their centroids,
+/// along the direction in which the centroids are most spread out. Contrary to the uniform grid
+/// of Octtree, the depth of the tree adapts to the element density, so that strongly graded meshes
+/// do not pile up many elements in a few cells.
+/// All nodes are stored in one flat array, and the elements are reordered so that each leaf
+/// refers to a contiguous range of them. Queries only read the tree, so they can run concurrently.
+class Mesh_API BoundingBoxTree : public common::Component
+{
+public: // functions
+
+  /// constructor
+  BoundingBoxTree( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "BoundingBoxTree"; }
+
+  /// Build the tree from the volume elements of the configured mesh
+  void create_tree();
+
+  bool is_created() const { return !m_nodes.empty(); }
+
+  Uint dimension() const { return m_dim; }
+
+  /// @brief Find which element contains a given coordinate
+  /// @return if element was found
+  bool find_element(const RealVector& target_coord, Entity& element) const;
+
+  /// @brief Find the element with the centroid closest to the given coordinate
+  /// Only coordinates inside the bounding box of the tree are considered.
+  /// @return if element was found
+  bool find_closest_element(const RealVector& target_coord, Entity& element) const;
+
+  /// @brief Find the elements containing each row of coordinates
+  ///
+  /// The coordinates are processed in the order of a Hilbert curve through the bounding box
+  /// of the tree, so that consecutive queries visit the same branches, and in parallel if
+  /// OpenMP is enabled.
+  /// @param [in]  coordinates  One coordinate per row
+  /// @param [out] elements     The element for each coordinate, with a null component if not found
+  /// @param [in]  closest      Fall back to find_closest_element for coordinates that are not inside any element
+  /// @return the number of coordinates for which an element was found
+  Uint find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<Entity>& elements, const bool closest = false) const;
+
+  /// Position of a point along a Hilbert curve, with each coordinate given as an integer of the given number of bits
+  /// (at most 21 in 3D)
+  static boost::uint64_t hilbert_key(const std::vector<Uint>& point, const Uint bits);
+
+private: // functions
+
+  /// Squared distance from the coordinate to the bounding box of a node, 0 if inside
+  Real distance_to_node(const RealVector& target_coord, const Uint node_idx) const;
+
+private: // data
+
+  /// Node of the tree
+  struct Node
+  {
+    Real min[3];
+    Real max[3];
+    /// For a leaf the first element, otherwise the first child (the second child follows it)
+    Uint first;
+    /// The number of elements of a leaf, 0 for other nodes
+    Uint nb_elements;
+  };
+
+  Handle<Mesh> m_mesh;
+
+  Uint m_dim;
+
+  std::vector<Node> m_nodes;
+
+  /// Elements, in the order of the leaves
+  std::vector<Entity> m_elements;
+
+  /// Bounding box of each element as min followed by max, 2*m_dim values per element
+  std::vector<Real> m_element_boxes;
+
+  /// Centroid of each element, m_dim values per element
+  std::vector<Real> m_centroids;
+
+}; // end BoundingBoxTree
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_BoundingBoxTree_hpp
@@ -14,7 +14,7 @@
 #include "common/EventHandler.hpp"
 #include "common/StringConversion.hpp"
 #include "common/Tags.hpp"
-#include "common/DynTable.hpp"
+#include "common/RaggedTable.hpp"
 #include "common/List.hpp"
 #include "common/PE/Comm.hpp"
 #include "common/PE/CommPattern.hpp"
@@ -309,10 +309,8 @@ void ContinuousDictionary::rebuild_spaces_from_geometry()
 
 void ContinuousDictionary::rebuild_node_to_element_connectivity()
 {
-  // Reserve memory in m_connectivity->array()
-  m_connectivity->array().resize(size());
-
-  std::vector<Uint> connectivity_sizes(size());
+  // Count the elements connected to each node
+  RaggedTable<SpaceElem>::Builder builder(*m_connectivity, size());
   boost_foreach (const Handle<Space>& space, spaces() )
   {
     for (Uint elem_idx=0; elem_idx<space->size(); ++elem_idx)
@@ -320,15 +318,11 @@ void ContinuousDictionary::rebuild_node_to_element_connectivity()
       boost_foreach (const Uint node_idx, space->connectivity()[elem_idx])
       {
         cf3_assert_desc(to_str(node_idx)+"<"+to_str(size())+" --> something wrong with the element-node connectivity table from space "+space->uri().path(),node_idx<size());
-        ++connectivity_sizes[node_idx];
+        builder.count(node_idx);
       }
     }
   }
-  for (Uint i=0; i<size(); ++i)
-  {
-    m_connectivity->array()[i].clear();
-    m_connectivity->array()[i].reserve(connectivity_sizes[i]);
-  }
+  builder.allocate();
 
   boost_foreach (const Handle<Space>& space, spaces())
   {
@@ -336,10 +330,11 @@ void ContinuousDictionary::rebuild_node_to_element_connectivity()
     {
       boost_foreach (const Uint node_idx, space->connectivity()[elem_idx])
       {
-        m_connectivity->array()[node_idx].push_back(SpaceElem(*space,elem_idx));
+        builder.add(node_idx, SpaceElem(*space,elem_idx));
       }
     }
   }
+  builder.finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
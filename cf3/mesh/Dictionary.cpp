@@ -20,6 +20,7 @@
 #include "common/StringConversion.hpp"
 #include "common/Tags.hpp"
 #include "common/DynTable.hpp"
+#include "common/RaggedTable.hpp"
 #include "common/List.hpp"
 
 #include "common/XML/SignalOptions.hpp"
@@ -69,7 +70,7 @@ Dictionary::Dictionary ( const std::string& name  ) :
   m_glb_to_loc = create_static_component< common::Map<boost::uint64_t,Uint> >(mesh::Tags::map_global_to_local());
   m_glb_to_loc->add_tag(mesh::Tags::map_global_to_local());
 
-  m_connectivity = create_static_component< common::DynTable<SpaceElem> >("element_connectivity");
+  m_connectivity = create_static_component< common::RaggedTable<SpaceElem> >("element_connectivity");
 
   options().add("dimension",m_dim).link_to(&m_dim);
 
@@ -18,6 +18,7 @@ namespace common {
   class Link;
   template <typename T> class List;
   template <typename T> class DynTable;
+  template <typename T> class RaggedTable;
   namespace PE { class CommPattern; }
 }
 namespace math { class VariablesDescriptor; }
@@ -96,7 +97,7 @@ public: // functions
   const common::Map<boost::uint64_t,Uint>& glb_to_loc() const { return *m_glb_to_loc; }
 
   /// Node to space-element connectivity
-  const common::DynTable<SpaceElem>& connectivity() const { return *m_connectivity; }
+  const common::RaggedTable<SpaceElem>& connectivity() const { return *m_connectivity; }
 
   /// Return the comm pattern valid for this field group. Created based on the glb_idx and rank if it didn't exist already
   common::PE::CommPattern& comm_pattern();
@@ -171,7 +172,7 @@ protected:
   bool m_is_continuous;
 
   /// Connectivity with the element of the space
-  Handle<common::DynTable<SpaceElem> > m_connectivity;
+  Handle<common::RaggedTable<SpaceElem> > m_connectivity;
 
 private:
 
@@ -0,0 +1,244 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <limits>
+
+#include <boost/bind.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Builder.hpp"
+#include "common/List.hpp"
+#include "common/OptionList.hpp"
+#include "common/RaggedTable.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementColoring.hpp"
+#include "mesh/Space.hpp"
+
+namespace cf3 {
+namespace mesh {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+ComponentBuilder< ElementColoring, Component, LibMesh > ElementColoring_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Marks the colors of all elements of a space that share a (periodic) node with a given element
+  struct NeighbourColors
+  {
+    NeighbourColors(const Space& space,
+                    const std::vector<Uint>& node_map,
+                    const std::vector<Uint>& group_offsets,
+                    const std::vector<Uint>& group_nodes,
+                    const std::vector<Uint>& element_colors,
+                    std::vector<Uint>& color_used_by) :
+      m_space(&space),
+      m_connectivity(space.connectivity()),
+      m_node_elements(space.dict().connectivity().values()),
+      m_node_elements_offsets(space.dict().connectivity().offsets()),
+      m_node_map(node_map),
+      m_group_offsets(group_offsets),
+      m_group_nodes(group_nodes),
+      m_element_colors(element_colors),
+      m_color_used_by(color_used_by)
+    {
+    }
+
+    /// Set color_used_by to elem for each color used by a neighbour of elem
+    void mark(const Uint elem) const
+    {
+      const Uint no_color = std::numeric_limits<Uint>::max();
+      const Uint nb_elem_nodes = m_connectivity.row_size();
+      for(Uint i = 0; i != nb_elem_nodes; ++i)
+      {
+        const Uint target = m_node_map[m_connectivity[elem][i]];
+        for(Uint g = m_group_offsets[target]; g != m_group_offsets[target+1]; ++g)
+        {
+          const Uint node = m_group_nodes[g];
+          for(Uint j = m_node_elements_offsets[node]; j != m_node_elements_offsets[node+1]; ++j)
+          {
+            if(m_node_elements[j].comp != m_space)
+              continue;
+            const Uint neighbour_color = m_element_colors[m_node_elements[j].idx];
+            if(neighbour_color != no_color)
+              m_color_used_by[neighbour_color] = elem;
+          }
+        }
+      }
+    }
+
+    const Space* m_space;
+    const Connectivity& m_connectivity;
+    const std::vector<SpaceElem>& m_node_elements;
+    const std::vector<Uint>& m_node_elements_offsets;
+    const std::vector<Uint>& m_node_map;
+    const std::vector<Uint>& m_group_offsets;
+    const std::vector<Uint>& m_group_nodes;
+    const std::vector<Uint>& m_element_colors;
+    std::vector<Uint>& m_color_used_by;
+  };
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+ElementColoring::ElementColoring ( const std::string& name ) :
+  Component(name),
+  m_color_offsets(1, 0u),
+  m_is_valid(false)
+{
+  options().add("algorithm", std::string("greedy"))
+    .description("Coloring algorithm: greedy (fewest colors) or balanced (colors of similar size)")
+    .pretty_name("Algorithm")
+    .attach_trigger(boost::bind(&ElementColoring::invalidate, this))
+    .mark_basic();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+const ElementColoring& ElementColoring::get(const Space& space)
+{
+  // The coloring is a cache, storing it does not modify the space itself
+  Space& cache_owner = const_cast<Space&>(space);
+  Handle<ElementColoring> coloring(cache_owner.get_child("element_coloring"));
+  if(is_null(coloring))
+    coloring = cache_owner.create_component<ElementColoring>("element_coloring");
+
+  if(!coloring->is_valid() || coloring->elements().size() != space.size())
+    coloring->compute(space);
+
+  return *coloring;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementColoring::compute(const Space& space)
+{
+  const std::string algorithm = options().value<std::string>("algorithm");
+  if(algorithm != "greedy" && algorithm != "balanced")
+    throw BadValue(FromHere(), "Unknown coloring algorithm " + algorithm + ", expected greedy or balanced");
+
+  const Connectivity& connectivity = space.connectivity();
+  Dictionary& dict = space.dict();
+  const Uint nb_elems = connectivity.size();
+  const Uint nb_nodes = dict.size();
+
+  // Use the node to element connectivity of the dictionary, rebuilding it if it doesn't match the nodes
+  if(dict.connectivity().size() != nb_nodes)
+    dict.rebuild_node_to_element_connectivity();
+
+  // Nodes that are periodically linked are mapped onto the node they finally link to
+  std::vector<Uint> node_map(nb_nodes);
+  for(Uint i = 0; i != nb_nodes; ++i)
+    node_map[i] = i;
+
+  Handle< common::List<Uint> const > periodic_links_nodes(dict.get_child("periodic_links_nodes"));
+  Handle< common::List<bool> const > periodic_links_active(dict.get_child("periodic_links_active"));
+  if(is_not_null(periodic_links_nodes) && is_not_null(periodic_links_active))
+  {
+    const common::List<Uint>& per_links = *periodic_links_nodes;
+    const common::List<bool>& per_active = *periodic_links_active;
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      Uint target = i;
+      for(Uint level = 0; per_active[target] && level != 4; ++level)
+        target = per_links[target];
+      node_map[i] = target;
+    }
+  }
+
+  // All nodes that map onto the same node, stored as compressed rows
+  std::vector<Uint> group_offsets(nb_nodes+1, 0);
+  for(Uint i = 0; i != nb_nodes; ++i)
+    ++group_offsets[node_map[i]+1];
+  for(Uint i = 0; i != nb_nodes; ++i)
+    group_offsets[i+1] += group_offsets[i];
+  std::vector<Uint> group_nodes(nb_nodes);
+  std::vector<Uint> fill_position(group_offsets.begin(), group_offsets.end()-1);
+  for(Uint i = 0; i != nb_nodes; ++i)
+    group_nodes[fill_position[node_map[i]]++] = i;
+
+  const Uint no_color = std::numeric_limits<Uint>::max();
+  std::vector<Uint> element_colors(nb_elems, no_color);
+  std::vector<Uint> color_used_by(nb_elems+1, no_color); // Last element that marked a color as used
+  std::vector<Uint> color_sizes;
+
+  const detail::NeighbourColors neighbour_colors(space, node_map, group_offsets, group_nodes, element_colors, color_used_by);
+
+  // Greedy coloring: each element gets the lowest color that is not used by any of its neighbours
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+  {
+    neighbour_colors.mark(elem);
+
+    Uint color = 0;
+    while(color_used_by[color] == elem)
+      ++color;
+
+    element_colors[elem] = color;
+    if(color == color_sizes.size())
+      color_sizes.push_back(0);
+    ++color_sizes[color];
+  }
+
+  const Uint nb_colors = color_sizes.size();
+
+  // Balancing: move elements out of colors that are larger than the average, into the smallest allowed color
+  if(algorithm == "balanced" && nb_colors > 1)
+  {
+    const Uint target_size = (nb_elems + nb_colors - 1) / nb_colors;
+    color_used_by.assign(nb_elems+1, no_color);
+    for(Uint elem = 0; elem != nb_elems; ++elem)
+    {
+      const Uint old_color = element_colors[elem];
+      if(color_sizes[old_color] <= target_size)
+        continue;
+
+      neighbour_colors.mark(elem);
+
+      Uint new_color = old_color;
+      for(Uint color = 0; color != nb_colors; ++color)
+      {
+        if(color_used_by[color] != elem && color_sizes[color] < target_size && (new_color == old_color || color_sizes[color] < color_sizes[new_color]))
+          new_color = color;
+      }
+
+      element_colors[elem] = new_color;
+      --color_sizes[old_color];
+      ++color_sizes[new_color];
+    }
+  }
+
+  // Sort the elements by color
+  m_color_offsets.assign(nb_colors+1, 0);
+  for(Uint color = 0; color != nb_colors; ++color)
+    m_color_offsets[color+1] = m_color_offsets[color] + color_sizes[color];
+
+  m_elements.resize(nb_elems);
+  fill_position.assign(m_color_offsets.begin(), m_color_offsets.end()-1);
+  for(Uint elem = 0; elem != nb_elems; ++elem)
+    m_elements[fill_position[element_colors[elem]]++] = elem;
+
+  m_is_valid = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ElementColoring::invalidate()
+{
+  m_is_valid = false;
+  std::vector<Uint>().swap(m_elements);
+  m_color_offsets.assign(1, 0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
@@ -0,0 +1,87 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_ElementColoring_hpp
+#define cf3_mesh_ElementColoring_hpp
+
+#include "common/Component.hpp"
+
+#include "mesh/LibMesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+  class Space;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Coloring of the elements of a Space, so that no two elements with the same color share a node
+///
+/// The elements are stored sorted by color, with an offset table that gives the start of each color,
+/// so all elements of one color can be processed concurrently without write conflicts on node data.
+/// Periodic links of the dictionary are followed, so elements that touch the same periodic node
+/// also get a different color.
+///
+/// The coloring is stored as the child "element_coloring" of the space it belongs to. It is invalidated
+/// when the mesh is loaded or changed, and recomputed by get() on the next use.
+/// Two algorithms are available through the option "algorithm":
+/// - greedy: each element gets the lowest color not used by its neighbours. This gives few colors.
+/// - balanced: the greedy coloring, after which elements are moved from the large colors to smaller ones,
+///   to get colors of about the same size and thus better load balance in threaded loops.
+class Mesh_API ElementColoring : public common::Component
+{
+public:
+
+  /// Contructor
+  /// @param name of the component
+  ElementColoring ( const std::string& name );
+
+  /// Virtual destructor
+  virtual ~ElementColoring() {}
+
+  /// Get the class name
+  static std::string type_name () { return "ElementColoring"; }
+
+  /// The valid coloring of the given space. It is computed and stored in the space if it does not exist,
+  /// or if it was invalidated. Not thread-safe, so this must be called outside of parallel regions.
+  static const ElementColoring& get(const Space& space);
+
+  /// Compute the coloring for the elements of the given space
+  void compute(const Space& space);
+
+  /// False if the mesh changed since the coloring was computed
+  bool is_valid() const { return m_is_valid; }
+
+  /// Mark the coloring as out of date
+  void invalidate();
+
+  /// Number of colors
+  Uint nb_colors() const { return m_color_offsets.size() - 1; }
+
+  /// Element indices, sorted by color
+  const std::vector<Uint>& elements() const { return m_elements; }
+
+  /// The elements with color c are found between color_offsets()[c] and color_offsets()[c+1] in elements()
+  const std::vector<Uint>& color_offsets() const { return m_color_offsets; }
+
+private:
+
+  std::vector<Uint> m_elements;
+  std::vector<Uint> m_color_offsets;
+  bool m_is_valid;
+
+}; // ElementColoring
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_ElementColoring_hpp
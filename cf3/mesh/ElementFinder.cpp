@@ -11,6 +11,7 @@
 
 #include "mesh/ElementFinder.hpp"
 #include "mesh/Dictionary.hpp"
+#include "mesh/Space.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -28,5 +29,27 @@ ElementFinder::ElementFinder(const std::string &name) : common::Component(name)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint ElementFinder::find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector<bool>& found)
+{
+  const Uint nb_coords = coordinates.size();
+  const Uint dim = coordinates.shape()[1];
+  elements.assign(nb_coords, SpaceElem());
+  found.assign(nb_coords, false);
+
+  Uint nb_found = 0;
+  RealVector coord(dim);
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    for (Uint d=0; d<dim; ++d)
+      coord[d] = coordinates[i][d];
+    found[i] = find_element(coord, elements[i]);
+    if (found[i])
+      ++nb_found;
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
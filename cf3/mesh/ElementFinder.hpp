@@ -10,6 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "common/Component.hpp"
+#include "common/BoostArray.hpp"
 #include "mesh/LibMesh.hpp"
 #include "math/MatrixTypes.hpp"
 
@@ -40,6 +41,16 @@ public:
   /// @return if element was found
   virtual bool find_element(const RealVector& target_coord, SpaceElem& element) = 0;
 
+  /// @brief Find the elements containing many coordinates at once
+  ///
+  /// The default implementation calls find_element for each coordinate. Implementations
+  /// can override this to share work between the queries.
+  /// @param [in]  coordinates  One coordinate per row
+  /// @param [out] elements     The found element for each coordinate
+  /// @param [out] found        For each coordinate, true if the element was found
+  /// @return the number of coordinates for which an element was found
+  virtual Uint find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector<bool>& found);
+
 protected:
   Handle<Dictionary> m_dict;
 };
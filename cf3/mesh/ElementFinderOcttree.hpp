@@ -17,9 +17,12 @@
 namespace cf3 {
 namespace mesh {
 
-  class Octtree;
+  class BoundingBoxTree;
   
-/// @brief Find elements using an octtree
+/// @brief Find elements using a tree of element bounding boxes
+///
+/// The BoundingBoxTree is shared with other users of the same mesh, as the mesh child "bounding_box_tree".
+/// The name is kept for compatibility with existing configurations.
 class Mesh_API ElementFinderOcttree : public ElementFinder
 {
 public:
@@ -32,24 +35,27 @@ public:
 
   virtual bool find_element(const RealVector& target_coord, SpaceElem& element);
 
+  /// @brief Find the elements containing many coordinates at once, sorted along a Hilbert curve and threaded
+  virtual Uint find_elements(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector<bool>& found);
+
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
 private:
 
-  void configure_octtree();
+  void configure_tree();
+
+  /// Build the tree on first use
+  BoundingBoxTree& tree();
 
 private:
 
-  Handle<Octtree> m_octtree;
-  Entity m_tmp;
+  Handle<BoundingBoxTree> m_tree;
   bool m_closest;
 
-  std::vector<Uint> m_octtree_idx;
-
-  std::vector<Entity> m_elements_pool;
-
-  RealMatrix m_coordinates;
-
+  /// Temporaries for find_element and find_elements
+  RealVector m_coord;
+  Entity m_entity;
+  std::vector<Entity> m_entities;
 
 };
 
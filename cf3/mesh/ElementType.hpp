@@ -224,7 +224,8 @@ protected: // data
 
 ////////////////////////////////////////////////////////////////////////////////
 
-/// Stores connectivity information about the faces that form the cell boundary
+/// Stores connectivity information about the faces that form the cell boundary.
+/// The element types build it in the initializer of a function-local static, so it is safe to get from several threads.
 struct ElementTypeFaceConnectivity
 {
   /// Range of const indices
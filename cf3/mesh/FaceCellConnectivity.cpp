@@ -4,6 +4,13 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <limits>
+
+#include <boost/functional/hash.hpp>
+
+#include "coolfluid-packages.hpp"
+
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
@@ -49,6 +56,10 @@ FaceCellConnectivity::FaceCellConnectivity ( const std::string& name ) :
       .link_to(&m_face_building_algorithm)
       .description("Improves efficiency for face building algorithm");
 
+  options().add("face_matching", std::string("sort"))
+      .pretty_name("Face Matching")
+      .description("Algorithm to find the faces shared by two cells: sort or node_search");
+
   m_used_components = create_static_component<Group>("used_components");
   m_connectivity = create_static_component<common::Table<Entity> >(mesh::Tags::connectivity_table());
   m_face_nb_in_elem = create_static_component<common::Table<Uint> >("face_number");
@@ -117,6 +128,274 @@ void FaceCellConnectivity::build_connectivity()
     return;
   }
 
+  if (m_face_building_algorithm)
+  {
+    // allocate storage if doesn't exist that says if the element is at the boundary of a region
+    // ( = not the same as the mesh boundary)
+    boost_foreach (Handle< Component > elements_comp, used())
+    {
+      Elements& elements = dynamic_cast<Elements&>(*elements_comp);
+      Handle< Component > comp = elements.get_child("is_bdry");
+      if ( is_null( comp ) || is_null(Handle< common::List<bool> >(comp)) )
+      {
+        common::List<bool>& is_bdry_elem = * elements.create_component< common::List<bool> >("is_bdry");
+
+        const Uint nb_elem = elements.size();
+        is_bdry_elem.resize(nb_elem);
+
+        for (Uint e=0; e<nb_elem; ++e)
+          is_bdry_elem[e] = true;
+      }
+      cf3_assert( Handle< common::List<bool> >(elements.get_child("is_bdry")) );
+    }
+  }
+
+  const std::string face_matching = options().value<std::string>("face_matching");
+  if (face_matching == "sort")
+    match_faces_sorted();
+  else if (face_matching == "node_search")
+    match_faces_node_search();
+  else
+    throw BadValue(FromHere(), "Unknown face matching algorithm " + face_matching + " for " + uri().path() + ", expected sort or node_search");
+
+  if (m_face_building_algorithm)
+  {
+    for (Uint f=0; f<m_connectivity->size(); ++f)
+    {
+      ElementConnectivity::Row elem_row = (*m_connectivity)[f];
+      boost_foreach (Entity& elem, elem_row)
+      {
+        if ( is_not_null(elem.comp) )
+        {
+          common::List<bool>& is_bdry_elem = *Handle< common::List<bool> >(elem.comp->get_child("is_bdry"));
+          is_bdry_elem[elem.idx] = is_bdry_elem[elem.idx] || (*m_is_bdry_face)[f] ;
+        }
+      }
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  /// Orders cell faces by their key: the hash of the sorted nodes, then the sorted nodes themselves.
+  /// Faces with the same key keep the order in which they were visited.
+  struct FaceKeyLess
+  {
+    FaceKeyLess(const std::vector<std::size_t>& hashes, const std::vector<Uint>& sorted_nodes, const Uint stride) :
+      m_hashes(hashes),
+      m_sorted_nodes(sorted_nodes),
+      m_stride(stride)
+    {
+    }
+
+    bool operator()(const Uint a, const Uint b) const
+    {
+      if (m_hashes[a] != m_hashes[b])
+        return m_hashes[a] < m_hashes[b];
+      const int cmp = compare(a, b);
+      if (cmp != 0)
+        return cmp < 0;
+      return a < b;
+    }
+
+    /// Compare the sorted nodes of faces a and b
+    int compare(const Uint a, const Uint b) const
+    {
+      const Uint* nodes_a = &m_sorted_nodes[a*m_stride];
+      const Uint* nodes_b = &m_sorted_nodes[b*m_stride];
+      for (Uint i=0; i!=m_stride; ++i)
+      {
+        if (nodes_a[i] != nodes_b[i])
+          return nodes_a[i] < nodes_b[i] ? -1 : 1;
+      }
+      return 0;
+    }
+
+    bool same_face(const Uint a, const Uint b) const
+    {
+      return m_hashes[a] == m_hashes[b] && compare(a, b) == 0;
+    }
+
+    const std::vector<std::size_t>& m_hashes;
+    const std::vector<Uint>& m_sorted_nodes;
+    const Uint m_stride;
+  };
+}
+
+void FaceCellConnectivity::match_faces_sorted()
+{
+  const std::vector<Handle< Component > > used_components = used();
+  const Uint nb_used = used_components.size();
+  const Uint invalid = std::numeric_limits<Uint>::max();
+
+  // Every face of every cell gets a slot, numbered in the order the cells and their faces are visited.
+  // The slots of the cells in used component u start at slot_begin[u].
+  std::vector<Uint> slot_begin(nb_used+1, 0);
+  Uint stride = 1;
+  for (Uint u=0; u!=nb_used; ++u)
+  {
+    const Elements& elements = dynamic_cast<const Elements&>(*used_components[u]);
+    const ElementType& etype = elements.element_type();
+    slot_begin[u+1] = slot_begin[u] + elements.size()*etype.nb_faces();
+    for (Uint face_idx=0; face_idx!=etype.nb_faces(); ++face_idx)
+      stride = std::max(stride, etype.face_type(face_idx).nb_nodes());
+  }
+  const Uint nb_slots = slot_begin.back();
+
+  // Sorted nodes of each face, padded with invalid for faces with less nodes than the stride.
+  // Faces of cells that are known not to be on a region boundary are skipped.
+  std::vector<Uint> sorted_nodes(nb_slots*stride, invalid);
+  std::vector<std::size_t> hashes(nb_slots, 0);
+  std::vector<char> skipped(nb_slots, false);
+  for (Uint u=0; u!=nb_used; ++u)
+  {
+    const Elements& elements = dynamic_cast<const Elements&>(*used_components[u]);
+    const ElementType& etype = elements.element_type();
+    const Uint nb_faces_in_elem = etype.nb_faces();
+    const Connectivity::ArrayT& connectivity = elements.geometry_space().connectivity().array();
+
+    Handle< common::List<bool> const > is_bdry_elem;
+    if (m_face_building_algorithm)
+      is_bdry_elem = Handle< common::List<bool> const >(elements.get_child("is_bdry"));
+
+    // Local nodes of each face of the element type
+    std::vector< std::vector<Uint> > face_local_nodes(nb_faces_in_elem);
+    for (Uint face_idx=0; face_idx!=nb_faces_in_elem; ++face_idx)
+    {
+      boost_foreach(const Uint face_node_idx, etype.faces().nodes_range(face_idx))
+        face_local_nodes[face_idx].push_back(face_node_idx);
+    }
+
+    const int nb_elems = elements.size();
+#ifdef CF3_HAVE_OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (int e=0; e<nb_elems; ++e)
+    {
+      const Uint first_slot = slot_begin[u] + e*nb_faces_in_elem;
+      if ( is_not_null(is_bdry_elem) && (*is_bdry_elem)[e] == false )
+      {
+        for (Uint face_idx=0; face_idx!=nb_faces_in_elem; ++face_idx)
+          skipped[first_slot+face_idx] = true;
+        continue;
+      }
+
+      Connectivity::ConstRow elem_nodes = connectivity[e];
+      for (Uint face_idx=0; face_idx!=nb_faces_in_elem; ++face_idx)
+      {
+        const Uint slot = first_slot + face_idx;
+        const std::vector<Uint>& local_nodes = face_local_nodes[face_idx];
+        Uint* nodes = &sorted_nodes[slot*stride];
+        for (Uint i=0; i!=local_nodes.size(); ++i)
+          nodes[i] = elem_nodes[local_nodes[i]];
+        std::sort(nodes, nodes+local_nodes.size());
+        hashes[slot] = boost::hash_range(nodes, nodes+local_nodes.size());
+      }
+    }
+  }
+
+  std::vector<Uint> order;
+  order.reserve(nb_slots);
+  for (Uint slot=0; slot!=nb_slots; ++slot)
+  {
+    if (!skipped[slot])
+      order.push_back(slot);
+  }
+
+  // Faces shared by cells now follow each other, the first visited one in front
+  const detail::FaceKeyLess face_less(hashes, sorted_nodes, stride);
+  std::sort(order.begin(), order.end(), face_less);
+
+  // For every face, the first visited face with the same nodes, or invalid if it is the first itself
+  std::vector<Uint> first_slot(nb_slots, invalid);
+  Uint nb_faces = 0;
+  for (Uint i=0; i!=order.size(); )
+  {
+    Uint j=i+1;
+    while (j!=order.size() && face_less.same_face(order[i], order[j]))
+    {
+      first_slot[order[j]] = order[i];
+      ++j;
+    }
+    ++nb_faces;
+    i=j;
+  }
+  std::vector<Uint>().swap(order);
+  std::vector<std::size_t>().swap(hashes);
+  std::vector<Uint>().swap(sorted_nodes);
+
+  // Fill the pre-sized tables, numbering the faces in the order they are first visited
+  m_connectivity->resize(nb_faces);
+  m_face_nb_in_elem->resize(nb_faces);
+  m_is_bdry_face->resize(nb_faces);
+  m_cell_rotation->resize(nb_faces);
+  m_cell_orientation->resize(nb_faces);
+
+  std::vector<Uint> face_of_slot(nb_slots, invalid);
+  m_nb_faces = 0;
+  for (Uint u=0; u!=nb_used; ++u)
+  {
+    Elements& elements = dynamic_cast<Elements&>(*used_components[u]);
+    const ElementType& etype = elements.element_type();
+    const Uint nb_faces_in_elem = etype.nb_faces();
+    for (Uint slot=slot_begin[u]; slot!=slot_begin[u+1]; ++slot)
+    {
+      if (skipped[slot])
+        continue;
+      const Entity element(elements, (slot-slot_begin[u])/nb_faces_in_elem);
+      const Uint face_idx = (slot-slot_begin[u])%nb_faces_in_elem;
+
+      if (first_slot[slot] == invalid)
+      {
+        // a new face has been found
+        const Uint face = m_nb_faces++;
+        face_of_slot[slot] = face;
+        (*m_connectivity)[face][0] = element;
+        (*m_connectivity)[face][1] = Entity();
+        (*m_face_nb_in_elem)[face][0] = face_idx;
+        (*m_face_nb_in_elem)[face][1] = 0;
+        (*m_cell_orientation)[face][0] = MATCHED;
+        (*m_cell_orientation)[face][1] = INVERTED;
+        (*m_cell_rotation)[face][0] = 0;
+        (*m_cell_rotation)[face][1] = 0;
+        (*m_is_bdry_face)[face] = true;
+      }
+      else
+      {
+        // the face already exists, meaning that the face is an internal one, shared by two elements
+        const Uint face = face_of_slot[first_slot[slot]];
+        cf3_assert(face != invalid);
+        (*m_connectivity)[face][1] = element;
+        (*m_face_nb_in_elem)[face][1] = face_idx;
+        (*m_is_bdry_face)[face] = false;
+
+        // Find the rotation, i.e. the position of the first node of the face in the first element
+        const Entity first_element = (*m_connectivity)[face][0];
+        const Uint first_node = first_element.get_nodes()[first_element.element_type().faces().nodes_range((*m_face_nb_in_elem)[face][0])[0]];
+        Connectivity::ConstRow elem_nodes = element.get_nodes();
+        Uint rotation = 0;
+        boost_foreach(const Uint face_node_idx, etype.faces().nodes_range(face_idx))
+        {
+          if (elem_nodes[face_node_idx] == first_node)
+            break;
+          ++rotation;
+        }
+        // Following assertion fails, it means the correct orientation was not found! This should never happen!
+        cf3_always_assert(rotation != etype.face_type(face_idx).nb_nodes());
+        (*m_cell_rotation)[face][1] = rotation;
+      }
+    }
+  }
+
+  cf3_assert(m_nb_faces == nb_faces);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void FaceCellConnectivity::match_faces_node_search()
+{
   // declartions
   m_connectivity->resize(0);
   common::Table<Entity>::Buffer f2c = m_connectivity->create_buffer();
@@ -143,28 +422,6 @@ void FaceCellConnectivity::build_connectivity()
     max_nb_faces += nb_faces * elements->size() ;
   }
 
-  if (m_face_building_algorithm)
-  {
-    // allocate storage if doesn't exist that says if the element is at the boundary of a region
-    // ( = not the same as the mesh boundary)
-    boost_foreach (Handle< Component > elements_comp, used())
-    {
-      Elements& elements = dynamic_cast<Elements&>(*elements_comp);
-      Handle< Component > comp = elements.get_child("is_bdry");
-      if ( is_null( comp ) || is_null(Handle< common::List<bool> >(comp)) )
-      {
-        common::List<bool>& is_bdry_elem = * elements.create_component< common::List<bool> >("is_bdry");
-
-        const Uint nb_elem = elements.size();
-        is_bdry_elem.resize(nb_elem);
-
-        for (Uint e=0; e<nb_elem; ++e)
-          is_bdry_elem[e] = true;
-      }
-      cf3_assert( Handle< common::List<bool> >(elements.get_child("is_bdry")) );
-    }
-  }
-
   // Declarations to save frequent allocations in the loop algorithm
   Uint nb_inner_faces = 0;
   Uint nb_matched_nodes = 1;
@@ -338,22 +595,6 @@ void FaceCellConnectivity::build_connectivity()
 
 
   cf3_assert(m_nb_faces == m_connectivity->size());
-
-  if (m_face_building_algorithm)
-  {
-    for (Uint f=0; f<m_connectivity->size(); ++f)
-    {
-      ElementConnectivity::Row elem_row = (*m_connectivity)[f];
-      boost_foreach (Entity& elem, elem_row)
-      {
-        if ( is_not_null(elem.comp) )
-        {
-          common::List<bool>& is_bdry_elem = *Handle< common::List<bool> >(elem.comp->get_child("is_bdry"));
-          is_bdry_elem[elem.idx] = is_bdry_elem[elem.idx] || is_bdry_face.get_row(f) ;
-        }
-      }
-    }
-  }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -61,6 +61,12 @@ public:
 
   /// Build the connectivity table
   /// Build the connectivity table as a DynTable<Uint>
+  /// The option "face_matching" selects how faces shared by two cells are found:
+  /// - "sort" (default): the faces of all cells are keyed by their sorted nodes, and matching keys
+  ///   are found by sorting the keys. Keys are computed in parallel if OpenMP is enabled.
+  /// - "node_search": faces are registered to their nodes, and the faces of every cell are searched
+  ///   among the faces of its nodes. This is the original algorithm, kept for comparison.
+  /// Both give the same faces, in the same order.
   /// @pre set_nodes() and set_elements() must have been called
 
   void build_connectivity();
@@ -95,6 +101,14 @@ public:
 
   void add_used (Component& used_comp);
 
+private: // functions
+
+  /// Match faces by sorting their node keys
+  void match_faces_sorted();
+
+  /// Match faces by searching the faces registered to their nodes
+  void match_faces_node_search();
+
 private: // data
 
   /// nb_faces
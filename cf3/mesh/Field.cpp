@@ -172,6 +172,29 @@ void Field::synchronize()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+void Field::start_synchronize()
+{
+  if ( is_not_null(m_comm_pattern) )
+  {
+    CFdebug << "Starting synchronization of field " << uri().path() << CFendl;
+    m_comm_pattern->start_synchronize( name() );
+  }
+  else
+  {
+    CFdebug << "Not synchronizing field " << uri().path() << " due to null comm pattern" << CFendl;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Field::finish_synchronize()
+{
+  if ( is_not_null(m_comm_pattern) )
+    m_comm_pattern->finish_synchronize();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////
 
 void Field::set_descriptor(math::VariablesDescriptor& descriptor)
@@ -124,6 +124,16 @@ public: // functions
 
   void synchronize();
 
+  /// Start a nonblocking synchronize. Only one synchronization of the fields sharing a comm pattern can be in progress,
+  /// and the field may not be accessed until finish_synchronize is called
+  void start_synchronize();
+
+  /// Complete the synchronization started using start_synchronize
+  void finish_synchronize();
+
+  /// The comm pattern used by synchronize, null if the field was not parallelized
+  const Handle<common::PE::CommPattern>& comm_pattern() const { return m_comm_pattern; }
+
   math::VariablesDescriptor& descriptor() const { return *m_descriptor; }
 
   void set_descriptor(math::VariablesDescriptor& descriptor);
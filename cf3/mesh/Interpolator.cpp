@@ -4,9 +4,13 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cmath>
+
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
 
+#include "math/Consts.hpp"
 #include "math/MatrixTypesConversion.hpp"
 
 #include "common/FindComponents.hpp"
@@ -15,11 +19,14 @@
 #include "common/OptionT.hpp"
 #include "common/Signal.hpp"
 #include "common/XML/SignalOptions.hpp"
+#include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
 
 #include "mesh/Interpolator.hpp"
 #include "mesh/Mesh.hpp"
 #include "mesh/Field.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Connectivity.hpp"
 
 #include "mesh/PointInterpolator.hpp"
 
@@ -53,11 +60,29 @@ Interpolator::Interpolator(const std::string &name) :
       .description("Flag to store weights and stencils used for faster interpolation in the future")
       .pretty_name("Store");
 
+  options().add("ring_fallback", true)
+      .description("Offer points that are not found on any processor whose bounding box contains them to all processors in turn")
+      .pretty_name("Ring Fallback")
+      .attach_trigger( boost::bind( &Interpolator::trigger_reset_storage, this ) );
+
+  options().add("routing", true)
+      .description("Send coordinates only to the processors whose bounding box contains them. If disabled, all coordinates are offered to all processors in turn")
+      .pretty_name("Routing")
+      .attach_trigger( boost::bind( &Interpolator::trigger_reset_storage, this ) );
+
   m_point_interpolator = Handle<APointInterpolator>(create_component<PointInterpolator>("point_interpolator"));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Interpolator::trigger_reset_storage()
+{
+  // Forces the storage to be recomputed at the next stored interpolation
+  m_source_dict_uri = URI();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 void Interpolator_send_receive(const Uint send_to_pid, std::vector<T>& send, const Uint receive_from_pid, std::vector<T>& receive)
 {
@@ -80,6 +105,181 @@ void Interpolator_send_receive(const Uint send_to_pid, std::vector<T>& send, con
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Sparse exchange: send[p] is sent to processor p, receive[p] is received from processor p
+template <typename T>
+void Interpolator_all_to_all(const std::vector< std::vector<T> >& send, std::vector< std::vector<T> >& receive)
+{
+  if (PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    PE::Comm::instance().all_to_all(send, receive);
+  else
+    receive = send;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool Interpolator::needs_ring_fallback(const Uint nb_not_found) const
+{
+  if (!options().value<bool>("ring_fallback"))
+    return false;
+  if (!PE::Comm::instance().is_active() || PE::Comm::instance().size() == 1)
+    return false;
+  // All processors have to take part in the ring, even those that found all their points
+  Uint nb_not_found_glb;
+  PE::Comm::instance().all_reduce(PE::plus(), &nb_not_found, 1, &nb_not_found_glb);
+  return nb_not_found_glb != 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Interpolator::route_coordinates(const Dictionary& dict, const Table<Real>& target_coords, std::vector< std::vector<Uint> >& requests, std::vector<bool>& in_global_box) const
+{
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint nb_procs = parallel ? PE::Comm::instance().size() : 1u;
+  const Uint nb_coords = target_coords.size();
+  const Uint dim = target_coords.row_size();
+
+  // Bounding box of the elements of this processor, stored as [min, max].
+  // An empty processor has an inverted box, which contains no points.
+  std::vector<Real> box(2*dim);
+  for (Uint d=0; d<dim; ++d)
+  {
+    box[d]     =  math::Consts::real_max();
+    box[dim+d] = -math::Consts::real_max();
+  }
+  bool empty = true;
+  boost_foreach(const Handle<Entities>& entities, dict.entities_range())
+  {
+    const Field& coordinates = entities->geometry_fields().coordinates();
+    const Uint coord_dim = std::min(dim, coordinates.row_size());
+    boost_foreach(Connectivity::ConstRow nodes, entities->geometry_space().connectivity().array())
+    {
+      boost_foreach(const Uint node, nodes)
+      {
+        for (Uint d=0; d<coord_dim; ++d)
+        {
+          box[d]     = std::min(box[d],     coordinates[node][d]);
+          box[dim+d] = std::max(box[dim+d], coordinates[node][d]);
+        }
+        empty = false;
+      }
+    }
+  }
+  if (!empty)
+  {
+    // Grow the box a little, so points on the partition boundary are not lost to round-off
+    Real extent = 0.;
+    for (Uint d=0; d<dim; ++d)
+      extent = std::max(extent, box[dim+d]-box[d]);
+    const Real tolerance = 1e-6*extent;
+    for (Uint d=0; d<dim; ++d)
+    {
+      box[d]     -= tolerance;
+      box[dim+d] += tolerance;
+    }
+  }
+
+  std::vector<Real> boxes;
+  if (parallel)
+    PE::Comm::instance().all_gather(box, boxes);
+  else
+    boxes = box;
+
+  // Union of all boxes
+  std::vector<Real> global_box(2*dim);
+  for (Uint d=0; d<dim; ++d)
+  {
+    global_box[d]     =  math::Consts::real_max();
+    global_box[dim+d] = -math::Consts::real_max();
+    for (Uint p=0; p<nb_procs; ++p)
+    {
+      global_box[d]     = std::min(global_box[d],     boxes[p*2*dim+d]);
+      global_box[dim+d] = std::max(global_box[dim+d], boxes[p*2*dim+dim+d]);
+    }
+  }
+
+  // Coarse uniform grid over the global box, listing the processor boxes that overlap each cell,
+  // so that a point is only tested against the few boxes in its cell
+  const Uint nb_cells_1d = 2u * std::max(1u, Uint(std::pow(Real(nb_procs), 1./Real(std::max(dim,1u))) + 0.5));
+  std::vector<Real> cell_size(dim);
+  Uint nb_cells = 1;
+  for (Uint d=0; d<dim; ++d)
+  {
+    cell_size[d] = (global_box[dim+d]-global_box[d]) / Real(nb_cells_1d);
+    nb_cells *= nb_cells_1d;
+  }
+  std::vector< std::vector<Uint> > cell_procs(nb_cells);
+  std::vector<Uint> lo(dim), hi(dim), idx(dim);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    const Real* p_box = &boxes[p*2*dim];
+    bool p_empty = false;
+    for (Uint d=0; d<dim; ++d)
+    {
+      if (p_box[dim+d] < p_box[d])
+        p_empty = true;
+    }
+    if (p_empty)
+      continue;
+    for (Uint d=0; d<dim; ++d)
+    {
+      lo[d] = cell_index(p_box[d],     global_box[d], cell_size[d], nb_cells_1d);
+      hi[d] = cell_index(p_box[dim+d], global_box[d], cell_size[d], nb_cells_1d);
+    }
+    // Loop over the range of cells [lo,hi] in all directions
+    idx = lo;
+    while (true)
+    {
+      Uint cell = 0;
+      for (Uint d=dim; d-- > 0;)
+        cell = cell*nb_cells_1d + idx[d];
+      cell_procs[cell].push_back(p);
+      Uint d=0;
+      for (; d<dim; ++d)
+      {
+        if (idx[d] < hi[d]) { ++idx[d]; break; }
+        idx[d] = lo[d];
+      }
+      if (d == dim)
+        break;
+    }
+  }
+
+  requests.assign(nb_procs, std::vector<Uint>());
+  in_global_box.assign(nb_coords, true);
+  for (Uint t=0; t<nb_coords; ++t)
+  {
+    Uint cell = 0;
+    for (Uint d=dim; d-- > 0;)
+    {
+      const Real x = target_coords[t][d];
+      if (x < global_box[d] || x > global_box[dim+d])
+        in_global_box[t] = false;
+      cell = cell*nb_cells_1d + cell_index(x, global_box[d], cell_size[d], nb_cells_1d);
+    }
+    if (!in_global_box[t])
+      continue;
+    boost_foreach(const Uint p, cell_procs[cell])
+    {
+      const Real* p_box = &boxes[p*2*dim];
+      bool inside = true;
+      for (Uint d=0; d<dim && inside; ++d)
+        inside = target_coords[t][d] >= p_box[d] && target_coords[t][d] <= p_box[dim+d];
+      if (inside)
+        requests[p].push_back(t);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint Interpolator::cell_index(const Real x, const Real min, const Real cell_size, const Uint nb_cells_1d)
+{
+  if (cell_size <= 0. || x <= min)
+    return 0;
+  return std::min(Uint((x-min)/cell_size), nb_cells_1d-1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
 void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coords)
 {
@@ -89,30 +289,141 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
   cf3_assert(m_point_interpolator);
   m_point_interpolator->options().set("dict", const_cast<Dictionary*>(m_dict.get())->handle<Dictionary>());
 
-  Uint nb_coords = target_coords.size();
-  Uint dim = target_coords.row_size();
-
-  std::vector<Uint> not_found; not_found.reserve(nb_coords);
-  for (Uint i=0; i<nb_coords; ++i)
-    not_found.push_back(i);
+  const Uint nb_coords = target_coords.size();
+  const Uint dim = target_coords.row_size();
+  const Uint nb_procs = PE::Comm::instance().size();
 
-  m_proc.resize(nb_coords,-1);
+  m_proc.assign(nb_coords,-1);
 
-  m_proc.clear();
   m_expect_recv.clear();
   m_stored_element.clear();
   m_stored_stencil.clear();
   m_stored_source_field_points.clear();
   m_stored_source_field_weights.clear();
 
-  m_expect_recv.resize(PE::Comm::instance().size());
-  m_stored_element.resize(PE::Comm::instance().size());
-  m_stored_stencil.resize(PE::Comm::instance().size());
-  m_stored_source_field_points.resize(PE::Comm::instance().size());
-  m_stored_source_field_weights.resize(PE::Comm::instance().size());
+  m_expect_recv.resize(nb_procs);
+  m_stored_element.resize(nb_procs);
+  m_stored_stencil.resize(nb_procs);
+  m_stored_source_field_points.resize(nb_procs);
+  m_stored_source_field_weights.resize(nb_procs);
+
+  if (!options().value<bool>("routing"))
+  {
+    std::vector<Uint> all_coords(nb_coords);
+    for (Uint t=0; t<nb_coords; ++t)
+      all_coords[t] = t;
+    ring_store(target_coords, all_coords);
+    return;
+  }
+
+  // Send each coordinate only to the processors whose bounding box contains it
+  std::vector< std::vector<Uint> > requests;
+  std::vector<bool> in_global_box;
+  route_coordinates(dict, target_coords, requests, in_global_box);
+
+  std::vector< std::vector<Real> > send_coords(nb_procs);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    send_coords[p].reserve(requests[p].size()*dim);
+    boost_foreach (const Uint t, requests[p])
+    {
+      boost_foreach (const Real& xyz, target_coords[t])
+      {
+        send_coords[p].push_back(xyz);
+      }
+    }
+  }
+  std::vector< std::vector<Real> > received_coords;
+  Interpolator_all_to_all(send_coords, received_coords);
+
+  // Compute the storage for the received coordinates of all processors in one batch,
+  // and report back which were found.
+  // Only the entries accepted by the requesting processor are kept afterwards.
+  std::vector<Uint> received_offsets(nb_procs+1, 0u);
+  for (Uint p=0; p<nb_procs; ++p)
+    received_offsets[p+1] = received_offsets[p] + received_coords[p].size()/dim;
+  boost::multi_array<Real,2> all_received_coords(boost::extents[received_offsets.back()][dim]);
+  for (Uint p=0; p<nb_procs; ++p)
+    std::copy(received_coords[p].begin(), received_coords[p].end(), all_received_coords.data()+received_offsets[p]*dim);
+
+  std::vector< SpaceElem              > found_element;
+  std::vector< std::vector<SpaceElem> > found_stencil;
+  std::vector< std::vector<Uint>      > found_points;
+  std::vector< std::vector<Real>      > found_weights;
+  std::vector<bool> found;
+  m_point_interpolator->compute_storage(all_received_coords, found_element, found_stencil, found_points, found_weights, found);
+
+  std::vector< std::vector<Uint> > send_found_coords(nb_procs);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (Uint t=0; t<received_offsets[p+1]-received_offsets[p]; ++t)
+    {
+      // mark found
+      if (found[received_offsets[p]+t])
+        send_found_coords[p].push_back(t);
+    }
+  }
+
+  std::vector< std::vector<Uint> > recv_found_coords;
+  Interpolator_all_to_all(send_found_coords, recv_found_coords);
+
+  // A coordinate found on several processors is interpolated by the lowest rank
+  std::vector< std::vector<Uint> > send_accepted(nb_procs);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (Uint k=0; k<recv_found_coords[p].size(); ++k)
+    {
+      cf3_assert(recv_found_coords[p][k]<requests[p].size());
+      const Uint t = requests[p][recv_found_coords[p][k]];
+      if (m_proc[t]<0)
+      {
+        m_proc[t] = p;
+        m_expect_recv[p].push_back(t);
+        send_accepted[p].push_back(recv_found_coords[p][k]);
+      }
+    }
+  }
+
+  std::vector< std::vector<Uint> > recv_accepted;
+  Interpolator_all_to_all(send_accepted, recv_accepted);
 
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    m_stored_element[p].reserve(recv_accepted[p].size());
+    m_stored_stencil[p].reserve(recv_accepted[p].size());
+    m_stored_source_field_points[p].reserve(recv_accepted[p].size());
+    m_stored_source_field_weights[p].reserve(recv_accepted[p].size());
+    boost_foreach(const Uint t, recv_accepted[p])
+    {
+      const Uint i = received_offsets[p]+t;
+      cf3_assert(i<received_offsets[p+1]);
+      cf3_assert(found[i]);
+      m_stored_element[p].push_back(found_element[i]);
+      m_stored_stencil[p].push_back(found_stencil[i]);
+      m_stored_source_field_points[p].push_back(found_points[i]);
+      m_stored_source_field_weights[p].push_back(found_weights[i]);
+    }
+  }
+
+  // Points that were found nowhere, while inside the global bounding box,
+  // are offered to all processors in turn
+  std::vector<Uint> not_found;
+  for (Uint t=0; t<nb_coords; ++t)
+  {
+    if (m_proc[t]<0 && in_global_box[t])
+      not_found.push_back(t);
+  }
+  if (needs_ring_fallback(not_found.size()))
+    ring_store(target_coords, not_found);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Interpolator::ring_store(const Table<Real>& target_coords, std::vector<Uint> not_found)
+{
+  const Uint nb_coords = target_coords.size();
+  const Uint dim = target_coords.row_size();
 
-  // Now find missing on other procs.
   for (Uint pid=0; pid<PE::Comm::instance().size(); pid++)
   {
     // Trade my requests with processor send and recv
@@ -121,7 +432,7 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
     const Uint pid_recv_coords = (PE::Comm::instance().size() + PE::Comm::instance().rank() - pid) %
                                   PE::Comm::instance().size();
 
-    std::vector<Real> send_coords; send_coords.reserve(not_found.size()*target_coords.row_size());
+    std::vector<Real> send_coords; send_coords.reserve(not_found.size()*dim);
     std::vector<Real> received_coords;
 
     // fill in coords to send
@@ -139,21 +450,10 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
 
     Uint nb_received_coords = received_coords.size()/dim;
 
-    // Find interpolated
-
-    m_stored_element[pid_recv_coords].clear();
-    m_stored_stencil[pid_recv_coords].clear();
-    m_stored_source_field_points[pid_recv_coords].clear();
-    m_stored_source_field_weights[pid_recv_coords].clear();
-
-    m_stored_element[pid_recv_coords].reserve(nb_received_coords);
-    m_stored_stencil[pid_recv_coords].reserve(nb_received_coords);
-    m_stored_source_field_points[pid_recv_coords].reserve(nb_received_coords);
-    m_stored_source_field_weights[pid_recv_coords].reserve(nb_received_coords);
+    // Find interpolated, appending to what was stored by the routed exchange
 
     std::vector<Uint> send_found_coords;  send_found_coords.reserve(nb_received_coords);
 
-    Uint dim = target_coords.row_size();
     RealVector t_point(dim);
     SpaceElem element;
     std::vector<SpaceElem> stencil;
@@ -191,8 +491,6 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
     Interpolator_send_receive (pid_send_back, send_found_coords,
                                pid_recv_back, recv_found_coords);
 
-    m_expect_recv[pid_recv_back].reserve(recv_found_coords.size());
-
     boost_foreach(const Uint i, recv_found_coords)
     {
       cf3_assert(i<not_found.size());
@@ -202,12 +500,13 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
       m_expect_recv[pid_recv_back].push_back(t);
     }
 
-    not_found.clear();
-    for (Uint t=0; t<nb_coords; ++t)
+    std::vector<Uint> still_not_found; still_not_found.reserve(not_found.size());
+    boost_foreach (const Uint t, not_found)
     {
       if (m_proc[t]<0)
-        not_found.push_back(t);
+        still_not_found.push_back(t);
     }
+    not_found.swap(still_not_found);
   }
 }
 
@@ -215,28 +514,25 @@ void Interpolator::store(const Dictionary& dict, const Table<Real>& target_coord
 
 void Interpolator::stored_interpolation(const Field& source_field, Table<Real>& target)
 {
+  const Uint nb_procs = m_stored_element.size();
+
+  // number of variables for each point to be interpolated
+  const Uint nb_vars = m_source_vars.size();
+
   // Do interpolation on processors that can do the interpolation,
-  // and send back an array of interpolated values
-  for (Uint pid=0; pid<PE::Comm::instance().size(); pid++)
+  // and send back an array of interpolated values to the processors that requested them
+  std::vector< std::vector<Real> > send_interpolated(nb_procs);
+  for (Uint pid=0; pid<nb_procs; pid++)
   {
-    // Trade my requests with processor send and recv
-    const Uint pid_send_interpolated = (PE::Comm::instance().size() + PE::Comm::instance().rank() - pid) %
-                                        PE::Comm::instance().size();
-    const Uint pid_recv_interpolated = (PE::Comm::instance().rank() + pid) %
-                                        PE::Comm::instance().size();
-
     // number of points to be interpolated
-    const Uint nb_points = m_stored_element[pid_send_interpolated].size();
+    const Uint nb_points = m_stored_element[pid].size();
 
-    // number of variables for each point to be interpolated
-    const Uint nb_vars = m_source_vars.size();
-
-    // storage for interpolated variables, which will be sent to the pid that reqests it (pid_recv_interpolated)
-    std::vector<Real> interpolated; interpolated.reserve(nb_points*nb_vars);
+    std::vector<Real>& interpolated = send_interpolated[pid];
+    interpolated.reserve(nb_points*nb_vars);
 
     // Interpolation points and weights
-    const std::vector< std::vector<Uint> >& s_points  = m_stored_source_field_points[pid_send_interpolated];
-    const std::vector< std::vector<Real> >& s_weights = m_stored_source_field_weights[pid_send_interpolated];
+    const std::vector< std::vector<Uint> >& s_points  = m_stored_source_field_points[pid];
+    const std::vector< std::vector<Real> >& s_weights = m_stored_source_field_weights[pid];
 
     // Do interpolation
     for (Uint t=0; t<nb_points; ++t)
@@ -251,20 +547,23 @@ void Interpolator::stored_interpolation(const Field& source_field, Table<Real>&
         }
       }
     }
+  }
 
-    // Send/Receive interpolated variables
-    std::vector<Real> recv_interpolated;
-    Interpolator_send_receive(pid_send_interpolated   , interpolated,
-                              pid_recv_interpolated   , recv_interpolated);
+  // Send/Receive interpolated variables
+  std::vector< std::vector<Real> > recv_interpolated;
+  Interpolator_all_to_all(send_interpolated, recv_interpolated);
 
-    // Fill the target_field with received interpolated variables from requested processor
+  // Fill the target_field with received interpolated variables from each processor
+  for (Uint pid=0; pid<nb_procs; pid++)
+  {
     Uint it=0;
-    boost_foreach( const Uint t, m_expect_recv[pid_recv_interpolated] )
+    boost_foreach( const Uint t, m_expect_recv[pid] )
     {
       for (Uint v=0; v<nb_vars; ++v)
       {
         cf3_assert(t<target.size());
-        target[t][ m_target_vars[v] ] = recv_interpolated[it++];
+        cf3_assert(it<recv_interpolated[pid].size());
+        target[t][ m_target_vars[v] ] = recv_interpolated[pid][it++];
       }
     }
   }
@@ -283,12 +582,133 @@ void Interpolator::unstored_interpolation(const Field& source_field, const commo
 
   const Uint nb_coords = target_coords.size();
   const Uint dim = target_coords.row_size();
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  // number of variables for each point to be interpolated
+  const Uint nb_vars = m_source_vars.size();
+
+  if (!options().value<bool>("routing"))
+  {
+    std::vector<Uint> all_coords(nb_coords);
+    for (Uint t=0; t<nb_coords; ++t)
+      all_coords[t] = t;
+    ring_interpolation(source_field, target_coords, target, all_coords);
+    return;
+  }
+
+  // Send each coordinate only to the processors whose bounding box contains it
+  std::vector< std::vector<Uint> > requests;
+  std::vector<bool> in_global_box;
+  route_coordinates(source_field.dict(), target_coords, requests, in_global_box);
+
+  std::vector< std::vector<Real> > send_coords(nb_procs);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    send_coords[p].reserve(requests[p].size()*dim);
+    boost_foreach (const Uint t, requests[p])
+    {
+      boost_foreach (const Real& xyz, target_coords[t])
+      {
+        send_coords[p].push_back(xyz);
+      }
+    }
+  }
+  std::vector< std::vector<Real> > received_coords;
+  Interpolator_all_to_all(send_coords, received_coords);
+
+  // Interpolate the received coordinates of all processors in one batch,
+  // and send back the found ones with their values
+  std::vector<Uint> received_offsets(nb_procs+1, 0u);
+  for (Uint p=0; p<nb_procs; ++p)
+    received_offsets[p+1] = received_offsets[p] + received_coords[p].size()/dim;
+  boost::multi_array<Real,2> all_received_coords(boost::extents[received_offsets.back()][dim]);
+  for (Uint p=0; p<nb_procs; ++p)
+    std::copy(received_coords[p].begin(), received_coords[p].end(), all_received_coords.data()+received_offsets[p]*dim);
+
+  std::vector< SpaceElem              > found_element;
+  std::vector< std::vector<SpaceElem> > found_stencil;
+  std::vector< std::vector<Uint>      > found_points;
+  std::vector< std::vector<Real>      > found_weights;
+  std::vector<bool> found_here;
+  m_point_interpolator->compute_storage(all_received_coords, found_element, found_stencil, found_points, found_weights, found_here);
+
+  std::vector< std::vector<Uint> > send_found_coords(nb_procs);
+  std::vector< std::vector<Real> > send_interpolated(nb_procs);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    for (Uint t=0; t<received_offsets[p+1]-received_offsets[p]; ++t)
+    {
+      const Uint i = received_offsets[p]+t;
+      if (!found_here[i])
+        continue;
+
+      // mark found
+      send_found_coords[p].push_back(t);
+
+      for (Uint v=0; v<nb_vars; ++v)
+      {
+        send_interpolated[p].push_back(0.);
+        for (Uint s=0; s<found_points[i].size(); ++s)
+        {
+          cf3_assert(found_points[i][s]<source_field.size());
+          send_interpolated[p].back() += source_field[ found_points[i][s] ][ m_source_vars[v] ] * found_weights[i][s];
+        }
+      }
+    }
+  }
+
+  std::vector< std::vector<Uint> > recv_found_coords;
+  std::vector< std::vector<Real> > recv_interpolated;
+  Interpolator_all_to_all(send_found_coords, recv_found_coords);
+  Interpolator_all_to_all(send_interpolated, recv_interpolated);
+
+  // A coordinate found on several processors takes the values of the lowest rank
+  std::vector<bool> found(nb_coords, false);
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    Uint it=0;
+    boost_foreach(const Uint i, recv_found_coords[p])
+    {
+      cf3_assert(i<requests[p].size());
+      const Uint t = requests[p][i];
+      if (found[t])
+      {
+        it += nb_vars;
+        continue;
+      }
+      found[t] = true;
+      for (Uint v=0; v<nb_vars; ++v)
+      {
+        cf3_assert(t<target.size());
+        target[t][ m_target_vars[v] ] = recv_interpolated[p][it++];
+      }
+    }
+  }
+
+  // Points that were found nowhere, while inside the global bounding box,
+  // are offered to all processors in turn
+  std::vector<Uint> not_found;
+  for (Uint t=0; t<nb_coords; ++t)
+  {
+    if (!found[t] && in_global_box[t])
+      not_found.push_back(t);
+  }
+  if (needs_ring_fallback(not_found.size()))
+    ring_interpolation(source_field, target_coords, target, not_found);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Interpolator::ring_interpolation(const Field& source_field, const common::Table<Real>& target_coords, common::Table<Real>& target, std::vector<Uint> not_found)
+{
+  const Uint nb_coords = target_coords.size();
+  const Uint dim = target_coords.row_size();
+
+  // number of variables for each point to be interpolated
+  const Uint nb_vars = m_source_vars.size();
 
-  std::vector<int> not_found; not_found.reserve(nb_coords);
-  for (Uint i=0; i<nb_coords; ++i)
-    not_found.push_back(i);
+  std::vector<bool> found(nb_coords, false);
 
-  // Now find missing on other procs.
   for (Uint pid=0; pid<PE::Comm::instance().size(); pid++)
   {
     // Trade my requests with processor send and recv
@@ -297,20 +717,15 @@ void Interpolator::unstored_interpolation(const Field& source_field, const commo
     const Uint pid_recv_coords = (PE::Comm::instance().size() + PE::Comm::instance().rank() - pid) %
                                   PE::Comm::instance().size();
 
-    std::vector<Real> send_coords; send_coords.reserve(not_found.size()*target_coords.row_size());
-    std::vector<Uint>  unknown_ids; unknown_ids.reserve(not_found.size());
+    std::vector<Real> send_coords; send_coords.reserve(not_found.size()*dim);
     std::vector<Real> received_coords;
 
     // fill in coords to send
-    boost_foreach (const int t, not_found)
+    boost_foreach (const Uint t, not_found)
     {
-      if (t>=0)
+      boost_foreach (const Real& xyz, target_coords[t])
       {
-        unknown_ids.push_back(t);
-        boost_foreach (const Real& xyz, target_coords[t])
-        {
-          send_coords.push_back(xyz);
-        }
+        send_coords.push_back(xyz);
       }
     }
 
@@ -324,13 +739,9 @@ void Interpolator::unstored_interpolation(const Field& source_field, const commo
 
     std::vector<Uint> send_found_coords;  send_found_coords.reserve(nb_received_coords);
 
-    // number of variables for each point to be interpolated
-    const Uint nb_vars = m_source_vars.size();
-
     // storage for interpolated variables, which will be sent to the pid that reqests it (pid_recv_interpolated)
     std::vector<Real> send_interpolated; send_interpolated.reserve(nb_received_coords*nb_vars);
 
-    Uint dim = target_coords.row_size();
     RealVector t_point(dim);
     RealVector t_val(source_field.row_size());
 
@@ -363,16 +774,24 @@ void Interpolator::unstored_interpolation(const Field& source_field, const commo
     Uint it=0;
     boost_foreach(const Uint i, recv_found_coords)
     {
-      cf3_assert(i<unknown_ids.size());
-      const int t = unknown_ids[i];
-      not_found[t] = -1;
-      cf3_assert_desc(common::to_str(t)+'<'+common::to_str(nb_coords),t<(int)nb_coords);
+      cf3_assert(i<not_found.size());
+      const Uint t = not_found[i];
+      cf3_assert_desc(common::to_str(t)+'<'+common::to_str(nb_coords),t<nb_coords);
+      found[t] = true;
       for (Uint v=0; v<nb_vars; ++v)
       {
         cf3_assert(t<target.size());
         target[t][ m_target_vars[v] ] = recv_interpolated[it++];
       }
     }
+
+    std::vector<Uint> still_not_found; still_not_found.reserve(not_found.size());
+    boost_foreach (const Uint t, not_found)
+    {
+      if (!found[t])
+        still_not_found.push_back(t);
+    }
+    not_found.swap(still_not_found);
   }
 }
 
@@ -27,6 +27,11 @@ class APointInterpolator;
 /// mesh as the source, depending on concrete implementations
 /// The interpolation also works with parallel distributed fields. Interpolation
 /// is delegated to the processor that has the necessary source values.
+/// Each processor publishes the bounding box of its part of the source dictionary,
+/// and a coordinate is only sent to the processors whose box contains it.
+/// Coordinates that are not found this way are offered to all processors in turn
+/// if the option "ring_fallback" is enabled. Disabling the option "routing" offers
+/// all coordinates to all processors in turn.
 /// @author Willem Deconinck
 class Mesh_API Interpolator : public AInterpolator {
 
@@ -56,12 +61,32 @@ public: // functions
 
 private: // functions
 
+  /// Discard the stored interpolation, when an option changes the way it is computed
+  void trigger_reset_storage();
+
   void store(const Dictionary& dict, const common::Table<Real>& target_coords);
 
   void stored_interpolation(const Field& source_field, common::Table<Real>& target);
 
   void unstored_interpolation(const Field& source_field, const common::Table<Real>& target_coords, common::Table<Real>& target);
 
+  /// Compute for every processor the coordinates that lie inside its bounding box of dict (collective)
+  /// @param [out] requests       For each processor, the indices of the target_coords to send to it
+  /// @param [out] in_global_box  For each coordinate, true if it is inside the union of all bounding boxes
+  void route_coordinates(const Dictionary& dict, const common::Table<Real>& target_coords, std::vector< std::vector<Uint> >& requests, std::vector<bool>& in_global_box) const;
+
+  /// Index of the cell containing x, in a uniform grid of nb_cells_1d cells starting at min
+  static Uint cell_index(const Real x, const Real min, const Real cell_size, const Uint nb_cells_1d);
+
+  /// True if any processor has coordinates left that were not found (collective)
+  bool needs_ring_fallback(const Uint nb_not_found) const;
+
+  /// Compute the storage of the not_found coordinates by passing them to all processors in turn
+  void ring_store(const common::Table<Real>& target_coords, std::vector<Uint> not_found);
+
+  /// Interpolate the not_found coordinates by passing them to all processors in turn
+  void ring_interpolation(const Field& source_field, const common::Table<Real>& target_coords, common::Table<Real>& target, std::vector<Uint> not_found);
+
 protected: // data
 
   /// The strategy to interpolate one coordinate
@@ -24,15 +24,18 @@ common::ComponentBuilder < ElementTypeT<Point1D>, ElementType , LibLagrangeP0 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0);
+  connectivity.stride.assign(1, 1);
+  connectivity.nodes = boost::assign::list_of(0);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Point1D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0);
-    connectivity.stride.assign(1, 1);
-    connectivity.nodes = boost::assign::list_of(0);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
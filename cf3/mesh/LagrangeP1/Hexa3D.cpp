@@ -23,31 +23,29 @@ namespace LagrangeP1 {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-Eigen::Matrix<Real,Hexa3D::nb_nodes,1> Hexa3D::m_shapeFunc;
-Eigen::Matrix<Real,Hexa3D::nb_nodes,Hexa3D::dimensionality> Hexa3D::m_shapeFuncDerivs;
-Eigen::Matrix<Real,Hexa3D::dimension,1> Hexa3D::m_vec1;
-Eigen::Matrix<Real,Hexa3D::dimension,1> Hexa3D::m_vec2;
-
 common::ComponentBuilder < ElementTypeT<Hexa3D>, ElementType , LibLagrangeP1 >
    Hexa3D_Builder(LibLagrangeP1::library_namespace()+"."+Hexa3D::type_name());
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0)(4)(8)(12)(16)(20);
+  connectivity.stride.assign(Hexa3D::nb_faces, 4);
+  connectivity.nodes = boost::assign::list_of
+      (0)(3)(2)(1)
+      (4)(5)(6)(7)
+      (0)(1)(5)(4)
+      (1)(2)(6)(5)
+      (3)(7)(6)(2)
+      (0)(4)(7)(3);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Hexa3D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0)(4)(8)(12)(16)(20);
-    connectivity.stride.assign(nb_faces, 4);
-    connectivity.nodes = boost::assign::list_of
-        (0)(3)(2)(1)
-        (4)(5)(6)(7)
-        (0)(1)(5)(4)
-        (1)(2)(6)(5)
-        (3)(7)(6)(2)
-        (0)(4)(7)(3);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
@@ -405,92 +403,95 @@ void Hexa3D::compute_plane_jacobian_normal(const MappedCoordsT& mapped_coord, co
   const Real c1 = 1. + zta;
   const Real c2 = 1. - zta;
 
+  Eigen::Matrix<Real,nb_nodes,dimensionality> shape_func_derivs;
+  CoordsT vec1, vec2;
+
   switch (orientation)
   {
     case KSI:
 
-      m_shapeFuncDerivs(0,ETA) = -a2*c2;
-      m_shapeFuncDerivs(1,ETA) = -a1*c2;
-      m_shapeFuncDerivs(2,ETA) =  a1*c2;
-      m_shapeFuncDerivs(3,ETA) =  a2*c2;
-      m_shapeFuncDerivs(4,ETA) = -a2*c1;
-      m_shapeFuncDerivs(5,ETA) = -a1*c1;
-      m_shapeFuncDerivs(6,ETA) =  a1*c1;
-      m_shapeFuncDerivs(7,ETA) =  a2*c1;
-
-      m_shapeFuncDerivs(0,ZTA) = -a2*b2;
-      m_shapeFuncDerivs(1,ZTA) = -a1*b2;
-      m_shapeFuncDerivs(2,ZTA) = -a1*b1;
-      m_shapeFuncDerivs(3,ZTA) = -a2*b1;
-      m_shapeFuncDerivs(4,ZTA) =  b2*a2;
-      m_shapeFuncDerivs(5,ZTA) =  b2*a1;
-      m_shapeFuncDerivs(6,ZTA) =  b1*a1;
-      m_shapeFuncDerivs(7,ZTA) =  b1*a2;
-
-      m_vec1 = m_shapeFuncDerivs(0,ETA)*(nodes.row(0));
-      m_vec2 = m_shapeFuncDerivs(0,ZTA)*(nodes.row(0));
+      shape_func_derivs(0,ETA) = -a2*c2;
+      shape_func_derivs(1,ETA) = -a1*c2;
+      shape_func_derivs(2,ETA) =  a1*c2;
+      shape_func_derivs(3,ETA) =  a2*c2;
+      shape_func_derivs(4,ETA) = -a2*c1;
+      shape_func_derivs(5,ETA) = -a1*c1;
+      shape_func_derivs(6,ETA) =  a1*c1;
+      shape_func_derivs(7,ETA) =  a2*c1;
+
+      shape_func_derivs(0,ZTA) = -a2*b2;
+      shape_func_derivs(1,ZTA) = -a1*b2;
+      shape_func_derivs(2,ZTA) = -a1*b1;
+      shape_func_derivs(3,ZTA) = -a2*b1;
+      shape_func_derivs(4,ZTA) =  b2*a2;
+      shape_func_derivs(5,ZTA) =  b2*a1;
+      shape_func_derivs(6,ZTA) =  b1*a1;
+      shape_func_derivs(7,ZTA) =  b1*a2;
+
+      vec1 = shape_func_derivs(0,ETA)*(nodes.row(0));
+      vec2 = shape_func_derivs(0,ZTA)*(nodes.row(0));
       for (Uint in = 1; in < 8; ++in)
       {
-        m_vec1 += m_shapeFuncDerivs(in,ETA)*(nodes.row(in));
-        m_vec2 += m_shapeFuncDerivs(in,ZTA)*(nodes.row(in));
+        vec1 += shape_func_derivs(in,ETA)*(nodes.row(in));
+        vec2 += shape_func_derivs(in,ZTA)*(nodes.row(in));
       }
       break;
 
     case ETA:
 
-      m_shapeFuncDerivs(0,ZTA) = -a2*b2;
-      m_shapeFuncDerivs(1,ZTA) = -a1*b2;
-      m_shapeFuncDerivs(2,ZTA) = -a1*b1;
-      m_shapeFuncDerivs(3,ZTA) = -a2*b1;
-      m_shapeFuncDerivs(4,ZTA) =  b2*a2;
-      m_shapeFuncDerivs(5,ZTA) =  b2*a1;
-      m_shapeFuncDerivs(6,ZTA) =  b1*a1;
-      m_shapeFuncDerivs(7,ZTA) =  b1*a2;
-
-      m_shapeFuncDerivs(0,KSI) = -b2*c2;
-      m_shapeFuncDerivs(1,KSI) =  b2*c2;
-      m_shapeFuncDerivs(2,KSI) =  b1*c2;
-      m_shapeFuncDerivs(3,KSI) = -b1*c2;
-      m_shapeFuncDerivs(4,KSI) = -b2*c1;
-      m_shapeFuncDerivs(5,KSI) =  b2*c1;
-      m_shapeFuncDerivs(6,KSI) =  b1*c1;
-      m_shapeFuncDerivs(7,KSI) = -b1*c1;
-
-      m_vec1 = m_shapeFuncDerivs(0,ZTA)*(nodes.row(0));
-      m_vec2 = m_shapeFuncDerivs(0,KSI)*(nodes.row(0));
+      shape_func_derivs(0,ZTA) = -a2*b2;
+      shape_func_derivs(1,ZTA) = -a1*b2;
+      shape_func_derivs(2,ZTA) = -a1*b1;
+      shape_func_derivs(3,ZTA) = -a2*b1;
+      shape_func_derivs(4,ZTA) =  b2*a2;
+      shape_func_derivs(5,ZTA) =  b2*a1;
+      shape_func_derivs(6,ZTA) =  b1*a1;
+      shape_func_derivs(7,ZTA) =  b1*a2;
+
+      shape_func_derivs(0,KSI) = -b2*c2;
+      shape_func_derivs(1,KSI) =  b2*c2;
+      shape_func_derivs(2,KSI) =  b1*c2;
+      shape_func_derivs(3,KSI) = -b1*c2;
+      shape_func_derivs(4,KSI) = -b2*c1;
+      shape_func_derivs(5,KSI) =  b2*c1;
+      shape_func_derivs(6,KSI) =  b1*c1;
+      shape_func_derivs(7,KSI) = -b1*c1;
+
+      vec1 = shape_func_derivs(0,ZTA)*(nodes.row(0));
+      vec2 = shape_func_derivs(0,KSI)*(nodes.row(0));
       for (Uint in = 1; in < 8; ++in)
       {
-        m_vec1 += m_shapeFuncDerivs(in,ZTA)*(nodes.row(in));
-        m_vec2 += m_shapeFuncDerivs(in,KSI)*(nodes.row(in));
+        vec1 += shape_func_derivs(in,ZTA)*(nodes.row(in));
+        vec2 += shape_func_derivs(in,KSI)*(nodes.row(in));
       }
       break;
 
     case ZTA:
 
-      m_shapeFuncDerivs(0,KSI) = -b2*c2;
-      m_shapeFuncDerivs(1,KSI) =  b2*c2;
-      m_shapeFuncDerivs(2,KSI) =  b1*c2;
-      m_shapeFuncDerivs(3,KSI) = -b1*c2;
-      m_shapeFuncDerivs(4,KSI) = -b2*c1;
-      m_shapeFuncDerivs(5,KSI) =  b2*c1;
-      m_shapeFuncDerivs(6,KSI) =  b1*c1;
-      m_shapeFuncDerivs(7,KSI) = -b1*c1;
-
-      m_shapeFuncDerivs(0,ETA) = -a2*c2;
-      m_shapeFuncDerivs(1,ETA) = -a1*c2;
-      m_shapeFuncDerivs(2,ETA) =  a1*c2;
-      m_shapeFuncDerivs(3,ETA) =  a2*c2;
-      m_shapeFuncDerivs(4,ETA) = -a2*c1;
-      m_shapeFuncDerivs(5,ETA) = -a1*c1;
-      m_shapeFuncDerivs(6,ETA) =  a1*c1;
-      m_shapeFuncDerivs(7,ETA) =  a2*c1;
-
-      m_vec1 = m_shapeFuncDerivs(0,KSI)*(nodes.row(0));
-      m_vec2 = m_shapeFuncDerivs(0,ETA)*(nodes.row(0));
+      shape_func_derivs(0,KSI) = -b2*c2;
+      shape_func_derivs(1,KSI) =  b2*c2;
+      shape_func_derivs(2,KSI) =  b1*c2;
+      shape_func_derivs(3,KSI) = -b1*c2;
+      shape_func_derivs(4,KSI) = -b2*c1;
+      shape_func_derivs(5,KSI) =  b2*c1;
+      shape_func_derivs(6,KSI) =  b1*c1;
+      shape_func_derivs(7,KSI) = -b1*c1;
+
+      shape_func_derivs(0,ETA) = -a2*c2;
+      shape_func_derivs(1,ETA) = -a1*c2;
+      shape_func_derivs(2,ETA) =  a1*c2;
+      shape_func_derivs(3,ETA) =  a2*c2;
+      shape_func_derivs(4,ETA) = -a2*c1;
+      shape_func_derivs(5,ETA) = -a1*c1;
+      shape_func_derivs(6,ETA) =  a1*c1;
+      shape_func_derivs(7,ETA) =  a2*c1;
+
+      vec1 = shape_func_derivs(0,KSI)*(nodes.row(0));
+      vec2 = shape_func_derivs(0,ETA)*(nodes.row(0));
       for (Uint in = 1; in < 8; ++in)
       {
-        m_vec1 += m_shapeFuncDerivs(in,KSI)*(nodes.row(in));
-        m_vec2 += m_shapeFuncDerivs(in,ETA)*(nodes.row(in));
+        vec1 += shape_func_derivs(in,KSI)*(nodes.row(in));
+        vec2 += shape_func_derivs(in,ETA)*(nodes.row(in));
       }
       break;
 
@@ -499,7 +500,7 @@ void Hexa3D::compute_plane_jacobian_normal(const MappedCoordsT& mapped_coord, co
   }
 
   // compute normal
-  math::Functions::cross_product(m_vec1,m_vec2,result);
+  math::Functions::cross_product(vec1,vec2,result);
   result *= 0.015625;
 }
 ////////////////////////////////////////////////////////////////////////////////
@@ -27,16 +27,19 @@ common::ComponentBuilder < ElementTypeT<Line1D>, ElementType , LibLagrangeP1 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0)(1);
+  connectivity.stride.assign(Line1D::nb_faces, 1);
+  connectivity.nodes = boost::assign::list_of(0)
+                                             (1);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Line1D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0)(1);
-    connectivity.stride.assign(nb_faces, 1);
-    connectivity.nodes = boost::assign::list_of(0)
-                                               (1);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
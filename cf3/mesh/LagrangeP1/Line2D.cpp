@@ -27,15 +27,18 @@ common::ComponentBuilder < ElementTypeT<Line2D>, ElementType , LibLagrangeP1 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0);
+  connectivity.stride.assign(1, 2);
+  connectivity.nodes = boost::assign::list_of(0)(1);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Line2D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0);
-    connectivity.stride.assign(1, 2);
-    connectivity.nodes = boost::assign::list_of(0)(1);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
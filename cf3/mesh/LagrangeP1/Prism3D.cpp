@@ -28,20 +28,23 @@ common::ComponentBuilder < ElementTypeT<Prism3D>, ElementType , LibLagrangeP1 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0)(3)(6)(10)(14)(18);
+  connectivity.stride = boost::assign::list_of(3)(3)(4)(4)(4)(4);
+  connectivity.nodes = boost::assign::list_of
+      (0)(1)(2)
+      (3)(5)(4)
+      (0)(2)(5)(3)
+      (0)(3)(4)(1)
+      (2)(1)(4)(5);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Prism3D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0)(3)(6)(10)(14)(18);
-    connectivity.stride = boost::assign::list_of(3)(3)(4)(4)(4)(4);
-    connectivity.nodes = boost::assign::list_of
-        (0)(1)(2)
-        (3)(5)(4)
-        (0)(2)(5)(3)
-        (0)(3)(4)(1)
-        (2)(1)(4)(5);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
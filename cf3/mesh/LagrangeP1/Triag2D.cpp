@@ -54,17 +54,20 @@ Real jacobian_determinant_helper(const Triag2D::NodesT& nodes)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0)(2)(4);
+  connectivity.stride.assign(Triag2D::nb_faces, 2);
+  connectivity.nodes = boost::assign::list_of(0)(1)
+                                             (1)(2)
+                                             (2)(0);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Triag2D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0)(2)(4);
-    connectivity.stride.assign(nb_faces, 2);
-    connectivity.nodes = boost::assign::list_of(0)(1)
-                                               (1)(2)
-                                               (2)(0);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
@@ -40,15 +40,18 @@ Real jacobian_determinant_helper(const Triag3D::NodesT& nodes)
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0);
+  connectivity.stride.assign(1, Triag3D::nb_nodes);
+  connectivity.nodes = boost::assign::list_of(0)(1)(2);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Triag3D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0);
-    connectivity.stride.assign(1, nb_nodes);
-    connectivity.nodes = boost::assign::list_of(0)(1)(2);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
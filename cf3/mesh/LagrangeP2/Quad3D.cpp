@@ -24,15 +24,18 @@ common::ComponentBuilder < ElementTypeT<Quad3D>, ElementType , LibLagrangeP2 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0);
+  connectivity.stride.assign(1, Quad3D::nb_nodes);
+  connectivity.nodes = boost::assign::list_of(0)(1)(2)(3);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Quad3D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0);
-    connectivity.stride.assign(1, nb_nodes);
-    connectivity.nodes = boost::assign::list_of(0)(1)(2)(3);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
@@ -25,18 +25,21 @@ common::ComponentBuilder < ElementTypeT<Quad2D>, ElementType , LibLagrangeP3 >
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static ElementType::FaceConnectivity build_faces()
+{
+  ElementType::FaceConnectivity connectivity;
+  connectivity.displs = boost::assign::list_of(0)(4)(8)(12);
+  connectivity.stride.assign(Quad2D::nb_faces, 4);
+  connectivity.nodes = boost::assign::list_of(0)(4)(5)(1)
+                                             (1)(6)(7)(2)
+                                             (2)(8)(9)(3)
+                                             (3)(10)(11)(0);
+  return connectivity;
+}
+
 const cf3::mesh::ElementType::FaceConnectivity& Quad2D::faces()
 {
-  static ElementType::FaceConnectivity connectivity;
-  if(connectivity.displs.empty())
-  {
-    connectivity.displs = boost::assign::list_of(0)(4)(8)(12);
-    connectivity.stride.assign(nb_faces, 4);
-    connectivity.nodes = boost::assign::list_of(0)(4)(5)(1)
-                                               (1)(6)(7)(2)
-                                               (2)(8)(9)(3)
-                                               (3)(10)(11)(0);
-  }
+  static const ElementType::FaceConnectivity connectivity = build_faces();
   return connectivity;
 }
 
@@ -0,0 +1,114 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <exception>
+
+#include "common/BasicExceptions.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/MappedFile.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  /// Start of the first line that starts at or after split
+  const char* line_boundary(const char* begin, const char* end, const char* split)
+  {
+    return (split == begin || split == end) ? split : next_line(split-1, end);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+MappedFile::MappedFile(const std::string& path)
+{
+  try
+  {
+    m_file.open(path);
+  }
+  catch(std::exception& e)
+  {
+    throw FileSystemError(FromHere(), "Could not map file " + path + ": " + e.what());
+  }
+  if(!m_file.is_open())
+    throw FileSystemError(FromHere(), "Could not map file " + path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+std::vector<MappedFile::KeywordLine> MappedFile::find_keyword_lines(const std::vector<std::string>& keywords) const
+{
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  const Uint part = parallel ? PE::Comm::instance().rank() : 0;
+  const Uint nb_parts = parallel ? PE::Comm::instance().size() : 1;
+
+  const char* share_begin;
+  const char* share_end;
+  line_aligned_share(begin(), end(), part, nb_parts, share_begin, share_end);
+
+  // Pairs of (offset, keyword index)
+  std::vector<Uint> found;
+  for(const char* line = share_begin; line != share_end; line = next_line(line, share_end))
+  {
+    const char* p = skip_blanks(line, share_end);
+    for(Uint k = 0; k != keywords.size(); ++k)
+    {
+      const std::string& keyword = keywords[k];
+      if(Uint(share_end - p) >= keyword.size() && std::memcmp(p, keyword.data(), keyword.size()) == 0)
+      {
+        found.push_back(line - begin());
+        found.push_back(k);
+        break;
+      }
+    }
+  }
+
+  std::vector< std::vector<Uint> > found_per_part;
+  if(parallel)
+    PE::Comm::instance().all_gather(found, found_per_part);
+  else
+    found_per_part.assign(1, found);
+
+  // The shares are ordered, so concatenating them keeps the lines sorted
+  std::vector<KeywordLine> result;
+  for(Uint p = 0; p != found_per_part.size(); ++p)
+  {
+    const std::vector<Uint>& part_found = found_per_part[p];
+    for(Uint i = 0; i+1 < part_found.size(); i += 2)
+    {
+      KeywordLine keyword_line;
+      keyword_line.offset = part_found[i];
+      keyword_line.keyword = part_found[i+1];
+      result.push_back(keyword_line);
+    }
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void MappedFile::line_aligned_share(const char* begin, const char* end, const Uint part, const Uint nb_parts, const char*& share_begin, const char*& share_end)
+{
+  cf3_assert(part < nb_parts);
+  const Uint size = end - begin;
+
+  // A line belongs to the part in which its first byte falls
+  share_begin = line_boundary(begin, end, begin + (part*size)/nb_parts);
+  share_end = line_boundary(begin, end, begin + ((part+1)*size)/nb_parts);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
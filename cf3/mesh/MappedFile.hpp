@@ -0,0 +1,212 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_MappedFile_hpp
+#define cf3_mesh_MappedFile_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/noncopyable.hpp>
+
+#include "mesh/LibMesh.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Read-only memory mapping of a mesh file, used by the mesh readers to parse
+/// only a part of a large file on each process.
+class Mesh_API MappedFile : public boost::noncopyable
+{
+public:
+
+  /// Line of the file that starts with one of the keywords passed to find_keyword_lines
+  struct KeywordLine
+  {
+    /// Offset of the start of the line, from the start of the file
+    Uint offset;
+    /// Index of the keyword in the list of keywords
+    Uint keyword;
+  };
+
+  /// Map the file at the given path. Throws a FileSystemError if it can't be mapped.
+  MappedFile(const std::string& path);
+
+  /// Pointer to the first byte of the file
+  const char* begin() const { return m_file.data(); }
+
+  /// Pointer past the last byte of the file
+  const char* end() const { return m_file.data() + m_file.size(); }
+
+  /// Number of bytes in the file
+  Uint size() const { return m_file.size(); }
+
+  /// Find the lines that start with one of the keywords, after leading blanks. Each process scans an equal
+  /// share of the file and the results are gathered on all processes, so this is collective if the
+  /// communicator is active. The returned lines are sorted by offset.
+  std::vector<KeywordLine> find_keyword_lines(const std::vector<std::string>& keywords) const;
+
+  /// Part of the lines in [begin,end) to be handled by the given part, when splitting
+  /// them in nb_parts parts of roughly equal size in bytes. Each line belongs to exactly one part.
+  static void line_aligned_share(const char* begin, const char* end, const Uint part, const Uint nb_parts, const char*& share_begin, const char*& share_end);
+
+private:
+  boost::iostreams::mapped_file_source m_file;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @name Parsing helpers
+/// Parse a number at p, skipping leading whitespace (including line ends) and advancing p past the number.
+/// They return false if no number could be read before end.
+//@{
+
+/// Pointer to the start of the line following the one containing p, or end
+inline const char* next_line(const char* p, const char* end)
+{
+  const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+  return eol ? eol + 1 : end;
+}
+
+/// Skip blanks, not including line ends
+inline const char* skip_blanks(const char* p, const char* end)
+{
+  while(p != end && (*p == ' ' || *p == '\t' || *p == '\r'))
+    ++p;
+  return p;
+}
+
+inline const char* skip_whitespace(const char* p, const char* end)
+{
+  while(p != end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+    ++p;
+  return p;
+}
+
+inline bool parse_uint(const char*& p, const char* end, Uint& value)
+{
+  p = skip_whitespace(p, end);
+  if(p == end || *p < '0' || *p > '9')
+    return false;
+  Uint result = 0;
+  while(p != end && *p >= '0' && *p <= '9')
+    result = 10*result + Uint(*p++ - '0');
+  value = result;
+  return true;
+}
+
+inline bool parse_int(const char*& p, const char* end, int& value)
+{
+  p = skip_whitespace(p, end);
+  const bool negative = p != end && *p == '-';
+  if(negative || (p != end && *p == '+'))
+    ++p;
+  Uint result;
+  if(!parse_uint(p, end, result))
+    return false;
+  value = negative ? -int(result) : int(result);
+  return true;
+}
+
+/// Reals with up to 15 or 16 significant digits and moderate exponents are converted exactly using a single
+/// multiplication or division by an exact power of ten. Other values fall back to strtod.
+inline bool parse_real(const char*& p, const char* end, Real& value)
+{
+  static const double powers_of_ten[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  static const boost::uint64_t max_exact_mantissa = boost::uint64_t(1) << 53;
+
+  p = skip_whitespace(p, end);
+  const char* start = p;
+  const bool negative = p != end && *p == '-';
+  if(negative || (p != end && *p == '+'))
+    ++p;
+
+  boost::uint64_t mantissa = 0;
+  int exponent = 0;
+  int nb_digits = 0;
+  bool exact = true;
+  for(; p != end && *p >= '0' && *p <= '9'; ++p, ++nb_digits)
+  {
+    if(mantissa < max_exact_mantissa)
+      mantissa = 10*mantissa + (*p - '0');
+    else
+      exact = false;
+  }
+  if(p != end && *p == '.')
+  {
+    for(++p; p != end && *p >= '0' && *p <= '9'; ++p, ++nb_digits)
+    {
+      if(mantissa < max_exact_mantissa)
+      {
+        mantissa = 10*mantissa + (*p - '0');
+        --exponent;
+      }
+      else if(*p != '0')
+      {
+        exact = false;
+      }
+    }
+  }
+  if(nb_digits == 0)
+  {
+    p = start;
+    return false;
+  }
+  if(p != end && (*p == 'e' || *p == 'E' || *p == 'd' || *p == 'D'))
+  {
+    ++p;
+    int explicit_exponent;
+    if(!parse_int(p, end, explicit_exponent))
+    {
+      p = start;
+      return false;
+    }
+    exponent += explicit_exponent;
+  }
+
+  while(mantissa != 0 && mantissa % 10 == 0 && exponent < 0)
+  {
+    mantissa /= 10;
+    ++exponent;
+  }
+
+  if(exact && mantissa <= max_exact_mantissa && exponent >= -22 && exponent <= 22)
+  {
+    const double result = exponent < 0 ? double(mantissa) / powers_of_ten[-exponent] : double(mantissa) * powers_of_ten[exponent];
+    value = negative ? -result : result;
+    return true;
+  }
+
+  // Slow path: the mapped file is not null-terminated, so copy the token. Fortran exponents are not understood by strtod.
+  std::string token(start, p);
+  const std::string::size_type fortran_exponent = token.find_first_of("dD");
+  if(fortran_exponent != std::string::npos)
+    token[fortran_exponent] = 'e';
+  value = std::strtod(token.c_str(), 0);
+  return true;
+}
+
+//@}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_MappedFile_hpp
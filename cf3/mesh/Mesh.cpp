@@ -43,6 +43,7 @@
 #include "mesh/DiscontinuousDictionary.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/MeshElements.hpp"
+#include "mesh/ElementColoring.hpp"
 #include "mesh/ElementType.hpp"
 #include "mesh/WriteMesh.hpp"
 #include "mesh/MeshMetadata.hpp"
@@ -478,6 +479,7 @@ bool Mesh::check_sanity() const
 
 void Mesh::raise_mesh_loaded()
 {
+  invalidate_element_colorings();
   update_structures();
   update_statistics();
 
@@ -506,6 +508,7 @@ void Mesh::raise_mesh_loaded()
 
 void Mesh::raise_mesh_changed()
 {
+  invalidate_element_colorings();
   update_structures();
   update_statistics();
 
@@ -540,6 +543,14 @@ void Mesh::block_mesh_changed ( const bool block )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Mesh::invalidate_element_colorings()
+{
+  boost_foreach(ElementColoring& coloring, find_components_recursively<ElementColoring>(*this))
+    coloring.invalidate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void Mesh::signature_create_space ( SignalArgs& node)
 {
   SignalOptions options( node );
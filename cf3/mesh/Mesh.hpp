@@ -100,6 +100,10 @@ public: // functions
   /// If true, block subsequent raise_mesh_changed event.
   void block_mesh_changed(const bool block);
 
+  /// Mark the element colorings stored in the spaces as out of date, so they are recomputed on the next use.
+  /// Called when the mesh is loaded or changed.
+  void invalidate_element_colorings();
+
   const Handle<BoundingBox>& local_bounding_box()  const { return m_local_bounding_box; }
   const Handle<BoundingBox>& global_bounding_box() const { return m_global_bounding_box; }
 
@@ -12,6 +12,7 @@
 #include "common/Log.hpp"
 #include "common/FindComponents.hpp"
 #include "common/Map.hpp"
+#include "common/RaggedTable.hpp"
 #include "common/PropertyList.hpp"
 
 #include "common/PE/debug.hpp"
@@ -5,7 +5,7 @@
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
 #include "common/FindComponents.hpp"
-#include "common/DynTable.hpp"
+#include "common/RaggedTable.hpp"
 #include "common/Link.hpp"
 #include "common/Builder.hpp"
 
@@ -31,7 +31,7 @@ NodeElementConnectivity::NodeElementConnectivity ( const std::string& name ) :
 {
   m_nodes = create_static_component<common::Link>(mesh::Tags::nodes());
   m_elements = create_static_component<UnifiedData>("elements");
-  m_connectivity = create_static_component<DynTable<Uint> >(mesh::Tags::connectivity_table());
+  m_connectivity = create_static_component<RaggedTable<Uint> >(mesh::Tags::connectivity_table());
   mark_basic();
 }
 
@@ -39,7 +39,7 @@ NodeElementConnectivity::NodeElementConnectivity ( const std::string& name ) :
 
 void NodeElementConnectivity::setup(Region& region)
 {
-  m_connectivity->resize(0);
+  m_connectivity->clear();
   elements().reset();
   boost_foreach( Entities& elements_comp, find_components_recursively<Entities>(region))
     elements().add(elements_comp);
@@ -55,7 +55,6 @@ void NodeElementConnectivity::setup(Region& region)
 void NodeElementConnectivity::set_nodes(Dictionary& nodes)
 {
   m_nodes->link_to(nodes);
-  m_connectivity->resize(nodes.size());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -70,8 +69,8 @@ void NodeElementConnectivity::build_connectivity()
   cf3_assert(m_nodes->follow());
   Dictionary const& nodes = *Handle<Dictionary>(m_nodes->follow());
 
-  // Reserve memory in m_connectivity->array()
-  std::vector<Uint> connectivity_sizes(nodes.size());
+  // Count the elements connected to each node
+  RaggedTable<Uint>::Builder builder(*m_connectivity, nodes.size());
   boost_foreach(Handle<Component> elements_comp, m_elements->components() )
   {
     Entities& elements = dynamic_cast<Entities&>(*elements_comp);
@@ -80,17 +79,13 @@ void NodeElementConnectivity::build_connectivity()
       boost_foreach (const Uint node_idx, elem_nodes)
       {
         cf3_assert(node_idx<nodes.size());
-        ++connectivity_sizes[node_idx];
+        builder.count(node_idx);
       }
     }
   }
-  Uint i(0);
-  boost_foreach (DynTable<Uint>::Row row, m_connectivity->array() )
-  {
-    row.reserve(connectivity_sizes[i++]);
-  }
+  builder.allocate();
 
-  // fill m_connectivity->array()
+  // fill the connectivity table
   Uint glb_elem_idx = 0;
   boost_foreach(Handle<Component> elements_comp, m_elements->components() )
   {
@@ -99,11 +94,12 @@ void NodeElementConnectivity::build_connectivity()
     {
       boost_foreach (const Uint node_idx, elem_nodes)
       {
-        m_connectivity->array()[node_idx].push_back(glb_elem_idx);
+        builder.add(node_idx, glb_elem_idx);
       }
       ++glb_elem_idx;
     }
   }
+  builder.finish();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
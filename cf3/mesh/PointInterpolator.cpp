@@ -58,6 +58,31 @@ void APointInterpolator::configure_dict()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint APointInterpolator::compute_storage(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils, std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found)
+{
+  const Uint nb_coords = coordinates.size();
+  const Uint dim = coordinates.shape()[1];
+  elements.assign(nb_coords, SpaceElem());
+  stencils.resize(nb_coords);
+  points.resize(nb_coords);
+  weights.resize(nb_coords);
+  found.assign(nb_coords, false);
+
+  Uint nb_found = 0;
+  RealVector coord(dim);
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    for (Uint d=0; d<dim; ++d)
+      coord[d] = coordinates[i][d];
+    found[i] = compute_storage(coord,elements[i],stencils[i],points[i],weights[i]);
+    if (found[i])
+      ++nb_found;
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 cf3::common::ComponentBuilder<PointInterpolator,APointInterpolator,LibMesh> PointInterpolator_builder;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -154,5 +179,41 @@ bool PointInterpolator::compute_storage(const RealVector& coordinate, SpaceElem&
 
 ////////////////////////////////////////////////////////////////////////////////
 
+Uint PointInterpolator::compute_storage(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils, std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found)
+{
+  const Uint nb_coords = coordinates.size();
+  const Uint dim = coordinates.shape()[1];
+  stencils.resize(nb_coords);
+  points.resize(nb_coords);
+  weights.resize(nb_coords);
+
+  // 1) Find the elements these coordinates fall in, all at once
+  cf3_assert(m_element_finder);
+  const Uint nb_found = m_element_finder->find_elements(coordinates,elements,found);
+
+  cf3_assert(m_stencil_computer);
+  cf3_assert(m_interpolator_function);
+  RealVector coord(dim);
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    stencils[i].clear();
+    points[i].clear();
+    weights[i].clear();
+    if (!found[i])
+      continue;
+
+    // 2) Find stencil of elements to use
+    m_stencil_computer->compute_stencil(elements[i],stencils[i]);
+
+    // 3) Find interpolation
+    for (Uint d=0; d<dim; ++d)
+      coord[d] = coordinates[i][d];
+    m_interpolator_function->compute_interpolation_weights(coord,stencils[i],points[i],weights[i]);
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
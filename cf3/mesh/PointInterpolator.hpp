@@ -10,6 +10,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "common/Component.hpp"
+#include "common/BoostArray.hpp"
 
 #include "math/MatrixTypes.hpp"
 
@@ -55,6 +56,10 @@ public: // functions
 
   virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights) = 0;
 
+  /// @brief Compute the storage for many coordinates at once, one coordinate per row
+  /// @return the number of coordinates for which the storage was computed
+  virtual Uint compute_storage(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils, std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found);
+
 private: // functions
 
   void configure_dict();
@@ -119,6 +124,9 @@ public: // functions
 
   virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
 
+  /// @brief Compute the storage for many coordinates at once, finding all elements in one batch
+  virtual Uint compute_storage(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils, std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found);
+
 private: // functions
 
   void configure_element_finder();
@@ -40,6 +40,9 @@ public: // functions
 
   virtual bool compute_storage(const RealVector& coordinate, SpaceElem& element, std::vector<SpaceElem>& stencil, std::vector<Uint>& points, std::vector<Real>& weights);
 
+  /// @brief Compute the storage for many coordinates at once, finding all elements in one batch
+  virtual Uint compute_storage(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils, std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found);
+
 private: // functions
 
   void configure();
@@ -114,6 +117,40 @@ bool PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::co
 
 ////////////////////////////////////////////////////////////////////////////////
 
+template< typename ELEMENTFINDER, typename STENCILCOMPUTER, typename INTERPOLATIONFUNCTION>
+Uint PointInterpolatorT<ELEMENTFINDER,STENCILCOMPUTER,INTERPOLATIONFUNCTION>::compute_storage(const boost::multi_array<Real,2>& coordinates, std::vector<SpaceElem>& elements, std::vector< std::vector<SpaceElem> >& stencils, std::vector< std::vector<Uint> >& points, std::vector< std::vector<Real> >& weights, std::vector<bool>& found)
+{
+  const Uint nb_coords = coordinates.size();
+  const Uint dim = coordinates.shape()[1];
+  stencils.resize(nb_coords);
+  points.resize(nb_coords);
+  weights.resize(nb_coords);
+
+  // 1) Find the elements these coordinates fall in, all at once
+  const Uint nb_found = m_element_finder->find_elements(coordinates,elements,found);
+
+  RealVector coord(dim);
+  for (Uint i=0; i<nb_coords; ++i)
+  {
+    stencils[i].clear();
+    points[i].clear();
+    weights[i].clear();
+    if (!found[i])
+      continue;
+
+    // 2) Find stencil of elements to use
+    m_stencil_computer->compute_stencil(elements[i],stencils[i]);
+
+    // 3) Find interpolation
+    for (Uint d=0; d<dim; ++d)
+      coord[d] = coordinates[i][d];
+    m_interpolator_function->compute_interpolation_weights(coord,stencils[i],points[i],weights[i]);
+  }
+  return nb_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // mesh
 } // cf3
 
@@ -19,6 +19,7 @@
 #include "common/Foreach.hpp"
 #include "common/Log.hpp"
 #include "common/PE/Comm.hpp"
+#include "common/PE/write_ordered.hpp"
 #include "common/OptionList.hpp"
 #include "common/OptionT.hpp"
 #include "common/Builder.hpp"
@@ -192,6 +193,19 @@ namespace detail
     }
   }
 
+  // Recursively add base to the offset attributes of the appended DataArrays
+  void shift_offsets(XmlNode& node, const Uint base)
+  {
+    const std::string offset = node.attribute_value("offset");
+    if(!offset.empty())
+      node.set_attribute("offset", to_str(from_str<Uint>(offset) + base));
+    XmlNode child;
+    for (child.content = node.content->first_node(); child.is_valid() ; child.content = child.content->next_sibling() )
+    {
+      shift_offsets(child, base);
+    }
+  }
+
 } // namespace detail
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -206,6 +220,14 @@ Writer::Writer( const std::string& name )
     options().add("distributed_files", false)
     .pretty_name("Distributed Files")
     .description("Indicate if the filesystem is local to each note. When true, the pvtu file is written on each node.");
+
+    options().add("single_file", false)
+    .pretty_name("Single File")
+    .description("Write all processes into a single vtu file with one piece per process, using collective MPI-IO, instead of one file per process and a pvtu file.");
+
+    options().add("io_aggregators", 0u)
+    .pretty_name("IO Aggregators")
+    .description("Number of processes that access the file when writing a single file. Zero leaves the choice to the MPI implementation.");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -449,6 +471,12 @@ void Writer::write()
     }
   }
 
+  if(options().value<bool>("single_file"))
+  {
+    write_single_file(doc, piece, appended_data.data_stream.str());
+    return;
+  }
+
   // Write to file, inserting the binary data at the end
   std::cout << "writing file " << my_path.path() << std::endl;
   boost::filesystem::fstream fout(my_path.path(), std::ios_base::out | std::ios_base::binary);
@@ -501,6 +529,52 @@ void Writer::write()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void Writer::write_single_file(const XmlDoc& doc, XmlNode& piece, const std::string& appended_data)
+{
+  PE::Comm& comm = PE::Comm::instance();
+  const bool parallel = comm.is_active() && comm.size() > 1;
+  const Uint rank = parallel ? comm.rank() : 0;
+
+  // The appended data of all pieces is concatenated, so the offsets of each piece are shifted by the data of the lower ranks
+  cf3_assert(!appended_data.empty() && appended_data[0] == '_');
+  const Uint data_size = appended_data.size() - 1;
+  std::vector<Uint> data_sizes(1, data_size);
+  if(parallel)
+    comm.all_gather(data_size, data_sizes);
+  Uint base_offset = 0;
+  for(Uint i = 0; i != rank; ++i)
+    base_offset += data_sizes[i];
+  detail::shift_offsets(piece, base_offset);
+
+  std::string xml_string;
+  to_string(doc, xml_string);
+  const std::string::size_type piece_begin = xml_string.find("<Piece");
+  const std::string::size_type piece_end = xml_string.find("</Piece>") + std::string("</Piece>").size();
+  cf3_assert(piece_begin != std::string::npos && piece_end > piece_begin);
+
+  // Segments are written for all ranks in turn: the pieces, the appended data and the closing tags
+  std::vector<std::string> segments(3);
+  if(rank == 0)
+  {
+    segments[0] = xml_string.substr(0, piece_begin);
+    segments[1] = "\t</UnstructuredGrid>\n\t<AppendedData encoding=\"raw\">\n_";
+    segments[2] = "\n\t</AppendedData>\n</VTKFile>\n";
+  }
+  else
+  {
+    segments[0] = "\t\t";
+  }
+  segments[0] += xml_string.substr(piece_begin, piece_end - piece_begin) + "\n";
+  segments[1].append(appended_data, 1, data_size);
+
+  const URI path(m_file_path.path());
+  const URI vtu_path = path.base_path() / (path.base_name() + ".vtu");
+  CFinfo << "writing file " << vtu_path.path() << CFendl;
+  PE::write_ordered(vtu_path.path(), segments, options().value<Uint>("io_aggregators"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 } // VTKXML
 } // mesh
 } // cf3
@@ -17,6 +17,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 namespace cf3 {
+namespace common { namespace XML { class XmlDoc; class XmlNode; } }
 namespace mesh {
   class ElementType;
 namespace VTKXML {
@@ -45,6 +46,11 @@ public: // functions
   virtual std::string get_format() { return "VTKXML"; }
 
   virtual std::vector<std::string> get_extensions();
+
+private:
+  /// Write a single vtu file containing the pieces of all processes, given the document for this process
+  /// and its appended data (which starts with the _ marker)
+  void write_single_file(const common::XML::XmlDoc& doc, common::XML::XmlNode& piece, const std::string& appended_data);
 }; // end Writer
 
 
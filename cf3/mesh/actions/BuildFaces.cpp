@@ -7,7 +7,6 @@
 #include <set>
 
 #include <boost/foreach.hpp>
-#include <boost/functional/hash.hpp>
 
 #include "common/Log.hpp"
 #include "common/Builder.hpp"
@@ -51,18 +50,14 @@ namespace actions {
   using namespace common;
   using namespace math::Functions;
 
+/// Orders faces by the connectivity table they belong to and their index in it
 struct FaceCompare
 {
   bool operator()(const Face2Cell& face1, const Face2Cell& face2) const
   {
-    std::size_t seed1=0;
-    std::size_t seed2=0;
-
-    boost::hash_combine(seed1,face1.comp->uri().string());
-    boost::hash_combine(seed2,face2.comp->uri().string());
-    boost::hash_combine(seed1,face1.idx);
-    boost::hash_combine(seed2,face2.idx);
-    return seed1 < seed2;
+    if (face1.comp != face2.comp)
+      return face1.comp < face2.comp;
+    return face1.idx < face2.idx;
   }
 };
 
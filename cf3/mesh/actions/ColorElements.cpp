@@ -0,0 +1,89 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Builder.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementColoring.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Space.hpp"
+
+#include "mesh/actions/ColorElements.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < ColorElements, MeshTransformer, mesh::actions::LibActions> ColorElements_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+ColorElements::ColorElements(const std::string& name) : MeshTransformer(name)
+{
+  properties()["brief"] = std::string("Color the elements, so that elements of the same color share no nodes");
+  properties()["description"] = std::string(
+    "Computes an element coloring for each space of the given dictionary, and stores it in the space.\n"
+    "Threaded loops use it to process the elements of one color concurrently.");
+
+  options().add("algorithm", std::string("greedy"))
+    .description("Coloring algorithm: greedy (fewest colors) or balanced (colors of similar size)")
+    .pretty_name("Algorithm")
+    .mark_basic();
+
+  options().add("dict", URI("./"+std::string(mesh::Tags::geometry())))
+    .description("Dictionary whose spaces are colored")
+    .pretty_name("Dictionary")
+    .mark_basic();
+
+  properties().add("nb_colors", 0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void ColorElements::execute()
+{
+  if ( is_null(m_mesh) ) throw SetupError(FromHere(), "mesh is not configured");
+  Handle<Dictionary> dict ( m_mesh->access_component_checked( options().value<URI>("dict") ) );
+  if (is_null(dict))
+    throw SetupError(FromHere(), "Dictionary not found in "+m_mesh->uri().string());
+
+  const std::string algorithm = options().value<std::string>("algorithm");
+
+  Uint max_nb_colors = 0;
+  boost_foreach(const Handle<Space>& space, dict->spaces())
+  {
+    Handle<ElementColoring> coloring(space->get_child("element_coloring"));
+    if (is_null(coloring))
+      coloring = space->create_component<ElementColoring>("element_coloring");
+
+    coloring->options().set("algorithm", algorithm);
+    coloring->compute(*space);
+    max_nb_colors = std::max(max_nb_colors, coloring->nb_colors());
+
+    CFdebug << "ColorElements: " << space->support().uri().path() << " has " << coloring->nb_colors() << " colors for " << space->size() << " elements" << CFendl;
+  }
+
+  properties()["nb_colors"] = max_nb_colors;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
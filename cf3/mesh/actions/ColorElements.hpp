@@ -0,0 +1,53 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_ColorElements_hpp
+#define cf3_mesh_actions_ColorElements_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshTransformer.hpp"
+
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Color the elements of each space of a dictionary, so elements of the same color don't share nodes
+///
+/// The coloring of each space is stored in the space as an ElementColoring, which lists the elements
+/// sorted by color together with the start of each color. Threaded loops can then process the elements
+/// color by color without write conflicts. The coloring is invalidated when the mesh changes and recomputed,
+/// with the same algorithm, when it is used again.
+/// The largest number of colors over all spaces is stored in the property "nb_colors".
+class mesh_actions_API ColorElements : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  ColorElements( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "ColorElements"; }
+
+  virtual void execute();
+
+}; // end ColorElements
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_ColorElements_hpp
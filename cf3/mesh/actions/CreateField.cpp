@@ -212,18 +212,17 @@ Handle<Field> CreateField::create_field(const std::string& name, Dictionary& dic
   vectorial_function.parse();
 
 
-  // Evaluate function
+  // Evaluate function for all points at once
 
-  std::vector<Real> params(var_names.size());
+  Table<Real>::ArrayT params(boost::extents[new_field.size()][var_names.size()]);
   for (Uint pt=0; pt<new_field.size(); ++pt)
   {
-    for (Uint v=0; v<params.size(); ++v)
+    for (Uint v=0; v<var_names.size(); ++v)
     {
-      params[v] = (*var_arrays[v])[pt][var_array_idx[v]];
+      params[pt][v] = (*var_arrays[v])[pt][var_array_idx[v]];
     }
-    Table<Real>::ArrayT::reference ref = new_field.array()[pt];
-    vectorial_function.evaluate(params,ref);
   }
+  vectorial_function.evaluate_batch(params,std::vector<Real>(),new_field.array());
 
   return new_field.handle<Field>();
 }
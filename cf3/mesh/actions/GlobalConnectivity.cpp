@@ -14,6 +14,7 @@
 #include "common/Foreach.hpp"
 #include "common/StreamHelpers.hpp"
 #include "common/StringConversion.hpp"
+#include "common/DynTable.hpp"
 #include "common/OptionArray.hpp"
 #include "common/CreateComponentDataType.hpp"
 #include "common/PropertyList.hpp"
@@ -122,7 +123,7 @@ void GlobalConnectivity::execute()
     {
       ghostnode_glb_idx[cnt] = nodes_glb_idx[i];
 
-      DynTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
+      RaggedTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
       boost_foreach(const Uint e, elems)
       {
         boost::tie(elem_comp,elem_idx) = node2elem.elements().location(e);
@@ -179,7 +180,7 @@ void GlobalConnectivity::execute()
   {
 //    CFinfo << "i = " << i << CFendl;
     cf3_assert(i<node2elem.connectivity().size());
-    DynTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
+    RaggedTable<Uint>::ConstRow elems = node2elem.connectivity()[i];
     cf3_assert(i<nodes_glb_elem_connectivity.size());
     cf3_assert(i<glb_elem_connectivity.size());
     nodes_glb_elem_connectivity[i].resize(glb_elem_connectivity[i].size() + elems.size());
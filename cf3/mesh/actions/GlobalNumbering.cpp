@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <limits>
 #include <set>
 
 #include "common/Log.hpp"
@@ -18,6 +20,7 @@
 #include "common/PropertyList.hpp"
 #include "common/OptionT.hpp"
 #include "common/List.hpp"
+#include "common/Timer.hpp"
 
 #include "common/PE/Comm.hpp"
 #include "common/PE/debug.hpp"
@@ -53,6 +56,74 @@ namespace actions {
 
 common::ComponentBuilder < GlobalNumbering, MeshTransformer, mesh::actions::LibActions> GlobalNumbering_Builder;
 
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Entry of the distributed directory, mapping a hash to the global index and owner rank.
+/// Hashes are only unique per kind: 0 for the nodes, 1+i for the i-th Entities component.
+struct DirectoryEntry
+{
+  DirectoryEntry(const boost::uint64_t a_kind, const boost::uint64_t a_hash, const boost::uint64_t a_glb_idx, const Uint a_rank) :
+    kind(a_kind), hash(a_hash), glb_idx(a_glb_idx), rank(a_rank)
+  {
+  }
+
+  bool operator<(const DirectoryEntry& other) const
+  {
+    return kind < other.kind || (kind == other.kind && hash < other.hash);
+  }
+
+  boost::uint64_t kind;
+  boost::uint64_t hash;
+  boost::uint64_t glb_idx;
+  Uint rank;
+};
+
+/// Requests to send to the directory, as (kind, hash, glb_idx) triples, per directory rank
+struct DirectoryRequests
+{
+  /// (kind, local index) of a ghost that asked for its global index
+  typedef std::pair<Uint,Uint> Query;
+
+  /// glb_idx value used to mark a query
+  static const boost::uint64_t no_id;
+
+  DirectoryRequests(const Uint nb_procs) : send(nb_procs), queries(nb_procs)
+  {
+  }
+
+  /// Rank holding the directory entry for the given hash
+  Uint directory_rank(const boost::uint64_t hash) const
+  {
+    return hash % send.size();
+  }
+
+  void publish(const Uint kind, const boost::uint64_t hash, const Uint glb_idx)
+  {
+    std::vector<boost::uint64_t>& buf = send[directory_rank(hash)];
+    buf.push_back(kind);
+    buf.push_back(hash);
+    buf.push_back(glb_idx);
+  }
+
+  void query(const Uint kind, const boost::uint64_t hash, const Uint loc_idx)
+  {
+    const Uint p = directory_rank(hash);
+    send[p].push_back(kind);
+    send[p].push_back(hash);
+    send[p].push_back(no_id);
+    queries[p].push_back(Query(kind, loc_idx));
+  }
+
+  std::vector< std::vector<boost::uint64_t> > send;
+  std::vector< std::vector<Query> > queries;
+};
+
+const boost::uint64_t DirectoryRequests::no_id = std::numeric_limits<boost::uint64_t>::max();
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////////
 
 GlobalNumbering::GlobalNumbering( const std::string& name )
@@ -118,6 +189,8 @@ void GlobalNumbering::execute()
     return;
   }
 
+  common::WallTimer timer;
+
   common::Table<Real>& coordinates = mesh.geometry_fields().coordinates();
   RealVector coord_vec(coordinates.row_size());
 
@@ -183,18 +256,19 @@ void GlobalNumbering::execute()
   }
 
 
+  const double hashing_time = timer.elapsed();
+  timer.restart();
+
   // now renumber
 
-  //------------------------------------------------------------------------------
-  // create node_hilbert2loc mapping
+  const Uint nb_procs = PE::Comm::instance().size();
+  const Uint my_rank = PE::Comm::instance().rank();
   Dictionary& nodes = mesh.geometry_fields();
-  std::map<boost::uint64_t,Uint> node_hilbert2loc;
-  Uint loc_node_idx(0);
-  boost_foreach(boost::uint64_t hilbert_idx, hilbert_indices.data())
-    node_hilbert2loc[hilbert_idx]=loc_node_idx++;
 
-  // Check if all nodes have been added to the map
-  cf3_assert(loc_node_idx==nodes.size());
+  // Entities are numbered in the same order on every rank, so their position in this list identifies them in the directory
+  std::vector< Handle<Entities> > entities_list;
+  boost_foreach( Entities& elements, find_components_recursively<Entities>(mesh) )
+    entities_list.push_back(elements.handle<Entities>());
 
   //------------------------------------------------------------------------------
   // get tot nb of owned indexes and communicate
@@ -211,14 +285,14 @@ void GlobalNumbering::execute()
   }
 
   Uint nb_owned_elems(0);
-  boost_foreach( Entities& elements, find_components_recursively<Entities>(mesh) )
+  boost_foreach( const Handle<Entities>& elements, entities_list )
   {
-    common::List<Uint>& elem_rank = elements.rank();
-    elem_rank.resize(elements.size());
+    common::List<Uint>& elem_rank = elements->rank();
+    elem_rank.resize(elements->size());
 
-    for (Uint e=0; e<elements.size(); ++e)
+    for (Uint e=0; e<elements->size(); ++e)
     {
-      if (elements.is_ghost(e) == false)
+      if (elements->is_ghost(e) == false)
       {
         ++nb_owned_elems;
       }
@@ -227,9 +301,9 @@ void GlobalNumbering::execute()
 
   Uint tot_nb_owned_ids=nb_owned_nodes + nb_owned_elems;
 
-  std::vector<Uint> nb_ids_per_proc(PE::Comm::instance().size());
+  std::vector<Uint> nb_ids_per_proc(nb_procs);
   PE::Comm::instance().all_gather(tot_nb_owned_ids, nb_ids_per_proc);
-  std::vector<Uint> start_id_per_proc(PE::Comm::instance().size());
+  std::vector<Uint> start_id_per_proc(nb_procs);
   Uint start_id=0;
   for (Uint p=0; p<nb_ids_per_proc.size(); ++p)
   {
@@ -239,187 +313,163 @@ void GlobalNumbering::execute()
 
   if (m_debug)
   {
-    std::cout << "["<<PE::Comm::instance().rank() << "]  start_ids gathered" << std::endl;
+    std::cout << "["<<my_rank << "]  start_ids gathered" << std::endl;
   }
 
-
   //------------------------------------------------------------------------------
-  // add glb_idx to owned nodes, broadcast/receive glb_idx for ghost nodes
+  // add glb_idx to owned nodes and elements, and prepare the directory requests:
+  // owned items publish their glb_idx to the directory rank of their hash, ghosts ask for it
 
-  std::vector<boost::uint64_t> node_from(nb_owned_nodes);
-  std::vector<boost::uint64_t> node_to(nb_owned_nodes);
+  DirectoryRequests requests(nb_procs);
 
   common::List<Uint>& nodes_glb_idx = mesh.geometry_fields().glb_idx();
   nodes_glb_idx.resize(nodes.size());
 
-  Uint cnt=0;
-  Uint glb_id = start_id_per_proc[PE::Comm::instance().rank()];
+  Uint glb_id = start_id_per_proc[my_rank];
   for (Uint i=0; i<nodes.size(); ++i)
   {
-    cf3_assert(nodes.rank()[i] < PE::Comm::instance().size());
+    cf3_assert(nodes.rank()[i] < nb_procs);
     if ( ! nodes.is_ghost(i) )
     {
       nodes_glb_idx[i] = glb_id++;
-      node_from[cnt] = hilbert_indices.data()[i];
-      node_to[cnt]   = nodes_glb_idx[i];
-      ++cnt;
+      requests.publish(0, hilbert_indices.data()[i], nodes_glb_idx[i]);
     }
     else
     {
       nodes_glb_idx[i] = uint_max();
+      requests.query(0, hilbert_indices.data()[i], i);
     }
   }
 
-  for (Uint root=0; root<PE::Comm::instance().size(); ++root)
+  for (Uint entities_idx=0; entities_idx<entities_list.size(); ++entities_idx)
   {
+    Entities& elements = *entities_list[entities_idx];
+    std::vector<boost::uint64_t>& elem_hilbert_indices = Handle<CVector_uint64>(elements.get_child("hilbert_indices"))->data();
+    common::List<Uint>& elements_glb_idx = elements.glb_idx();
+    elements_glb_idx.resize(elements.size());
+    cf3_assert(elem_hilbert_indices.size() == elements.size());
 
-    std::vector<boost::uint64_t> rcv_node_from(0);
-    PE::Comm::instance().broadcast(node_from,rcv_node_from,root);
-    std::vector<boost::uint64_t>        rcv_node_to(0);
-    PE::Comm::instance().broadcast(node_to,rcv_node_to,root);
-
-    if (m_debug)
+    for (Uint e=0; e<elements.size(); ++e)
     {
-      std::cout << "["<<PE::Comm::instance().rank() << "]  received nodes from " << root << std::endl;
-    }
+      if ( ! elements.is_ghost(e) )
+      {
+        if (m_debug)
+          std::cout << "["<<my_rank << "]  will change owned elem "<< elem_hilbert_indices[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << glb_id << std::endl;
 
-    if (PE::Comm::instance().rank() != root)
-    {
-      for (Uint p=0; p<PE::Comm::instance().size(); ++p)
+        elements_glb_idx[e] = glb_id++;
+        requests.publish(entities_idx+1, elem_hilbert_indices[e], elements_glb_idx[e]);
+      }
+      else
       {
-        if (p == PE::Comm::instance().rank())
-        {
-          Uint rcv_idx(0);
-          boost_foreach(const boost::uint64_t hilbert_idx, rcv_node_from)
-          {
-            if ( node_hilbert2loc.count(hilbert_idx) )
-            {
-              const Uint loc_idx = node_hilbert2loc[hilbert_idx];
-              if (m_debug)
-                std::cout << "["<<PE::Comm::instance().rank() << "]  will change node "<< hilbert_idx << " (local " << loc_idx<< ") to (global " << rcv_node_to[rcv_idx] << ")" << std::endl;
-              cf3_assert(rcv_idx < rcv_node_to.size());
-              nodes_glb_idx[loc_idx]=rcv_node_to[rcv_idx];
-              cf3_assert(loc_idx < nodes_rank.size());
-              cf3_assert_desc("node "+to_str(loc_idx)+ " with hilbert_idx " +to_str(hilbert_idx) +" must be a ghost, but is owned by "+to_str(nodes_rank[loc_idx]),nodes.is_ghost(loc_idx));
-              nodes_rank[loc_idx]=std::min(root,nodes_rank[loc_idx]);
-            }
-            ++rcv_idx;
-          }
-          break;
-        }
+        elements_glb_idx[e] = uint_max();
+        requests.query(entities_idx+1, elem_hilbert_indices[e], e);
       }
     }
-    if (m_debug)
+  }
+
+  const double numbering_time = timer.elapsed();
+  timer.restart();
+
+  //------------------------------------------------------------------------------
+  // rendezvous: a single all_to_all brings all published ids and queries to the directory ranks,
+  // a second one sends the answers back in the order the queries were made
+
+  std::vector< std::vector<boost::uint64_t> > received_requests;
+  PE::Comm::instance().all_to_all(requests.send, received_requests);
+  requests.send.clear();
+
+  std::vector<DirectoryEntry> directory;
+  for (Uint p=0; p<nb_procs; ++p)
+  {
+    const std::vector<boost::uint64_t>& recv = received_requests[p];
+    for (Uint i=0; i<recv.size(); i+=3)
     {
-      std::cout << "["<<PE::Comm::instance().rank() << "]  changed nodes based on " << root << std::endl;
+      if (recv[i+2] != DirectoryRequests::no_id)
+        directory.push_back(DirectoryEntry(recv[i], recv[i+1], recv[i+2], p));
     }
-
   }
+  // stable, so that for duplicate hashes the lowest rank comes first
+  std::stable_sort(directory.begin(), directory.end());
 
-  if (m_debug)
+  std::vector< std::vector<boost::uint64_t> > answers(nb_procs);
+  for (Uint p=0; p<nb_procs; ++p)
   {
-    std::cout << "["<<PE::Comm::instance().rank() << "]  checking node validity" << std::endl;
-    for (Uint i=0; i<nodes.size(); ++i)
+    const std::vector<boost::uint64_t>& recv = received_requests[p];
+    for (Uint i=0; i<recv.size(); i+=3)
     {
-      cf3_assert(nodes.glb_idx()[i] != uint_max());
-      if (nodes.is_ghost(i) == false)
+      if (recv[i+2] != DirectoryRequests::no_id)
+        continue;
+      const DirectoryEntry key(recv[i], recv[i+1], 0, 0);
+      std::vector<DirectoryEntry>::const_iterator entry = std::lower_bound(directory.begin(), directory.end(), key);
+      if (entry != directory.end() && !(key < *entry))
       {
-        cf3_assert(nodes.glb_idx()[i] >= start_id_per_proc[PE::Comm::instance().rank()]);
-        cf3_assert(nodes.glb_idx()[i] < start_id_per_proc[PE::Comm::instance().rank()] + nb_owned_nodes);
+        answers[p].push_back(entry->glb_idx);
+        answers[p].push_back(entry->rank);
+      }
+      else
+      {
+        answers[p].push_back(DirectoryRequests::no_id);
+        answers[p].push_back(DirectoryRequests::no_id);
       }
     }
   }
+  received_requests.clear();
+  directory.clear();
 
-  //------------------------------------------------------------------------------
-  // give glb idx to elements
+  std::vector< std::vector<boost::uint64_t> > received_answers;
+  PE::Comm::instance().all_to_all(answers, received_answers);
 
-  boost_foreach( Entities& elements, find_components_recursively<Entities>(mesh) )
+  for (Uint p=0; p<nb_procs; ++p)
   {
-    if (m_debug)
-      std::cout << "give glb idx to elements " << elements.uri() << std::endl;
-    std::vector<boost::uint64_t>& hilbert_indices = Handle<CVector_uint64>(elements.get_child("hilbert_indices"))->data();
-    common::List<Uint>& elem_rank = elements.rank();
-    elem_rank.resize(elements.size());
-
-    //------------------------------------------------------------------------------
-    // create elem_glb2loc mapping
-    Uint nb_owned_elems=0;
-    std::map<boost::uint64_t,Uint> elem_glb2loc;
-    std::map<boost::uint64_t,Uint>::iterator elem_glb2loc_it;
-    std::map<boost::uint64_t,Uint>::iterator hash_not_found = elem_glb2loc.end();
-
-    for (Uint e=0; e<elements.size(); ++e)
-    {
-      elem_glb2loc [ hilbert_indices[e] ] = e;
-      if ( ! elements.is_ghost(e) )
-        ++nb_owned_elems;
-    }
-
-
-    std::vector<boost::uint64_t> send_hash(nb_owned_elems);
-    std::vector<boost::uint64_t>   send_id(nb_owned_elems);
-
-    common::List<Uint>& elements_glb_idx = elements.glb_idx();
-    elements_glb_idx.resize(elements.size());
-    cf3_assert(hilbert_indices.size() == elements.size());
-
-    Uint cnt(0);
-    for (Uint e=0; e<elements.size(); ++e)
+    const std::vector<DirectoryRequests::Query>& queries = requests.queries[p];
+    const std::vector<boost::uint64_t>& answer = received_answers[p];
+    cf3_assert(answer.size() == 2*queries.size());
+    for (Uint q=0; q<queries.size(); ++q)
     {
-
-      if ( ! elements.is_ghost(e) )
+      if (answer[2*q] == DirectoryRequests::no_id)
+        continue; // no owner found, caught by the checks in debug mode
+      const Uint loc_idx = queries[q].second;
+      const Uint owner = static_cast<Uint>(answer[2*q+1]);
+      if (queries[q].first == 0)
       {
         if (m_debug)
-          std::cout << "["<<PE::Comm::instance().rank() << "]  will change owned elem "<< hilbert_indices[e] << " (" << elements.uri().path() << "["<<e<<"]) to " << glb_id << std::endl;
-
-        elements_glb_idx[e] = glb_id++;
-        send_hash[cnt] = hilbert_indices[e];
-        send_id[cnt]   = elements_glb_idx[e];
-        ++cnt;
+          std::cout << "["<<my_rank << "]  will change node (local " << loc_idx<< ") to (global " << answer[2*q] << ")" << std::endl;
+        cf3_assert_desc("node "+to_str(loc_idx)+" must be a ghost, but is owned by "+to_str(nodes_rank[loc_idx]),nodes.is_ghost(loc_idx));
+        nodes_glb_idx[loc_idx] = static_cast<Uint>(answer[2*q]);
+        nodes_rank[loc_idx] = std::min(owner,nodes_rank[loc_idx]);
       }
       else
       {
-        elements_glb_idx[e] = uint_max();
+        Entities& elements = *entities_list[queries[q].first-1];
+        if (m_debug)
+          std::cout << "["<<my_rank << "]  will change ghost elem " << elements.uri() << "[" << loc_idx << "] to " << answer[2*q] << std::endl;
+        cf3_assert(elements.is_ghost(loc_idx));
+        elements.glb_idx()[loc_idx] = static_cast<Uint>(answer[2*q]);
+        elements.rank()[loc_idx] = owner;
       }
-    } // end foreach elem_idx
-    cf3_assert(cnt == nb_owned_elems);
+    }
+  }
+
+  const double rendezvous_time = timer.elapsed();
 
-    for (Uint root=0; root<PE::Comm::instance().size(); ++root)
+  if (m_debug)
+  {
+    std::cout << "["<<my_rank << "]  checking node validity" << std::endl;
+    for (Uint i=0; i<nodes.size(); ++i)
     {
-      std::vector<boost::uint64_t> recv_hash(0);
-      PE::Comm::instance().broadcast(send_hash,recv_hash,root);
-      std::vector<boost::uint64_t>        recv_id(0);
-      PE::Comm::instance().broadcast(send_id,recv_id,root);
-      if (PE::Comm::instance().rank() != root)
+      cf3_assert(nodes.glb_idx()[i] != uint_max());
+      if (nodes.is_ghost(i) == false)
       {
-        for (Uint p=0; p<PE::Comm::instance().size(); ++p)
-        {
-          if (p == PE::Comm::instance().rank())
-          {
-            Uint recv_idx(0);
-            boost_foreach(const boost::uint64_t hash, recv_hash)
-            {
-              elem_glb2loc_it = elem_glb2loc.find(hash);
-              if ( elem_glb2loc_it != hash_not_found )
-              {
-                if (m_debug)
-                  std::cout << "["<<PE::Comm::instance().rank() << "]  will change ghost elem "<< elem_glb2loc_it->first << " (" << elements.uri() << "[" << elem_glb2loc_it->second << "]) to " << recv_id[recv_idx] << std::endl;
-                elements_glb_idx[elem_glb2loc_it->second]=recv_id[recv_idx];
-                cf3_assert(elements.is_ghost(elem_glb2loc_it->second));
-                elem_rank[elem_glb2loc_it->second]=root;
-              }
-              ++recv_idx;
-            }
-            break;
-          }
-        }
+        cf3_assert(nodes.glb_idx()[i] >= start_id_per_proc[my_rank]);
+        cf3_assert(nodes.glb_idx()[i] < start_id_per_proc[my_rank] + nb_owned_nodes);
       }
-    } // end foreach broadcasting process
-
-
-
-  } // end foreach elements
+    }
+  }
 
+  properties()["hashing_time"] = hashing_time;
+  properties()["numbering_time"] = numbering_time;
+  properties()["rendezvous_time"] = rendezvous_time;
+  CFdebug << "GlobalNumbering timings: hashing " << hashing_time << " s, local numbering " << numbering_time << " s, rendezvous " << rendezvous_time << " s" << CFendl;
 
   // In debug mode, check if no hashes are duplicated
   if (m_debug)
@@ -17,7 +17,6 @@
 #include "common/PropertyList.hpp"
 #include "common/Signal.hpp"
 #include "common/XML/SignalOptions.hpp"
-#include "math/AnalyticalFunction.hpp"
 
 #include "mesh/actions/InitFieldFunction.hpp"
 #include "mesh/Elements.hpp"
@@ -186,36 +185,36 @@ void InitFieldFunction::execute()
   }
 
   // create the functions
-  std::vector<math::AnalyticalFunction> functions(option_functions.size());
-  for (Uint f=0; f<functions.size(); ++f)
+  for (Uint f=0; f<option_functions.size(); ++f)
   {
     // check: columns must be of index smaller than index of field
     if (cols[f] >= m_field->row_size()) throw SetupError(FromHere(), "Specified column ["+to_str(cols[f])+"] doesn't exist. (field has only "+to_str(m_field->row_size())+" cols)");
-    functions[f].parse(option_functions[f],variable_names);
   }
+  m_function.functions(option_functions);
+  m_function.variables(variable_names);
+  m_function.parse();
 
   std::vector<Real> constants;
   constants.push_back( options().value<Real>("time") );
 
-  std::vector<Real> variables(variable_names.size());
-
+  // Gather the point variables, and evaluate all points at once
+  math::VectorialFunction::ArrayT variables(boost::extents[dict.size()][field_comps.size()]);
   for (Uint pt=0; pt<dict.size(); ++pt)
   {
-    // Assemble variables per point
-    Uint c=0;
-    for (Uint j=0; j<field_comps.size(); ++j, ++c)
-    {
-      variables[c] = field_comps[j]->array()[pt][field_cols[j]];
-    }
-    for (Uint j=0; j<constants.size(); ++j, ++c)
+    for (Uint j=0; j<field_comps.size(); ++j)
     {
-      variables[c] = constants[j];
+      variables[pt][j] = field_comps[j]->array()[pt][field_cols[j]];
     }
+  }
+
+  math::VectorialFunction::ArrayT values(boost::extents[dict.size()][option_functions.size()]);
+  m_function.evaluate_batch(variables, constants, values);
 
-    // Evaluate functions
-    for (Uint f=0; f<cols.size(); ++f)
+  for (Uint pt=0; pt<dict.size(); ++pt)
+  {
+    for (Uint f=0; f<option_functions.size(); ++f)
     {
-      m_field->array()[pt][f] = functions[f](variables);
+      m_field->array()[pt][cols[f]] = values[pt][f];
     }
   }
 }
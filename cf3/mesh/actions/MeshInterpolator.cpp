@@ -220,6 +220,8 @@ void MeshInterpolator::execute()
       }
     }
 
+    // The ghosts of each field are exchanged while the next field is interpolated
+    Handle<Field> syncing_field;
     BOOST_FOREACH(const Handle<Field>& source_field, source_dict->fields())
     {
       if(source_field->has_tag(mesh::Tags::coordinates()))
@@ -271,9 +273,17 @@ void MeshInterpolator::execute()
         }
       }
 
+      // Only one synchronization can be in progress per comm pattern
+      if(is_not_null(syncing_field))
+        syncing_field->finish_synchronize();
+
       target_field->parallelize();
-      target_field->synchronize();
+      target_field->start_synchronize();
+      syncing_field = target_field;
     }
+
+    if(is_not_null(syncing_field))
+      syncing_field->finish_synchronize();
   }
 }
 
@@ -0,0 +1,506 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Builder.hpp"
+#include "common/DynTable.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Link.hpp"
+#include "common/List.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/RaggedTable.hpp"
+#include "common/Table.hpp"
+
+#include "common/PE/CommPattern.hpp"
+
+#include "math/Hilbert.hpp"
+
+#include "mesh/BoundingBox.hpp"
+#include "mesh/BoundingBoxTree.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Space.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+using namespace common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+common::ComponentBuilder < Renumber, MeshTransformer, mesh::actions::LibActions> Renumber_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+/// Reorder the rows of a table, so that new row i is old row new_to_old[i]
+template <typename T>
+void permute_rows(common::Table<T>& table, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(table.size() == new_to_old.size());
+  const typename common::Table<T>::ArrayT old_array(table.array());
+  const Uint nb_rows = new_to_old.size();
+  for (Uint i=0; i<nb_rows; ++i)
+    table.array()[i] = old_array[new_to_old[i]];
+}
+
+template <typename T>
+void permute_rows(common::List<T>& list, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(list.size() == new_to_old.size());
+  const typename common::List<T>::ListT old_array(list.array());
+  const Uint nb_rows = new_to_old.size();
+  for (Uint i=0; i<nb_rows; ++i)
+    list.array()[i] = old_array[new_to_old[i]];
+}
+
+template <typename T>
+void permute_rows(common::DynTable<T>& table, const std::vector<Uint>& new_to_old)
+{
+  cf3_assert(table.size() == new_to_old.size());
+  typename common::DynTable<T>::ArrayT old_array;
+  old_array.swap(table.array());
+  const Uint nb_rows = new_to_old.size();
+  table.array().resize(nb_rows);
+  for (Uint i=0; i<nb_rows; ++i)
+    table.array()[i].swap(old_array[new_to_old[i]]);
+}
+
+/// Replace each index stored in the table by its new value
+void remap_values(common::Table<Uint>& table, const std::vector<Uint>& old_to_new)
+{
+  boost_foreach(common::Table<Uint>::Row row, table.array())
+  {
+    boost_foreach(Uint& value, row)
+    {
+      cf3_assert(value < old_to_new.size());
+      value = old_to_new[value];
+    }
+  }
+}
+
+void invert(const std::vector<Uint>& new_to_old, std::vector<Uint>& old_to_new)
+{
+  old_to_new.resize(new_to_old.size());
+  const Uint nb_rows = new_to_old.size();
+  for (Uint i=0; i<nb_rows; ++i)
+    old_to_new[new_to_old[i]] = i;
+}
+
+/// Orders indices by the key stored for them
+struct KeyLess
+{
+  KeyLess(const std::vector<boost::uint64_t>& keys) : m_keys(keys) {}
+  bool operator()(const Uint a, const Uint b) const { return m_keys[a] < m_keys[b]; }
+  const std::vector<boost::uint64_t>& m_keys;
+};
+
+/// Orders indices by their degree in the node graph
+struct DegreeLess
+{
+  DegreeLess(const std::vector<Uint>& degree) : m_degree(degree) {}
+  bool operator()(const Uint a, const Uint b) const { return m_degree[a] < m_degree[b]; }
+  const std::vector<Uint>& m_degree;
+};
+
+/// True for nodes that are not ghosts
+struct IsOwned
+{
+  IsOwned(const Dictionary& dict) : m_dict(dict) {}
+  bool operator()(const Uint idx) const { return !m_dict.is_ghost(idx); }
+  const Dictionary& m_dict;
+};
+
+/// Node graph of the geometry, built from the element-node and node-element connectivities
+class NodeGraph
+{
+public:
+  NodeGraph(const Mesh& mesh) :
+    m_elem_nodes(allocate_component< RaggedTable<Uint> >("elem_nodes")),
+    m_node_elems(allocate_component< RaggedTable<Uint> >("node_elems"))
+  {
+    const Uint nb_nodes = mesh.geometry_fields().size();
+    Uint nb_elems = 0;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+      nb_elems += entities->size();
+
+    RaggedTable<Uint>::Builder elem_builder(*m_elem_nodes, nb_elems);
+    RaggedTable<Uint>::Builder node_builder(*m_node_elems, nb_nodes);
+    Uint elem_idx = 0;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      boost_foreach(Connectivity::ConstRow row, entities->geometry_space().connectivity().array())
+      {
+        elem_builder.count(elem_idx++, row.size());
+        boost_foreach(const Uint node, row)
+          node_builder.count(node);
+      }
+    }
+    elem_builder.allocate();
+    node_builder.allocate();
+    elem_idx = 0;
+    boost_foreach(const Handle<Entities>& entities, mesh.elements())
+    {
+      boost_foreach(Connectivity::ConstRow row, entities->geometry_space().connectivity().array())
+      {
+        boost_foreach(const Uint node, row)
+        {
+          elem_builder.add(elem_idx, node);
+          node_builder.add(node, elem_idx);
+        }
+        ++elem_idx;
+      }
+    }
+    elem_builder.finish();
+    node_builder.finish();
+
+    m_stamp.assign(nb_nodes, 0u);
+    m_current_stamp = 0;
+  }
+
+  Uint size() const { return m_node_elems->size(); }
+
+  /// Put the distinct neighbours of a node in the given vector
+  void neighbours(const Uint node, std::vector<Uint>& result)
+  {
+    result.clear();
+    ++m_current_stamp;
+    m_stamp[node] = m_current_stamp;
+    boost_foreach(const Uint elem, (*m_node_elems)[node])
+    {
+      boost_foreach(const Uint other, (*m_elem_nodes)[elem])
+      {
+        if (m_stamp[other] != m_current_stamp)
+        {
+          m_stamp[other] = m_current_stamp;
+          result.push_back(other);
+        }
+      }
+    }
+  }
+
+private:
+  boost::shared_ptr< RaggedTable<Uint> > m_elem_nodes;
+  boost::shared_ptr< RaggedTable<Uint> > m_node_elems;
+  /// Marks the nodes already added to the current neighbour list
+  std::vector<Uint> m_stamp;
+  Uint m_current_stamp;
+};
+
+/// Breadth first traversal from start over the nodes that are not visited yet, sorting the new neighbours
+/// of each node by increasing degree. The traversed nodes are appended to order.
+/// @return the index in order where the last level of the traversal starts
+Uint breadth_first(NodeGraph& graph, const std::vector<Uint>& degree, const Uint start, std::vector<bool>& visited, std::vector<Uint>& order)
+{
+  std::vector<Uint> neighbours;
+  Uint front = order.size();
+  Uint level_end = front+1;
+  Uint last_level_begin = front;
+  order.push_back(start);
+  visited[start] = true;
+  while (front != order.size())
+  {
+    if (front == level_end)
+    {
+      last_level_begin = front;
+      level_end = order.size();
+    }
+    graph.neighbours(order[front++], neighbours);
+    const Uint first_new = order.size();
+    boost_foreach(const Uint neighbour, neighbours)
+    {
+      if (!visited[neighbour])
+      {
+        visited[neighbour] = true;
+        order.push_back(neighbour);
+      }
+    }
+    std::stable_sort(order.begin()+first_new, order.end(), DegreeLess(degree));
+  }
+  return last_level_begin;
+}
+
+} // detail
+
+////////////////////////////////////////////////////////////////////////////////
+
+Renumber::Renumber(const std::string& name) : MeshTransformer(name)
+{
+  properties()["brief"] = std::string("Renumber nodes and elements to improve cache locality");
+  properties()["description"] = std::string(
+    "Orders the geometry nodes with Reverse Cuthill-McKee (RCM) or along a Hilbert curve (Hilbert),\n"
+    "and sorts the elements by their lowest node. Must be executed before faces are built.");
+
+  options().add("ordering", std::string("RCM"))
+    .description("Node ordering algorithm: RCM or Hilbert")
+    .pretty_name("Ordering")
+    .mark_basic();
+
+  options().add("renumber_elements", true)
+    .description("Sort the elements of each Entities by their lowest node index")
+    .pretty_name("Renumber Elements");
+
+  properties().add("bandwidth_before", 0u);
+  properties().add("bandwidth_after", 0u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Renumber::execute()
+{
+  Mesh& mesh = *m_mesh;
+
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+  {
+    if (is_not_null(entities->connectivity_face2cell()) || is_not_null(entities->connectivity_cell2face()) || is_not_null(entities->connectivity_cell2cell()))
+      throw SetupError(FromHere(), "Renumber must be executed before faces are built, but " + entities->uri().string() + " has face connectivity");
+  }
+
+  const Uint bandwidth_before = bandwidth(mesh);
+
+  std::vector<Uint> new_to_old;
+  const std::string ordering = options().value<std::string>("ordering");
+  if (ordering == "RCM")
+    compute_rcm_order(mesh, new_to_old);
+  else if (ordering == "Hilbert")
+    compute_hilbert_order(mesh, new_to_old);
+  else
+    throw BadValue(FromHere(), "Unknown ordering " + ordering + ", expected RCM or Hilbert");
+
+  // Ghost nodes are kept after the owned nodes
+  std::stable_partition(new_to_old.begin(), new_to_old.end(), detail::IsOwned(mesh.geometry_fields()));
+
+  renumber_nodes(mesh, new_to_old);
+
+  if (options().value<bool>("renumber_elements"))
+    renumber_elements(mesh);
+
+  mesh.raise_mesh_changed();
+
+  // The element order changed, so a cached bounding box tree must be rebuilt
+  Handle<BoundingBoxTree> tree(mesh.get_child("bounding_box_tree"));
+  if (is_not_null(tree) && tree->is_created())
+    tree->create_tree();
+
+  const Uint bandwidth_after = bandwidth(mesh);
+  properties()["bandwidth_before"] = bandwidth_before;
+  properties()["bandwidth_after"] = bandwidth_after;
+  CFinfo << "Renumbered " << mesh.uri().path() << " with " << ordering << " ordering: bandwidth " << bandwidth_before << " -> " << bandwidth_after << CFendl;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+Uint Renumber::bandwidth(const Mesh& mesh)
+{
+  Uint result = 0;
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+  {
+    boost_foreach(Connectivity::ConstRow row, entities->geometry_space().connectivity().array())
+    {
+      if (row.size() == 0)
+        continue;
+      const Uint min_node = *std::min_element(row.begin(), row.end());
+      const Uint max_node = *std::max_element(row.begin(), row.end());
+      result = std::max(result, max_node - min_node);
+    }
+  }
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Renumber::compute_rcm_order(const Mesh& mesh, std::vector<Uint>& new_to_old) const
+{
+  detail::NodeGraph graph(mesh);
+  const Uint nb_nodes = graph.size();
+
+  std::vector<Uint> degree(nb_nodes);
+  std::vector<Uint> neighbours;
+  for (Uint node=0; node<nb_nodes; ++node)
+  {
+    graph.neighbours(node, neighbours);
+    degree[node] = neighbours.size();
+  }
+
+  new_to_old.clear();
+  new_to_old.reserve(nb_nodes);
+  std::vector<bool> visited(nb_nodes, false);
+  std::vector<bool> probe_visited;
+  std::vector<Uint> probe;
+  for (Uint seed=0; seed<nb_nodes; ++seed)
+  {
+    if (visited[seed])
+      continue;
+    if (degree[seed] == 0)
+    {
+      visited[seed] = true;
+      new_to_old.push_back(seed);
+      continue;
+    }
+
+    // Use a node of minimal degree in the last level of a traversal from the seed as start,
+    // which approximates a pseudo-peripheral node of this connected part
+    probe_visited = visited;
+    probe.clear();
+    const Uint last_level = detail::breadth_first(graph, degree, seed, probe_visited, probe);
+    Uint start = probe[last_level];
+    for (Uint i=last_level; i<probe.size(); ++i)
+    {
+      if (degree[probe[i]] < degree[start])
+        start = probe[i];
+    }
+
+    detail::breadth_first(graph, degree, start, visited, new_to_old);
+  }
+
+  std::reverse(new_to_old.begin(), new_to_old.end());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Renumber::compute_hilbert_order(const Mesh& mesh, std::vector<Uint>& new_to_old) const
+{
+  const Field& coordinates = mesh.geometry_fields().coordinates();
+  const Uint nb_nodes = coordinates.size();
+
+  math::Hilbert compute_key(*mesh.local_bounding_box(), 20);
+  std::vector<boost::uint64_t> keys(nb_nodes);
+  RealVector coord(coordinates.row_size());
+  for (Uint node=0; node<nb_nodes; ++node)
+  {
+    for (Uint d=0; d<coord.size(); ++d)
+      coord[d] = coordinates[node][d];
+    keys[node] = compute_key(coord);
+  }
+
+  new_to_old.resize(nb_nodes);
+  for (Uint node=0; node<nb_nodes; ++node)
+    new_to_old[node] = node;
+  std::stable_sort(new_to_old.begin(), new_to_old.end(), detail::KeyLess(keys));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Renumber::renumber_nodes(Mesh& mesh, const std::vector<Uint>& new_to_old) const
+{
+  Dictionary& nodes = mesh.geometry_fields();
+  std::vector<Uint> old_to_new;
+  detail::invert(new_to_old, old_to_new);
+
+  boost_foreach(const Handle<Field>& field, nodes.fields())
+    detail::permute_rows(*field, new_to_old);
+  detail::permute_rows(nodes.glb_idx(), new_to_old);
+  detail::permute_rows(nodes.rank(), new_to_old);
+
+  Handle< List<Uint> > periodic_links_nodes(nodes.get_child("periodic_links_nodes"));
+  Handle< List<bool> > periodic_links_active(nodes.get_child("periodic_links_active"));
+  if (is_not_null(periodic_links_nodes) && is_not_null(periodic_links_active))
+  {
+    detail::permute_rows(*periodic_links_nodes, new_to_old);
+    detail::permute_rows(*periodic_links_active, new_to_old);
+    const Uint nb_nodes = nodes.size();
+    for (Uint node=0; node<nb_nodes; ++node)
+    {
+      if (periodic_links_active->array()[node])
+        periodic_links_nodes->array()[node] = old_to_new[periodic_links_nodes->array()[node]];
+    }
+  }
+
+  if (nodes.glb_elem_connectivity().size() == new_to_old.size())
+    detail::permute_rows(nodes.glb_elem_connectivity(), new_to_old);
+
+  // Only used during global numbering, and would be out of order
+  if (is_not_null(nodes.get_child("hilbert_indices")))
+    nodes.remove_component("hilbert_indices");
+
+  boost_foreach(const Handle<Space>& space, nodes.spaces())
+    detail::remap_values(space->connectivity(), old_to_new);
+
+  // The communication pattern stores the local indices of the ghosts, so it is recreated
+  if (is_not_null(nodes.get_child("CommPattern")))
+  {
+    Handle<PE::CommPattern> old_pattern(nodes.get_child("CommPattern"));
+    std::vector< Handle<Field> > parallel_fields;
+    boost_foreach(const Handle<Field>& field, nodes.fields())
+    {
+      if (field->comm_pattern() == old_pattern)
+        parallel_fields.push_back(field);
+    }
+    nodes.remove_component("CommPattern");
+    PE::CommPattern& new_pattern = nodes.comm_pattern();
+    boost_foreach(const Handle<Field>& field, parallel_fields)
+      field->parallelize_with(new_pattern);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Renumber::renumber_elements(Mesh& mesh) const
+{
+  // Permutation of each Entities, by entities_idx
+  std::vector< std::vector<Uint> > permutations(mesh.elements().size());
+  std::vector<boost::uint64_t> keys;
+
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+  {
+    const Connectivity& connectivity = entities->geometry_space().connectivity();
+    const Uint nb_elems = connectivity.size();
+    keys.resize(nb_elems);
+    for (Uint elem=0; elem<nb_elems; ++elem)
+    {
+      Connectivity::ConstRow row = connectivity[elem];
+      keys[elem] = row.size() ? *std::min_element(row.begin(), row.end()) : 0u;
+    }
+    std::vector<Uint>& new_to_old = permutations[entities->entities_idx()];
+    new_to_old.resize(nb_elems);
+    for (Uint elem=0; elem<nb_elems; ++elem)
+      new_to_old[elem] = elem;
+    std::stable_sort(new_to_old.begin(), new_to_old.end(), detail::KeyLess(keys));
+
+    detail::permute_rows(entities->glb_idx(), new_to_old);
+    detail::permute_rows(entities->rank(), new_to_old);
+    boost_foreach(const Handle<Space>& space, entities->spaces())
+      detail::permute_rows(space->connectivity(), new_to_old);
+  }
+
+  // Periodic element links refer to elements of another Entities, so they are updated once all permutations are known
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+  {
+    Handle< List<Uint> > periodic_links_elements(entities->get_child("periodic_links_elements"));
+    if (is_null(periodic_links_elements))
+      continue;
+    detail::permute_rows(*periodic_links_elements, permutations[entities->entities_idx()]);
+
+    Handle<Link> periodic_link(periodic_links_elements->get_child("periodic_link"));
+    cf3_assert(is_not_null(periodic_link));
+    Handle<Entities const> linked(periodic_link->follow());
+    if (is_null(linked))
+      continue;
+    std::vector<Uint> old_to_new;
+    detail::invert(permutations[linked->entities_idx()], old_to_new);
+    boost_foreach(Uint& linked_elem, periodic_links_elements->array())
+      linked_elem = old_to_new[linked_elem];
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
@@ -0,0 +1,72 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_mesh_actions_Renumber_hpp
+#define cf3_mesh_actions_Renumber_hpp
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include "mesh/MeshTransformer.hpp"
+
+#include "mesh/actions/LibActions.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace mesh {
+namespace actions {
+
+//////////////////////////////////////////////////////////////////////////////
+
+/// @brief Change the local order of the nodes and elements, to improve cache locality
+///
+/// The geometry nodes are ordered with Reverse Cuthill-McKee, which minimizes the bandwidth
+/// of the node graph, or along a Hilbert space filling curve. Owned nodes are placed before ghost nodes.
+/// The elements of each Entities are then sorted by their lowest node index.
+/// All fields of the geometry dictionary, the connectivity tables, periodic links and
+/// communication patterns are permuted consistently. Global indices are not changed.
+/// The bandwidth before and after is stored in the properties "bandwidth_before" and "bandwidth_after".
+/// @pre Faces must not have been built yet, since the face-cell connectivity is not renumbered
+class mesh_actions_API Renumber : public MeshTransformer
+{
+public: // functions
+
+  /// constructor
+  Renumber( const std::string& name );
+
+  /// Gets the Class name
+  static std::string type_name() { return "Renumber"; }
+
+  virtual void execute();
+
+  /// The largest difference between the indices of two nodes of the same element, over all elements of the mesh
+  static Uint bandwidth(const Mesh& mesh);
+
+private: // functions
+
+  /// Reverse Cuthill-McKee order of the geometry nodes. new_to_old[i] is the old index of new node i
+  void compute_rcm_order(const Mesh& mesh, std::vector<Uint>& new_to_old) const;
+
+  /// Order of the geometry nodes along a Hilbert curve through the local bounding box
+  void compute_hilbert_order(const Mesh& mesh, std::vector<Uint>& new_to_old) const;
+
+  /// Apply the node permutation to everything that is stored per node or refers to node indices
+  void renumber_nodes(Mesh& mesh, const std::vector<Uint>& new_to_old) const;
+
+  /// Sort the elements of each Entities by their lowest node index
+  void renumber_elements(Mesh& mesh) const;
+
+}; // end Renumber
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // actions
+} // mesh
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_mesh_actions_Renumber_hpp
@@ -4,8 +4,12 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <limits>
 #include <set>
 
+#include "coolfluid-packages.hpp"
+
 #include "common/Builder.hpp"
 
 #include "common/FindComponents.hpp"
@@ -13,6 +17,7 @@
 #include "common/Option.hpp"
 #include "common/OptionList.hpp"
 #include "common/List.hpp"
+#include "common/PE/Comm.hpp"
 
 #include "mesh/ConnectivityData.hpp"
 #include "mesh/DiscontinuousDictionary.hpp"
@@ -26,8 +31,11 @@
 #include "mesh/Connectivity.hpp"
 #include "mesh/ElementData.hpp"
 
+#include "mesh/LagrangeP1/Line2D.hpp"
 #include "mesh/LagrangeP1/Triag2D.hpp"
+#include "mesh/LagrangeP1/Triag3D.hpp"
 #include "mesh/LagrangeP1/Quad2D.hpp"
+#include "mesh/LagrangeP1/Quad3D.hpp"
 
 #include "WallDistance.hpp"
 
@@ -46,61 +54,328 @@ common::ComponentBuilder < WallDistance, MeshTransformer, mesh::actions::LibActi
 namespace detail
 {
 
-/// Helper struct to handle projection to the wall near a given surface node
+/// Wall surface, with the points and elements stored in compressed arrays. In parallel, the surface of all ranks is
+/// gathered, so the distances are correct for nodes close to a wall that is located on another partition.
+struct WallSurface
+{
+  /// Gather the linear surface elements of the given regions
+  WallSurface(const std::vector< Handle<Region> >& regions, const Dictionary& geometry) :
+    dim(geometry.coordinates().row_size())
+  {
+    const Field& coords = geometry.coordinates();
+    const bool is_parallel = common::PE::Comm::instance().is_active() && common::PE::Comm::instance().size() > 1;
+
+    // Collect the local surface, using global node indices in parallel and local ones in serial
+    std::vector<Uint> node_ids;
+    std::vector<Real> node_coords;
+    std::vector<Uint> elem_sizes;
+    std::vector<Uint> elem_node_ids;
+    std::vector<bool> node_added(coords.size(), false);
+    BOOST_FOREACH(const Handle<Region>& region, regions)
+    {
+      BOOST_FOREACH(const mesh::Elements& elements, common::find_components_recursively_with_filter<mesh::Elements>(*region, IsElementsSurface()))
+      {
+        const ElementType& etype = elements.element_type();
+        const Uint element_nb_nodes = etype.nb_nodes();
+
+        // We consider lines, triangles and quads as viable surface elements
+        if(element_nb_nodes < 2 || element_nb_nodes > 4 || etype.order() != 1 || etype.dimensionality() + 1 != dim)
+        {
+          throw common::SetupError(FromHere(), "Unsupported surface element of type " + etype.name() + " in surface region " + elements.uri().path());
+        }
+
+        BOOST_FOREACH(const Connectivity::ConstRow conn_row, elements.geometry_space().connectivity().array())
+        {
+          elem_sizes.push_back(element_nb_nodes);
+          BOOST_FOREACH(const Uint node, conn_row)
+          {
+            const Uint node_id = is_parallel ? geometry.glb_idx()[node] : node;
+            elem_node_ids.push_back(node_id);
+            if(!node_added[node])
+            {
+              node_added[node] = true;
+              node_ids.push_back(node_id);
+              node_coords.insert(node_coords.end(), coords[node].begin(), coords[node].end());
+            }
+          }
+        }
+      }
+    }
+
+    if(is_parallel)
+    {
+      std::vector< std::vector<Uint> > all_node_ids, all_elem_sizes, all_elem_node_ids;
+      std::vector< std::vector<Real> > all_node_coords;
+      common::PE::Comm::instance().all_gather(node_ids, all_node_ids);
+      common::PE::Comm::instance().all_gather(node_coords, all_node_coords);
+      common::PE::Comm::instance().all_gather(elem_sizes, all_elem_sizes);
+      common::PE::Comm::instance().all_gather(elem_node_ids, all_elem_node_ids);
+      build(all_node_ids, all_node_coords, all_elem_sizes, all_elem_node_ids);
+    }
+    else
+    {
+      build(std::vector< std::vector<Uint> >(1, node_ids), std::vector< std::vector<Real> >(1, node_coords), std::vector< std::vector<Uint> >(1, elem_sizes), std::vector< std::vector<Uint> >(1, elem_node_ids));
+    }
+  }
+
+  Uint nb_points() const
+  {
+    return point_ids.size();
+  }
+
+  Real coord(const Uint point, const Uint i) const
+  {
+    return point_coords[point*dim + i];
+  }
+
+  RealVector point(const Uint point) const
+  {
+    RealVector result(dim);
+    for(Uint i = 0; i != dim; ++i)
+      result[i] = coord(point, i);
+    return result;
+  }
+
+  /// Dimension of the mesh
+  const Uint dim;
+  /// Sorted, unique node ids of the surface points
+  std::vector<Uint> point_ids;
+  /// Coordinates of the points, dim values per point
+  std::vector<Real> point_coords;
+  /// The points of element e are elem_points[elem_offsets[e]] to elem_points[elem_offsets[e+1]]
+  std::vector<Uint> elem_offsets;
+  std::vector<Uint> elem_points;
+  /// The elements around point p are point_elems[point_elem_offsets[p]] to point_elems[point_elem_offsets[p+1]]
+  std::vector<Uint> point_elem_offsets;
+  std::vector<Uint> point_elems;
+
+private:
+  /// Merge the surface parts coming from each rank, removing the points and elements that are present more than once
+  void build(const std::vector< std::vector<Uint> >& node_ids, const std::vector< std::vector<Real> >& node_coords, const std::vector< std::vector<Uint> >& elem_sizes, const std::vector< std::vector<Uint> >& elem_node_ids)
+  {
+    const Uint nb_parts = node_ids.size();
+    for(Uint part = 0; part != nb_parts; ++part)
+      point_ids.insert(point_ids.end(), node_ids[part].begin(), node_ids[part].end());
+    std::sort(point_ids.begin(), point_ids.end());
+    point_ids.erase(std::unique(point_ids.begin(), point_ids.end()), point_ids.end());
+
+    const Uint nb_pts = point_ids.size();
+    point_coords.resize(nb_pts*dim);
+    for(Uint part = 0; part != nb_parts; ++part)
+    {
+      const Uint part_nb_nodes = node_ids[part].size();
+      for(Uint i = 0; i != part_nb_nodes; ++i)
+      {
+        const Uint point = point_index(node_ids[part][i]);
+        std::copy(node_coords[part].begin() + i*dim, node_coords[part].begin() + (i+1)*dim, point_coords.begin() + point*dim);
+      }
+    }
+
+    // Elements, identified by their sorted point list
+    std::set< std::vector<Uint> > added_elements;
+    std::vector<Uint> elem_pts, elem_key;
+    elem_offsets.assign(1, 0);
+    for(Uint part = 0; part != nb_parts; ++part)
+    {
+      Uint pos = 0;
+      BOOST_FOREACH(const Uint elem_size, elem_sizes[part])
+      {
+        elem_pts.clear();
+        for(Uint i = 0; i != elem_size; ++i)
+          elem_pts.push_back(point_index(elem_node_ids[part][pos++]));
+        elem_key = elem_pts;
+        std::sort(elem_key.begin(), elem_key.end());
+        if(!added_elements.insert(elem_key).second)
+          continue;
+        elem_points.insert(elem_points.end(), elem_pts.begin(), elem_pts.end());
+        elem_offsets.push_back(elem_points.size());
+      }
+    }
+
+    // Point to element connectivity
+    const Uint nb_elems = elem_offsets.size() - 1;
+    point_elem_offsets.assign(nb_pts+1, 0);
+    BOOST_FOREACH(const Uint point, elem_points)
+      ++point_elem_offsets[point+1];
+    for(Uint i = 0; i != nb_pts; ++i)
+      point_elem_offsets[i+1] += point_elem_offsets[i];
+    point_elems.resize(elem_points.size());
+    std::vector<Uint> fill_position(point_elem_offsets.begin(), point_elem_offsets.end()-1);
+    for(Uint elem = 0; elem != nb_elems; ++elem)
+    {
+      for(Uint i = elem_offsets[elem]; i != elem_offsets[elem+1]; ++i)
+        point_elems[fill_position[elem_points[i]]++] = elem;
+    }
+  }
+
+  Uint point_index(const Uint node_id) const
+  {
+    return std::lower_bound(point_ids.begin(), point_ids.end(), node_id) - point_ids.begin();
+  }
+};
+
+/// Compare points along one coordinate axis
+struct AxisLess
+{
+  AxisLess(const WallSurface& surface, const Uint axis) : m_surface(surface), m_axis(axis)
+  {
+  }
+
+  bool operator()(const Uint a, const Uint b) const
+  {
+    return m_surface.coord(a, m_axis) < m_surface.coord(b, m_axis);
+  }
+
+  const WallSurface& m_surface;
+  const Uint m_axis;
+};
+
+/// Balanced k-d tree over the surface points, used to find the closest surface point to a given coordinate.
+/// The tree is stored implicitly: each range of the index array is split at its middle element.
+class SurfaceKdTree
+{
+public:
+  SurfaceKdTree(const WallSurface& surface) :
+    m_surface(surface),
+    m_points(surface.nb_points()),
+    m_axes(surface.nb_points(), 0)
+  {
+    for(Uint i = 0; i != m_points.size(); ++i)
+      m_points[i] = i;
+    build(0, m_points.size());
+  }
+
+  /// Index of the surface point that is closest to the given coordinates
+  Uint closest_point(const RealVector& coord) const
+  {
+    Uint closest = 0;
+    Real shortest_distance = std::numeric_limits<Real>::max();
+    search(0, m_points.size(), coord, closest, shortest_distance);
+    return closest;
+  }
+
+private:
+  void build(const Uint begin, const Uint end)
+  {
+    if(end - begin < 2)
+      return;
+
+    // Split along the axis with the largest extent
+    const Uint dim = m_surface.dim;
+    RealVector min_coord = m_surface.point(m_points[begin]);
+    RealVector max_coord = min_coord;
+    for(Uint i = begin+1; i != end; ++i)
+    {
+      for(Uint j = 0; j != dim; ++j)
+      {
+        const Real c = m_surface.coord(m_points[i], j);
+        min_coord[j] = std::min(min_coord[j], c);
+        max_coord[j] = std::max(max_coord[j], c);
+      }
+    }
+    Uint axis = 0;
+    (max_coord - min_coord).maxCoeff(&axis);
+
+    const Uint middle = (begin + end) / 2;
+    std::nth_element(m_points.begin() + begin, m_points.begin() + middle, m_points.begin() + end, AxisLess(m_surface, axis));
+    m_axes[middle] = axis;
+    build(begin, middle);
+    build(middle+1, end);
+  }
+
+  void search(const Uint begin, const Uint end, const RealVector& coord, Uint& closest, Real& shortest_distance) const
+  {
+    if(begin == end)
+      return;
+
+    const Uint middle = (begin + end) / 2;
+    const Uint point = m_points[middle];
+    Real d2 = 0.;
+    for(Uint j = 0; j != m_surface.dim; ++j)
+    {
+      const Real dx = coord[j] - m_surface.coord(point, j);
+      d2 += dx*dx;
+    }
+    if(d2 < shortest_distance)
+    {
+      shortest_distance = d2;
+      closest = point;
+    }
+
+    // Visit the side containing the coordinate first, and the other side only if it can contain a closer point
+    const Uint axis = m_axes[middle];
+    const Real axis_distance = coord[axis] - m_surface.coord(point, axis);
+    if(axis_distance < 0.)
+    {
+      search(begin, middle, coord, closest, shortest_distance);
+      if(axis_distance*axis_distance < shortest_distance)
+        search(middle+1, end, coord, closest, shortest_distance);
+    }
+    else
+    {
+      search(middle+1, end, coord, closest, shortest_distance);
+      if(axis_distance*axis_distance < shortest_distance)
+        search(begin, middle, coord, closest, shortest_distance);
+    }
+  }
+
+  const WallSurface& m_surface;
+  std::vector<Uint> m_points;
+  std::vector<Uint> m_axes;
+};
+
+/// Helper struct to handle projection to the wall near a given surface point
 struct WallProjection
 {
-  WallProjection(const Field& coordinates, const CNodeConnectivity& node_connectivity) :
-    m_coords(coordinates),
-    m_node_connectivity(node_connectivity)
+  WallProjection(const WallSurface& surface) :
+    m_surface(surface)
   {
   }
 
-  // Get the wall distance for an inner node, looking at the elements that are adjacent to the given surface node
-  Real operator()(const Uint inner_node_idx, const Uint surface_node_idx)
+  // Get the wall distance for an inner node, looking at the elements that are adjacent to the given surface point
+  Real operator()(const RealVector& inner_coord, const Uint surface_point) const
   {
     RealMatrix elem_coords;
-    const Uint dim = m_coords.row_size();
-    const RealVector inner_coord = to_vector(m_coords[inner_node_idx]);
-    std::vector<Uint> neighbor_nodes; // Collect neighboring nodes, so we can project onto a sharp corner in 3D if needed (i.e. near a step)
-    // Loop over all surface elements around the given node
-    BOOST_FOREACH(const Uint elem_idx, m_node_connectivity.node_element_range(surface_node_idx))
+    const Uint dim = m_surface.dim;
+    std::vector<Uint> neighbor_points; // Collect neighboring points, so we can project onto a sharp corner in 3D if needed (i.e. near a step)
+    // Loop over all surface elements around the given point
+    for(Uint elem_pos = m_surface.point_elem_offsets[surface_point]; elem_pos != m_surface.point_elem_offsets[surface_point+1]; ++elem_pos)
     {
       // Get the element coordinates
-      const CNodeConnectivity::ElementReferenceT element_ref = m_node_connectivity.element(elem_idx);
-      const ElementType& etype = element_ref.first->element_type();
-      const Uint element_nb_nodes = etype.nb_nodes();
+      const Uint elem_idx = m_surface.point_elems[elem_pos];
+      const Uint* conn_row = &m_surface.elem_points[m_surface.elem_offsets[elem_idx]];
+      const Uint element_nb_nodes = m_surface.elem_offsets[elem_idx+1] - m_surface.elem_offsets[elem_idx];
       elem_coords.resize(element_nb_nodes, dim);
-      const Connectivity::ConstRow conn_row = element_ref.first->geometry_space().connectivity()[element_ref.second];
-      fill(elem_coords, m_coords, conn_row);
+      for(Uint i = 0; i != element_nb_nodes; ++i)
+        elem_coords.row(i) = m_surface.point(conn_row[i]);
 
-      // We consider lines, triangles and quads as viable surface elements
-      if(element_nb_nodes < 2 || element_nb_nodes > 4 || etype.order() != 1)
-      {
-        throw common::SetupError(FromHere(), "Unsupported surface element of type " + etype.name() + " in surface region " + element_ref.first->uri().path());
-      }
-      
       bool in_element = false;
+      RealVector n(dim); // normal vector
 
       if(element_nb_nodes == 2) // line segment
       {
         cf3_assert(dim == 2);
-        cf3_assert(etype.shape() == GeoShape::LINE);
         RealVector e1 = elem_coords.row(1) - elem_coords.row(0); // line segment vector
         Real e1_len = e1.norm();
         e1 /= e1_len;
         const Real projection = e1.dot(inner_coord - elem_coords.row(0).transpose());
         // If the projection of the node along the normal fits inside the element, we can take the normal distance
         in_element = projection > 0 && projection < e1_len;
+        if(in_element)
+        {
+          LagrangeP1::Line2D::CoordsT normal;
+          LagrangeP1::Line2D::compute_normal(elem_coords, normal);
+          n = normal;
+        }
       }
       if(element_nb_nodes == 3)
       {
         cf3_assert(dim == 3);
-        cf3_assert(etype.shape() == GeoShape::TRIAG);
         RealVector3 e1 = (elem_coords.row(1) - elem_coords.row(0)).normalized();
         RealVector3 en = elem_coords.row(2) - elem_coords.row(0);
         RealVector3 e2 = (e1.cross(en)).cross(e1).normalized();
         RealVector3 p = inner_coord - elem_coords.row(0).transpose();
-        
+
         // Construct 2D coordinates for the boundary element
         Eigen::Matrix<Real, 3, 2> triag_coords_2d;
         triag_coords_2d.row(0).setZero();
@@ -108,33 +383,38 @@ struct WallProjection
         triag_coords_2d(1,1) = 0.;
         triag_coords_2d(2,0) = e1.dot(elem_coords.row(2) - elem_coords.row(0));
         triag_coords_2d(2,1) = e2.dot(elem_coords.row(2) - elem_coords.row(0));
-        
+
         RealVector2 p_proj(2);
         p_proj[0] = p.dot(e1);
         p_proj[1] = p.dot(e2);
-        
+
         in_element = LagrangeP1::Triag2D::is_coord_in_element(p_proj, triag_coords_2d);
-        const Uint origin_corner = std::find(conn_row.begin(), conn_row.end(), surface_node_idx) - conn_row.begin();
+        if(in_element)
+        {
+          LagrangeP1::Triag3D::CoordsT normal;
+          LagrangeP1::Triag3D::compute_normal(elem_coords, normal);
+          n = normal;
+        }
+        const Uint origin_corner = std::find(conn_row, conn_row + 3, surface_point) - conn_row;
         if(origin_corner == 0)
         {
-          neighbor_nodes.push_back(conn_row[1]);
-          neighbor_nodes.push_back(conn_row[2]);
+          neighbor_points.push_back(conn_row[1]);
+          neighbor_points.push_back(conn_row[2]);
         }
         else if(origin_corner == 1)
         {
-          neighbor_nodes.push_back(conn_row[0]);
-          neighbor_nodes.push_back(conn_row[2]);
+          neighbor_points.push_back(conn_row[0]);
+          neighbor_points.push_back(conn_row[2]);
         }
         else
         {
-          neighbor_nodes.push_back(conn_row[0]);
-          neighbor_nodes.push_back(conn_row[1]);
+          neighbor_points.push_back(conn_row[0]);
+          neighbor_points.push_back(conn_row[1]);
         }
       }
       if(element_nb_nodes == 4)
       {
         cf3_assert(dim == 3);
-        cf3_assert(etype.shape() == GeoShape::QUAD);
         RealVector3 e1 = (elem_coords.row(1) - elem_coords.row(0)).normalized();
         RealVector3 en = elem_coords.row(3) - elem_coords.row(0);
         RealVector3 e2 = (e1.cross(en)).cross(e1).normalized();
@@ -154,33 +434,37 @@ struct WallProjection
         p_proj[1] = p.dot(e2);
 
         in_element = LagrangeP1::Quad2D::is_coord_in_element(p_proj, quad_coords_2d);
-        const Uint origin_corner = std::find(conn_row.begin(), conn_row.end(), surface_node_idx) - conn_row.begin();
+        if(in_element)
+        {
+          LagrangeP1::Quad3D::CoordsT normal;
+          LagrangeP1::Quad3D::compute_normal(elem_coords, normal);
+          n = normal;
+        }
+        const Uint origin_corner = std::find(conn_row, conn_row + 4, surface_point) - conn_row;
         if(origin_corner == 0 || origin_corner == 2)
         {
-          neighbor_nodes.push_back(conn_row[1]);
-          neighbor_nodes.push_back(conn_row[3]);
+          neighbor_points.push_back(conn_row[1]);
+          neighbor_points.push_back(conn_row[3]);
         }
         else
         {
-          neighbor_nodes.push_back(conn_row[0]);
-          neighbor_nodes.push_back(conn_row[2]);
+          neighbor_points.push_back(conn_row[0]);
+          neighbor_points.push_back(conn_row[2]);
         }
       }
-      
+
       // If the projection was in an element, we can just proceed to compute the normal distance
       if(in_element)
       {
-        RealVector n(dim); // normal vector
-        etype.compute_normal(elem_coords, n);
         return fabs((n/n.norm()).dot(inner_coord - elem_coords.row(0).transpose()));
       }
     }
     // If we got here, no projections on the elements gave a result
     // First, verify the 3D case where we need to project on "step" edges
-    BOOST_FOREACH(const Uint neighbor_node, neighbor_nodes)
+    const RealVector surface_coord = m_surface.point(surface_point);
+    BOOST_FOREACH(const Uint neighbor_point, neighbor_points)
     {
-      const RealVector surface_coord = to_vector(m_coords[surface_node_idx]);
-      const RealVector neighbor_coord = to_vector(m_coords[neighbor_node]);
+      const RealVector neighbor_coord = m_surface.point(neighbor_point);
       RealVector e1 = neighbor_coord - surface_coord;
       Real e1_len = e1.norm();
       e1 /= e1_len;
@@ -190,11 +474,10 @@ struct WallProjection
         return (inner_coord - (surface_coord + e1*projection)).norm();
       }
     }
-    return (inner_coord - to_vector(m_coords[surface_node_idx])).norm();
+    return (inner_coord - surface_coord).norm();
   }
 
-  const Field& m_coords;
-  const CNodeConnectivity& m_node_connectivity;
+  const WallSurface& m_surface;
 };
 }
 
@@ -216,48 +499,43 @@ void WallDistance::execute()
   const Field& coords = mesh.geometry_fields().coordinates();
   const Uint nb_nodes = coords.size();
 
-  boost::shared_ptr<CNodeConnectivity> node_connectivity = common::allocate_component<CNodeConnectivity>("NodeConnectivity");
-  std::vector< Handle<Entities const> > surface_entities;
-  BOOST_FOREACH(const Handle<Region const>& region, m_regions)
+  // Nodes that are part of the wall on this rank have a zero distance
+  std::vector<bool> is_surface_node(nb_nodes, false);
+  BOOST_FOREACH(const Handle<Region>& region, m_regions)
   {
     BOOST_FOREACH(const mesh::Elements& elements, common::find_components_recursively_with_filter<mesh::Elements>(*region, IsElementsSurface()))
     {
-      surface_entities.push_back(elements.handle<Entities const>());
+      BOOST_FOREACH(const Connectivity::ConstRow conn_row, elements.geometry_space().connectivity().array())
+      {
+        BOOST_FOREACH(const Uint node, conn_row)
+          is_surface_node[node] = true;
+      }
     }
   }
 
-  node_connectivity->initialize(nb_nodes, surface_entities);
+  const detail::WallSurface surface(m_regions, mesh.geometry_fields());
+  if(surface.nb_points() == 0)
+    throw common::SetupError(FromHere(), "No surface elements found in the wall regions for " + uri().path());
 
-  boost::shared_ptr< common::List< Uint > > surface_nodes_ptr = build_used_nodes_list(surface_entities, mesh.geometry_fields(), true);
-  const common::List<Uint>& surface_nodes = *surface_nodes_ptr;
-  const Uint nb_surface_nodes = surface_nodes.size();
+  const detail::SurfaceKdTree kd_tree(surface);
+  const detail::WallProjection normal_distance(surface);
 
-  detail::WallProjection normal_distance(coords, *node_connectivity);
-
-  for(Uint inner_node_idx = 0; inner_node_idx != nb_nodes; ++inner_node_idx)
+  // The queries are independent, so they can be spread over the threads
+  const int nb_nodes_int = nb_nodes;
+#ifdef CF3_HAVE_OPENMP
+  #pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for(int inner_node_idx = 0; inner_node_idx < nb_nodes_int; ++inner_node_idx)
   {
-    bool is_surface_node = false;
-    Real shortest_distance = 1e20;
-    Uint closest_surface_node = 0;
-    for(Uint j = 0; j != nb_surface_nodes; ++j)
+    if(is_surface_node[inner_node_idx])
     {
-      const Uint surface_node_idx = surface_nodes[j];
-      if(surface_node_idx == inner_node_idx)
-      {
-        is_surface_node = true;
-        break;
-      }
-      const Real d2 = (to_vector(coords[inner_node_idx]) - to_vector(coords[surface_node_idx])).squaredNorm();
-      if(d2 < shortest_distance)
-      {
-        shortest_distance = d2;
-        closest_surface_node = surface_node_idx;
-      }
+      d[inner_node_idx][0] = 0.;
+      continue;
     }
 
-    d[inner_node_idx][0] = is_surface_node ? 0. : normal_distance(inner_node_idx, closest_surface_node);
+    const RealVector inner_coord = to_vector(coords[inner_node_idx]);
+    d[inner_node_idx][0] = normal_distance(inner_coord, kd_tree.closest_point(inner_coord));
   }
-
 }
 
 //////////////////////////////////////////////////////////////////////////////
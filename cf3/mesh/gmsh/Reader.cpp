@@ -4,6 +4,9 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+#include <cstring>
+
 #include <boost/foreach.hpp>
 #include <boost/tokenizer.hpp>
 #include <boost/regex.hpp>
@@ -33,6 +36,7 @@
 #include "mesh/Field.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/Cells.hpp"
+#include "mesh/MappedFile.hpp"
 
 #include "mesh/gmsh/Reader.hpp"
 
@@ -71,6 +75,12 @@ Reader::Reader( const std::string& name )
       .pretty_name("Read Fields")
       .mark_basic();
 
+  options().add("parallel_read", false)
+      .description("Memory-map the file and let each process parse only a share of the nodes and elements, "
+                   "instead of every process parsing the whole file. Requires part and nb_parts to match "
+                   "the rank and size of the communicator. Binary files are always read this way.")
+      .pretty_name("Parallel Read");
+
   // properties
 
   properties()["brief"] = std::string("Gmsh file reader component");
@@ -121,15 +131,31 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // NOTE: since gmsh contains several 'physical entities' in one mesh, we create one region per physical entity
   m_region = Handle<Region>(m_mesh->topology().handle<Component>());
 
-  // Read file once and store positions
-  get_file_positions();
-  cf3_assert(m_hash);
+  const bool binary = is_binary_file();
+  const bool chunked_possible = options().value<Uint>("part") == PE::Comm::instance().rank()
+                             && options().value<Uint>("nb_parts") == PE::Comm::instance().size();
+  if (binary && !chunked_possible)
+    throw NotSupported(FromHere(), "Binary gmsh files can only be read with part and nb_parts matching the rank and size of the communicator");
 
-  m_mesh->initialize_nodes(0, m_mesh_dimension);
+  if (binary || (options().value<bool>("parallel_read") && chunked_possible))
+  {
+    read_chunked(fp.string());
+  }
+  else
+  {
+    if (options().value<bool>("parallel_read"))
+      CFwarn << "Ignoring option parallel_read: part and nb_parts don't match the communicator" << CFendl;
 
-  find_used_nodes();
-  read_coordinates();
-  read_connectivity();
+    // Read file once and store positions
+    get_file_positions();
+    cf3_assert(m_hash);
+
+    m_mesh->initialize_nodes(0, m_mesh_dimension);
+
+    find_used_nodes();
+    read_coordinates();
+    read_connectivity();
+  }
 
   fix_negative_volumes(*m_mesh);
 
@@ -178,31 +204,7 @@ void Reader::get_file_positions()
     getline(m_file,line);
     if (line.find(region_names)!=std::string::npos) {
       m_region_names_position=p;
-      m_file >> m_nb_regions;
-      m_region_list.resize(m_nb_regions);
-
-      m_nb_gmsh_elem_in_region.resize(m_nb_regions);
-      for(Uint ir = 0; ir < m_nb_regions; ++ir)
-      {
-        m_nb_gmsh_elem_in_region[ir].resize(Shared::nb_gmsh_types);
-        for(Uint type = 0; type < Shared::nb_gmsh_types; ++ type)
-           (m_nb_gmsh_elem_in_region[ir])[type] = 0;
-      }
-
-      m_mesh_dimension = options().value<Uint>("dimension");
-      for(Uint ir = 0; ir < m_nb_regions; ++ir)
-      {
-        Uint phys_group_dimensionality;
-        Uint phys_group_index;
-        std::string phys_group_name;
-        m_file >> phys_group_dimensionality >> phys_group_index >> phys_group_name;
-        m_region_list[phys_group_index-1].dim=phys_group_dimensionality;
-        m_region_list[phys_group_index-1].index=phys_group_index;
-        //The original name of the region in the mesh file has quotes, we want to strip them off
-        m_region_list[phys_group_index-1].name=phys_group_name.substr(1,phys_group_name.length()-2);
-        m_region_list[phys_group_index-1].region = create_region(m_region_list[phys_group_index-1].name);
-        m_mesh_dimension = std::max(m_region_list[phys_group_index-1].dim,m_mesh_dimension);
-      }
+      read_physical_names();
     }
     else if (line.find(nodes)!=std::string::npos) {
       m_coordinates_position=p;
@@ -264,6 +266,56 @@ void Reader::get_file_positions()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+bool Reader::is_binary_file()
+{
+  std::string line;
+  m_file.seekg(0,std::ios::beg);
+  getline(m_file,line);
+
+  Real version(0.);
+  Uint file_type(0);
+  if (line.find("$MeshFormat")!=std::string::npos)
+    m_file >> version >> file_type;
+
+  m_file.clear();
+  m_file.seekg(0,std::ios::beg);
+  return file_type == 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_physical_names()
+{
+  m_file >> m_nb_regions;
+  m_region_list.clear();
+  m_region_list.resize(m_nb_regions);
+
+  m_nb_gmsh_elem_in_region.resize(m_nb_regions);
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+  {
+    m_nb_gmsh_elem_in_region[ir].resize(Shared::nb_gmsh_types);
+    for(Uint type = 0; type < Shared::nb_gmsh_types; ++ type)
+       (m_nb_gmsh_elem_in_region[ir])[type] = 0;
+  }
+
+  m_mesh_dimension = options().value<Uint>("dimension");
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+  {
+    Uint phys_group_dimensionality;
+    Uint phys_group_index;
+    std::string phys_group_name;
+    m_file >> phys_group_dimensionality >> phys_group_index >> phys_group_name;
+    m_region_list[phys_group_index-1].dim=phys_group_dimensionality;
+    m_region_list[phys_group_index-1].index=phys_group_index;
+    //The original name of the region in the mesh file has quotes, we want to strip them off
+    m_region_list[phys_group_index-1].name=phys_group_name.substr(1,phys_group_name.length()-2);
+    m_region_list[phys_group_index-1].region = create_region(m_region_list[phys_group_index-1].name);
+    m_mesh_dimension = std::max(m_region_list[phys_group_index-1].dim,m_mesh_dimension);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 Handle< Region > Reader::create_region(std::string const& relative_path)
 {
   typedef boost::tokenizer<boost::char_separator<char> > Tokenizer;
@@ -498,42 +550,20 @@ void Reader::read_coordinates()
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Reader::read_connectivity()
+void Reader::create_element_tables(std::vector<std::map<Uint, Entities*> >& conn_table_idx)
 {
+ Dictionary& nodes = m_mesh->geometry_fields();
 
-  Dictionary& nodes = m_mesh->geometry_fields();
-
-
-  Uint part = options().value<Uint>("part");
-
-  //Each entry of this vector holds a map (gmsh_type_idx, pointer to connectivity table of this gmsh type).
- //Each row corresponds to one region of the mesh
- std::vector<std::map<Uint, Entities* > > conn_table_idx;
- conn_table_idx.resize(m_nb_regions);
- for(Uint ir = 0; ir < m_nb_regions; ++ir)
- {
-    conn_table_idx[ir].clear();
- }
-
- std::map<Uint, Entities*>::iterator elem_table_iter;
-
-// std::vector<std::map<std::string,Handle< Elements > > > elements(m_nb_regions);
-// std::vector<std::map<std::string,Handle< Connectivity::Buffer > > > buffer(m_nb_regions);
+ conn_table_idx.assign(m_nb_regions, std::map<Uint, Entities*>());
 
-
- m_elem_idx_gmsh_to_cf.clear();
  //Loop over all regions and allocate a connectivity table of proper size for each element type that
  //is present in each region. Counting of elements was done during the first pass in the function
- //get_file_positions
+ //get_file_positions, or in read_chunked
  for(Uint ir = 0; ir < m_nb_regions; ++ir)
  {
    // create new region
    Handle< Region > region = m_region_list[ir].region;
 
-//   elements[ir] = create_cells_in_region(*region,m_mesh->geometry_fields(),m_supported_types);
-//   buffer[ir] = create_connectivity_buffermap(elements[ir]);
-
-
    // Take the gmsh element types present in this region and generate new names of elements which correspond
    // to coolfuid naming:
    for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
@@ -562,6 +592,22 @@ void Reader::read_connectivity()
      }
    }
  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_connectivity()
+{
+  Uint part = options().value<Uint>("part");
+
+  //Each entry of this vector holds a map (gmsh_type_idx, pointer to connectivity table of this gmsh type).
+ //Each row corresponds to one region of the mesh
+ std::vector<std::map<Uint, Entities* > > conn_table_idx;
+ create_element_tables(conn_table_idx);
+
+ std::map<Uint, Entities*>::iterator elem_table_iter;
+
+ m_elem_idx_gmsh_to_cf.clear();
 
    std::string etype_CF;
    std::set<Uint>::const_iterator it;
@@ -651,6 +697,568 @@ void Reader::read_connectivity()
   getline(m_file,line);  // ENDOFSECTION
 }
 
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Exchange buffers with all processes, or copy them when running on a single process
+template<typename T>
+void exchange(const std::vector< std::vector<T> >& send, std::vector< std::vector<T> >& recv)
+{
+  if (PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    PE::Comm::instance().all_to_all(send, recv);
+  else
+    recv = send;
+}
+
+/// Index of the first record parsed by this process, given the number of records it parsed.
+/// Also returns the total number of records parsed by all processes.
+Uint first_record(const Uint nb_local_records, Uint& nb_records)
+{
+  std::vector<Uint> nb_records_per_part(1, nb_local_records);
+  if (PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    PE::Comm::instance().all_gather(nb_local_records, nb_records_per_part);
+
+  Uint first = 0;
+  nb_records = 0;
+  for (Uint part=0; part<nb_records_per_part.size(); ++part)
+  {
+    if (part == PE::Comm::instance().rank())
+      first = nb_records;
+    nb_records += nb_records_per_part[part];
+  }
+  return first;
+}
+
+/// Read a value stored in native byte order and advance p past it
+template<typename T>
+T read_binary(const char*& p)
+{
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+/// True if the text at p starts with the given keyword
+bool is_keyword(const char* p, const char* end, const std::string& keyword)
+{
+  return Uint(end - p) >= keyword.size() && std::memcmp(p, keyword.data(), keyword.size()) == 0;
+}
+
+void throw_parse_error(const MappedFile& file, const char* p, const std::string& path, const std::string& what)
+{
+  throw ParsingFailed(FromHere(), "Could not read " + what + " at byte " + to_str(Uint(p - file.begin())) + " of " + path);
+}
+
+/// Block of element records of the same type, in a binary file
+struct BinaryElementBlock
+{
+  const char* begin;
+  Uint type;
+  Uint nb_tags;
+  Uint first_record;
+  Uint nb_records;
+  Uint record_size;
+};
+
+/// Node stored on this process
+struct ChunkedNode
+{
+  Uint record;
+  Uint number;
+  Uint rank;
+  Real coords[3];
+  bool operator<(const ChunkedNode& other) const { return record < other.record; }
+};
+
+/// Element owned by this process. The data points to (record, number, type, physical tag, nodes...) in a receive buffer.
+struct ChunkedElement
+{
+  Uint record;
+  const Uint* data;
+  bool operator<(const ChunkedElement& other) const { return record < other.record; }
+};
+
+/// Append the nodes received as (record, number) pairs and coordinate triplets
+void unpack_nodes(const std::vector< std::vector<Uint> >& idx, const std::vector< std::vector<Real> >& coords, std::vector<ChunkedNode>& nodes)
+{
+  for (Uint proc=0; proc<idx.size(); ++proc)
+  {
+    for (Uint i=0; 2*i<idx[proc].size(); ++i)
+    {
+      ChunkedNode node;
+      node.record = idx[proc][2*i];
+      node.number = idx[proc][2*i+1];
+      node.rank = 0;
+      for (Uint d=0; d<3; ++d)
+        node.coords[d] = coords[proc][3*i+d];
+      nodes.push_back(node);
+    }
+  }
+}
+
+/// Queue a node for sending to the given process
+void pack_node(const Uint proc, const Uint record, const Uint number, const Real* coords, std::vector< std::vector<Uint> >& idx, std::vector< std::vector<Real> >& coords_buffer)
+{
+  idx[proc].push_back(record);
+  idx[proc].push_back(number);
+  coords_buffer[proc].insert(coords_buffer[proc].end(), coords, coords+3);
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_chunked(const std::string& path)
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  MappedFile file(path);
+  const char* const file_end = file.end();
+
+  // $MeshFormat, always the first section
+  const char* p = skip_whitespace(file.begin(), file_end);
+  if (!is_keyword(p, file_end, "$MeshFormat"))
+    throw ParsingFailed(FromHere(), path + " does not start with a $MeshFormat section");
+  p = next_line(p, file_end);
+  Real version;
+  Uint file_type, data_size;
+  if (!parse_real(p, file_end, version) || !parse_uint(p, file_end, file_type) || !parse_uint(p, file_end, data_size))
+    throw_parse_error(file, p, path, "the $MeshFormat section");
+  if (version < 2. || version >= 3.)
+    throw NotSupported(FromHere(), path + " has gmsh format version " + to_str(version) + ", only version 2 is supported");
+  const bool binary = (file_type == 1);
+  p = next_line(p, file_end);
+  if (binary)
+  {
+    if (data_size != sizeof(double))
+      throw NotSupported(FromHere(), "Binary gmsh file " + path + " stores reals in " + to_str(data_size) + " bytes, only " + to_str(sizeof(double)) + " is supported");
+    if (Uint(file_end - p) < sizeof(int) || read_binary<int>(p) != 1)
+      throw NotSupported(FromHere(), "Binary gmsh file " + path + " was written with a different byte order");
+  }
+
+  // Locate the sections
+  const char* nodes_begin = 0;
+  const char* nodes_end = 0;
+  const char* elements_begin = 0;
+  const char* elements_end = 0;
+  bool found_physical_names = false;
+  std::vector<BinaryElementBlock> element_blocks;
+  m_element_data_positions.clear();
+  m_node_data_positions.clear();
+  m_element_node_data_positions.clear();
+  if (binary)
+  {
+    // Keywords can't be searched for in binary data, so walk the section headers, skipping the records.
+    // The data sections after the elements are not read.
+    while ((p = skip_whitespace(p, file_end)) != file_end)
+    {
+      const char* line_end = next_line(p, file_end);
+      if (is_keyword(p, line_end, "$PhysicalNames"))
+      {
+        m_region_names_position = p - file.begin();
+        found_physical_names = true;
+        p = line_end;
+      }
+      else if (is_keyword(p, line_end, "$Nodes"))
+      {
+        m_coordinates_position = p - file.begin();
+        p = line_end;
+        if (!parse_uint(p, file_end, m_total_nb_nodes))
+          throw_parse_error(file, p, path, "the number of nodes");
+        nodes_begin = next_line(p, file_end);
+        const Uint nodes_size = m_total_nb_nodes * (sizeof(int) + 3*sizeof(double));
+        if (Uint(file_end - nodes_begin) < nodes_size)
+          throw ParsingFailed(FromHere(), "Binary gmsh file " + path + " is truncated in the $Nodes section");
+        nodes_end = nodes_begin + nodes_size;
+        p = nodes_end;
+      }
+      else if (is_keyword(p, line_end, "$Elements"))
+      {
+        m_elements_position = p - file.begin();
+        p = line_end;
+        if (!parse_uint(p, file_end, m_total_nb_elements))
+          throw_parse_error(file, p, path, "the number of elements");
+        p = next_line(p, file_end);
+        elements_begin = p;
+        Uint record = 0;
+        while (record < m_total_nb_elements)
+        {
+          if (Uint(file_end - p) < 3*sizeof(int))
+            throw ParsingFailed(FromHere(), "Binary gmsh file " + path + " is truncated in the $Elements section");
+          BinaryElementBlock block;
+          block.type = read_binary<int>(p);
+          block.nb_records = read_binary<int>(p);
+          block.nb_tags = read_binary<int>(p);
+          if (block.type >= Shared::nb_gmsh_types || Shared::m_nodes_in_gmsh_elem[block.type] == 0)
+            throw NotSupported(FromHere(), "Unsupported gmsh element type " + to_str(block.type) + " in " + path);
+          if (block.nb_tags == 0)
+            throw ParsingFailed(FromHere(), "Elements without physical tag in " + path);
+          block.begin = p;
+          block.first_record = record;
+          block.record_size = (1 + block.nb_tags + Shared::m_nodes_in_gmsh_elem[block.type]) * sizeof(int);
+          if (Uint(file_end - p) < block.nb_records*block.record_size)
+            throw ParsingFailed(FromHere(), "Binary gmsh file " + path + " is truncated in the $Elements section");
+          p += block.nb_records*block.record_size;
+          record += block.nb_records;
+          element_blocks.push_back(block);
+        }
+        elements_end = p;
+
+        // skip $EndElements
+        p = next_line(skip_whitespace(p, file_end), file_end);
+        if (skip_whitespace(p, file_end) != file_end && options().value<bool>("read_fields"))
+          CFwarn << "Fields are not read from binary gmsh files, ignoring the sections after $Elements in " << path << CFendl;
+        break;
+      }
+      else
+      {
+        p = line_end;
+      }
+    }
+  }
+  else
+  {
+    enum { PHYSICAL_NAMES, NODES, END_NODES, ELEMENTS, END_ELEMENTS, NODE_DATA, ELEMENT_NODE_DATA };
+    std::vector<std::string> keywords;
+    keywords.push_back("$PhysicalNames");
+    keywords.push_back("$Nodes");
+    keywords.push_back("$EndNodes");
+    keywords.push_back("$Elements");
+    keywords.push_back("$EndElements");
+    keywords.push_back("$NodeData");
+    keywords.push_back("$ElementNodeData");
+
+    const std::vector<MappedFile::KeywordLine> keyword_lines = file.find_keyword_lines(keywords);
+    boost_foreach(const MappedFile::KeywordLine& keyword_line, keyword_lines)
+    {
+      const char* line = file.begin() + keyword_line.offset;
+      switch (keyword_line.keyword)
+      {
+        case PHYSICAL_NAMES:
+          m_region_names_position = keyword_line.offset;
+          found_physical_names = true;
+          break;
+        case NODES:
+          m_coordinates_position = keyword_line.offset;
+          p = next_line(line, file_end);
+          if (!parse_uint(p, file_end, m_total_nb_nodes))
+            throw_parse_error(file, p, path, "the number of nodes");
+          nodes_begin = next_line(p, file_end);
+          break;
+        case END_NODES:
+          nodes_end = line;
+          break;
+        case ELEMENTS:
+          m_elements_position = keyword_line.offset;
+          p = next_line(line, file_end);
+          if (!parse_uint(p, file_end, m_total_nb_elements))
+            throw_parse_error(file, p, path, "the number of elements");
+          elements_begin = next_line(p, file_end);
+          break;
+        case END_ELEMENTS:
+          elements_end = line;
+          break;
+        case NODE_DATA:
+          m_node_data_positions.push_back(keyword_line.offset);
+          break;
+        case ELEMENT_NODE_DATA:
+          m_element_node_data_positions.push_back(keyword_line.offset);
+          break;
+      }
+    }
+  }
+
+  if (!found_physical_names)
+    throw ParsingFailed(FromHere(), path + " has no $PhysicalNames section");
+  if (nodes_begin == 0 || nodes_end == 0 || nodes_end < nodes_begin)
+    throw ParsingFailed(FromHere(), path + " has no complete $Nodes section");
+  if (elements_begin == 0 || elements_end == 0 || elements_end < elements_begin)
+    throw ParsingFailed(FromHere(), path + " has no complete $Elements section");
+  if (m_total_nb_nodes == 0) throw ParsingFailed(FromHere(),"File contains no nodes");
+  if (m_total_nb_elements == 0) throw ParsingFailed(FromHere(),"File contains no elements");
+
+  // The physical names are always stored as text
+  std::string line;
+  m_file.seekg(m_region_names_position,std::ios::beg);
+  getline(m_file,line);
+  read_physical_names();
+
+  m_mesh->initialize_nodes(0, m_mesh_dimension);
+
+  //Create a hash
+  m_hash = create_component<MergedParallelDistribution>("hash");
+  std::vector<Uint> num_obj(2);
+  num_obj[0] = m_total_nb_nodes;
+  num_obj[1] = m_total_nb_elements;
+  m_hash->options().set("nb_parts",options().value<Uint>("nb_parts"));
+  m_hash->options().set("nb_obj",num_obj);
+  const ParallelDistribution& node_hash = m_hash->subhash(NODES);
+  const ParallelDistribution& elem_hash = m_hash->subhash(ELEMS);
+
+  // 1) Parse this process's share of the node records. Each node is sent to the process that owns it,
+  //    and to a directory process chosen from the gmsh node number, where ghost nodes are looked up later.
+  std::vector< std::vector<Uint> > node_idx_send(nb_procs), directory_idx_send(nb_procs);
+  std::vector< std::vector<Real> > node_coords_send(nb_procs), directory_coords_send(nb_procs);
+  {
+    std::vector<Uint> numbers;
+    std::vector<Real> coords;
+    Uint first;
+    if (binary)
+    {
+      const Uint record_size = sizeof(int) + 3*sizeof(double);
+      first = (rank*m_total_nb_nodes)/nb_procs;
+      const Uint last = ((rank+1)*m_total_nb_nodes)/nb_procs;
+      p = nodes_begin + first*record_size;
+      for (Uint record=first; record<last; ++record)
+      {
+        numbers.push_back(read_binary<int>(p));
+        for (Uint d=0; d<3; ++d)
+          coords.push_back(read_binary<double>(p));
+      }
+    }
+    else
+    {
+      const char* share_begin;
+      const char* share_end;
+      MappedFile::line_aligned_share(nodes_begin, nodes_end, rank, nb_procs, share_begin, share_end);
+      Uint number;
+      Real coord;
+      for (p=share_begin; (p=skip_whitespace(p,share_end)) != share_end; p=next_line(p,share_end))
+      {
+        if (!parse_uint(p, share_end, number))
+          throw_parse_error(file, p, path, "node");
+        numbers.push_back(number);
+        for (Uint d=0; d<3; ++d)
+        {
+          if (!parse_real(p, share_end, coord))
+            throw_parse_error(file, p, path, "coordinates of node "+to_str(number));
+          coords.push_back(coord);
+        }
+      }
+      Uint nb_records;
+      first = first_record(numbers.size(), nb_records);
+      if (nb_records != m_total_nb_nodes)
+        throw ParsingFailed(FromHere(), path + " announces " + to_str(m_total_nb_nodes) + " nodes, but contains " + to_str(nb_records));
+    }
+
+    for (Uint i=0; i<numbers.size(); ++i)
+    {
+      pack_node(node_hash.part_of_obj(first+i), first+i, numbers[i], &coords[3*i], node_idx_send, node_coords_send);
+      pack_node(numbers[i] % nb_procs, first+i, numbers[i], &coords[3*i], directory_idx_send, directory_coords_send);
+    }
+  }
+  std::vector< std::vector<Uint> > node_idx_recv, directory_idx_recv;
+  std::vector< std::vector<Real> > node_coords_recv, directory_coords_recv;
+  exchange(node_idx_send, node_idx_recv);
+  exchange(node_coords_send, node_coords_recv);
+  exchange(directory_idx_send, directory_idx_recv);
+  exchange(directory_coords_send, directory_coords_recv);
+
+  std::vector<ChunkedNode> local_nodes;
+  unpack_nodes(node_idx_recv, node_coords_recv, local_nodes);
+  std::set<Uint> owned_numbers;
+  boost_foreach(ChunkedNode& node, local_nodes)
+  {
+    node.rank = rank;
+    owned_numbers.insert(node.number);
+  }
+
+  // 2) Parse this process's share of the element records, and send each element to the process that owns it
+  //    as (record, number, type, physical tag, nodes...)
+  std::vector< std::vector<Uint> > elements_send(nb_procs);
+  if (binary)
+  {
+    const Uint first = (rank*m_total_nb_elements)/nb_procs;
+    const Uint last = ((rank+1)*m_total_nb_elements)/nb_procs;
+    boost_foreach(const BinaryElementBlock& block, element_blocks)
+    {
+      const Uint nb_element_nodes = Shared::m_nodes_in_gmsh_elem[block.type];
+      const Uint block_end = block.first_record + block.nb_records;
+      for (Uint record=std::max(first, block.first_record); record<std::min(last, block_end); ++record)
+      {
+        p = block.begin + (record - block.first_record)*block.record_size;
+        std::vector<Uint>& buffer = elements_send[elem_hash.part_of_obj(record)];
+        buffer.push_back(record);
+        buffer.push_back(read_binary<int>(p));
+        buffer.push_back(block.type);
+        buffer.push_back(read_binary<int>(p));
+        p += (block.nb_tags-1)*sizeof(int);
+        for (Uint n=0; n<nb_element_nodes; ++n)
+          buffer.push_back(read_binary<int>(p));
+      }
+    }
+  }
+  else
+  {
+    const char* share_begin;
+    const char* share_end;
+    MappedFile::line_aligned_share(elements_begin, elements_end, rank, nb_procs, share_begin, share_end);
+
+    // The owner of an element depends on its record index, so count the records first
+    Uint nb_local_records = 0;
+    for (p=share_begin; (p=skip_whitespace(p,share_end)) != share_end; p=next_line(p,share_end))
+      ++nb_local_records;
+    Uint nb_records;
+    Uint record = first_record(nb_local_records, nb_records);
+    if (nb_records != m_total_nb_elements)
+      throw ParsingFailed(FromHere(), path + " announces " + to_str(m_total_nb_elements) + " elements, but contains " + to_str(nb_records));
+
+    Uint element_number, gmsh_element_type, nb_tags, phys_tag, gmsh_node_number;
+    int other_tag;
+    for (p=share_begin; (p=skip_whitespace(p,share_end)) != share_end; p=next_line(p,share_end), ++record)
+    {
+      if (!parse_uint(p, share_end, element_number) || !parse_uint(p, share_end, gmsh_element_type)
+       || !parse_uint(p, share_end, nb_tags) || nb_tags == 0 || !parse_uint(p, share_end, phys_tag))
+        throw_parse_error(file, p, path, "element");
+      if (gmsh_element_type >= Shared::nb_gmsh_types || Shared::m_nodes_in_gmsh_elem[gmsh_element_type] == 0)
+        throw NotSupported(FromHere(), "Unsupported gmsh element type " + to_str(gmsh_element_type) + " in " + path);
+      for (Uint itag=1; itag<nb_tags; ++itag)
+        if (!parse_int(p, share_end, other_tag))
+          throw_parse_error(file, p, path, "tags of element "+to_str(element_number));
+
+      std::vector<Uint>& buffer = elements_send[elem_hash.part_of_obj(record)];
+      buffer.push_back(record);
+      buffer.push_back(element_number);
+      buffer.push_back(gmsh_element_type);
+      buffer.push_back(phys_tag);
+      for (Uint n=0; n<Shared::m_nodes_in_gmsh_elem[gmsh_element_type]; ++n)
+      {
+        if (!parse_uint(p, share_end, gmsh_node_number))
+          throw_parse_error(file, p, path, "nodes of element "+to_str(element_number));
+        buffer.push_back(gmsh_node_number);
+      }
+    }
+  }
+  std::vector< std::vector<Uint> > elements_recv;
+  exchange(elements_send, elements_recv);
+
+  std::vector<ChunkedElement> local_elements;
+  for (Uint proc=0; proc<elements_recv.size(); ++proc)
+  {
+    const std::vector<Uint>& buffer = elements_recv[proc];
+    for (Uint i=0; i<buffer.size(); i+=4+Shared::m_nodes_in_gmsh_elem[buffer[i+2]])
+    {
+      ChunkedElement element;
+      element.record = buffer[i];
+      element.data = &buffer[i];
+      local_elements.push_back(element);
+    }
+  }
+  std::sort(local_elements.begin(), local_elements.end());
+
+  // Count the elements per region and type, and find the ghost nodes
+  std::vector<Uint> types_in_regions(m_nb_regions*Shared::nb_gmsh_types, 0);
+  std::set<Uint> ghost_numbers;
+  boost_foreach(const ChunkedElement& element, local_elements)
+  {
+    const Uint gmsh_element_type = element.data[2];
+    const Uint phys_tag = element.data[3];
+    if (phys_tag == 0 || phys_tag > m_nb_regions)
+      throw ParsingFailed(FromHere(), "Element " + to_str(element.data[1]) + " in " + path + " has unknown physical tag " + to_str(phys_tag));
+    (m_nb_gmsh_elem_in_region[phys_tag-1])[gmsh_element_type]++;
+    types_in_regions[(phys_tag-1)*Shared::nb_gmsh_types + gmsh_element_type] = 1;
+    for (Uint n=0; n<Shared::m_nodes_in_gmsh_elem[gmsh_element_type]; ++n)
+    {
+      if (!owned_numbers.count(element.data[4+n]))
+        ghost_numbers.insert(element.data[4+n]);
+    }
+  }
+
+  // Every process creates the same element components, even if it owns no elements of some type
+  if (PE::Comm::instance().is_active() && nb_procs > 1)
+  {
+    std::vector<Uint> local_types_in_regions(types_in_regions);
+    PE::Comm::instance().all_reduce(PE::max(), local_types_in_regions, types_in_regions);
+  }
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+    for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
+      if (types_in_regions[ir*Shared::nb_gmsh_types + etype])
+        m_region_list[ir].element_types.insert(etype);
+
+  // 3) Look up the ghost nodes in the directory
+  std::vector< std::vector<Uint> > ghost_requests(nb_procs), ghost_requests_recv;
+  boost_foreach(const Uint gmsh_node_number, ghost_numbers)
+    ghost_requests[gmsh_node_number % nb_procs].push_back(gmsh_node_number);
+  exchange(ghost_requests, ghost_requests_recv);
+
+  std::vector<ChunkedNode> directory;
+  unpack_nodes(directory_idx_recv, directory_coords_recv, directory);
+  std::map<Uint,Uint> directory_entry;
+  for (Uint i=0; i<directory.size(); ++i)
+    directory_entry[directory[i].number] = i;
+
+  std::vector< std::vector<Uint> > ghost_idx_send(nb_procs), ghost_idx_recv;
+  std::vector< std::vector<Real> > ghost_coords_send(nb_procs), ghost_coords_recv;
+  for (Uint proc=0; proc<ghost_requests_recv.size(); ++proc)
+  {
+    boost_foreach(const Uint gmsh_node_number, ghost_requests_recv[proc])
+    {
+      std::map<Uint,Uint>::const_iterator entry = directory_entry.find(gmsh_node_number);
+      if (entry == directory_entry.end())
+        throw ParsingFailed(FromHere(), "Node " + to_str(gmsh_node_number) + " is used by an element, but is not defined in " + path);
+      const ChunkedNode& node = directory[entry->second];
+      pack_node(proc, node.record, node.number, node.coords, ghost_idx_send, ghost_coords_send);
+    }
+  }
+  exchange(ghost_idx_send, ghost_idx_recv);
+  exchange(ghost_coords_send, ghost_coords_recv);
+
+  const Uint nb_owned_nodes = local_nodes.size();
+  unpack_nodes(ghost_idx_recv, ghost_coords_recv, local_nodes);
+  for (Uint i=nb_owned_nodes; i<local_nodes.size(); ++i)
+    local_nodes[i].rank = node_hash.part_of_obj(local_nodes[i].record);
+
+  // 4) Store the owned and ghost nodes in file order, like the sequential reader
+  std::sort(local_nodes.begin(), local_nodes.end());
+  Dictionary& nodes = m_mesh->geometry_fields();
+  nodes.resize(local_nodes.size());
+  m_node_idx_gmsh_to_cf.clear();
+  for (Uint coord_idx=0; coord_idx<local_nodes.size(); ++coord_idx)
+  {
+    const ChunkedNode& node = local_nodes[coord_idx];
+    m_node_idx_gmsh_to_cf[node.number] = coord_idx;
+    for (Uint dim=0; dim<m_mesh_dimension; ++dim)
+      nodes.coordinates()[coord_idx][dim] = node.coords[dim];
+    nodes.rank()[coord_idx] = node.rank;
+    nodes.glb_idx()[coord_idx] = node.number-1;
+  }
+
+  // 5) Fill the connectivity tables, in file order
+  std::vector<std::map<Uint, Entities* > > conn_table_idx;
+  create_element_tables(conn_table_idx);
+
+  for(Uint ir = 0; ir < m_nb_regions; ++ir)
+    for(Uint etype = 0; etype < Shared::nb_gmsh_types; ++etype)
+      (m_nb_gmsh_elem_in_region[ir])[etype] = 0;
+
+  m_elem_idx_gmsh_to_cf.clear();
+  std::vector<Uint> cf_element;
+  boost_foreach(const ChunkedElement& element, local_elements)
+  {
+    const Uint element_number = element.data[1];
+    const Uint gmsh_element_type = element.data[2];
+    const Uint phys_tag = element.data[3];
+    const Uint nb_element_nodes = Shared::m_nodes_in_gmsh_elem[gmsh_element_type];
+
+    cf_element.resize(nb_element_nodes);
+    for (Uint j=0; j<nb_element_nodes; ++j)
+      cf_element[Shared::m_nodes_gmsh_to_cf[gmsh_element_type][j]] = m_node_idx_gmsh_to_cf[element.data[4+j]];
+
+    Handle< Elements > elements_region = Handle<Elements>(conn_table_idx[phys_tag-1][gmsh_element_type]->handle<Component>());
+    const Uint row_idx = (m_nb_gmsh_elem_in_region[phys_tag-1])[gmsh_element_type]++;
+    Connectivity::Row element_nodes = elements_region->geometry_space().connectivity()[row_idx];
+    for(Uint node = 0; node < nb_element_nodes; ++node)
+      element_nodes[node] = cf_element[node];
+
+    elements_region->rank()[row_idx] = rank;
+    elements_region->glb_idx()[row_idx] = element_number-1;
+    m_elem_idx_gmsh_to_cf[element_number] = std::make_pair(elements_region, row_idx);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void Reader::read_element_node_data()
@@ -23,6 +23,7 @@ namespace cf3 {
 namespace mesh {
 
 class Elements;
+class Entities;
 class Region;
 class MergedParallelDistribution;
 class Dictionary;
@@ -53,6 +54,14 @@ private: // functions
 
   void get_file_positions();
 
+  void read_physical_names();
+
+  bool is_binary_file();
+
+  void read_chunked(const std::string& path);
+
+  void create_element_tables(std::vector<std::map<Uint, Entities*> >& conn_table_idx);
+
   Handle<Region> create_region(std::string const& relative_path);
 
   void find_used_nodes();
@@ -17,6 +17,8 @@
 #include "common/OptionT.hpp"
 #include "common/Foreach.hpp"
 #include "common/PE/Comm.hpp"
+#include "common/PE/all_reduce.hpp"
+#include "common/PE/write_ordered.hpp"
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
 #include "common/StringConversion.hpp"
@@ -51,13 +53,19 @@ common::ComponentBuilder < gmsh::Writer, MeshWriter, LibGmsh> aGmshWriter_Builde
 //////////////////////////////////////////////////////////////////////////////
 
 Writer::Writer( const std::string& name )
-: MeshWriter(name)
+: MeshWriter(name),
+  m_single_file(false),
+  m_write_overlap(false)
 {
   options().add("serial",false)
       .pretty_name("Serial Format")
-      .description("All processors write in 1 file")
+      .description("All processors write in 1 file, using collective MPI-IO. Ghost elements are never written in this mode.")
       .mark_basic();
 
+  options().add("io_aggregators",0u)
+      .pretty_name("IO Aggregators")
+      .description("Number of processes that access the file when all processors write in 1 file. Zero leaves the choice to the MPI implementation.");
+
   // gmsh types: http://www.geuz.org/gmsh/doc/texinfo/gmsh.html#MSH-ASCII-file-format
 
   m_elementTypes["cf3.mesh.LagrangeP0.Point1D"]=P0POINT;
@@ -107,6 +115,33 @@ std::vector<std::string> Writer::get_extensions()
 
 void Writer::write()
 {
+  const bool parallel = PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1;
+  m_single_file = options().value<bool>("serial") && parallel;
+  // Elements are numbered globally, so in a single file each element may only be written once
+  m_write_overlap = m_enable_overlap && !m_single_file;
+
+  if (m_single_file)
+  {
+    // Sections that are the same on all processors are only written by rank 0
+    std::stringstream discarded;
+    std::ostream& header_file = PE::Comm::instance().rank() == 0 ? static_cast<std::ostream&>(m_segment) : discarded;
+
+    m_segments.clear();
+    m_segment.str(std::string());
+    write_header(header_file);
+    write_interpolation_schemes(header_file);
+    write_coordinates(m_segment);
+    write_connectivity(m_segment);
+    write_elem_nodal_data(m_segment);
+    write_nodal_data(m_segment);
+    m_segments.push_back(m_segment.str());
+
+    PE::write_ordered(m_file_path.path(), m_segments, options().value<Uint>("io_aggregators"));
+    m_segments.clear();
+    m_segment.str(std::string());
+    return;
+  }
+
   // if the file is present open it
   boost::filesystem::fstream file;
   boost::filesystem::path path (m_file_path.path());
@@ -150,7 +185,43 @@ void Writer::write()
 }
 /////////////////////////////////////////////////////////////////////////////
 
-void Writer::write_header(std::fstream& file)
+void Writer::write_section_header(std::ostream& file, const std::string& section, const std::string& tags, const Uint nb_records)
+{
+  if (m_single_file)
+  {
+    Uint global_nb_records;
+    PE::Comm::instance().all_reduce(PE::plus(), &nb_records, 1, &global_nb_records);
+    if (PE::Comm::instance().rank() == 0)
+      file << "$" << section << "\n" << tags << global_nb_records << "\n";
+  }
+  else
+  {
+    file << "$" << section << "\n" << tags << nb_records << "\n";
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_section_footer(std::ostream& file, const std::string& section)
+{
+  if (m_single_file)
+  {
+    // The records of all processors end up contiguous in the file, followed by the footer from rank 0
+    cf3_assert(&file == &m_segment);
+    m_segments.push_back(m_segment.str());
+    m_segment.str(std::string());
+    if (PE::Comm::instance().rank() == 0)
+      file << "$End" << section << "\n";
+  }
+  else
+  {
+    file << "$End" << section << "\n";
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+void Writer::write_header(std::ostream& file)
 {
   std::string version = "2";
   Uint file_type = 0; // ASCII
@@ -206,26 +277,38 @@ void Writer::write_header(std::fstream& file)
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Writer::write_coordinates(std::fstream& file)
+void Writer::write_coordinates(std::ostream& file)
 {
   // set precision for Real
   Uint prec = file.precision();
   file.precision(8);
 
-  // Assemble a list of all the coordinates that are used in this mesh
-  const boost::shared_ptr< common::List<Uint> > used_nodes_ptr = build_used_nodes_list(m_filtered_entities,m_mesh->geometry_fields(),m_enable_overlap);
-  const common::List<Uint>& used_nodes = *used_nodes_ptr;
+  const Dictionary& geometry = m_mesh->geometry_fields();
 
-  // Create a mapping between the actual node-numbering in the mesh, and the node-numbering to be written
-  const Uint nb_nodes = used_nodes.size();
+  // Assemble a list of all the coordinates that are used in this mesh
+  std::vector<Uint> used_nodes;
+  if (m_single_file)
+  {
+    // Each node is written once, by its owner. The elements of another processor may use nodes
+    // that are not used by any written element here, so all owned nodes are written.
+    used_nodes.reserve(geometry.size());
+    for (Uint node=0; node<geometry.size(); ++node)
+    {
+      if (!geometry.is_ghost(node))
+        used_nodes.push_back(node);
+    }
+  }
+  else
+  {
+    const boost::shared_ptr< common::List<Uint> > used_nodes_ptr = build_used_nodes_list(m_filtered_entities,geometry,m_enable_overlap);
+    used_nodes.assign(used_nodes_ptr->array().begin(), used_nodes_ptr->array().end());
+  }
 
-  file << "$Nodes\n";
-  file << nb_nodes << "\n";
+  write_section_header(file, "Nodes", "", used_nodes.size());
 
   const Uint nb_dim = m_mesh->dimension();
-  const Dictionary& geometry = m_mesh->geometry_fields();
   const common::Table<Real>& coordinates = geometry.coordinates();
-  boost_foreach( const Uint node, used_nodes.array())
+  boost_foreach( const Uint node, used_nodes)
   {
     common::Table<Real>::ConstRow coord = coordinates[node];
     file << geometry.glb_idx()[node]+1 << " ";
@@ -239,14 +322,14 @@ void Writer::write_coordinates(std::fstream& file)
     file << "\n";
   }
 
-  file << "$EndNodes\n";
+  write_section_footer(file, "Nodes");
   // restore precision
   file.precision(prec);
 }
 
 //////////////////////////////////////////////////////////////////////////////
 
-void Writer::write_connectivity(std::fstream& file)
+void Writer::write_connectivity(std::ostream& file)
 {
   /// Elements section:
   /// @code
@@ -259,10 +342,9 @@ void Writer::write_connectivity(std::fstream& file)
 
   Uint nb_elems = 0;
   boost_foreach(const Handle<Region const>& region, m_regions)
-      nb_elems += region->recursive_filtered_elements_count(m_entities_filter,m_enable_overlap);
+      nb_elems += region->recursive_filtered_elements_count(m_entities_filter,m_write_overlap);
 
-  file << "$Elements\n";
-  file << nb_elems << "\n";
+  write_section_header(file, "Elements", "", nb_elems);
   std::string group_name("");
   Uint group_number;
   Uint elm_type;
@@ -281,7 +363,7 @@ void Writer::write_connectivity(std::fstream& file)
     for (Uint e=0; e<nb_elem; ++e)
     {
       ghost = elements->is_ghost(e);
-      if( m_enable_overlap || !ghost )
+      if( m_write_overlap || !ghost )
       {
         file << elements->glb_idx()[e]+1 << " " << elm_type << " " << number_of_tags << " " << group_number << " " << elementary_entity_index << " " << (ghost? -1 : partition_number);
         boost_foreach(const Uint node_idx, element_connectivity[e])
@@ -293,12 +375,12 @@ void Writer::write_connectivity(std::fstream& file)
     }
     ++elementary_entity_index;
   }
-  file << "$EndElements\n";
+  write_section_footer(file, "Elements");
 }
 
 //////////////////////////////////////////////////////////////////////
 
-void Writer::write_interpolation_schemes(std::fstream& file)
+void Writer::write_interpolation_schemes(std::ostream& file)
 {
   // step 1: detect which shapefunctions need to be used
   std::set< Handle<Dictionary> > dicts;
@@ -389,7 +471,7 @@ void Writer::write_interpolation_schemes(std::fstream& file)
 
 //////////////////////////////////////////////////////////////////////
 
-void Writer::write_elem_nodal_data(std::fstream& file)
+void Writer::write_elem_nodal_data(std::ostream& file)
 {
 
   /// Discontinuous fields section
@@ -446,7 +528,7 @@ void Writer::write_elem_nodal_data(std::fstream& file)
         if (field.dict().defined_for_entities(elements_handle))
         {
           nb_elements += elements_handle->size();
-          if (m_enable_overlap==false)
+          if (m_write_overlap==false)
           {
             Uint nb_ghost=0;
             for(Uint e=0; e<elements_handle->size(); ++e)
@@ -481,17 +563,18 @@ void Writer::write_elem_nodal_data(std::fstream& file)
 
         CFdebug << "Writing discontinuous field " << field.uri() << " with " << nb_elements << " elements" << CFendl;
 
-        file << "$ElementNodeData\n";
-
+        std::stringstream tags;
+        tags.precision(8);
         // add 3 string tags : var_name, interpolation_scheme, field_name
-        file << 3 << "\n";
-        file << "\"" << (var_name == "var" ? field_name+to_str(iVar) : var_name) << "\"\n";
-        file << "\"" << interpolation_scheme << "\"\n";
-        file << "\"" << field_name << "\"\n";
+        tags << 3 << "\n";
+        tags << "\"" << (var_name == "var" ? field_name+to_str(iVar) : var_name) << "\"\n";
+        tags << "\"" << interpolation_scheme << "\"\n";
+        tags << "\"" << field_name << "\"\n";
         // add 1 real tag: time
-        file << 1 << "\n" << field_time << "\n";  // 1 real tag: time
+        tags << 1 << "\n" << field_time << "\n";  // 1 real tag: time
         // add 3 integer tags: time_step, variable_type, nb elements
-        file << 3 << "\n" << field_iter << "\n" << datasize << "\n" << nb_elements <<"\n";
+        tags << 3 << "\n" << field_iter << "\n" << datasize << "\n";
+        write_section_header(file, "ElementNodeData", tags.str(), nb_elements);
 
         boost_foreach(const Handle<Entities const>& elements_handle, m_filtered_entities )
         {
@@ -507,7 +590,7 @@ void Writer::write_elem_nodal_data(std::fstream& file)
             /// write element
             for (Uint local_elm_idx = 0; local_elm_idx<local_nb_elms; ++local_elm_idx)
             {
-              if (m_enable_overlap || !elements.is_ghost(local_elm_idx))
+              if (m_write_overlap || !elements.is_ghost(local_elm_idx))
               {
                 file << elements.glb_idx()[local_elm_idx]+1 << " " << nb_sf_nodes << " ";
                 /// set field data
@@ -539,7 +622,7 @@ void Writer::write_elem_nodal_data(std::fstream& file)
             }
           }
         }
-        file << "$EndElementNodeData\n";
+        write_section_footer(file, "ElementNodeData");
         row_idx += Uint(var_type);
       }
     }
@@ -558,7 +641,7 @@ void Writer::write_elem_nodal_data(std::fstream& file)
  * 3) when a geometry-node is interpolated, add it to a list_of_interpolated_geom_nodes
  * 4) Nodes can be written to file in any order, as long as the geometry::glb_idx is used as the node-index.
  */
-void Writer::write_nodal_data(std::fstream& file)
+void Writer::write_nodal_data(std::ostream& file)
 {
 
   //  $NodeData
@@ -621,8 +704,21 @@ void Writer::write_nodal_data(std::fstream& file)
         }
       }
 
-      const boost::shared_ptr< common::List<Uint> > used_nodes_ptr = build_used_nodes_list(filtered_used_entities_by_field,m_mesh->geometry_fields(),m_enable_overlap);
+      // In a single file, nodes are written by their owner, which may need ghost elements to interpolate them
+      const bool visit_ghost_elements = m_enable_overlap || m_single_file;
+      const Dictionary& geometry = m_mesh->geometry_fields();
+      const boost::shared_ptr< common::List<Uint> > used_nodes_ptr = build_used_nodes_list(filtered_used_entities_by_field,geometry,visit_ghost_elements);
       const common::List<Uint>& used_nodes = *used_nodes_ptr;
+      Uint nb_written_nodes = used_nodes.size();
+      if (m_single_file)
+      {
+        nb_written_nodes = 0;
+        boost_foreach(const Uint node, used_nodes.array())
+        {
+          if (!geometry.is_ghost(node))
+            ++nb_written_nodes;
+        }
+      }
       std::vector<bool> is_node_visited(m_mesh->geometry_fields().size(),false);
 
       // data_header
@@ -649,17 +745,18 @@ void Writer::write_nodal_data(std::fstream& file)
 
         CFdebug << "Writing continuous field " << field.uri() << " with " << field.size() << " nodes" << CFendl;
 
-        file << "$NodeData\n";
-
+        std::stringstream tags;
+        tags.precision(8);
         // add 2 string tags : var_name, field_name
-        file << 3 << "\n";
-        file << "\"" << (var_name == "var" ? field_name+to_str(iVar) : var_name) << "\"\n";
-        file << "\"" << interpolation_scheme << "\"\n";
-        file << "\"" << field_name << "\"\n";
+        tags << 3 << "\n";
+        tags << "\"" << (var_name == "var" ? field_name+to_str(iVar) : var_name) << "\"\n";
+        tags << "\"" << interpolation_scheme << "\"\n";
+        tags << "\"" << field_name << "\"\n";
         // add 1 real tag: time
-        file << 1 << "\n" << field_time << "\n";  // 1 real tag: time
+        tags << 1 << "\n" << field_time << "\n";  // 1 real tag: time
         // add 3 integer tags: time_step, variable_type, nb elements
-        file << 3 << "\n" << field_iter << "\n" << datasize << "\n" << used_nodes.size() <<"\n";
+        tags << 3 << "\n" << field_iter << "\n" << datasize << "\n";
+        write_section_header(file, "NodeData", tags.str(), nb_written_nodes);
 
         boost_foreach (const Handle<Entities const>& elements_handle, filtered_used_entities_by_field)
         {
@@ -672,7 +769,7 @@ void Writer::write_nodal_data(std::fstream& file)
 
           for (Uint elem_idx=0; elem_idx<nb_elems; ++elem_idx)
           {
-            if (m_enable_overlap || !elements_handle->is_ghost(elem_idx))
+            if (visit_ghost_elements || !elements_handle->is_ghost(elem_idx))
             {
               Connectivity::ConstRow field_space_nodes = field_space.connectivity()[elem_idx];
               Connectivity::ConstRow geom_space_nodes = field_space.support().geometry_space().connectivity()[elem_idx];
@@ -689,7 +786,7 @@ void Writer::write_nodal_data(std::fstream& file)
               {
                 const Uint geom_space_node = geom_space_nodes[elem_node_idx];
                 cf3_assert(geom_space_node < is_node_visited.size());
-                if (!is_node_visited[geom_space_node])
+                if (!is_node_visited[geom_space_node] && !(m_single_file && geometry.is_ghost(geom_space_node)))
                 {
                   is_node_visited[geom_space_node]=true;
 
@@ -727,7 +824,7 @@ void Writer::write_nodal_data(std::fstream& file)
             }
           }
         }
-        file << "$EndNodeData\n";
+        write_section_footer(file, "NodeData");
         row_idx += Uint(var_type);
       }
     }
@@ -740,7 +837,7 @@ void Writer::write_nodal_data(std::fstream& file)
 /*
 // Could be useful for visualizing extra element information such as global index, rank,
 // The only advantage over write_element_nodal_data() is that it is taking less file memory.
-void Writer::write_element_data(std::fstream& file)
+void Writer::write_element_data(std::ostream& file)
 {
   //  $ElementData
   //  1              // 1 string tag:
@@ -9,6 +9,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <sstream>
+
 #include "mesh/MeshWriter.hpp"
 #include "mesh/GeoShape.hpp"
 
@@ -46,19 +48,27 @@ private: // functions
 
   virtual void write();
 
-  void write_header(std::fstream& file);
+  /// Write the start of a section with nb_records records. With the serial option, the number of records
+  /// is summed over all processors and only rank 0 writes the header.
+  void write_section_header(std::ostream& file, const std::string& section, const std::string& tags, const Uint nb_records);
+
+  /// Write the end of a section. With the serial option, the records written so far by all processors
+  /// are placed before the footer, which is only written by rank 0.
+  void write_section_footer(std::ostream& file, const std::string& section);
 
-  void write_coordinates(std::fstream& file);
+  void write_header(std::ostream& file);
 
-  void write_connectivity(std::fstream& file);
+  void write_coordinates(std::ostream& file);
 
-  void write_interpolation_schemes(std::fstream& file);
+  void write_connectivity(std::ostream& file);
 
-  void write_nodal_data(std::fstream& file);
+  void write_interpolation_schemes(std::ostream& file);
 
-  void write_elem_nodal_data(std::fstream& file);
+  void write_nodal_data(std::ostream& file);
 
-//  void write_element_data(std::fstream& file);
+  void write_elem_nodal_data(std::ostream& file);
+
+//  void write_element_data(std::ostream& file);
 
 private: // data
 
@@ -68,6 +78,18 @@ private: // data
 
   std::vector< Handle<Entities const> > m_entities_vector;
 
+  /// True if all processors write in 1 file
+  bool m_single_file;
+
+  /// True if ghost elements are written
+  bool m_write_overlap;
+
+  /// Contents of the current segment of the single file, for this processor
+  std::stringstream m_segment;
+
+  /// Completed segments of the single file, each followed by the same segment of the other processors
+  std::vector<std::string> m_segments;
+
 }; // end Writer
 
 
@@ -29,6 +29,7 @@
 #include "mesh/Connectivity.hpp"
 #include "mesh/Space.hpp"
 #include "mesh/MeshTransformer.hpp"
+#include "mesh/MappedFile.hpp"
 
 #include "mesh/neu/Reader.hpp"
 
@@ -66,6 +67,12 @@ Reader::Reader( const std::string& name )
       .description("Read the surface elements for the boundary")
       .pretty_name("Read Boundaries");
 
+  options().add("parallel_read", false)
+      .description("Memory-map the file and let each process parse only a share of the nodes and elements, "
+                   "instead of every process parsing the whole file. Requires part and nb_parts to match "
+                   "the rank and size of the communicator.")
+      .pretty_name("Parallel Read");
+
   properties()["brief"] = std::string("neutral file mesh reader component");
 
   std::string desc;
@@ -105,8 +112,15 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   // set the internal mesh pointer
   m_mesh = Handle<Mesh>(mesh.handle<Component>());
 
+  const bool chunked = options().value<bool>("parallel_read")
+                    && options().value<Uint>("part") == PE::Comm::instance().rank()
+                    && options().value<Uint>("nb_parts") == PE::Comm::instance().size();
+  if (options().value<bool>("parallel_read") && !chunked)
+    CFwarn << "Ignoring option parallel_read: part and nb_parts don't match the communicator" << CFendl;
+
   // Read file once and store positions
-  get_file_positions();
+  if (!chunked)
+    get_file_positions();
 
   // Read mesh information
   read_headerData();
@@ -128,9 +142,16 @@ void Reader::do_read_mesh_into(const URI& file, Mesh& mesh)
   //else
   //  m_region = m_mesh->create_region(m_headerData.mesh_name,!option("Serial Handle<Region>(Merge").value<bool>()).handle<Component>());
 
-  find_ghost_nodes();
-  read_coordinates();
-  read_connectivity();
+  if (chunked)
+  {
+    read_chunked(fp.string());
+  }
+  else
+  {
+    find_ghost_nodes();
+    read_coordinates();
+    read_connectivity();
+  }
   if (options().value<bool>("read_boundaries"))
     read_boundaries();
 
@@ -434,6 +455,265 @@ void Reader::read_connectivity()
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/// Exchange buffers with all processes, or copy them when running on a single process
+template<typename T>
+void exchange(const std::vector< std::vector<T> >& send, std::vector< std::vector<T> >& recv)
+{
+  if (PE::Comm::instance().is_active() && PE::Comm::instance().size() > 1)
+    PE::Comm::instance().all_to_all(send, recv);
+  else
+    recv = send;
+}
+
+/// Element records span several lines if they have more than 7 nodes. The continuation lines are indented
+/// by 15 characters, while the element number at the start of a record is written in 8 characters.
+bool is_record_start(const char* line, const char* end)
+{
+  return skip_blanks(line, end) - line < 8;
+}
+
+/// Move p forward to the start of the next element record
+const char* record_aligned(const char* p, const char* end)
+{
+  while (p != end && !is_record_start(p, end))
+    p = next_line(p, end);
+  return p;
+}
+
+void throw_parse_error(const MappedFile& file, const char* p, const std::string& path, const std::string& what)
+{
+  throw ParsingFailed(FromHere(), "Could not read " + what + " at byte " + to_str(Uint(p - file.begin())) + " of " + path);
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
+void Reader::read_chunked(const std::string& path)
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+  const Uint dim = m_headerData.NDFCD;
+  const ParallelDistribution& node_hash = m_hash->subhash(NODES);
+  const ParallelDistribution& elem_hash = m_hash->subhash(ELEMS);
+
+  MappedFile file(path);
+  const char* const file_end = file.end();
+
+  // Locate the sections. The groups and boundaries are read from these positions by read_groups and read_boundaries.
+  enum { NODAL_COORDINATES, ELEMENTS_CELLS, ELEMENT_GROUP, BOUNDARY_CONDITIONS, END_OF_SECTION };
+  std::vector<std::string> keywords;
+  keywords.push_back("NODAL COORDINATES");
+  keywords.push_back("ELEMENTS/CELLS");
+  keywords.push_back("ELEMENT GROUP");
+  keywords.push_back("BOUNDARY CONDITIONS");
+  keywords.push_back("ENDOFSECTION");
+
+  const char* nodes_begin = 0;
+  const char* nodes_end = 0;
+  const char* elements_begin = 0;
+  const char* elements_end = 0;
+  m_element_group_positions.resize(0);
+  m_boundary_condition_positions.resize(0);
+  const std::vector<MappedFile::KeywordLine> keyword_lines = file.find_keyword_lines(keywords);
+  for (Uint i=0; i<keyword_lines.size(); ++i)
+  {
+    const char* line = file.begin() + keyword_lines[i].offset;
+    const bool section_ends = i+1 < keyword_lines.size() && keyword_lines[i+1].keyword == END_OF_SECTION;
+    switch (keyword_lines[i].keyword)
+    {
+      case NODAL_COORDINATES:
+        m_nodal_coordinates_position = keyword_lines[i].offset;
+        nodes_begin = next_line(line, file_end);
+        nodes_end = section_ends ? file.begin() + keyword_lines[i+1].offset : 0;
+        break;
+      case ELEMENTS_CELLS:
+        m_elements_cells_position = keyword_lines[i].offset;
+        elements_begin = next_line(line, file_end);
+        elements_end = section_ends ? file.begin() + keyword_lines[i+1].offset : 0;
+        break;
+      case ELEMENT_GROUP:
+        m_element_group_positions.push_back(keyword_lines[i].offset);
+        break;
+      case BOUNDARY_CONDITIONS:
+        m_boundary_condition_positions.push_back(keyword_lines[i].offset);
+        break;
+    }
+  }
+  if (nodes_begin == 0 || nodes_end == 0)
+    throw ParsingFailed(FromHere(), path + " has no complete NODAL COORDINATES section");
+  if (elements_begin == 0 || elements_end == 0)
+    throw ParsingFailed(FromHere(), path + " has no complete ELEMENTS/CELLS section");
+
+  // 1) Parse this process's share of the nodes, and send each node to its owner
+  std::vector< std::vector<Uint> > node_idx_send(nb_procs), node_idx_recv;
+  std::vector< std::vector<Real> > node_coords_send(nb_procs), node_coords_recv;
+  {
+    const char* share_begin;
+    const char* share_end;
+    MappedFile::line_aligned_share(nodes_begin, nodes_end, rank, nb_procs, share_begin, share_end);
+    const char* p;
+    Uint neu_node_idx;
+    Real coord;
+    for (p=share_begin; (p=skip_whitespace(p,share_end)) != share_end; p=next_line(p,share_end))
+    {
+      if (!parse_uint(p, share_end, neu_node_idx) || neu_node_idx == 0 || neu_node_idx > m_headerData.NUMNP)
+        throw_parse_error(file, p, path, "node");
+      const Uint owner = node_hash.part_of_obj(neu_node_idx-1);
+      node_idx_send[owner].push_back(neu_node_idx);
+      for (Uint d=0; d<dim; ++d)
+      {
+        if (!parse_real(p, share_end, coord))
+          throw_parse_error(file, p, path, "coordinates of node "+to_str(neu_node_idx));
+        node_coords_send[owner].push_back(coord);
+      }
+    }
+  }
+  exchange(node_idx_send, node_idx_recv);
+  exchange(node_coords_send, node_coords_recv);
+
+  // owned nodes, as neu index -> (process, position in the receive buffer)
+  std::map<Uint, std::pair<Uint,Uint> > owned_nodes;
+  for (Uint proc=0; proc<nb_procs; ++proc)
+    for (Uint i=0; i<node_idx_recv[proc].size(); ++i)
+      owned_nodes[node_idx_recv[proc][i]] = std::make_pair(proc, i);
+  if (owned_nodes.size() != node_hash.nb_objects_in_part(rank))
+    throw ParsingFailed(FromHere(), "Nodes in " + path + " are not numbered consecutively from 1");
+
+  // 2) Parse this process's share of the elements, and send each element to its owner as (number, type, nb_nodes, nodes...)
+  std::vector< std::vector<Uint> > elements_send(nb_procs), elements_recv;
+  {
+    const char* share_begin;
+    const char* share_end;
+    MappedFile::line_aligned_share(elements_begin, elements_end, rank, nb_procs, share_begin, share_end);
+    share_begin = record_aligned(share_begin, elements_end);
+    share_end = record_aligned(share_end, elements_end);
+    const char* p;
+    Uint elementNumber, elementType, nbElementNodes, neu_node_number;
+    for (p=share_begin; (p=skip_whitespace(p,share_end)) != share_end; p=next_line(p,share_end))
+    {
+      if (!parse_uint(p, share_end, elementNumber) || !parse_uint(p, share_end, elementType) || !parse_uint(p, share_end, nbElementNodes)
+       || elementNumber == 0 || elementNumber > m_headerData.NELEM)
+        throw_parse_error(file, p, path, "element");
+      if(!m_supported_neu_types.count(elementType))
+        throw common::NotSupported(FromHere(), "Failed to read neutral file: unsupported element type " + common::to_str(elementType));
+
+      std::vector<Uint>& buffer = elements_send[elem_hash.part_of_obj(elementNumber-1)];
+      buffer.push_back(elementNumber);
+      buffer.push_back(elementType);
+      buffer.push_back(nbElementNodes);
+      for (Uint j=0; j<nbElementNodes; ++j)
+      {
+        if (!parse_uint(p, share_end, neu_node_number) || neu_node_number == 0 || neu_node_number > m_headerData.NUMNP)
+          throw_parse_error(file, p, path, "nodes of element "+to_str(elementNumber));
+        buffer.push_back(neu_node_number);
+      }
+    }
+  }
+  exchange(elements_send, elements_recv);
+
+  // owned elements, as element number -> (process, position in the receive buffer)
+  std::map<Uint, std::pair<Uint,Uint> > owned_elements;
+  std::set<Uint> ghost_nodes;
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    const std::vector<Uint>& buffer = elements_recv[proc];
+    for (Uint i=0; i<buffer.size(); i+=3+buffer[i+2])
+    {
+      owned_elements[buffer[i]] = std::make_pair(proc, i);
+      for (Uint j=0; j<buffer[i+2]; ++j)
+      {
+        if (node_hash.part_of_obj(buffer[i+3+j]-1) != rank)
+          ghost_nodes.insert(buffer[i+3+j]);
+      }
+    }
+  }
+  if (owned_elements.size() != elem_hash.nb_objects_in_part(rank))
+    throw ParsingFailed(FromHere(), "Elements in " + path + " are not numbered consecutively from 1");
+
+  // 3) Ask the owners of the ghost nodes for their coordinates
+  std::vector< std::vector<Uint> > ghost_requests(nb_procs), ghost_requests_recv;
+  boost_foreach(const Uint neu_node_idx, ghost_nodes)
+    ghost_requests[node_hash.part_of_obj(neu_node_idx-1)].push_back(neu_node_idx);
+  exchange(ghost_requests, ghost_requests_recv);
+
+  std::vector< std::vector<Real> > ghost_coords_send(nb_procs), ghost_coords_recv;
+  for (Uint proc=0; proc<nb_procs; ++proc)
+  {
+    boost_foreach(const Uint neu_node_idx, ghost_requests_recv[proc])
+    {
+      const std::pair<Uint,Uint>& location = owned_nodes[neu_node_idx];
+      const Real* coords = &node_coords_recv[location.first][dim*location.second];
+      ghost_coords_send[proc].insert(ghost_coords_send[proc].end(), coords, coords+dim);
+    }
+  }
+  exchange(ghost_coords_send, ghost_coords_recv);
+
+  // neu index -> coordinates of the ghost nodes
+  std::map<Uint, const Real*> ghost_coords;
+  for (Uint proc=0; proc<nb_procs; ++proc)
+    for (Uint i=0; i<ghost_requests[proc].size(); ++i)
+      ghost_coords[ghost_requests[proc][i]] = &ghost_coords_recv[proc][dim*i];
+
+  // 4) Store the owned and ghost nodes ordered by index, like the sequential reader
+  Dictionary& nodes = m_mesh->geometry_fields();
+  nodes.resize(owned_nodes.size() + ghost_coords.size());
+  m_neu_node_to_coord_idx.clear();
+  std::map<Uint, std::pair<Uint,Uint> >::const_iterator owned_it = owned_nodes.begin();
+  std::map<Uint, const Real*>::const_iterator ghost_it = ghost_coords.begin();
+  for (Uint coord_idx=0; coord_idx<nodes.size(); ++coord_idx)
+  {
+    Uint neu_node_idx;
+    const Real* coords;
+    if (ghost_it == ghost_coords.end() || (owned_it != owned_nodes.end() && owned_it->first < ghost_it->first))
+    {
+      neu_node_idx = owned_it->first;
+      coords = &node_coords_recv[owned_it->second.first][dim*owned_it->second.second];
+      ++owned_it;
+    }
+    else
+    {
+      neu_node_idx = ghost_it->first;
+      coords = ghost_it->second;
+      ++ghost_it;
+    }
+    nodes.rank()[coord_idx] = node_hash.part_of_obj(neu_node_idx-1);
+    nodes.glb_idx()[coord_idx] = neu_node_idx;
+    m_neu_node_to_coord_idx[neu_node_idx] = coord_idx;
+    for (Uint d=0; d<dim; ++d)
+      nodes.coordinates()[coord_idx][d] = coords[d];
+  }
+
+  // 5) Store the owned elements in the temporary region, ordered by number
+  m_tmp = Handle<Region>(m_region->create_region("main").handle<Component>());
+  m_global_to_tmp.clear();
+  {
+    std::map<std::string,Handle< Elements > > elements = create_cells_in_region(*m_tmp,nodes,m_supported_types);
+    std::map<std::string,boost::shared_ptr< Connectivity::Buffer > > buffer = create_connectivity_buffermap(elements);
+
+    std::vector<Uint> cf_element;
+    typedef std::map<Uint, std::pair<Uint,Uint> >::value_type OwnedElement;
+    boost_foreach(const OwnedElement& owned_element, owned_elements)
+    {
+      const Uint* element = &elements_recv[owned_element.second.first][owned_element.second.second];
+      const Uint elementType = element[1];
+      const Uint nbElementNodes = element[2];
+      cf_element.resize(nbElementNodes);
+      for (Uint j=0; j<nbElementNodes; ++j)
+        cf_element[m_nodes_neu_to_cf[elementType][j]] = m_neu_node_to_coord_idx[element[3+j]];
+      const std::string etype_CF = element_type(elementType,nbElementNodes);
+      const Uint table_idx = buffer[etype_CF]->add_row(cf_element);
+      m_global_to_tmp[owned_element.first] = std::make_pair(elements[etype_CF],table_idx);
+    }
+  }
+
+  m_neu_node_to_coord_idx.clear();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 void Reader::read_groups()
 {
   Dictionary& nodes = m_mesh->geometry_fields();
@@ -64,6 +64,8 @@ private: // functions
 
   void get_file_positions();
 
+  void read_chunked(const std::string& path);
+
   std::string element_type(const Uint neu_type, const Uint nb_nodes);
 
 private: // data
@@ -13,6 +13,7 @@
 #include "common/PropertyList.hpp"
 #include "common/OptionT.hpp"
 #include "common/PE/Comm.hpp"
+#include "common/PE/write_ordered.hpp"
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
 #include "common/StringConversion.hpp"
@@ -51,6 +52,14 @@ Writer::Writer( const std::string& name )
 
   options().add("cell_centred",true)
     .description("True if discontinuous fields are to be plotted as cell-centred fields");
+
+  options().add("single_file",false)
+    .pretty_name("Single File")
+    .description("Write the zones of all processes into a single file using collective MPI-IO, instead of one file per process");
+
+  options().add("io_aggregators",0u)
+    .pretty_name("IO Aggregators")
+    .description("Number of processes that access the file when writing a single file. Zero leaves the choice to the MPI implementation.");
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -66,6 +75,15 @@ std::vector<std::string> Writer::get_extensions()
 
 void Writer::write()
 {
+  if (options().value<bool>("single_file"))
+  {
+    // Each process contributes its zones, rank 0 also the file header
+    std::stringstream contents;
+    write_file(contents, PE::Comm::instance().rank() == 0);
+    PE::write_ordered(m_file_path.path(), std::vector<std::string>(1, contents.str()), options().value<Uint>("io_aggregators"));
+    return;
+  }
+
   // if the file is present open it
   boost::filesystem::fstream file;
   boost::filesystem::path path(m_file_path.path());
@@ -89,16 +107,17 @@ void Writer::write()
 }
 /////////////////////////////////////////////////////////////////////////////
 
-void Writer::write_file(std::fstream& file)
+void Writer::write_file(std::ostream& file, const bool with_header)
 {
-  file << "TITLE      = COOLFluiD Mesh Data" << "\n";
-  file << "VARIABLES  = ";
+  std::stringstream header;
+  header << "TITLE      = COOLFluiD Mesh Data" << "\n";
+  header << "VARIABLES  = ";
 
   Uint dimension = m_mesh->geometry_fields().coordinates().row_size();
   // write the coordinate variable names
   for (Uint i = 0; i < dimension ; ++i)
   {
-    file << " \"x" << i << "\" ";
+    header << " \"x" << i << "\" ";
   }
 
   std::vector<Uint> cell_centered_var_ids;
@@ -115,7 +134,7 @@ void Writer::write_file(std::fstream& file)
       {
         for (Uint i=0; i<static_cast<Uint>(var_type); ++i)
         {
-          file << " \"" << var_name << "["<<i<<"]\"";
+          header << " \"" << var_name << "["<<i<<"]\"";
           ++zone_var_id;
           if (field.discontinuous())
             cell_centered_var_ids.push_back(zone_var_id);
@@ -123,14 +142,16 @@ void Writer::write_file(std::fstream& file)
       }
       else
       {
-        file << " \"" << var_name <<"\"";
+        header << " \"" << var_name <<"\"";
         ++zone_var_id;
         if (field.discontinuous())
           cell_centered_var_ids.push_back(zone_var_id);
       }
     }
   }
-  file << "\n";
+  header << "\n";
+  if (with_header)
+    file << header.str();
 
 
   // loop over the element types
@@ -48,7 +48,9 @@ public: // functions
 
 private: // functions
 
-  void write_file(std::fstream& file);
+  /// Write the file contents to the given stream. The header with the variable names is omitted
+  /// if with_header is false, to append the zones to those of another process.
+  void write_file(std::ostream& file, const bool with_header = true);
 
   std::string zone_type(const ElementType& etype) const;
 
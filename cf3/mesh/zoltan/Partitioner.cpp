@@ -86,7 +86,7 @@ Zoltan& Partitioner::zoltan_handle()
 
 void Partitioner::partition_graph()
 {
-  CFdebug.setFilterRankZero(false);
+  Logger::instance().getStream(DEBUG).setFilterRankZero(false);
 
   m_partitioned = true;
   set_partitioning_params();
@@ -118,7 +118,7 @@ void Partitioner::partition_graph()
   // see line below: zoltan_handle().Set_Param( "RETURN_LISTS", "EXPORT");
   cf3_assert((int)numImport<=0);
 
-  CFdebug.setFilterRankZero(true);
+  Logger::instance().getStream(DEBUG).setFilterRankZero(true);
 
 }
 
@@ -28,6 +28,21 @@ namespace physics {
     typedef Eigen::Matrix<Real,NDIM,NGRAD> Matrix_NDIMxNGRAD;
   };
 
+  /// Number of faces that batched physics functions process at once.
+  /// Four doubles fill an AVX register, or two SSE registers.
+  enum { BATCH_SIZE = 4 };
+
+  /// Types to store a quantity for BATCH_SIZE faces, one column per component.
+  /// Each column is a fixed-size array that Eigen processes as whole SIMD packets,
+  /// when vectorization is enabled (CF3_ENABLE_VECTORIZATION).
+  template < Uint NDIM, Uint NEQS=1 >
+  struct BatchTypes
+  {
+    typedef Eigen::Array<Real,BATCH_SIZE,1>    Array;
+    typedef Eigen::Array<Real,BATCH_SIZE,NDIM> Array_NDIM;
+    typedef Eigen::Array<Real,BATCH_SIZE,NEQS> Array_NEQS;
+  };
+
 ////////////////////////////////////////////////////////////////////////////////
 
 } // physics
@@ -417,6 +417,22 @@ void set_item(ComponentWrapper& self, const Uint i, boost::python::object& value
   return self.get_list_interface()->set_item(i, value);
 }
 
+/// Shares the storage of lists with numpy, so numpy.asarray returns a view instead of copying item by item
+boost::python::object get_array_interface(ComponentWrapper& self)
+{
+  boost::python::object result;
+  if(is_not_null(self.get_list_interface()))
+    result = self.get_list_interface()->array_interface();
+
+  if(result.is_none())
+  {
+    PyErr_SetString(PyExc_AttributeError, ("Object " + self.component().uri().path() + " has no contiguous storage").c_str());
+    boost::python::throw_error_already_set();
+  }
+
+  return result;
+}
+
 std::string to_str(ComponentWrapper& self)
 {
   return self.component().uri().string();
@@ -724,6 +740,7 @@ void def_component()
     .def("__len__", get_len)
     .def("__getitem__", get_item)
     .def("__setitem__", set_item)
+    .add_property("__array_interface__", get_array_interface)
     .def("__str__", to_str)
     .def("__repr__", to_str)
     .def("__eq__", is_equal)
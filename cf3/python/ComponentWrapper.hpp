@@ -37,6 +37,10 @@ struct PythonListInterface
 
   /// Get the whole list as a string
   virtual std::string to_str() const = 0;
+
+  /// Description of the storage following the numpy array interface protocol, or None if the values are not
+  /// stored contiguously. The description is only valid until the list is resized.
+  virtual boost::python::object array_interface() const { return boost::python::object(); }
 };
   
 /// Wrapper class for components
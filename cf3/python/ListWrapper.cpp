@@ -64,6 +64,11 @@ struct List : PythonListInterface
     return out_stream.str();
   }
 
+  virtual object array_interface() const
+  {
+    return python::array_interface(m_list.array().data(), make_tuple(m_list.size()));
+  }
+
   ListT& m_list;
 };
 
@@ -110,6 +110,11 @@ struct TableList : PythonListInterface
     return out_stream.str();
   }
 
+  virtual object array_interface() const
+  {
+    return python::array_interface(m_table.array().data(), make_tuple(m_table.size(), m_table.row_size()));
+  }
+
   TableT& m_table;
 };
 
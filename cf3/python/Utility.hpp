@@ -11,6 +11,12 @@
 
 #include <string>
 
+#include <boost/lexical_cast.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_signed.hpp>
+
+#include "common/CF.hpp"
+
 namespace cf3 {
 namespace python {
 
@@ -29,6 +35,28 @@ inline boost::python::object weak_ref(const boost::python::object& source)
   return boost::python::object(boost::python::handle<>(PyWeakref_NewRef(source.ptr(), NULL)));
 }
   
+/// Build the dictionary for the numpy array interface (__array_interface__), describing contiguous C-ordered storage
+/// at data with the given shape. numpy.asarray then returns a view on this storage without copying.
+/// @param data Pointer to the first value. May be null if the shape has a zero extent.
+/// @param shape Python tuple with the extent in each dimension
+template<typename ValueT>
+boost::python::dict array_interface(ValueT* data, const boost::python::tuple& shape)
+{
+  // numpy does not accept a null pointer, even if there is no data
+  static ValueT empty_data;
+
+  const Uint one = 1;
+  const char byte_order = sizeof(ValueT) == 1 ? '|' : (*reinterpret_cast<const char*>(&one) == 1 ? '<' : '>');
+  const char kind = boost::is_floating_point<ValueT>::value ? 'f' : (boost::is_signed<ValueT>::value ? 'i' : 'u');
+
+  boost::python::dict result;
+  result["version"] = 3;
+  result["shape"] = shape;
+  result["typestr"] = boost::python::str(std::string(1, byte_order) + kind + boost::lexical_cast<std::string>(sizeof(ValueT)));
+  result["data"] = boost::python::make_tuple(reinterpret_cast<std::size_t>(data == 0 ? &empty_data : data), false);
+  return result;
+}
+
 /// Add a function dynamically
 /// @param object Object to add a function to
 /// @param function Function to add (function pointer, ...)
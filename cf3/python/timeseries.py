@@ -0,0 +1,129 @@
+# Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+#
+# This software is distributed under the terms of the
+# GNU Lesser General Public License version 3 (LGPLv3).
+# See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+# Reader for the binary time series files (extension cf3ts) written by cf3.solver.TimeSeriesWriter,
+# as used by History with format binary and by the probes of TurbulenceStatistics.
+#
+# Example:
+#   import timeseries
+#   data = timeseries.read_time_series('history.cf3ts')
+#   print data['time'], data['probe-0/U']
+
+import struct
+import numpy
+
+_magic = 'CF3TSER\0'
+_version = 2
+
+def _byte_order(marker):
+  for prefix in ['<', '>']:
+    if struct.unpack(prefix + 'I', marker)[0] == 0x01020304:
+      return prefix
+  raise IOError('Invalid byte order marker in time series file')
+
+def _read_header(f, filename):
+  """Read the file header, returning the byte order prefix and the position of the block index (0 if there is none)"""
+  header = f.read(16)
+  if len(header) != 16 or header[0:8].decode('latin-1') != _magic:
+    raise IOError(filename + ' is not a coolfluid time series file')
+  order = _byte_order(header[12:16])
+  version = struct.unpack(order + 'I', header[8:12])[0]
+  if version > _version:
+    raise IOError(filename + ' has version ' + str(version) + ', only versions up to ' + str(_version) + ' are supported')
+  index_position = 0
+  if version >= 2:
+    index_position = struct.unpack(order + 'Q', f.read(8))[0]
+  return order, index_position
+
+def _read_block(f, order, filename):
+  """Read the block at the current position, returning None at the end of the blocks"""
+  tag = f.read(4)
+  if len(tag) < 4 or tag.decode('latin-1') == 'INDX':
+    return None
+  if tag.decode('latin-1') != 'BLCK':
+    raise IOError('Corrupt block in ' + filename)
+  size = struct.unpack(order + 'Q', f.read(8))[0]
+  data = f.read(size)
+  if len(data) < size:
+    return None # block was not completely written, e.g. the run is still going
+  nb_columns, nb_rows = struct.unpack(order + 'II', data[0:8])
+  offset = 8
+  names = []
+  for i in range(nb_columns):
+    length = struct.unpack(order + 'I', data[offset:offset+4])[0]
+    offset += 4
+    names.append(data[offset:offset+length].decode('latin-1'))
+    offset += length
+  values = numpy.frombuffer(data, dtype=numpy.dtype(order + 'f8'), count=nb_columns*nb_rows, offset=offset)
+  return (names, values.reshape(nb_columns, nb_rows))
+
+def read_index(filename):
+  """Return the block index of the file, as a list of (position, first row, number of rows, number of columns) tuples,
+  or None if the file has no index because it was not closed"""
+  f = open(filename, 'rb')
+  try:
+    order, index_position = _read_header(f, filename)
+    if index_position == 0:
+      return None
+    f.seek(index_position)
+    if f.read(4).decode('latin-1') != 'INDX':
+      raise IOError('Corrupt block index in ' + filename)
+    nb_blocks = struct.unpack(order + 'Q', f.read(8))[0]
+    entry_size = struct.calcsize(order + 'QQII')
+    data = f.read(nb_blocks*entry_size)
+    return [struct.unpack(order + 'QQII', data[i*entry_size:(i+1)*entry_size]) for i in range(nb_blocks)]
+  finally:
+    f.close()
+
+def read_blocks(filename, first_row=0, nb_rows=None):
+  """Return the list of blocks in the file, as (column names, values) tuples,
+  where values is a numpy array with one row per column.
+  Only the blocks containing rows from first_row up to first_row+nb_rows are returned. If the file has a
+  block index, the other blocks are skipped without reading them."""
+  end_row = None if nb_rows is None else first_row + nb_rows
+  index = read_index(filename)
+  blocks = []
+  f = open(filename, 'rb')
+  try:
+    order, index_position = _read_header(f, filename)
+    if index is not None:
+      for (position, block_first_row, block_rows, block_columns) in index:
+        if block_first_row + block_rows <= first_row or (end_row is not None and block_first_row >= end_row):
+          continue
+        f.seek(position)
+        blocks.append(_read_block(f, order, filename))
+      return blocks
+
+    # No index: scan all blocks
+    row = 0
+    while True:
+      block = _read_block(f, order, filename)
+      if block is None:
+        break
+      block_rows = block[1].shape[1]
+      if row + block_rows > first_row and (end_row is None or row < end_row):
+        blocks.append(block)
+      row += block_rows
+  finally:
+    f.close()
+  return blocks
+
+def read_time_series(filename):
+  """Return a dictionary with a numpy array of values for each column in the file.
+  Columns that are missing in some blocks are padded with NaN for those rows."""
+  blocks = read_blocks(filename)
+  nb_rows = sum([values.shape[1] for (names, values) in blocks])
+  result = {}
+  row = 0
+  for (names, values) in blocks:
+    block_rows = values.shape[1]
+    for (i, name) in enumerate(names):
+      if name not in result:
+        result[name] = numpy.empty(nb_rows)
+        result[name].fill(numpy.nan)
+      result[name][row:row+block_rows] = values[i]
+    row += block_rows
+  return result
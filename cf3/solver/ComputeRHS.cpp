@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include "common/Builder.hpp"
 #include "common/FindComponents.hpp"
 #include "common/OptionList.hpp"
@@ -33,7 +35,9 @@ common::ComponentBuilder < ComputeRHS, common::Action, solver::LibSolver > Compu
 
 ////////////////////////////////////////////////////////////////////////////////
 
-ComputeRHS::ComputeRHS ( const std::string& name ) : common::Action(name)
+ComputeRHS::ComputeRHS ( const std::string& name ) :
+  common::Action(name),
+  m_batch_size(64)
 {
   options().add("rhs",m_rhs).link_to(&m_rhs)
       .description("Right-Hand-Side of equations")
@@ -41,6 +45,8 @@ ComputeRHS::ComputeRHS ( const std::string& name ) : common::Action(name)
   options().add("wave_speed",m_ws).link_to(&m_ws)
       .description("Wave speed")
       .mark_basic();
+  options().add("batch_size",m_batch_size).link_to(&m_batch_size)
+      .description("Number of elements for which the rhs is computed at once");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -104,6 +110,22 @@ void ComputeRHS::compute_rhs(const Uint elem_idx, std::vector<RealVector>& rhs,
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void ComputeRHS::compute_rhs(const Uint begin, const Uint end, TermBatch& rhs)
+{
+  rhs.set_zero();
+
+  for (Uint t=0; t<m_term_computers.size(); ++t)
+  {
+    if (m_loop_cells[t])
+    {
+      m_term_computers[t]->compute_terms(begin,end,m_term_batch);
+      rhs.add(m_term_batch);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void ComputeRHS::compute_rhs(mesh::Field& rhs, mesh::Field& wave_speed)
 {
   const Uint nb_eqs = rhs.row_size();
@@ -118,23 +140,28 @@ void ComputeRHS::compute_rhs(mesh::Field& rhs, mesh::Field& wave_speed)
       const Uint nb_elems = cells->size();
       const Uint nb_sol_pts = space.shape_function().nb_nodes();
 
-      std::vector<RealVector> elem_rhs(nb_sol_pts,RealVector(nb_eqs));
-      std::vector<Real> elem_wave_speed(nb_sol_pts);
-
-      for (Uint elem_idx=0; elem_idx<nb_elems; ++elem_idx)
+      // Batches of elements are computed at once, ghost elements are computed but not stored
+      const Uint batch_size = std::max(m_batch_size,1u);
+      for (Uint begin=0; begin<nb_elems; begin+=batch_size)
       {
-        if (cells->is_ghost(elem_idx)==false)
-        {
-          compute_rhs(elem_idx,elem_rhs,elem_wave_speed);
+        const Uint end = std::min(begin+batch_size,nb_elems);
+        m_rhs_batch.resize(end-begin,nb_sol_pts,nb_eqs);
+        compute_rhs(begin,end,m_rhs_batch);
 
-          mesh::Connectivity::ConstRow nodes = space.connectivity()[elem_idx];
-          for (Uint sol_pt=0; sol_pt<nb_sol_pts; ++sol_pt)
+        for (Uint elem_idx=begin; elem_idx<end; ++elem_idx)
+        {
+          if (cells->is_ghost(elem_idx)==false)
           {
-            for (Uint eq=0; eq<nb_eqs; ++eq)
+            mesh::Connectivity::ConstRow nodes = space.connectivity()[elem_idx];
+            const Uint offset = (elem_idx-begin)*nb_sol_pts;
+            for (Uint sol_pt=0; sol_pt<nb_sol_pts; ++sol_pt)
             {
-              rhs[nodes[sol_pt]][eq] = elem_rhs[sol_pt][eq];
+              for (Uint eq=0; eq<nb_eqs; ++eq)
+              {
+                rhs[nodes[sol_pt]][eq] = m_rhs_batch.term(eq)[offset+sol_pt];
+              }
+              wave_speed[nodes[sol_pt]][0] = m_rhs_batch.wave_speed()[offset+sol_pt];
             }
-            wave_speed[nodes[sol_pt]][0] = elem_wave_speed[sol_pt];
           }
         }
       }
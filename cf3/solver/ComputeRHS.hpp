@@ -10,6 +10,7 @@
 #include "common/Action.hpp"
 #include "math/MatrixTypes.hpp"
 #include "solver/LibSolver.hpp"
+#include "solver/TermBatch.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -58,6 +59,10 @@ public:
   /// @brief Compute the complete rhs for a given element, as well as the wave-speeds
   virtual void compute_rhs(const Uint elem_idx, std::vector<RealVector>& rhs, std::vector<Real>& wave_speed);
 
+  /// @brief Compute the complete rhs for the elements begin to end (excluded), as well as the wave-speeds.
+  /// The batch must be sized for these elements, and is overwritten with the sum of all terms.
+  virtual void compute_rhs(const Uint begin, const Uint end, TermBatch& rhs);
+
   /// @brief Compute the complete rhs in a field, as well as wave speeds
   virtual void compute_rhs(mesh::Field& rhs, mesh::Field& wave_speed);
 
@@ -71,6 +76,10 @@ private:
 
   std::vector< RealVector > m_tmp_term;
   std::vector< Real > m_tmp_ws;
+
+  Uint m_batch_size;      ///! Number of elements computed at once
+  TermBatch m_rhs_batch;  ///! Sum of the terms for the current batch
+  TermBatch m_term_batch; ///! Single term for the current batch
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 
 
 #include "solver/History.hpp"
+#include "solver/TimeSeriesWriter.hpp"
 
 namespace cf3 {
 namespace solver {
@@ -40,11 +41,20 @@ History::History ( const std::string& name ) :
       .link_to(&m_logging)
       .mark_basic();
 
+  m_binary_writer = create_static_component< TimeSeriesWriter >("binary_writer");
+
   // Extension TSV for "Tab Separated Values"
   options().add("file",URI("history.tsv"))
       .description("Log file for history")
+      .attach_trigger(boost::bind(&History::trigger_file, this))
+      .mark_basic();
+
+  options().add("format",std::string("tsv"))
+      .description("Format of the log file: tsv, rewritten at every entry, or binary, written in blocks with the extension cf3ts")
       .mark_basic();
 
+  trigger_file();
+
   regist_signal ( "write" )
       .description( "Write history" )
       .pretty_name("Write" )
@@ -131,7 +141,16 @@ void History::save_entry()
   bool resized = resize_if_necessary();
   m_buffer->add_row(this_entry.data());
 
-  if (m_logging)
+  if (m_logging && options().value<std::string>("format") == "binary")
+  {
+    if (PE::Comm::instance().rank() == 0)
+    {
+      if (resized)
+        m_binary_writer->set_columns(column_names());
+      m_binary_writer->add_row(this_entry.data());
+    }
+  }
+  else if (m_logging)
   {
     if (PE::Comm::instance().rank() == 0)
     {
@@ -156,6 +175,14 @@ void History::save_entry()
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void History::trigger_file()
+{
+  const URI file_uri = options().value<URI>("file");
+  m_binary_writer->options().set("file", file_uri.base_path() / (file_uri.base_name() + ".cf3ts"));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void History::flush()
 {
   if(is_not_null(m_buffer))
@@ -279,6 +306,27 @@ std::string History::file_header() const
 
 ////////////////////////////////////////////////////////////////////////////////
 
+std::vector<std::string> History::column_names() const
+{
+  std::vector<std::string> names;
+  for (Uint var_idx=0; var_idx<m_variables->nb_vars(); ++var_idx)
+  {
+    const Uint var_length = m_variables->var_length(var_idx);
+    if (var_length == 1)
+    {
+      names.push_back(m_variables->user_variable_name(var_idx));
+    }
+    else
+    {
+      for (Uint i=0; i<var_length; ++i)
+        names.push_back(m_variables->user_variable_name(var_idx)+"["+to_str(i)+"]");
+    }
+  }
+  return names;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 void History::write_file(boost::filesystem::fstream& file)
 {
   // Write header, containing the variables
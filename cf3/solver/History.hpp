@@ -22,6 +22,7 @@ namespace solver {
 
 class History;
 class HistoryEntry;
+class TimeSeriesWriter;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -39,6 +40,10 @@ class HistoryEntry;
 /// The history file to be rewritten, including the new variables, putting zero's
 /// for the non-existent past entries.
 ///
+/// With the option "format" set to "binary", entries are instead buffered by a
+/// TimeSeriesWriter and written in blocks to a binary file with extension cf3ts,
+/// which avoids a file write for every entry. New variables then start a new block.
+///
 /// Example:\n
 /// @code
 /// boost::shared_ptr<History> history = allocate_component<History>("history");
@@ -140,6 +145,12 @@ private: // functions
   /// @brief return the log-file header in string format
   std::string file_header() const;
 
+  /// @brief names of the columns of the table
+  std::vector<std::string> column_names() const;
+
+  /// @brief configure the binary writer file from the "file" option
+  void trigger_file();
+
 private: // data
 
   /// Flag to check if the history has to be logged
@@ -157,6 +168,9 @@ private: // data
   /// Description of the variables
   Handle< math::VariablesDescriptor > m_variables;
 
+  /// Writer used for the binary format
+  Handle< TimeSeriesWriter > m_binary_writer;
+
   /// Flag to check if variables have been added.
   /// If so, the table needs to be resized.
   bool m_table_needs_resize;
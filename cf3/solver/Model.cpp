@@ -21,6 +21,7 @@
 #include "common/Group.hpp"
 #include "common/OptionList.hpp"
 #include "common/PropertyList.hpp"
+#include "common/Tracer.hpp"
 
 #include "common/XML/Protocol.hpp"
 #include "common/XML/SignalOptions.hpp"
@@ -35,6 +36,7 @@
 #include "solver/Solver.hpp"
 #include "solver/Model.hpp"
 #include "solver/Tags.hpp"
+#include "solver/TimeSeriesWriter.hpp"
 
 namespace cf3 {
 namespace solver {
@@ -138,8 +140,15 @@ void Model::simulate()
   {
     boost_foreach(Solver& solver, find_components<Solver>(*this))
     {
+      common::TraceScope trace(solver, common::Tracer::ACTION);
       solver.execute();
     }
+
+    // Write the buffered time series on all ranks, while the communicator is still available
+    boost_foreach(TimeSeriesWriter& writer, find_components_recursively<TimeSeriesWriter>(*this))
+    {
+      writer.close();
+    }
     CFinfo << name() << ": end simulation\n" << CFendl;
   }
 //  catch (common::FailedToConverge& e)
@@ -20,17 +20,26 @@ namespace solver {
 
 ////////////////////////////////////////////////////////////////////////////////
 
-template < typename DATA, Uint NB_DIM, Uint NB_EQS >
+/// @brief Approximate Riemann solver on faces with NB_DIM dimensions and NB_EQS equations
+///
+/// BATCH_DATA stores the data of physics::BATCH_SIZE faces, one array entry per face,
+/// and must provide set(i, data) and get(i, data) to copy the data of face i.
+template < typename DATA, Uint NB_DIM, Uint NB_EQS, typename BATCH_DATA >
 class solver_API RiemannSolver : public common::Component
 {
 public:
   typedef DATA Data;
+  typedef BATCH_DATA BatchData;
   static const Uint NDIM = NB_DIM;
   static const Uint NEQS = NB_EQS;
 
   typedef typename physics::MatrixTypes<NDIM,NEQS>::ColVector_NDIM    ColVector_NDIM;
   typedef typename physics::MatrixTypes<NDIM,NEQS>::RowVector_NEQS    RowVector_NEQS;
 
+  typedef typename physics::BatchTypes<NDIM,NEQS>::Array              BatchArray;
+  typedef typename physics::BatchTypes<NDIM,NEQS>::Array_NDIM         BatchArray_NDIM;
+  typedef typename physics::BatchTypes<NDIM,NEQS>::Array_NEQS         BatchArray_NEQS;
+
   RiemannSolver(const std::string& name) : common::Component(name)
   {
     regist_typeinfo(this);
@@ -42,6 +51,27 @@ public:
 
   virtual void compute_riemann_flux( const Data& left, const Data& right, const ColVector_NDIM& normal,
                                      RowVector_NEQS& flux, Real& wave_speed ) = 0;
+
+  /// @brief Compute the flux of physics::BATCH_SIZE faces at once
+  ///
+  /// The default implementation calls the single face compute_riemann_flux for each face of the batch.
+  /// Solvers with batched physics functions override it to process the faces together.
+  virtual void compute_riemann_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                                     BatchArray_NEQS& flux, BatchArray& wave_speed )
+  {
+    Data face_left;
+    Data face_right;
+    ColVector_NDIM face_normal;
+    RowVector_NEQS face_flux;
+    for(Uint i = 0; i != physics::BATCH_SIZE; ++i)
+    {
+      left.get(i, face_left);
+      right.get(i, face_right);
+      face_normal = normal.row(i).matrix().transpose();
+      compute_riemann_flux(face_left, face_right, face_normal, face_flux, wave_speed[i]);
+      flux.row(i) = face_flux.array();
+    }
+  }
 };
 
 ////////////////////////////////////////////////////////////////////////////////
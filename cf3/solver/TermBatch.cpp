@@ -0,0 +1,72 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include "common/Assertions.hpp"
+#include "solver/TermBatch.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+TermBatch::TermBatch() :
+  m_nb_elems(0),
+  m_nb_sol_pts(0),
+  m_nb_eqs(0)
+{
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void TermBatch::resize(const Uint nb_elems, const Uint nb_sol_pts, const Uint nb_eqs)
+{
+  m_nb_elems = nb_elems;
+  m_nb_sol_pts = nb_sol_pts;
+  m_nb_eqs = nb_eqs;
+  m_term.resize(nb_eqs*nb_points());
+  m_wave_speed.resize(nb_points());
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void TermBatch::set_zero()
+{
+  std::fill(m_term.begin(), m_term.end(), 0.);
+  std::fill(m_wave_speed.begin(), m_wave_speed.end(), 0.);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+void TermBatch::add(const TermBatch& other)
+{
+  cf3_assert(other.m_term.size() == m_term.size());
+  cf3_assert(other.m_wave_speed.size() == m_wave_speed.size());
+
+  const Uint nb_values = m_term.size();
+  const Real* other_term = other.m_term.empty() ? 0 : &other.m_term[0];
+  Real* this_term = m_term.empty() ? 0 : &m_term[0];
+  for (Uint i=0; i<nb_values; ++i)
+  {
+    this_term[i] += other_term[i];
+  }
+
+  const Uint nb_pts = m_wave_speed.size();
+  const Real* other_ws = other.m_wave_speed.empty() ? 0 : &other.m_wave_speed[0];
+  Real* this_ws = m_wave_speed.empty() ? 0 : &m_wave_speed[0];
+  for (Uint i=0; i<nb_pts; ++i)
+  {
+    this_ws[i] = std::max(this_ws[i], other_ws[i]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // solver
+} // cf3
@@ -0,0 +1,78 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_TermBatch_hpp
+#define cf3_solver_TermBatch_hpp
+
+#include <vector>
+
+#include "common/CF.hpp"
+#include "solver/LibSolver.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Term and wave speed in the solution points of a block of consecutive elements
+///
+/// The values are stored as structure of arrays: for each equation, the values of all points
+/// of the block are contiguous, so loops over the points of the block can be vectorized.
+/// Solution point s of the e-th element of the block has point index e*nb_sol_pts()+s.
+class solver_API TermBatch
+{
+public:
+
+  /// @brief Constructor, creates an empty batch
+  TermBatch();
+
+  /// @brief Set the dimensions of the batch. Values are not initialized.
+  void resize(const Uint nb_elems, const Uint nb_sol_pts, const Uint nb_eqs);
+
+  /// @brief Number of elements in the batch
+  Uint nb_elems() const { return m_nb_elems; }
+
+  /// @brief Number of solution points per element
+  Uint nb_sol_pts() const { return m_nb_sol_pts; }
+
+  /// @brief Number of equations
+  Uint nb_eqs() const { return m_nb_eqs; }
+
+  /// @brief Number of solution points in the batch
+  Uint nb_points() const { return m_nb_elems*m_nb_sol_pts; }
+
+  /// @brief Values of equation eq, for all points of the batch
+  Real* term(const Uint eq) { return &m_term[eq*nb_points()]; }
+  const Real* term(const Uint eq) const { return &m_term[eq*nb_points()]; }
+
+  /// @brief Wave speed, for all points of the batch
+  Real* wave_speed() { return &m_wave_speed[0]; }
+  const Real* wave_speed() const { return &m_wave_speed[0]; }
+
+  /// @brief Set all terms and wave speeds to zero
+  void set_zero();
+
+  /// @brief Add the terms of another batch of the same size, and take the maximum of the wave speeds
+  void add(const TermBatch& other);
+
+private:
+
+  Uint m_nb_elems;
+  Uint m_nb_sol_pts;
+  Uint m_nb_eqs;
+
+  std::vector<Real> m_term;
+  std::vector<Real> m_wave_speed;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // solver
+} // cf3
+
+#endif // cf3_solver_TermBatch_hpp
@@ -4,6 +4,8 @@
 // GNU Lesser General Public License version 3 (LGPLv3).
 // See doc/lgpl.txt and doc/gpl.txt for the license text.
 
+#include <algorithm>
+
 #include "common/Builder.hpp"
 #include "common/OptionList.hpp"
 #include "mesh/Entities.hpp"
@@ -20,7 +22,8 @@ namespace solver {
 /////////////////////////////////////////////////////////////////////////////////////
 
 TermComputer::TermComputer ( const std::string& name ) 
-  : common::Action(name) 
+  : common::Action(name),
+    m_batch_size(64)
 {
   options().add("field",m_term_field).link_to(&m_term_field)
     .description("Term that will be computed")
@@ -28,6 +31,8 @@ TermComputer::TermComputer ( const std::string& name )
   options().add("term_wave_speed_field",m_term_ws).link_to(&m_term_ws)
     .description("Term wave speed that will be computed")
     .mark_basic();
+  options().add("batch_size",m_batch_size).link_to(&m_batch_size)
+    .description("Number of elements for which the term is computed at once");
 }
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -52,23 +57,57 @@ void TermComputer::compute_term(mesh::Field& term, mesh::Field& wave_speed)
       const mesh::Space& space = term.space(*cells);
       const Uint nb_elems = space.size();
       const Uint nb_nodes_per_elem = space.shape_function().nb_nodes();
-      for (Uint e=0; e<nb_elems; ++e)
+      const Uint batch_size = std::max(m_batch_size, 1u);
+      for (Uint begin=0; begin<nb_elems; begin+=batch_size)
       {
-        compute_term(e,m_tmp_term,m_tmp_ws);
-        for (Uint s=0; s<nb_nodes_per_elem; ++s)
+        const Uint end = std::min(begin+batch_size, nb_elems);
+        compute_terms(begin,end,m_tmp_batch);
+        for (Uint e=begin; e<end; ++e)
         {
-          const Uint p=space.connectivity()[e][s];
-          for (Uint eq=0; eq<m_tmp_term[s].size(); ++eq)
+          for (Uint s=0; s<nb_nodes_per_elem; ++s)
           {
-            term[p][eq] += m_tmp_term[s][eq];
+            const Uint p=space.connectivity()[e][s];
+            const Uint pt=(e-begin)*nb_nodes_per_elem+s;
+            for (Uint eq=0; eq<m_tmp_batch.nb_eqs(); ++eq)
+            {
+              term[p][eq] += m_tmp_batch.term(eq)[pt];
+            }
+            wave_speed[p][0] = m_tmp_batch.wave_speed()[pt];
           }
-          wave_speed[p][0] = m_tmp_ws[s]; 
         }
       }
     }
   }
 }
 
+/////////////////////////////////////////////////////////////////////////////////////
+
+void TermComputer::compute_terms(const Uint begin, const Uint end, TermBatch& batch)
+{
+  if (begin == end)
+  {
+    batch.resize(0,batch.nb_sol_pts(),batch.nb_eqs());
+    return;
+  }
+
+  for (Uint e=begin; e<end; ++e)
+  {
+    compute_term(e,m_tmp_term,m_tmp_ws);
+    if (e == begin)
+      batch.resize(end-begin, m_tmp_term.size(), m_tmp_term.empty() ? 0u : static_cast<Uint>(m_tmp_term[0].size()));
+
+    const Uint offset = (e-begin)*batch.nb_sol_pts();
+    for (Uint s=0; s<batch.nb_sol_pts(); ++s)
+    {
+      for (Uint eq=0; eq<batch.nb_eqs(); ++eq)
+      {
+        batch.term(eq)[offset+s] = m_tmp_term[s][eq];
+      }
+      batch.wave_speed()[offset+s] = m_tmp_ws[s];
+    }
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 } // solver
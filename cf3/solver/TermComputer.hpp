@@ -10,6 +10,7 @@
 #include "common/Action.hpp"
 #include "math/MatrixTypes.hpp"
 #include "solver/LibSolver.hpp"
+#include "solver/TermBatch.hpp"
 
 // Forward declares
 namespace cf3 
@@ -55,13 +56,21 @@ public:
   /// @brief Compute the term for given element in given vectors
   virtual void compute_term(const Uint elem_idx, std::vector<RealVector>& term, std::vector<Real>& wave_speed) = 0;
 
+  /// @brief Compute the term for the elements begin to end (excluded) in a batch, which is resized to fit.
+  /// The default implementation calls compute_term for each element. Term computers for
+  /// a fixed number of equations should derive from TermComputerT, which fills the batch
+  /// without a virtual call per element.
+  virtual void compute_terms(const Uint begin, const Uint end, TermBatch& batch);
+
  private:
 
   Handle<mesh::Field> m_term_field;
   Handle<mesh::Field> m_term_ws;
+  Uint m_batch_size;
   
   std::vector<RealVector> m_tmp_term;
   std::vector<Real>       m_tmp_ws;
+  TermBatch               m_tmp_batch;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
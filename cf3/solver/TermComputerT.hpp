@@ -0,0 +1,111 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_TermComputerT_hpp
+#define cf3_solver_TermComputerT_hpp
+
+#include "physics/MatrixTypes.hpp"
+#include "solver/TermBatch.hpp"
+#include "solver/TermComputer.hpp"
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+
+/////////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Term computer for a fixed number of dimensions and equations
+///
+/// The derived class DERIVED must implement the non-virtual functions
+/// @code
+/// Uint nb_sol_pts() const;
+/// void compute_element_term(const Uint elem_idx, RowVector_NEQS* term, Real* wave_speed);
+/// @endcode
+/// where nb_sol_pts() is the number of solution points per element of the cells given to loop_cells(),
+/// and compute_element_term() computes the term and wave speed in each solution point of the element.
+/// A batch of elements is then computed with a single virtual call, using fixed-size vectors only,
+/// and stored in the structure of arrays layout of TermBatch.
+template < typename DERIVED, Uint NB_DIM, Uint NB_EQS >
+class TermComputerT : public TermComputer
+{
+public:
+  static const Uint NDIM = NB_DIM;
+  static const Uint NEQS = NB_EQS;
+
+  typedef typename physics::MatrixTypes<NDIM,NEQS>::ColVector_NDIM    ColVector_NDIM;
+  typedef typename physics::MatrixTypes<NDIM,NEQS>::RowVector_NEQS    RowVector_NEQS;
+
+  /// @brief Constructor
+  TermComputerT ( const std::string& name ) : TermComputer(name) {}
+
+  /// Virtual destructor
+  virtual ~TermComputerT() {}
+
+  /// @brief Compute the term for the elements begin to end (excluded) in a batch
+  virtual void compute_terms(const Uint begin, const Uint end, TermBatch& batch)
+  {
+    DERIVED& derived = static_cast<DERIVED&>(*this);
+    const Uint nb_sol_pts = derived.nb_sol_pts();
+    batch.resize(end-begin, nb_sol_pts, NEQS);
+    if (begin == end)
+      return;
+
+    m_elem_term.resize(nb_sol_pts);
+    m_elem_ws.resize(nb_sol_pts);
+
+    Real* batch_ws = batch.wave_speed();
+    Real* batch_term[NEQS];
+    for (Uint eq=0; eq<NEQS; ++eq)
+      batch_term[eq] = batch.term(eq);
+
+    for (Uint e=begin; e<end; ++e)
+    {
+      derived.compute_element_term(e, &m_elem_term[0], &m_elem_ws[0]);
+      const Uint offset = (e-begin)*nb_sol_pts;
+      for (Uint s=0; s<nb_sol_pts; ++s)
+      {
+        for (Uint eq=0; eq<NEQS; ++eq)
+        {
+          batch_term[eq][offset+s] = m_elem_term[s][eq];
+        }
+        batch_ws[offset+s] = m_elem_ws[s];
+      }
+    }
+  }
+
+  /// @brief Compute the term for given element in given vectors
+  virtual void compute_term(const Uint elem_idx, std::vector<RealVector>& term, std::vector<Real>& wave_speed)
+  {
+    DERIVED& derived = static_cast<DERIVED&>(*this);
+    const Uint nb_sol_pts = derived.nb_sol_pts();
+    m_elem_term.resize(nb_sol_pts);
+    term.resize(nb_sol_pts, RealVector(NEQS));
+    wave_speed.resize(nb_sol_pts);
+
+    derived.compute_element_term(elem_idx, &m_elem_term[0], &wave_speed[0]);
+    for (Uint s=0; s<nb_sol_pts; ++s)
+    {
+      term[s].resize(NEQS);
+      for (Uint eq=0; eq<NEQS; ++eq)
+      {
+        term[s][eq] = m_elem_term[s][eq];
+      }
+    }
+  }
+
+private:
+
+  std::vector<RowVector_NEQS, Eigen::aligned_allocator<RowVector_NEQS> > m_elem_term;
+  std::vector<Real> m_elem_ws;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // solver
+} // cf3
+
+#endif // cf3_solver_TermComputerT_hpp
@@ -0,0 +1,362 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include <algorithm>
+
+#include <boost/cstdint.hpp>
+#include <boost/foreach.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/Builder.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/OptionT.hpp"
+#include "common/Signal.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "solver/TimeSeriesWriter.hpp"
+
+namespace cf3 {
+namespace solver {
+
+using namespace common;
+
+common::ComponentBuilder < TimeSeriesWriter , Component, LibSolver > TimeSeriesWriter_Builder;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace detail
+{
+  template<typename T>
+  void write_binary(boost::filesystem::fstream& file, const T value)
+  {
+    file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TimeSeriesWriter::TimeSeriesWriter ( const std::string& name ) :
+  Component(name),
+  m_nb_rows(0),
+  m_nb_ranks(1),
+  m_nb_written_rows(0),
+  m_index_position(0)
+{
+  options().add("file", URI("timeseries.cf3ts"))
+      .pretty_name("File")
+      .description("Binary output file")
+      .attach_trigger(boost::bind(&TimeSeriesWriter::trigger_file, this))
+      .mark_basic();
+
+  options().add("flush_interval", 1000u)
+      .pretty_name("Flush Interval")
+      .description("Number of rows kept in memory before writing them to file")
+      .mark_basic();
+
+  options().add("parallel", false)
+      .pretty_name("Parallel")
+      .description("Gather the columns of all ranks into a single file written by rank 0. Flushing is then collective.")
+      .mark_basic();
+
+  regist_signal ( "flush" )
+      .description( "Write the buffered rows to file" )
+      .pretty_name("Flush" )
+      .connect   ( boost::bind ( &TimeSeriesWriter::signal_flush, this, _1 ) );
+
+  regist_signal ( "close" )
+      .description( "Write the buffered rows and the block index, and close the file" )
+      .pretty_name("Close" )
+      .connect   ( boost::bind ( &TimeSeriesWriter::signal_close, this, _1 ) );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+TimeSeriesWriter::~TimeSeriesWriter()
+{
+  try
+  {
+    if(m_nb_rows != 0)
+    {
+      // Gathering the rows of a parallel run would need all ranks, so only a serial run can still write them here
+      if(options().value<bool>("parallel") && m_nb_ranks > 1)
+        CFwarn << "Dropping " << m_nb_rows << " rows of parallel time series writer " << uri().string() << ", close() was not called" << CFendl;
+      else
+        flush(false);
+    }
+    close_file();
+  }
+  catch(std::exception& e)
+  {
+    CFerror << "Error closing time series writer " << uri().string() << ": " << e.what() << CFendl;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::set_columns(const std::vector<std::string>& names)
+{
+  // Always flush if there are rows, so all ranks flush together in parallel
+  if(m_nb_rows != 0)
+    flush();
+
+  m_columns = names;
+  m_buffer.resize(std::max(options().value<Uint>("flush_interval"), 1u) * m_columns.size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::add_row(const std::vector<Real>& values)
+{
+  const Uint nb_cols = m_columns.size();
+  if(values.size() != nb_cols)
+    throw BadValue(FromHere(), "Row of size " + to_str(values.size()) + " added to " + uri().string() + ", which has " + to_str(nb_cols) + " columns");
+
+  const Uint capacity = std::max(options().value<Uint>("flush_interval"), 1u);
+  if(m_buffer.size() < capacity*nb_cols)
+    m_buffer.resize(capacity*nb_cols);
+
+  // Remember the number of ranks that buffer rows, since the communicator may be gone when the destructor runs
+  if(m_nb_rows == 0)
+    m_nb_ranks = PE::Comm::instance().size();
+
+  std::copy(values.begin(), values.end(), m_buffer.begin() + m_nb_rows*nb_cols);
+  ++m_nb_rows;
+
+  if(m_nb_rows >= capacity)
+    flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool TimeSeriesWriter::is_parallel() const
+{
+  if(!options().value<bool>("parallel"))
+    return false;
+
+  PE::Comm& comm = PE::Comm::instance();
+  if(comm.is_finalized())
+    throw ParallelError(FromHere(), "Parallel time series writer " + uri().string() + " used after MPI was finalized. Call close() before finalizing.");
+
+  return comm.is_active() && comm.size() > 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::flush()
+{
+  flush(is_parallel());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::flush(const bool parallel)
+{
+  PE::Comm& comm = PE::Comm::instance();
+  if(!parallel && m_nb_rows == 0)
+    return;
+
+  // Store the values column after column
+  const Uint nb_rows = m_nb_rows;
+  const Uint nb_cols = m_columns.size();
+  std::vector<Real> values(nb_rows*nb_cols);
+  for(Uint row = 0; row != nb_rows; ++row)
+  {
+    for(Uint col = 0; col != nb_cols; ++col)
+      values[col*nb_rows + row] = m_buffer[row*nb_cols + col];
+  }
+  m_nb_rows = 0;
+
+  if(!parallel)
+  {
+    write_block(m_columns, values, nb_rows);
+    return;
+  }
+
+  std::vector<Uint> rank_nb_rows;
+  comm.all_gather(nb_rows, rank_nb_rows);
+  for(Uint rank = 0; rank != rank_nb_rows.size(); ++rank)
+  {
+    if(rank_nb_rows[rank] != nb_rows)
+      throw ParallelError(FromHere(), "Rank " + to_str(rank) + " has " + to_str(rank_nb_rows[rank]) + " rows to write in " + uri().string() + ", while rank " + to_str(comm.rank()) + " has " + to_str(nb_rows));
+  }
+  if(nb_rows == 0)
+    return;
+
+  // Send the names, separated by a null character, and the values to rank 0
+  const Uint nb_procs = comm.size();
+  std::vector< std::vector<char> > send_names(nb_procs), recv_names;
+  std::vector< std::vector<Real> > send_values(nb_procs), recv_values;
+  for(Uint col = 0; col != nb_cols; ++col)
+  {
+    send_names[0].insert(send_names[0].end(), m_columns[col].begin(), m_columns[col].end());
+    send_names[0].push_back('\0');
+  }
+  send_values[0].swap(values);
+  comm.all_to_all(send_names, recv_names);
+  comm.all_to_all(send_values, recv_values);
+
+  if(comm.rank() != 0)
+    return;
+
+  std::vector<std::string> all_names;
+  std::vector<Real> all_values;
+  for(Uint rank = 0; rank != nb_procs; ++rank)
+  {
+    std::string name;
+    BOOST_FOREACH(const char c, recv_names[rank])
+    {
+      if(c == '\0')
+      {
+        all_names.push_back(name);
+        name.clear();
+      }
+      else
+      {
+        name.push_back(c);
+      }
+    }
+    all_values.insert(all_values.end(), recv_values[rank].begin(), recv_values[rank].end());
+  }
+  write_block(all_names, all_values, nb_rows);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::close()
+{
+  flush();
+  close_file();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::write_block(const std::vector<std::string>& names, const std::vector<Real>& values, const Uint nb_rows)
+{
+  cf3_assert(values.size() == names.size()*nb_rows);
+
+  if(!m_file.is_open())
+  {
+    // Only rank 0 writes the file of a parallel writer, also if the gathering was skipped
+    PE::Comm& comm = PE::Comm::instance();
+    if(options().value<bool>("parallel") && comm.is_active() && comm.rank() != 0)
+      return;
+
+    const boost::filesystem::path path(options().value<URI>("file").path());
+    if(m_index_position != 0)
+    {
+      // Reopen a closed file, marking it as not closed and overwriting the index with the new blocks
+      m_file.open(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+      if(!m_file)
+        throw FileSystemError(FromHere(), "Failed to reopen file " + path.string());
+      m_file.seekp(16);
+      detail::write_binary(m_file, static_cast<boost::uint64_t>(0));
+      m_file.seekp(m_index_position);
+    }
+    else
+    {
+      m_file.open(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+      if(!m_file)
+        throw FileSystemError(FromHere(), "Failed to open file " + path.string());
+      m_file.write("CF3TSER\0", 8);
+      detail::write_binary(m_file, static_cast<boost::uint32_t>(version()));
+      detail::write_binary(m_file, static_cast<boost::uint32_t>(0x01020304));
+      detail::write_binary(m_file, static_cast<boost::uint64_t>(0));
+      m_blocks.clear();
+      m_nb_written_rows = 0;
+    }
+  }
+
+  BlockInfo info;
+  info.position = static_cast<boost::uint64_t>(m_file.tellp());
+  info.first_row = m_nb_written_rows;
+  info.nb_rows = nb_rows;
+  info.nb_cols = names.size();
+  m_blocks.push_back(info);
+  m_nb_written_rows += nb_rows;
+
+  boost::uint64_t block_size = 2*sizeof(boost::uint32_t) + values.size()*sizeof(double);
+  BOOST_FOREACH(const std::string& name, names)
+    block_size += sizeof(boost::uint32_t) + name.size();
+
+  m_file.write("BLCK", 4);
+  detail::write_binary(m_file, block_size);
+  detail::write_binary(m_file, static_cast<boost::uint32_t>(names.size()));
+  detail::write_binary(m_file, static_cast<boost::uint32_t>(nb_rows));
+  BOOST_FOREACH(const std::string& name, names)
+  {
+    detail::write_binary(m_file, static_cast<boost::uint32_t>(name.size()));
+    m_file.write(name.data(), name.size());
+  }
+  if(sizeof(Real) == sizeof(double))
+  {
+    if(!values.empty())
+      m_file.write(reinterpret_cast<const char*>(&values[0]), values.size()*sizeof(double));
+  }
+  else
+  {
+    BOOST_FOREACH(const Real value, values)
+      detail::write_binary(m_file, static_cast<double>(value));
+  }
+  m_file.flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::close_file()
+{
+  if(!m_file.is_open())
+    return;
+
+  const boost::uint64_t index_position = static_cast<boost::uint64_t>(m_file.tellp());
+  m_file.write("INDX", 4);
+  detail::write_binary(m_file, static_cast<boost::uint64_t>(m_blocks.size()));
+  BOOST_FOREACH(const BlockInfo& info, m_blocks)
+  {
+    detail::write_binary(m_file, info.position);
+    detail::write_binary(m_file, info.first_row);
+    detail::write_binary(m_file, static_cast<boost::uint32_t>(info.nb_rows));
+    detail::write_binary(m_file, static_cast<boost::uint32_t>(info.nb_cols));
+  }
+
+  // Point the header to the index
+  m_file.seekp(16);
+  detail::write_binary(m_file, index_position);
+  m_file.close();
+
+  // Blocks written later are appended, so the index is kept
+  m_index_position = index_position;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::trigger_file()
+{
+  close_file();
+  m_blocks.clear();
+  m_nb_written_rows = 0;
+  m_index_position = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::signal_flush(SignalArgs& args)
+{
+  flush();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+void TimeSeriesWriter::signal_close(SignalArgs& args)
+{
+  close();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // solver
+} // cf3
@@ -0,0 +1,147 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_TimeSeriesWriter_hpp
+#define cf3_solver_TimeSeriesWriter_hpp
+
+#include <boost/cstdint.hpp>
+
+#include "common/BoostFilesystem.hpp"
+#include "common/Component.hpp"
+
+#include "solver/LibSolver.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace cf3 {
+namespace solver {
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// @brief Buffers rows of named Real columns in memory, and writes them in large binary blocks to a single file
+///
+/// Rows are kept in a buffer that is allocated once for "flush_interval" rows. The buffered rows are written
+/// when the buffer is full, when the columns change, and when flush() or close() is called.
+/// Each block starts with the names of its columns, followed by all values of the first column,
+/// then all values of the second column, and so on. Columns may change between blocks.
+///
+/// If the option "parallel" is set, each rank adds rows with its own columns, and flushing is collective:
+/// the blocks of all ranks are gathered on rank 0, which is the only rank that writes to the file. All ranks
+/// must then add the same number of rows, and close() must be called on all ranks at the end of the run, before
+/// MPI is finalized. Model::simulate does this for all writers in the model. Otherwise, only the ranks that add
+/// rows write to the file.
+///
+/// The destructor never communicates: it writes the remaining rows if the rows were added in a serial run,
+/// and drops those of a parallel writer in a multi-rank run with a warning if close() was not called.
+///
+/// File layout, in native byte order:
+/// - header: the 8 characters "CF3TSER\0", Uint32 version, Uint32 0x01020304 to detect the byte order,
+///   Uint64 position of the block index, or 0 if the file was not closed
+/// - blocks: the 4 characters "BLCK", Uint64 number of bytes in the rest of the block, Uint32 number of columns,
+///   Uint32 number of rows, for each column a Uint32 name length followed by the name, and the values as doubles
+/// - block index, written by close(): the 4 characters "INDX", Uint64 number of blocks and, for each block,
+///   Uint64 position of the block, Uint64 index of its first row, Uint32 number of rows and Uint32 number of columns
+///
+/// The python module timeseries (timeseries.py) reads these files into numpy arrays.
+class solver_API TimeSeriesWriter : public common::Component
+{
+public:
+
+  /// @brief Contructor
+  /// @param name of the component
+  TimeSeriesWriter ( const std::string& name );
+
+  /// @brief Virtual destructor, closes the file without communicating
+  virtual ~TimeSeriesWriter();
+
+  /// @brief Get the class name
+  static std::string type_name () { return "TimeSeriesWriter"; }
+
+  /// @brief Set the names of the columns. The rows buffered for the previous columns are written first.
+  void set_columns(const std::vector<std::string>& names);
+
+  /// @brief The current column names
+  const std::vector<std::string>& columns() const { return m_columns; }
+
+  /// @brief Add a row with one value for each column
+  void add_row(const std::vector<Real>& values);
+
+  /// @brief Write the buffered rows. Collective if the "parallel" option is set.
+  void flush();
+
+  /// @brief Write the buffered rows and the block index, and close the file. Collective if the "parallel" option is set.
+  /// Rows added afterwards are appended to the same file, until the "file" option is changed.
+  void close();
+
+  /// @brief Number of rows in the buffer
+  Uint nb_buffered_rows() const { return m_nb_rows; }
+
+  /// @brief Version of the file format
+  static Uint version() { return 2u; }
+
+  /// @name SIGNALS
+  //@{
+  void signal_flush(common::SignalArgs& args);
+  void signal_close(common::SignalArgs& args);
+  //@}
+
+private:
+
+  void trigger_file();
+
+  /// True if this writer gathers the rows of all ranks. Throws if MPI was finalized already.
+  bool is_parallel() const;
+
+  /// Write the buffered rows, gathering them on rank 0 if parallel is true
+  void flush(const bool parallel);
+
+  /// Write one block with the given column names and values, stored column after column
+  void write_block(const std::vector<std::string>& names, const std::vector<Real>& values, const Uint nb_rows);
+
+  /// Write the block index at the end of the file, and close it. Local operation.
+  void close_file();
+
+  std::vector<std::string> m_columns;
+
+  /// Buffered values, row after row
+  std::vector<Real> m_buffer;
+
+  /// Number of rows in m_buffer
+  Uint m_nb_rows;
+
+  /// Size of the communicator when the buffered rows were added
+  Uint m_nb_ranks;
+
+  boost::filesystem::fstream m_file;
+
+  /// Position, first row, number of rows and number of columns of a written block
+  struct BlockInfo
+  {
+    boost::uint64_t position;
+    boost::uint64_t first_row;
+    Uint nb_rows;
+    Uint nb_cols;
+  };
+
+  /// The blocks written to the file
+  std::vector<BlockInfo> m_blocks;
+
+  /// Number of rows written to the file
+  boost::uint64_t m_nb_written_rows;
+
+  /// Position of the index of the closed file, or 0 if the file was not closed yet
+  boost::uint64_t m_index_position;
+
+}; // TimeSeriesWriter
+
+////////////////////////////////////////////////////////////////////////////////
+
+} // solver
+} // cf3
+
+////////////////////////////////////////////////////////////////////////////////
+
+#endif // cf3_solver_TimeSeriesWriter_hpp
@@ -0,0 +1,41 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#include "mesh/ElementColoring.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Space.hpp"
+
+#include "ElementColoring.hpp"
+
+namespace cf3 {
+namespace solver {
+namespace actions {
+namespace Proto {
+
+ElementColoring::ElementColoring(const mesh::Elements& elements) :
+  m_coloring(mesh::ElementColoring::get(elements.geometry_space()))
+{
+}
+
+Uint ElementColoring::nb_colors() const
+{
+  return m_coloring.nb_colors();
+}
+
+const std::vector<Uint>& ElementColoring::elements() const
+{
+  return m_coloring.elements();
+}
+
+const std::vector<Uint>& ElementColoring::color_offsets() const
+{
+  return m_coloring.color_offsets();
+}
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
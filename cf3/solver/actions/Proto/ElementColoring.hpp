@@ -0,0 +1,53 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#ifndef cf3_solver_actions_Proto_ElementColoring_hpp
+#define cf3_solver_actions_Proto_ElementColoring_hpp
+
+#include <vector>
+
+#include "common/CF.hpp"
+
+/// @file
+/// Coloring of elements, used to run element loops in parallel without write conflicts
+
+namespace cf3 {
+  namespace mesh { class Elements; class ElementColoring; }
+namespace solver {
+namespace actions {
+namespace Proto {
+
+/// Coloring of the elements of an Elements component, so that no two elements
+/// with the same color share a node. Periodic links of the geometry dictionary are followed,
+/// so elements that end up writing to the same (periodic) LSS row also get a different color.
+/// All elements of a single color can thus be assembled concurrently.
+/// This is a view on the mesh::ElementColoring stored in the geometry space, which is only
+/// recomputed after the mesh changed.
+class ElementColoring : public boost::noncopyable
+{
+public:
+  /// Get the coloring of the geometry space of the given elements, computing it if needed
+  ElementColoring(const mesh::Elements& elements);
+
+  /// Number of colors
+  Uint nb_colors() const;
+
+  /// Element indices, sorted by color
+  const std::vector<Uint>& elements() const;
+
+  /// The elements with color c are found between color_offsets()[c] and color_offsets()[c+1] in elements()
+  const std::vector<Uint>& color_offsets() const;
+
+private:
+  const mesh::ElementColoring& m_coloring;
+};
+
+} // namespace Proto
+} // namespace actions
+} // namespace solver
+} // namespace cf3
+
+#endif // cf3_solver_actions_Proto_ElementColoring_hpp
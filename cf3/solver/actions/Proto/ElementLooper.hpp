@@ -15,7 +15,15 @@
 #include <boost/mpl/assert.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/filter_view.hpp>
+#include <boost/ptr_container/ptr_vector.hpp>
 
+#include "coolfluid-packages.hpp"
+
+#ifdef CF3_HAVE_OPENMP
+#include <omp.h>
+#endif
+
+#include "ElementColoring.hpp"
 #include "ElementData.hpp"
 #include "ElementExpressionWrapper.hpp"
 #include "ElementGrammar.hpp"
@@ -60,7 +68,7 @@ struct CheckSameEtype
 template<typename ElementTypesT, typename ExprT, typename SupportETYPE, typename VariablesT, typename VariablesEtypesT, typename NbVarsT, typename VarIdxT>
 struct ExpressionRunner
 {
-  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems) : variables(vars), expression(expr), elements(elems), m_nb_tests(0), m_found(false) {}
+  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems, const Uint nb_thr) : variables(vars), expression(expr), elements(elems), nb_threads(nb_thr), m_nb_tests(0), m_found(false) {}
 
   typedef typename boost::remove_reference<typename boost::fusion::result_of::at<VariablesT, VarIdxT>::type>::type VarT;
 
@@ -89,7 +97,7 @@ struct ExpressionRunner
       NewVariablesEtypesT,
       NbVarsT,
       NextIdxT
-    >(variables, expression, elements).run();
+    >(variables, expression, elements, nb_threads).run();
   }
 
   // Chosen otherwise
@@ -141,12 +149,13 @@ struct ExpressionRunner
       NewVariablesEtypesT,
       NbVarsT,
       NextIdxT
-    >(variables, expression, elements).run();
+    >(variables, expression, elements, nb_threads).run();
   }
 
   VariablesT& variables;
   const ExprT& expression;
   mesh::Elements& elements;
+  const Uint nb_threads;
   // Number of times we tried a shape function
   mutable Uint m_nb_tests;
   mutable bool m_found;
@@ -158,11 +167,19 @@ struct ExpressionRunner
 template<typename DataT>
 struct ElementLooperImpl
 {
-  template<typename ExprT>
-  void operator()(const ExprT& expr, DataT& data, const Uint nb_elems) const
+  template<typename ExprT, typename VariablesT>
+  void operator()(const ExprT& expr, VariablesT& variables, mesh::Elements& elements, const Uint nb_threads) const
   {
+#ifdef CF3_HAVE_OPENMP
+    if(nb_threads > 1)
+    {
+      run_threaded(expr, variables, elements, nb_threads);
+      return;
+    }
+#endif
+    DataT data(variables, elements);
     const typename DataT::SupportShapeFunction::MappedCoordsT mapped_coords; // needed to deduce proper return type when wrapping
-    run(WrapExpression()(expr, mapped_coords, data), data, nb_elems);
+    run(WrapExpression()(expr, mapped_coords, data), data, elements.size());
   }
 
 private:
@@ -178,13 +195,84 @@ private:
       grammar(expr, elem, data);
     }
   }
+
+#ifdef CF3_HAVE_OPENMP
+  /// Run the loop using nb_threads OpenMP threads. Each thread owns its own element data (and thus its own block accumulator)
+  /// and its own copy of the wrapped expression. Elements are processed color by color, so elements that are handled concurrently never share a node.
+  template<typename ExprT, typename VariablesT>
+  void run_threaded(const ExprT& expr, VariablesT& variables, mesh::Elements& elements, const Uint nb_threads) const
+  {
+    const ElementColoring coloring(elements);
+
+    // Element data is created and destroyed on the master thread only, since destruction may involve communication
+    boost::ptr_vector<DataT> thread_data;
+    for(Uint i = 0; i != nb_threads; ++i)
+      thread_data.push_back(new DataT(variables, elements));
+
+    // Set atomically by the thread that fails first, read atomically by the others to skip their remaining elements
+    int failed = 0;
+    std::string error_message;
+
+    #pragma omp parallel num_threads(nb_threads)
+    {
+      DataT& data = thread_data[omp_get_thread_num()];
+      const typename DataT::SupportShapeFunction::MappedCoordsT mapped_coords;
+      run_colors(WrapExpression()(expr, mapped_coords, data), data, coloring, failed, error_message);
+    }
+
+    if(failed)
+      throw common::ParallelError(FromHere(), "Threaded element loop over " + elements.uri().path() + " failed: " + error_message);
+  }
+
+  /// Loop over the elements of each color, to be called from within an OpenMP parallel region
+  template<typename FilteredExprT>
+  void run_colors(const FilteredExprT& expr, DataT& data, const ElementColoring& coloring, int& failed, std::string& error_message) const
+  {
+    ElementGrammar grammar;
+    const std::vector<Uint>& colored_elements = coloring.elements();
+    const std::vector<Uint>& color_offsets = coloring.color_offsets();
+    const Uint nb_colors = coloring.nb_colors();
+    for(Uint color = 0; color != nb_colors; ++color)
+    {
+      const int color_begin = color_offsets[color];
+      const int color_end = color_offsets[color+1];
+      // The implicit barrier at the end of the omp for guarantees that colors don't overlap
+      #pragma omp for schedule(static)
+      for(int i = color_begin; i < color_end; ++i)
+      {
+        // Exceptions can't cross the parallel region, so they are stored and rethrown on the master thread
+        int has_failed;
+        #pragma omp atomic read
+        has_failed = failed;
+        if(has_failed)
+          continue;
+        try
+        {
+          const Uint elem = colored_elements[i];
+          data.set_element(elem);
+          grammar(expr, elem, data);
+        }
+        catch(std::exception& e)
+        {
+          #pragma omp critical(cf3_proto_element_loop_error)
+          {
+            if(!failed)
+              error_message = e.what();
+            #pragma omp atomic write
+            failed = 1;
+          }
+        }
+      }
+    }
+  }
+#endif
 };
 
 /// When we recursed to the last variable, actually run the expression
 template<typename ElementTypesT, typename ExprT, typename SupportETYPE, typename VariablesT, typename VariablesEtypesT, typename NbVarsT>
 struct ExpressionRunner<ElementTypesT, ExprT, SupportETYPE, VariablesT, VariablesEtypesT, NbVarsT, NbVarsT>
 {
-  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems) : variables(vars), expression(expr), elements(elems) {}
+  ExpressionRunner(VariablesT& vars, const ExprT& expr, mesh::Elements& elems, const Uint nb_thr) : variables(vars), expression(expr), elements(elems), nb_threads(nb_thr) {}
 
   typedef ElementData<VariablesT, VariablesEtypesT, SupportETYPE, typename EquationVariables<ExprT, NbVarsT>::type> DataT;
 
@@ -196,15 +284,14 @@ struct ExpressionRunner<ElementTypesT, ExprT, SupportETYPE, VariablesT, Variable
       INVALID_ELEMENT_EXPRESSION,
       (ElementGrammar));
 
-    DataT data(variables, elements);
-
-    ElementLooperImpl<DataT>()(expression, data, elements.size());
+    ElementLooperImpl<DataT>()(expression, variables, elements, nb_threads);
   }
 
 private:
   VariablesT& variables;
   const ExprT& expression;
   mesh::Elements& elements;
+  const Uint nb_threads;
 };
 
 /// mpl::for_each compatible functor to loop over elements, using the correct shape function for the geometry
@@ -215,10 +302,13 @@ struct ElementLooper
   // Type of a fusion vector that can contain a copy of each variable that is used in the expression
   typedef typename ExpressionProperties<ExprT>::VariablesT VariablesT;
 
-  ElementLooper(mesh::Elements& elements, const ExprT& expr, VariablesT& variables) :
+  /// Construct the looper. If nb_threads is larger than 1 and OpenMP is available, the loop over the elements is threaded,
+  /// so all custom functions used in the expression must be reentrant in that case.
+  ElementLooper(mesh::Elements& elements, const ExprT& expr, VariablesT& variables, const Uint nb_threads = 1) :
     m_elements(elements),
     m_expr(expr),
-    m_variables(variables)
+    m_variables(variables),
+    m_nb_threads(nb_threads)
   {
   }
 
@@ -252,9 +342,7 @@ struct ElementLooper
     // Verify the types match, and throw an error if non-matching fields are found
     boost::fusion::for_each(m_variables, CheckSameEtype<ETYPE>(m_elements));
 
-    DataT data(m_variables, m_elements);
-
-    ElementLooperImpl<DataT>()(m_expr, data, m_elements.size());
+    ElementLooperImpl<DataT>()(m_expr, m_variables, m_elements, m_nb_threads);
   }
 
   /// Static dispatch in case different ETYPE are possible
@@ -275,13 +363,14 @@ struct ElementLooper
       boost::mpl::vector0<>, // Start with an empty vector for the per-variable element types
       NbVarsT, // number of variables
       boost::mpl::int_<0> // Start index, as MPL integral constant
-    >(m_variables, m_expr, m_elements).run();
+    >(m_variables, m_expr, m_elements, m_nb_threads).run();
   }
 
 private:
   mesh::Elements& m_elements;
   const ExprT& m_expr;
   VariablesT& m_variables;
+  const Uint m_nb_threads;
 };
 
 template<typename ElementTypesT, typename ExprT>
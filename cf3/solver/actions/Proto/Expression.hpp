@@ -65,6 +65,10 @@ public:
   /// value: space library name, to indicate what kind of field is expected
   virtual void insert_field_info(std::map<std::string, std::string>& tags) const = 0;
 
+  /// Set the number of threads to use in element loops. Only has an effect if OpenMP is available, and requires
+  /// that all custom functions and terminals used in the expression are reentrant.
+  virtual void set_nb_threads(const Uint nb_threads) = 0;
+
   virtual ~Expression() {}
 };
 
@@ -76,6 +80,7 @@ public:
 
   ExpressionBase(const ExprT& expr) :
     m_constant_values(),
+    m_nb_threads(1),
     m_expr( DeepCopy()( ReplaceConfigurableConstants()(ReplacePhysicsConstants()(expr, m_physics_values), m_constant_values) ) )
   {
     // Store the variables
@@ -144,12 +149,19 @@ public:
     boost::fusion::for_each(m_variables, AppendTags(tags));
   }
 
+  void set_nb_threads(const Uint nb_threads)
+  {
+    m_nb_threads = nb_threads == 0 ? 1 : nb_threads;
+  }
+
 private:
   /// Values for configurable constants
   ConstantStorage m_constant_values;
   /// Values for physics constants
   PhysicsConstantStorage m_physics_values;
 protected:
+  /// Number of threads for element loops
+  Uint m_nb_threads;
 
   /// Store a copy of the expression
   typedef typename boost::result_of< DeepCopy(typename boost::result_of<ReplaceConfigurableConstants(typename boost::result_of<ReplacePhysicsConstants(ExprT, PhysicsConstantStorage)>::type, ConstantStorage)>::type) >::type CopiedExprT;
@@ -255,7 +267,7 @@ public:
     // Traverse all Elements under the region and evaluate the expression
     BOOST_FOREACH(mesh::Elements& elements, common::find_components_recursively<mesh::Elements>(region) )
     {
-      boost::mpl::for_each<boost::mpl::filter_view< ElementTypes, mesh::IsMinimalOrder<1> > >( ElementLooper<ElementTypes, typename BaseT::CopiedExprT>(elements, BaseT::m_expr, BaseT::m_variables) );
+      boost::mpl::for_each<boost::mpl::filter_view< ElementTypes, mesh::IsMinimalOrder<1> > >( ElementLooper<ElementTypes, typename BaseT::CopiedExprT>(elements, BaseT::m_expr, BaseT::m_variables, BaseT::m_nb_threads) );
     }
   }
 };
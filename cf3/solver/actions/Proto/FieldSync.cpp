@@ -30,18 +30,48 @@ void FieldSynchronizer::insert(cf3::mesh::Field& f)
 }
 
 void FieldSynchronizer::synchronize()
+{
+  start_synchronize();
+  finish_synchronize();
+}
+
+void FieldSynchronizer::start_synchronize()
 {
   if(common::PE::Comm::instance().is_active())
   {
+    // Group the field names per comm pattern
+    typedef std::map< std::string, std::vector<std::string> > FieldNamesT;
+    FieldNamesT field_names;
     for(FieldsT::iterator field_it = m_fields.begin(); field_it != m_fields.end(); ++field_it)
     {
-      field_it->second->synchronize();
+      const Handle<common::PE::CommPattern>& comm_pattern = field_it->second->comm_pattern();
+      if(is_null(comm_pattern))
+        continue;
+
+      const std::string comm_pattern_path = comm_pattern->uri().path();
+      m_comm_patterns[comm_pattern_path] = comm_pattern;
+      field_names[comm_pattern_path].push_back(field_it->second->name());
+    }
+
+    for(FieldNamesT::iterator names_it = field_names.begin(); names_it != field_names.end(); ++names_it)
+    {
+      m_comm_patterns[names_it->first]->start_synchronize(names_it->second);
     }
   }
 
   m_fields.clear();
 }
 
+void FieldSynchronizer::finish_synchronize()
+{
+  for(CommPatternsT::iterator comm_it = m_comm_patterns.begin(); comm_it != m_comm_patterns.end(); ++comm_it)
+  {
+    comm_it->second->finish_synchronize();
+  }
+
+  m_comm_patterns.clear();
+}
+
 } // namespace Proto
 } // namespace actions
 } // namespace solver
@@ -7,6 +7,8 @@
 #ifndef cf3_solver_actions_Proto_FieldSync_hpp
 #define cf3_solver_actions_Proto_FieldSync_hpp
 
+#include "common/PE/CommPattern.hpp"
+
 #include "mesh/Field.hpp"
 
 /// @file
@@ -31,6 +33,14 @@ public:
   /// Sync fields and clear the list
   void synchronize();
 
+  /// Start a nonblocking sync of the fields and clear the list. Fields sharing a comm pattern
+  /// are batched in a single message per neighbouring cpu. Work that does not touch ghost values
+  /// can be done before calling finish_synchronize.
+  void start_synchronize();
+
+  /// Wait for the sync started with start_synchronize to complete
+  void finish_synchronize();
+
 private:
   FieldSynchronizer();
 
@@ -38,6 +48,10 @@ private:
   // on each cpu.
   typedef std::map< std::string, Handle<mesh::Field> > FieldsT;
   FieldsT m_fields;
+
+  // Comm patterns with a synchronization in progress, sorted on their URI
+  typedef std::map< std::string, Handle<common::PE::CommPattern> > CommPatternsT;
+  CommPatternsT m_comm_patterns;
 };
 
 
@@ -104,9 +104,9 @@ boost::proto::transform< ParsedScalarFunctionTransform >
 
     Real operator()(typename impl::expr_param expr, typename impl::state_param state, typename impl::data_param data) const
     {
-      std::vector<Real> result(1);
+      Real result[1];
       evaluate_function(boost::proto::value(expr), data.coordinates(), result);
-      return result.back();
+      return result[0];
     }
   };
 };
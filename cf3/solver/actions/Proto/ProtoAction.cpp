@@ -40,6 +40,17 @@ struct ProtoAction::Implementation
     m_physical_model(physical_model)
   {
     m_component.options().option(Tags::physical_model()).attach_trigger(boost::bind(&Implementation::trigger_physical_model, this));
+
+    m_component.options().add("nb_threads", 1u)
+      .pretty_name("Number of Threads")
+      .description("Number of threads to use when looping over elements. Requires OpenMP, and all functions used in the expression must be reentrant.")
+      .attach_trigger(boost::bind(&Implementation::trigger_nb_threads, this));
+  }
+
+  void trigger_nb_threads()
+  {
+    if(m_expression)
+      m_expression->set_nb_threads(m_component.options().value<Uint>("nb_threads"));
   }
 
   void trigger_physical_model()
@@ -132,6 +143,7 @@ void ProtoAction::set_expression(const boost::shared_ptr< Expression >& expressi
   m_implementation->m_expression = expression;
   expression->add_options(options());
   m_implementation->trigger_physical_model();
+  m_implementation->trigger_nb_threads();
 }
 
 bool ProtoAction::expression_is_set() const
@@ -10,6 +10,7 @@
 #include "common/Builder.hpp"
 #include "common/OptionList.hpp"
 #include "common/Foreach.hpp"
+#include "common/PE/CommPattern.hpp"
 
 #include "mesh/Field.hpp"
 #include "mesh/Mesh.hpp"
@@ -64,12 +65,27 @@ void SynchronizeFields::config_fields()
 
 void SynchronizeFields::execute()
 {
+  // fields that share a comm pattern are sent together, in one message per neighbouring rank
+  typedef std::map< std::string, std::pair< Handle<PE::CommPattern>, std::vector<std::string> > > BatchesT;
+  BatchesT batches;
+
   boost_foreach(Handle<Field> ptr, m_fields)
   {
     if( is_null(ptr) ) continue; // skip if pointer invalid
 
-    ptr->synchronize();
+    const Handle<PE::CommPattern>& comm_pattern = ptr->comm_pattern();
+    if( is_null(comm_pattern) ) continue; // not parallelized
+
+    std::pair< Handle<PE::CommPattern>, std::vector<std::string> >& batch = batches[comm_pattern->uri().path()];
+    batch.first = comm_pattern;
+    batch.second.push_back(ptr->name());
   }
+
+  for(BatchesT::iterator it = batches.begin(); it != batches.end(); ++it)
+    it->second.first->start_synchronize(it->second.second);
+
+  for(BatchesT::iterator it = batches.begin(); it != batches.end(); ++it)
+    it->second.first->finish_synchronize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
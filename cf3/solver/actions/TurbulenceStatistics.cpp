@@ -6,7 +6,7 @@
 
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
-#include <boost/make_shared.hpp>
+#include <boost/assign/list_of.hpp>
 
 #include "common/Builder.hpp"
 #include "common/OptionList.hpp"
@@ -75,9 +75,12 @@ TurbulenceStatistics::TurbulenceStatistics ( const std::string& name ) :
     
   options().add("file", common::URI())
     .pretty_name("File")
-    .description("Base file name for the probe output files")
+    .description("Base file name for the probe output file, which gets the suffix -probes.cf3ts")
     .mark_basic();
 
+  m_probe_writer = create_static_component<TimeSeriesWriter>("probe_output");
+  m_probe_writer->options().set("parallel", true);
+
   options().add("count", m_count)
     .pretty_name("Count")
     .description("Number of averages made")
@@ -190,25 +193,21 @@ void TurbulenceStatistics::execute()
     }
   }
 
-  // Write the probe data
-  for(Uint my_probe_idx = 0; my_probe_idx != nb_my_probes; ++my_probe_idx)
+  // Buffer the probe data, for all probes of all ranks together
+  if(!m_probe_locations.empty())
   {
-    const Uint probe_begin = my_probe_idx*stride;
-    const Uint probe_end = probe_begin + stride;
-    boost::filesystem::fstream& file = *m_probe_files[my_probe_idx];
-    for(Uint j = probe_begin; j != probe_end; ++j)
-    {
-      if(j != 0)
-        file << " ";
-      file << boost::accumulators::mean(m_means[j]);
-    }
-    
-    for(Uint j = 0; j != stride; ++j)
+    m_probe_row.resize(2*nb_my_probes*stride);
+    Uint col = 0;
+    for(Uint my_probe_idx = 0; my_probe_idx != nb_my_probes; ++my_probe_idx)
     {
-      file << " " << boost::accumulators::rolling_mean(m_rolling_means[j]);
+      const Uint probe_begin = my_probe_idx*stride;
+      const Uint probe_end = probe_begin + stride;
+      for(Uint j = probe_begin; j != probe_end; ++j)
+        m_probe_row[col++] = boost::accumulators::mean(m_means[j]);
+      for(Uint j = probe_begin; j != probe_end; ++j)
+        m_probe_row[col++] = boost::accumulators::rolling_mean(m_rolling_means[j]);
     }
-    
-    file << "\n";
+    m_probe_writer->add_row(m_probe_row);
   }
 
   options().set("count", m_count+1u);
@@ -341,31 +340,31 @@ void TurbulenceStatistics::setup()
       throw common::SetupError(FromHere(), "Probe " + common::to_str(probe_idx) + " was found on " + common::to_str(global_probes_found[probe_idx]) + " CPUs");
   }
 
+  // Init the probe output, with the columns of the probes of this rank
   const common::URI original_uri = options().value<common::URI>("file");
+  m_probe_writer->options().set("file", original_uri.base_path() / (original_uri.base_name() + "-probes.cf3ts"));
+
+  std::vector<std::string> variables;
+  if(m_dim == 2)
+  {
+    variables = boost::assign::list_of("U")("V")("uu")("vv")("uv");
+  }
+  else if(m_dim == 3)
+  {
+    variables = boost::assign::list_of("U")("V")("W")("uu")("vv")("ww")("uv")("uw")("vw");
+  }
 
-  // Init probe files
-  m_probe_files.clear();
+  std::vector<std::string> columns;
   const Uint nb_my_probes = m_probe_nodes.size();
   for(Uint my_idx = 0; my_idx != nb_my_probes; ++my_idx)
   {
-    const Uint probe_idx = m_probe_indices[my_idx];
-    std::string probe_path = (original_uri.base_path() / (original_uri.base_name() + "-probe-" + common::to_str(probe_idx) + original_uri.extension())).path();
-
-    m_probe_files.push_back(boost::make_shared<boost::filesystem::fstream>(probe_path, std::ios_base::out));
-    boost::filesystem::fstream& file = *m_probe_files.back();
-    if(!file)
-      throw common::FileSystemError(FromHere(), "Failed to open file " + probe_path);
-
-    file << "# Probe data for probe " << probe_idx << " at point " << m_probe_locations[probe_idx].transpose() << "\n";
-    if(m_dim == 2)
-    {
-      file << "# U, V, uu, vv, uv, U_rolling, V_rolling, uu_rolling, vv_rolling, uv_rolling\n";
-    }
-    else if(m_dim == 3)
-    {
-      file << "# U, V, W, uu, vv, ww, uv, uw, vw, U_rolling, V_rolling, W_rolling, uu_rolling, vv_rolling, ww_rolling, uv_rolling, uw_rolling, vw_rolling\n";
-    }
+    const std::string prefix = "probe-" + common::to_str(m_probe_indices[my_idx]) + "/";
+    BOOST_FOREACH(const std::string& var, variables)
+      columns.push_back(prefix + var);
+    BOOST_FOREACH(const std::string& var, variables)
+      columns.push_back(prefix + var + "_rolling");
   }
+  m_probe_writer->set_columns(columns);
 
   // Create a field for the statistics data
   m_statistics_field = Handle<mesh::Field>(dictionary->get_child("turbulence_statistics"));
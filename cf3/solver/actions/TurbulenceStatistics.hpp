@@ -18,6 +18,8 @@
 
 #include "mesh/Field.hpp"
 
+#include "solver/TimeSeriesWriter.hpp"
+
 #include "solver/actions/LibActions.hpp"
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +30,11 @@ namespace actions {
 
 ///////////////////////////////////////////////////////////////////////////////////////
 
+/// Computes the mean velocity and Reynolds stresses at every node of a region, and their means and rolling means at probe locations.
+/// The probe values of all ranks are written each time step to a single binary file, through the TimeSeriesWriter child "probe_output",
+/// which can be configured to set the number of time steps between writes. Model::simulate closes it on all ranks at the end
+/// of the run, writing the remaining time steps and the block index. Call close() on probe_output on all ranks when running
+/// the action outside of a model.
 class solver_actions_API TurbulenceStatistics : public common::Action
 {
 public: // functions
@@ -81,7 +88,10 @@ private:
   std::vector<RealVector> m_probe_locations;
   std::vector<Uint> m_probe_nodes;
   std::vector<Uint> m_probe_indices;
-  std::vector< boost::shared_ptr<boost::filesystem::fstream> > m_probe_files;
+  /// Buffered output of the probes
+  Handle<TimeSeriesWriter> m_probe_writer;
+  /// Probe values of the current time step, on this rank
+  std::vector<Real> m_probe_row;
 };
 
 /////////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,8 @@ option( CF3_ENABLE_OPENCL             "Enable OpenCL for GPGPU (if available)"
 
 option( CF3_ENABLE_TCMALLOC           "Google tcmalloc (can be faster, but buggy)"     OFF )
 
+option( CF3_ENABLE_OPENMP             "Enable OpenMP threading (if available)"         OFF )
+
 option( CF3_ENABLE_STDDEBUG           "Enable debug of STL code"                       OFF )
 
 set( CF3_EXTRA_DEFINES "" CACHE STRING "Extra defines or undefines to pass (examples: -DNDEBUG or -UNDEBUG)" )
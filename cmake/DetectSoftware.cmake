@@ -95,6 +95,23 @@ if( CF3_ENABLE_OPENCL AND CF3_ENABLE_GPU )
   coolfluid_set_package( PACKAGE OpenCL DESCRIPTION "gpu computing" VARS OPENCL_LIBRARIES OPENCL_INCLUDE_DIRS QUIET )
 endif()
 
+# OpenMP shared memory threading
+if( CF3_ENABLE_OPENMP )
+  find_package(OpenMP QUIET)
+  coolfluid_log_file( "OPENMP_FOUND: [${OPENMP_FOUND}]" )
+  coolfluid_log_file( "  OpenMP_CXX_FLAGS: [${OpenMP_CXX_FLAGS}]" )
+  if( OPENMP_FOUND )
+    set( CMAKE_C_FLAGS   "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}" )
+    set( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}" )
+    set( CMAKE_EXE_LINKER_FLAGS    "${CMAKE_EXE_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}" )
+    set( CMAKE_SHARED_LINKER_FLAGS "${CMAKE_SHARED_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}" )
+    set( CMAKE_MODULE_LINKER_FLAGS "${CMAKE_MODULE_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}" )
+  endif()
+  coolfluid_set_package( PACKAGE OpenMP DESCRIPTION "shared memory threading" VARS OPENMP_FOUND QUIET )
+else()
+  set( CF3_HAVE_OPENMP OFF CACHE INTERNAL "OpenMP threading disabled" )
+endif()
+
 # cuda support
 if( CF3_ENABLE_CUDA AND CF3_ENABLE_GPU )
   find_package(CUDA)
@@ -11809,6 +11809,13 @@ std::complex<long
 double>nF1
 #endif
 //FUNCTIONPARSER_INSTANTIATE_TYPES
+/* The class itself is instantiated in fparser.cc, which does not see the
+   definition of Optimize() above, so instantiate it here */
+#define FUNCTIONPARSER_INSTANTIATE_OPTIMIZE(type) \
+    template void FunctionParserBase<type>::Optimize();
+FUNCTIONPARSER_INSTANTIATE_D(FUNCTIONPARSER_INSTANTIATE_OPTIMIZE)
+FUNCTIONPARSER_INSTANTIATE_F(FUNCTIONPARSER_INSTANTIATE_OPTIMIZE)
+FUNCTIONPARSER_INSTANTIATE_LD(FUNCTIONPARSER_INSTANTIATE_OPTIMIZE)
 #endif
 
 #endif
@@ -49,6 +49,48 @@ void Data::compute_from_primitive(const RowVector_NEQS& prim)
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+void BatchData::set(const Uint i, const Data& data)
+{
+  cons.row(i) = data.cons.array();
+  gamma[i] = data.gamma;
+  rho[i] = data.rho;
+  u[i] = data.u;
+  H[i] = data.H;
+  c2[i] = data.c2;
+  c[i] = data.c;
+  p[i] = data.p;
+}
+
+void BatchData::get(const Uint i, Data& data) const
+{
+  data.cons = cons.row(i).matrix();
+  data.gamma = gamma[i];
+  data.rho = rho[i];
+  data.u = u[i];
+  data.u2 = u[i]*u[i];
+  data.H = H[i];
+  data.c2 = c2[i];
+  data.c = c[i];
+  data.p = p[i];
+  data.E = H[i] - p[i]/rho[i];
+  data.M = u[i]/c[i];
+}
+
+void BatchData::compute_from_conservative(const BatchArray_NEQS& _cons)
+{
+  // cons: rho, rho*u, rho*E
+  cons = _cons;
+  rho=cons.col(0);
+  u=cons.col(1)/rho;
+  const BatchArray E=cons.col(2)/rho;
+  p=(gamma-1.)*rho*(E - 0.5*u*u);
+  H=E+p/rho;
+  c2=gamma*p/rho;
+  c=c2.sqrt();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // euler1D
 } // euler
 } // physics
@@ -196,6 +196,125 @@ void compute_hlle_flux( const Data& left, const Data& right, const ColVector_NDI
 }
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+void compute_convective_flux( const BatchData& p, const BatchArray_NDIM& normal,
+                              BatchArray_NEQS& flux )
+{
+  const BatchArray un = p.u * normal.col(XX);
+  const BatchArray rho_un = p.rho * un;
+  flux.col(0) = rho_un;
+  flux.col(1) = rho_un * p.u + p.p * normal.col(XX);
+  flux.col(2) = rho_un * p.H;
+}
+
+void compute_convective_wave_speed( const BatchData& p, const BatchArray_NDIM& normal,
+                                    BatchArray& wave_speed )
+{
+  wave_speed = (p.u * normal.col(XX)).abs() + p.c*normal.col(XX).abs();
+}
+
+void compute_rusanov_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                           BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchArray_NEQS left_flux, right_flux;
+  BatchArray left_wave_speed, right_wave_speed;
+  compute_convective_flux( left,  normal, left_flux );
+  compute_convective_flux( right, normal, right_flux );
+  compute_convective_wave_speed( left,  normal, left_wave_speed );
+  compute_convective_wave_speed( right, normal, right_wave_speed );
+  wave_speed = left_wave_speed.max(right_wave_speed);
+  for (Uint eq=0; eq<NEQS; ++eq)
+  {
+    flux.col(eq) = 0.5*(left_flux.col(eq)+right_flux.col(eq)) - 0.5*wave_speed*(right.cons.col(eq)-left.cons.col(eq));
+  }
+}
+
+void compute_roe_average( const BatchData& left, const BatchData& right,
+                          BatchData& roe )
+{
+  const BatchArray sqrt_rhoL = left.rho.abs().sqrt();
+  const BatchArray sqrt_rhoR = right.rho.abs().sqrt();
+  roe.gamma = 0.5*(left.gamma+right.gamma);
+  roe.rho   = sqrt_rhoL*sqrt_rhoR;
+  roe.u     = (sqrt_rhoL*left.u + sqrt_rhoR*right.u) / (sqrt_rhoL + sqrt_rhoR);
+  roe.H     = (sqrt_rhoL*left.H.abs() + sqrt_rhoR*right.H.abs()) / (sqrt_rhoL + sqrt_rhoR);
+  roe.c2    = (roe.gamma-1.)*(roe.H-0.5*roe.u*roe.u);
+  roe.p     = roe.c2 * roe.rho / roe.gamma;
+  roe.c     = roe.c2.sqrt();
+}
+
+void compute_roe_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                       BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  if ((left.rho<0.).any() || (right.rho<0.).any())
+  {
+    throw common::BadValue(FromHere(), "negative density");
+  }
+  BatchData roe;
+  compute_roe_average(left,right,roe);
+
+  // Wave strengths dW
+  const BatchArray drho = (right.rho - left.rho);
+  const BatchArray du   = (right.u   - left.u);
+  const BatchArray dp   = (right.p   - left.p);
+  const BatchArray dW0 = drho - dp/roe.c2;
+  const BatchArray dW1 = 0.5*(dp/roe.c2 + du*roe.rho/roe.c);
+  const BatchArray dW2 = 0.5*(dp/roe.c2 - du*roe.rho/roe.c);
+
+  // Upwind coefficients 0.5*|lambda_k|*dW_k, with the eigenvalues un, un+cn, un-cn
+  const BatchArray un = roe.u * normal.col(XX);
+  const BatchArray cn = roe.c * normal.col(XX);
+  const BatchArray a0 = 0.5*un.abs()*dW0;
+  const BatchArray a1 = 0.5*(un+cn).abs()*dW1;
+  const BatchArray a2 = 0.5*(un-cn).abs()*dW2;
+
+  BatchArray_NEQS flux_left, flux_right;
+  compute_convective_flux(left,normal,flux_left);
+  compute_convective_flux(right,normal,flux_right);
+
+  // Subtract the upwind coefficients times the right eigenvectors
+  flux.col(0) = 0.5*(flux_left.col(0)+flux_right.col(0)) - a0 - a1 - a2;
+  flux.col(1) = 0.5*(flux_left.col(1)+flux_right.col(1)) - a0*roe.u - a1*(roe.u+roe.c) - a2*(roe.u-roe.c);
+  flux.col(2) = 0.5*(flux_left.col(2)+flux_right.col(2)) - a0*(0.5*roe.u*roe.u) - a1*(roe.H+roe.c*roe.u) - a2*(roe.H-roe.c*roe.u);
+
+  compute_convective_wave_speed(roe, normal, wave_speed);
+}
+
+void compute_hlle_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                        BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchData roe;
+  compute_roe_average(left,right,roe);
+
+  // Smallest and largest of the eigenvalues un, un+cn, un-cn
+  const BatchArray un_left  = left.u  * normal.col(XX);
+  const BatchArray un_right = right.u * normal.col(XX);
+  const BatchArray un_roe   = roe.u   * normal.col(XX);
+  const BatchArray cn_left  = left.c  * normal.col(XX);
+  const BatchArray cn_right = right.c * normal.col(XX);
+  const BatchArray cn_roe   = roe.c   * normal.col(XX);
+  const BatchArray wave_speed_left  = un_left.min(un_left+cn_left).min(un_left-cn_left)
+                                       .min(un_roe.min(un_roe+cn_roe).min(un_roe-cn_roe));
+  const BatchArray wave_speed_right = un_right.max(un_right+cn_right).max(un_right-cn_right)
+                                       .max(un_roe.max(un_roe+cn_roe).max(un_roe-cn_roe));
+
+  BatchArray_NEQS flux_left, flux_right;
+  compute_convective_flux(left,  normal, flux_left );
+  compute_convective_flux(right, normal, flux_right);
+
+  // All cases are computed, and the flux is selected per face
+  for (Uint eq=0; eq<NEQS; ++eq)
+  {
+    BatchArray intermediate = (wave_speed_right*flux_left.col(eq)-wave_speed_left*flux_right.col(eq));
+    intermediate += (wave_speed_left*wave_speed_right)*(right.cons.col(eq)-left.cons.col(eq));
+    intermediate /= (wave_speed_right-wave_speed_left);
+    flux.col(eq) = (wave_speed_left >= 0.).select( flux_left.col(eq),
+                   (wave_speed_right <= 0.).select( flux_right.col(eq), intermediate ) );
+  }
+  compute_convective_wave_speed(roe,normal,wave_speed);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // euler1D
 } // euler
 } // physics
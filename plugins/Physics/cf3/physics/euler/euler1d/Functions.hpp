@@ -63,6 +63,34 @@ void compute_roe_flux( const Data& left, const Data& right, const ColVector_NDIM
 void compute_hlle_flux( const Data& left, const Data& right, const ColVector_NDIM& normal,
                         RowVector_NEQS& flux, Real& wave_speed );
 
+// ------- Batched functions ---------
+// Each computes the same as the function above with the same name, for the
+// BATCH_SIZE faces of a batch at once. Entry i of all arrays belongs to face i.
+
+/// @brief Convective flux in conservative form, for a batch of faces
+void compute_convective_flux( const BatchData& p, const BatchArray_NDIM& normal,
+                              BatchArray_NEQS& flux );
+
+/// @brief Maximum absolute wave speed, for a batch of faces
+void compute_convective_wave_speed( const BatchData& p, const BatchArray_NDIM& normal,
+                                    BatchArray& wave_speed );
+
+/// @brief Roe average, for a batch of faces
+void compute_roe_average( const BatchData& left, const BatchData& right,
+                          BatchData& roe );
+
+/// @brief Rusanov Approximate Riemann solver, for a batch of faces
+void compute_rusanov_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                           BatchArray_NEQS& flux, BatchArray& wave_speed );
+
+/// @brief Roe Approximate Riemann solver, for a batch of faces
+void compute_roe_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                       BatchArray_NEQS& flux, BatchArray& wave_speed );
+
+/// @brief HLLE Approximate Riemann solver, for a batch of faces
+void compute_hlle_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                        BatchArray_NEQS& flux, BatchArray& wave_speed );
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 } // euler1D
@@ -53,6 +53,51 @@ void Data::compute_from_primitive(const RowVector_NEQS& prim)
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+void BatchData::set(const Uint i, const Data& data)
+{
+  cons.row(i) = data.cons.array();
+  gamma[i] = data.gamma;
+  rho[i] = data.rho;
+  U.row(i) = data.U.transpose().array();
+  U2[i] = data.U2;
+  H[i] = data.H;
+  c2[i] = data.c2;
+  c[i] = data.c;
+  p[i] = data.p;
+}
+
+void BatchData::get(const Uint i, Data& data) const
+{
+  data.cons = cons.row(i).matrix();
+  data.gamma = gamma[i];
+  data.rho = rho[i];
+  data.U = U.row(i).matrix().transpose();
+  data.U2 = U2[i];
+  data.H = H[i];
+  data.c2 = c2[i];
+  data.c = c[i];
+  data.p = p[i];
+  data.E = H[i] - p[i]/rho[i];
+  data.M = std::sqrt(U2[i])/c[i];
+}
+
+void BatchData::compute_from_conservative(const BatchArray_NEQS& _cons)
+{
+  // cons: rho, rho*u, rho*v, rho*E
+  cons = _cons;
+  rho=cons.col(0);
+  U.col(XX)=cons.col(1)/rho;
+  U.col(YY)=cons.col(2)/rho;
+  const BatchArray E=cons.col(3)/rho;
+  U2=U.col(XX)*U.col(XX) + U.col(YY)*U.col(YY);
+  p=(gamma-1.)*rho*(E - 0.5*U2);
+  H=E+p/rho;
+  c2=gamma*p/rho;
+  c=c2.sqrt();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // euler2d
 } // euler
 } // physics
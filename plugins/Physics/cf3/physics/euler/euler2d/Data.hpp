@@ -56,6 +56,38 @@ struct Data
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+/// @brief Data of BATCH_SIZE states, stored per variable for the batched functions
+///
+/// Only the variables used by the batched Riemann solvers are stored.
+/// Entry i of each array belongs to the i-th face of the batch.
+struct BatchData
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+  BatchArray_NEQS cons;
+  BatchArray gamma;         ///< specific heat ratio
+  BatchArray rho;           ///< density
+  BatchArray_NDIM U;        ///< velocity
+  BatchArray U2;            ///< velocity squared
+  BatchArray H;             ///< specific enthalpy
+  BatchArray c2;            ///< square of speed of sound
+  BatchArray c;             ///< speed of sound
+  BatchArray p;             ///< pressure
+
+  /// @brief Copy a single state to entry i of the batch
+  void set(const Uint i, const Data& data);
+
+  /// @brief Copy entry i of the batch to a single state
+  /// @note R, T and coords are not stored in the batch, and are left unchanged
+  void get(const Uint i, Data& data) const;
+
+  /// @brief Compute the data given conservative states
+  /// @pre gamma must have been set
+  void compute_from_conservative(const BatchArray_NEQS& cons);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // euler2d
 } // euler
 } // physics
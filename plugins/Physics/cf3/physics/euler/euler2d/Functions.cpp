@@ -226,6 +226,134 @@ void compute_jacobian_primitive_wrt_conservative( const Data& p, Matrix_NEQSxNEQ
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+void compute_convective_flux( const BatchData& p, const BatchArray_NDIM& normal,
+                              BatchArray_NEQS& flux )
+{
+  const BatchArray un = p.U.col(XX)*normal.col(XX) + p.U.col(YY)*normal.col(YY);
+  const BatchArray rho_un = p.rho * un;
+  flux.col(0) = rho_un;
+  flux.col(1) = rho_un * p.U.col(XX) + p.p * normal.col(XX);
+  flux.col(2) = rho_un * p.U.col(YY) + p.p * normal.col(YY);
+  flux.col(3) = rho_un * p.H;
+}
+
+void compute_convective_wave_speed( const BatchData& p, const BatchArray_NDIM& normal,
+                                    BatchArray& wave_speed )
+{
+  wave_speed = (p.U.col(XX)*normal.col(XX) + p.U.col(YY)*normal.col(YY)).abs() + p.c;
+}
+
+void compute_rusanov_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                           BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchArray_NEQS left_flux, right_flux;
+  BatchArray left_wave_speed, right_wave_speed;
+  compute_convective_flux( left,  normal, left_flux );
+  compute_convective_flux( right, normal, right_flux );
+  compute_convective_wave_speed( left,  normal, left_wave_speed );
+  compute_convective_wave_speed( right, normal, right_wave_speed );
+  wave_speed = left_wave_speed.max(right_wave_speed);
+  for (Uint eq=0; eq<NEQS; ++eq)
+  {
+    flux.col(eq) = 0.5*(left_flux.col(eq)+right_flux.col(eq)) - 0.5*wave_speed*(right.cons.col(eq)-left.cons.col(eq));
+  }
+}
+
+void compute_roe_average( const BatchData& left, const BatchData& right,
+                          BatchData& roe )
+{
+  const BatchArray sqrt_rhoL = left.rho.sqrt();
+  const BatchArray sqrt_rhoR = right.rho.sqrt();
+  roe.gamma = 0.5*(left.gamma+right.gamma);
+  roe.rho   = sqrt_rhoL*sqrt_rhoR;
+  for (Uint d=0; d<NDIM; ++d)
+  {
+    roe.U.col(d) = (sqrt_rhoL*left.U.col(d) + sqrt_rhoR*right.U.col(d)) / (sqrt_rhoL + sqrt_rhoR);
+  }
+  roe.H     = (sqrt_rhoL*left.H + sqrt_rhoR*right.H) / (sqrt_rhoL + sqrt_rhoR);
+  roe.U2    = roe.U.col(XX)*roe.U.col(XX) + roe.U.col(YY)*roe.U.col(YY);
+  roe.c2    = (roe.gamma-1.)*(roe.H-0.5*roe.U2);
+  roe.p     = roe.c2 * roe.rho / roe.gamma;
+  roe.c     = roe.c2.sqrt();
+}
+
+void compute_roe_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                       BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchData roe;
+  compute_roe_average(left,right,roe);
+
+  const BatchArray& nx = normal.col(XX);
+  const BatchArray& ny = normal.col(YY);
+  const BatchArray& u  = roe.U.col(XX);
+  const BatchArray& v  = roe.U.col(YY);
+
+  // Wave strengths dW
+  const BatchArray dUx  = right.U.col(XX) - left.U.col(XX);
+  const BatchArray dUy  = right.U.col(YY) - left.U.col(YY);
+  const BatchArray drho = (right.rho - left.rho);
+  const BatchArray dp   = (right.p   - left.p);
+  const BatchArray dun  = dUx*nx + dUy*ny;
+  const BatchArray dus  = dUx*ny - dUy*nx;
+  const BatchArray dW0 = drho - dp/roe.c2;
+  const BatchArray dW1 = dus * roe.rho;
+  const BatchArray dW2 = 0.5*(dp/roe.c2 + dun*roe.rho/roe.c);
+  const BatchArray dW3 = 0.5*(dp/roe.c2 - dun*roe.rho/roe.c);
+
+  // Upwind coefficients 0.5*|lambda_k|*dW_k, with the eigenvalues un, un, un+c, un-c
+  const BatchArray un = u*nx + v*ny;
+  const BatchArray us = u*ny - v*nx;
+  const BatchArray a0 = 0.5*un.abs()*dW0;
+  const BatchArray a1 = 0.5*un.abs()*dW1;
+  const BatchArray a2 = 0.5*(un+roe.c).abs()*dW2;
+  const BatchArray a3 = 0.5*(un-roe.c).abs()*dW3;
+
+  BatchArray_NEQS flux_left, flux_right;
+  compute_convective_flux(left,normal,flux_left);
+  compute_convective_flux(right,normal,flux_right);
+
+  // Subtract the upwind coefficients times the right eigenvectors
+  flux.col(0) = 0.5*(flux_left.col(0)+flux_right.col(0)) - a0 - a2 - a3;
+  flux.col(1) = 0.5*(flux_left.col(1)+flux_right.col(1)) - a0*u - a1*ny - a2*(u+roe.c*nx) - a3*(u-roe.c*nx);
+  flux.col(2) = 0.5*(flux_left.col(2)+flux_right.col(2)) - a0*v + a1*nx - a2*(v+roe.c*ny) - a3*(v-roe.c*ny);
+  flux.col(3) = 0.5*(flux_left.col(3)+flux_right.col(3)) - a0*(0.5*roe.U2) - a1*us - a2*(roe.H+roe.c*un) - a3*(roe.H-roe.c*un);
+
+  compute_convective_wave_speed(roe, normal, wave_speed);
+}
+
+void compute_hlle_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                        BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchData roe;
+  compute_roe_average(left,right,roe);
+
+  // Smallest and largest of the eigenvalues un, un, un+c, un-c
+  const BatchArray un_left  = left.U.col(XX)*normal.col(XX)  + left.U.col(YY)*normal.col(YY);
+  const BatchArray un_right = right.U.col(XX)*normal.col(XX) + right.U.col(YY)*normal.col(YY);
+  const BatchArray un_roe   = roe.U.col(XX)*normal.col(XX)   + roe.U.col(YY)*normal.col(YY);
+  const BatchArray wave_speed_left  = un_left.min(un_left+left.c).min(un_left-left.c)
+                                       .min(un_roe.min(un_roe+roe.c).min(un_roe-roe.c));
+  const BatchArray wave_speed_right = un_right.max(un_right+right.c).max(un_right-right.c)
+                                       .max(un_roe.max(un_roe+roe.c).max(un_roe-roe.c));
+
+  BatchArray_NEQS flux_left, flux_right;
+  compute_convective_flux(left,  normal, flux_left );
+  compute_convective_flux(right, normal, flux_right);
+
+  // All cases are computed, and the flux is selected per face
+  for (Uint eq=0; eq<NEQS; ++eq)
+  {
+    BatchArray intermediate = (wave_speed_right*flux_left.col(eq)-wave_speed_left*flux_right.col(eq));
+    intermediate += (wave_speed_left*wave_speed_right)*(right.cons.col(eq)-left.cons.col(eq));
+    intermediate /= (wave_speed_right-wave_speed_left);
+    flux.col(eq) = (wave_speed_left >= 0.).select( flux_left.col(eq),
+                   (wave_speed_right <= 0.).select( flux_right.col(eq), intermediate ) );
+  }
+  compute_convective_wave_speed(roe,normal,wave_speed);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // euler2d
 } // euler
 } // physics
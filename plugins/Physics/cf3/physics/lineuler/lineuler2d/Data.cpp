@@ -41,6 +41,39 @@ void Data::compute_from_primitive(const RowVector_NEQS& prim)
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+void BatchData::set(const Uint i, const Data& data)
+{
+  cons.row(i) = data.cons.array();
+  U0.row(i) = data.U0.transpose().array();
+  rho0[i] = data.rho0;
+  c0[i] = data.c0;
+  U.row(i) = data.U.transpose().array();
+  p[i] = data.p;
+}
+
+void BatchData::get(const Uint i, Data& data) const
+{
+  data.cons = cons.row(i).matrix();
+  data.U0 = U0.row(i).matrix().transpose();
+  data.rho0 = rho0[i];
+  data.c0 = c0[i];
+  data.rho = cons(i,0);
+  data.U = U.row(i).matrix().transpose();
+  data.U2 = data.U.norm();
+  data.p = p[i];
+}
+
+void BatchData::compute_from_conservative(const BatchArray_NEQS& _cons)
+{
+  // cons: rho, rho0 U, p
+  cons = _cons;
+  U.col(XX)=cons.col(1)/rho0;
+  U.col(YY)=cons.col(2)/rho0;
+  p=cons.col(3);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // lineuler2d
 } // lineuler
 } // physics
@@ -57,6 +57,40 @@ struct Data
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+/// @brief Data of BATCH_SIZE states, stored per variable for the batched functions
+///
+/// Only the variables used by the batched Riemann solvers are stored.
+/// Entry i of each array belongs to the i-th face of the batch.
+struct BatchData
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW  ///< storing fixed-sized Eigen structures
+
+  BatchArray_NEQS cons;
+
+  /// @name Mean flow
+  //@{
+  BatchArray_NDIM U0;
+  BatchArray rho0;
+  BatchArray c0;
+  //@}
+
+  BatchArray_NDIM U;        ///< velocity
+  BatchArray p;             ///< pressure
+
+  /// @brief Copy a single state to entry i of the batch
+  void set(const Uint i, const Data& data);
+
+  /// @brief Copy entry i of the batch to a single state
+  /// @note gamma, p0, the mean flow gradients and coords are not stored in the batch, and are left unchanged
+  void get(const Uint i, Data& data) const;
+
+  /// @brief Compute the data given conservative states
+  /// @pre the mean flow must have been set
+  void compute_from_conservative(const BatchArray_NEQS& cons);
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 } // lineuler2d
 } // lineuler
 } // physics
@@ -195,6 +195,79 @@ void char_to_cons(const RowVector_NEQS& characteristic, const ColVector_NDIM& ch
   press =  0.5*c0*A;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+void compute_convective_flux( const BatchData& p, const BatchArray_NDIM& normal,
+                              BatchArray_NEQS& flux )
+{
+  const BatchArray u0n = p.U0.col(XX)*normal.col(XX) + p.U0.col(YY)*normal.col(YY);
+  const BatchArray un  = p.U.col(XX)*normal.col(XX)  + p.U.col(YY)*normal.col(YY);
+
+  flux.col(0) = u0n*p.cons.col(0) + p.rho0*un;
+  flux.col(1) = u0n*p.cons.col(1) + p.p*normal.col(XX);
+  flux.col(2) = u0n*p.cons.col(2) + p.p*normal.col(YY);
+  flux.col(3) = u0n*p.cons.col(3) + p.rho0*un*p.c0*p.c0;
+}
+
+void compute_convective_wave_speed( const BatchData& p, const BatchArray_NDIM& normal,
+                                    BatchArray& wave_speed )
+{
+  wave_speed = (p.U0.col(XX)*normal.col(XX) + p.U0.col(YY)*normal.col(YY)).abs() + p.c0;
+}
+
+void compute_rusanov_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                           BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchArray_NEQS left_flux, right_flux;
+  compute_convective_flux( left,  normal, left_flux );
+  compute_convective_flux( right, normal, right_flux);
+  compute_convective_wave_speed( left, normal, wave_speed );
+  for (Uint eq=0; eq<NEQS; ++eq)
+  {
+    flux.col(eq) = 0.5*(left_flux.col(eq)+right_flux.col(eq)) - 0.5*wave_speed*(right.cons.col(eq)-left.cons.col(eq));
+  }
+}
+
+void compute_cir_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                       BatchArray_NEQS& flux, BatchArray& wave_speed )
+{
+  BatchArray_NEQS flux_left, flux_right;
+  compute_convective_flux(left, normal,flux_left);
+  compute_convective_flux(right,normal,flux_right);
+
+  // Entries of the absolute flux jacobian of the left mean flow, as in compute_absolute_flux_jacobian()
+  const BatchArray& nx = normal.col(XX);
+  const BatchArray& ny = normal.col(YY);
+  const BatchArray& c0 = left.c0;
+  const BatchArray u0n = left.U0.col(XX)*nx + left.U0.col(YY)*ny;
+  const BatchArray inv_2c  = 0.5/c0;
+  const BatchArray inv_2c2 = 0.5/(c0*c0);
+  const BatchArray nx2 = nx*nx;
+  const BatchArray ny2 = ny*ny;
+  const BatchArray absu0n = u0n.abs();
+  const BatchArray cpu = (c0+u0n).abs();
+  const BatchArray cmu = (c0-u0n).abs();
+  const BatchArray plus  = cmu + cpu;
+  const BatchArray minus = cpu - cmu;
+  const BatchArray pm2u  = plus - 2*absu0n;
+
+  const BatchArray d0 = right.cons.col(0)-left.cons.col(0);
+  const BatchArray d1 = right.cons.col(1)-left.cons.col(1);
+  const BatchArray d2 = right.cons.col(2)-left.cons.col(2);
+  const BatchArray d3 = right.cons.col(3)-left.cons.col(3);
+
+  flux.col(0) = 0.5*(flux_left.col(0)+flux_right.col(0))
+      - 0.5*( absu0n*d0 + (nx*minus)*inv_2c*d1 + (ny*minus)*inv_2c*d2 + pm2u*inv_2c2*d3 );
+  flux.col(1) = 0.5*(flux_left.col(1)+flux_right.col(1))
+      - 0.5*( (2*ny2*absu0n + nx2*plus)*0.5*d1 + (nx*ny*pm2u)*0.5*d2 + (nx*minus)*inv_2c*d3 );
+  flux.col(2) = 0.5*(flux_left.col(2)+flux_right.col(2))
+      - 0.5*( (nx*ny*pm2u)*0.5*d1 + (2*nx2*absu0n + ny2*plus)*0.5*d2 + (ny*minus)*inv_2c*d3 );
+  flux.col(3) = 0.5*(flux_left.col(3)+flux_right.col(3))
+      - 0.5*( (c0*nx*minus)*0.5*d1 + (c0*ny*minus)*0.5*d2 + plus*0.5*d3 );
+
+  compute_convective_wave_speed(left,normal,wave_speed);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 } // lineuler2d
@@ -73,6 +73,26 @@ void compute_rusanov_flux( const Data& left, const Data& right, const ColVector_
 void compute_cir_flux( const Data& left, const Data& right, const ColVector_NDIM& normal,
                        RowVector_NEQS& flux, Real& wave_speed );
 
+// ------- Batched functions ---------
+// Each computes the same as the function above with the same name, for the
+// BATCH_SIZE faces of a batch at once. Entry i of all arrays belongs to face i.
+
+/// @brief Convective flux in conservative form, for a batch of faces
+void compute_convective_flux( const BatchData& p, const BatchArray_NDIM& normal,
+                              BatchArray_NEQS& flux );
+
+/// @brief Maximum absolute wave speed, for a batch of faces
+void compute_convective_wave_speed( const BatchData& p, const BatchArray_NDIM& normal,
+                                    BatchArray& wave_speed );
+
+/// @brief Rusanov Approximate Riemann solver, for a batch of faces
+void compute_rusanov_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                           BatchArray_NEQS& flux, BatchArray& wave_speed );
+
+/// @brief CIR Riemann solver, for a batch of faces
+void compute_cir_flux( const BatchData& left, const BatchData& right, const BatchArray_NDIM& normal,
+                       BatchArray_NEQS& flux, BatchArray& wave_speed );
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 } // lineuler2d
@@ -25,6 +25,10 @@ namespace lineuler2d {
   typedef MatrixTypes<NDIM,NEQS>::Matrix_NDIMxNEQS     Matrix_NDIMxNEQS;
   typedef MatrixTypes<NDIM,NEQS>::Matrix_NDIMxNDIM     Matrix_NDIMxNDIM;
 
+  typedef BatchTypes<NDIM,NEQS>::Array                 BatchArray;
+  typedef BatchTypes<NDIM,NEQS>::Array_NDIM            BatchArray_NDIM;
+  typedef BatchTypes<NDIM,NEQS>::Array_NEQS            BatchArray_NEQS;
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 
 } // lineuler1D
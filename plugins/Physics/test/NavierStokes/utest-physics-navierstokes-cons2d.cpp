@@ -9,11 +9,14 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include "math/Defs.hpp"
+
 #include "cf3/common/Log.hpp"
 #include "cf3/common/Core.hpp"
 #include "cf3/common/Environment.hpp"
 
 #include "cf3/physics/navierstokes/navierstokes2d/Functions.hpp"
+#include "cf3/physics/euler/euler2d/Functions.hpp"
 
 using namespace cf3;
 using namespace cf3::common;
@@ -47,6 +50,43 @@ BOOST_AUTO_TEST_CASE( test_navierstokes2d )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( test_navierstokes2d_convective_batch )
+{
+  // The convective part of Navier-Stokes uses the batched Euler kernels
+  Data pL[physics::BATCH_SIZE], pR[physics::BATCH_SIZE];
+  physics::euler::euler2d::BatchData batch_left, batch_right;
+  physics::euler::euler2d::BatchArray_NDIM batch_normal;
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    pL[i].gamma=1.4;  pR[i].gamma=1.4;
+    pL[i].R=287.05;   pR[i].R=287.05;
+    RowVector_NEQS prim_left, prim_right;
+    prim_left  << 1.2, 20.*i, 5., 101300.;     pL[i].compute_from_primitive(prim_left);
+    prim_right << 1.1, -10., 15.*i, 98000.;    pR[i].compute_from_primitive(prim_right);
+    batch_left.set(i,pL[i]);
+    batch_right.set(i,pR[i]);
+    batch_normal(i,XX) = std::cos(0.5*i);
+    batch_normal(i,YY) = std::sin(0.5*i);
+  }
+
+  physics::euler::euler2d::BatchArray_NEQS batch_flux;
+  physics::euler::euler2d::BatchArray batch_wave_speed;
+  physics::euler::euler2d::compute_roe_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+
+  RowVector_NEQS flux;
+  Real wave_speed;
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    ColVector_NDIM normal = batch_normal.row(i).transpose().matrix();
+    physics::euler::euler2d::compute_roe_flux( pL[i], pR[i], normal, flux, wave_speed );
+    for (Uint eq=0; eq<NEQS; ++eq)
+      BOOST_CHECK_SMALL( batch_flux(i,eq) - flux[eq], 1e-12*(1.+std::abs(flux[eq])) );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,328 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of scalar versus batched Riemann solvers"
+
+#include <cmath>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+
+#include "math/Defs.hpp"
+
+#include "common/CF.hpp"
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+#include "cf3/physics/euler/euler1d/Functions.hpp"
+#include "cf3/physics/euler/euler2d/Functions.hpp"
+#include "cf3/physics/navierstokes/navierstokes2d/Data.hpp"
+#include "cf3/physics/lineuler/lineuler2d/Functions.hpp"
+
+using namespace cf3;
+using namespace cf3::physics;
+using namespace Tools::Testing;
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Number of faces, multiple of the batch size
+#define NFACES 262144
+
+/// Left and right states of all faces, stored per face and per batch of faces
+template <typename DATA, typename BATCH_DATA, typename NORMAL, typename BATCH_NORMAL>
+struct Faces
+{
+  std::vector<DATA, Eigen::aligned_allocator<DATA> > left;
+  std::vector<DATA, Eigen::aligned_allocator<DATA> > right;
+  std::vector<NORMAL, Eigen::aligned_allocator<NORMAL> > normal;
+
+  std::vector<BATCH_DATA, Eigen::aligned_allocator<BATCH_DATA> > batch_left;
+  std::vector<BATCH_DATA, Eigen::aligned_allocator<BATCH_DATA> > batch_right;
+  std::vector<BATCH_NORMAL, Eigen::aligned_allocator<BATCH_NORMAL> > batch_normal;
+
+  Faces() : left(NFACES), right(NFACES), normal(NFACES),
+    batch_left(NFACES/BATCH_SIZE), batch_right(NFACES/BATCH_SIZE), batch_normal(NFACES/BATCH_SIZE) {}
+
+  /// Copy the per-face states into the batches
+  void fill_batches()
+  {
+    for (Uint f=0; f<NFACES; ++f)
+    {
+      const Uint b = f/BATCH_SIZE;
+      const Uint i = f%BATCH_SIZE;
+      batch_left[b].set(i, left[f]);
+      batch_right[b].set(i, right[f]);
+      batch_normal[b].row(i) = normal[f].transpose().array();
+    }
+  }
+};
+
+/// Normal of face f, rotating over all directions
+template <typename NORMAL>
+void set_normal(const Uint f, NORMAL& normal)
+{
+  const Real angle = 0.001*f;
+  if (normal.size() == 1)
+  {
+    normal[XX] = (f%2 ? -1. : 1.);
+  }
+  else
+  {
+    normal[XX] = std::cos(angle);
+    normal[YY] = std::sin(angle);
+  }
+}
+
+typedef Faces<euler::euler1d::Data, euler::euler1d::BatchData,
+              euler::euler1d::ColVector_NDIM, euler::euler1d::BatchArray_NDIM> Euler1DFaces;
+typedef Faces<euler::euler2d::Data, euler::euler2d::BatchData,
+              euler::euler2d::ColVector_NDIM, euler::euler2d::BatchArray_NDIM> Euler2DFaces;
+typedef Faces<navierstokes::navierstokes2d::Data, euler::euler2d::BatchData,
+              euler::euler2d::ColVector_NDIM, euler::euler2d::BatchArray_NDIM> NavierStokes2DFaces;
+typedef Faces<lineuler::lineuler2d::Data, lineuler::lineuler2d::BatchData,
+              lineuler::lineuler2d::ColVector_NDIM, lineuler::lineuler2d::BatchArray_NDIM> LinEuler2DFaces;
+
+/// Initialize Euler or Navier-Stokes faces with varying sub- and supersonic states
+template <typename FACES, typename RowVector_NEQS>
+void init_euler_faces(FACES& faces)
+{
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    faces.left[f].gamma = 1.4;   faces.right[f].gamma = 1.4;
+    faces.left[f].R = 287.05;    faces.right[f].R = 287.05;
+    RowVector_NEQS prim_left, prim_right;
+    prim_left.setConstant(50.+(f%7)*100.);   prim_right.setConstant(-30.-(f%5)*100.);
+    prim_left[0]  = 1.2+0.1*(f%3);            prim_right[0] = 1.1+0.2*(f%2);
+    prim_left[prim_left.size()-1] = 101300.;  prim_right[prim_right.size()-1] = 90000.+(f%11)*1000.;
+    faces.left[f].compute_from_primitive(prim_left);
+    faces.right[f].compute_from_primitive(prim_right);
+    set_normal(f, faces.normal[f]);
+  }
+  faces.fill_batches();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( RiemannBatchBenchmarkSuite, TimedTestFixture )
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler1d_roe_scalar )
+{
+  Euler1DFaces faces;
+  init_euler_faces<Euler1DFaces,euler::euler1d::RowVector_NEQS>(faces);
+  euler::euler1d::RowVector_NEQS flux, sum; sum.setZero();
+  Real wave_speed;
+
+  restart_timer();
+
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    euler::euler1d::compute_roe_flux(faces.left[f], faces.right[f], faces.normal[f], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler1d_roe_batch )
+{
+  Euler1DFaces faces;
+  init_euler_faces<Euler1DFaces,euler::euler1d::RowVector_NEQS>(faces);
+  euler::euler1d::BatchArray_NEQS flux, sum; sum.setZero();
+  euler::euler1d::BatchArray wave_speed;
+
+  restart_timer();
+
+  for (Uint b=0; b<NFACES/BATCH_SIZE; ++b)
+  {
+    euler::euler1d::compute_roe_flux(faces.batch_left[b], faces.batch_right[b], faces.batch_normal[b], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler2d_roe_scalar )
+{
+  Euler2DFaces faces;
+  init_euler_faces<Euler2DFaces,euler::euler2d::RowVector_NEQS>(faces);
+  euler::euler2d::RowVector_NEQS flux, sum; sum.setZero();
+  Real wave_speed;
+
+  restart_timer();
+
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    euler::euler2d::compute_roe_flux(faces.left[f], faces.right[f], faces.normal[f], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler2d_roe_batch )
+{
+  Euler2DFaces faces;
+  init_euler_faces<Euler2DFaces,euler::euler2d::RowVector_NEQS>(faces);
+  euler::euler2d::BatchArray_NEQS flux, sum; sum.setZero();
+  euler::euler2d::BatchArray wave_speed;
+
+  restart_timer();
+
+  for (Uint b=0; b<NFACES/BATCH_SIZE; ++b)
+  {
+    euler::euler2d::compute_roe_flux(faces.batch_left[b], faces.batch_right[b], faces.batch_normal[b], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler2d_hlle_scalar )
+{
+  Euler2DFaces faces;
+  init_euler_faces<Euler2DFaces,euler::euler2d::RowVector_NEQS>(faces);
+  euler::euler2d::RowVector_NEQS flux, sum; sum.setZero();
+  Real wave_speed;
+
+  restart_timer();
+
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    euler::euler2d::compute_hlle_flux(faces.left[f], faces.right[f], faces.normal[f], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( euler2d_hlle_batch )
+{
+  Euler2DFaces faces;
+  init_euler_faces<Euler2DFaces,euler::euler2d::RowVector_NEQS>(faces);
+  euler::euler2d::BatchArray_NEQS flux, sum; sum.setZero();
+  euler::euler2d::BatchArray wave_speed;
+
+  restart_timer();
+
+  for (Uint b=0; b<NFACES/BATCH_SIZE; ++b)
+  {
+    euler::euler2d::compute_hlle_flux(faces.batch_left[b], faces.batch_right[b], faces.batch_normal[b], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( navierstokes2d_rusanov_scalar )
+{
+  NavierStokes2DFaces faces;
+  init_euler_faces<NavierStokes2DFaces,navierstokes::navierstokes2d::RowVector_NEQS>(faces);
+  euler::euler2d::RowVector_NEQS flux, sum; sum.setZero();
+  Real wave_speed;
+
+  restart_timer();
+
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    euler::euler2d::compute_rusanov_flux(faces.left[f], faces.right[f], faces.normal[f], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( navierstokes2d_rusanov_batch )
+{
+  NavierStokes2DFaces faces;
+  init_euler_faces<NavierStokes2DFaces,navierstokes::navierstokes2d::RowVector_NEQS>(faces);
+  euler::euler2d::BatchArray_NEQS flux, sum; sum.setZero();
+  euler::euler2d::BatchArray wave_speed;
+
+  restart_timer();
+
+  for (Uint b=0; b<NFACES/BATCH_SIZE; ++b)
+  {
+    euler::euler2d::compute_rusanov_flux(faces.batch_left[b], faces.batch_right[b], faces.batch_normal[b], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Initialize linearized Euler faces with varying mean flows and perturbations
+void init_lineuler_faces(LinEuler2DFaces& faces)
+{
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    lineuler::lineuler2d::Data& left = faces.left[f];
+    lineuler::lineuler2d::Data& right = faces.right[f];
+    left.gamma = 1.4;                               right.gamma = left.gamma;
+    left.U0 << 0.1*(f%5), -0.05*(f%3);              right.U0    = left.U0;
+    left.rho0 = 1.+0.01*(f%7);                      right.rho0  = left.rho0;
+    left.p0 = 1.;                                   right.p0    = left.p0;
+    left.c0 = std::sqrt(left.gamma*left.p0/left.rho0); right.c0 = left.c0;
+    lineuler::lineuler2d::RowVector_NEQS cons_left, cons_right;
+    cons_left  << 0.1, 0.01*(f%13), 0.02, 0.3;
+    cons_right << 0.05*(f%3), 0.1, -0.01*(f%7), 0.2;
+    left.compute_from_conservative(cons_left);
+    right.compute_from_conservative(cons_right);
+    set_normal(f, faces.normal[f]);
+  }
+  faces.fill_batches();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( lineuler2d_cir_scalar )
+{
+  LinEuler2DFaces faces;
+  init_lineuler_faces(faces);
+  lineuler::lineuler2d::RowVector_NEQS flux, sum; sum.setZero();
+  Real wave_speed;
+
+  restart_timer();
+
+  for (Uint f=0; f<NFACES; ++f)
+  {
+    lineuler::lineuler2d::compute_cir_flux(faces.left[f], faces.right[f], faces.normal[f], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( lineuler2d_cir_batch )
+{
+  LinEuler2DFaces faces;
+  init_lineuler_faces(faces);
+  lineuler::lineuler2d::BatchArray_NEQS flux, sum; sum.setZero();
+  lineuler::lineuler2d::BatchArray wave_speed;
+
+  restart_timer();
+
+  for (Uint b=0; b<NFACES/BATCH_SIZE; ++b)
+  {
+    lineuler::lineuler2d::compute_cir_flux(faces.batch_left[b], faces.batch_right[b], faces.batch_normal[b], flux, wave_speed);
+    sum += flux;
+  }
+  BOOST_CHECK(sum.sum() == sum.sum());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+///////////////////////////////////////////////////////////////////////////////
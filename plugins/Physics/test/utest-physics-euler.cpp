@@ -15,6 +15,7 @@
 #include "cf3/common/Log.hpp"
 #include "cf3/common/Core.hpp"
 #include "cf3/common/Environment.hpp"
+#include "cf3/solver/RiemannSolver.hpp"
 #include "cf3/physics/euler/euler1d/Functions.hpp"
 #include "cf3/physics/euler/euler2d/Functions.hpp"
 
@@ -25,6 +26,38 @@ using namespace cf3::physics::euler;
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Check that a batched result in entry i matches the scalar result
+template <typename BatchT, typename ScalarT>
+void check_batch_entry(const BatchT& batch, const Uint i, const ScalarT& scalar)
+{
+  for (Uint eq=0; eq<(Uint)scalar.size(); ++eq)
+  {
+    BOOST_CHECK_SMALL( batch(i,eq) - scalar[eq], 1e-12*(1.+std::abs(scalar[eq])) );
+  }
+}
+
+/// Riemann solver that only implements the single face flux, to test the default batched flux
+class ScalarRoe : public solver::RiemannSolver<euler2d::Data,euler2d::NDIM,euler2d::NEQS,euler2d::BatchData>
+{
+public:
+  ScalarRoe(const std::string& name) : solver::RiemannSolver<euler2d::Data,euler2d::NDIM,euler2d::NEQS,euler2d::BatchData>(name)
+  {
+    regist_typeinfo(this);
+  }
+
+  static std::string type_name () { return "ScalarRoe"; }
+
+  using solver::RiemannSolver<euler2d::Data,euler2d::NDIM,euler2d::NEQS,euler2d::BatchData>::compute_riemann_flux;
+
+  virtual void compute_riemann_flux( const Data& left, const Data& right, const ColVector_NDIM& normal,
+                                     RowVector_NEQS& flux, Real& wave_speed )
+  {
+    euler2d::compute_roe_flux(left, right, normal, flux, wave_speed);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE( Euler_Suite )
 
 //////////////////////////////////////////////////////////////////////////////
@@ -243,6 +276,137 @@ BOOST_AUTO_TEST_CASE( Test_Euler2D_SymmetryBCs )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( Test_Euler1D_riemann_batch )
+{
+  // Batch of faces with subsonic and supersonic states, and normals in both directions
+  euler1d::Data pL[physics::BATCH_SIZE], pR[physics::BATCH_SIZE];
+  euler1d::BatchData batch_left, batch_right;
+  euler1d::BatchArray_NDIM batch_normal;
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    pL[i].gamma=1.4;                                   pR[i].gamma=1.4;
+    pL[i].R=287.05;                                    pR[i].R=287.05;
+    euler1d::RowVector_NEQS prim_left, prim_right;
+    prim_left  << 4.696-i, 100.*i,     404400-20000.*i; pL[i].compute_from_primitive(prim_left);
+    prim_right << 1.408+i, 700.-300.*i, 101100+5000.*i; pR[i].compute_from_primitive(prim_right);
+    batch_left.set(i,pL[i]);
+    batch_right.set(i,pR[i]);
+    batch_normal(i,XX) = (i%2 ? -1. : 1.);
+  }
+
+  euler1d::BatchArray_NEQS batch_flux;
+  euler1d::BatchArray batch_wave_speed;
+  euler1d::RowVector_NEQS flux;
+  Real wave_speed;
+
+  compute_rusanov_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    euler1d::ColVector_NDIM normal; normal << batch_normal(i,XX);
+    compute_rusanov_flux( pL[i], pR[i], normal, flux, wave_speed );
+    check_batch_entry( batch_flux, i, flux );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+
+  compute_roe_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    euler1d::ColVector_NDIM normal; normal << batch_normal(i,XX);
+    compute_roe_flux( pL[i], pR[i], normal, flux, wave_speed );
+    check_batch_entry( batch_flux, i, flux );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+
+  compute_hlle_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    euler1d::ColVector_NDIM normal; normal << batch_normal(i,XX);
+    compute_hlle_flux( pL[i], pR[i], normal, flux, wave_speed );
+    check_batch_entry( batch_flux, i, flux );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Test_Euler2D_riemann_batch )
+{
+  // Batch of faces with subsonic and supersonic states, and arbitrary unit normals
+  euler2d::Data pL[physics::BATCH_SIZE], pR[physics::BATCH_SIZE];
+  euler2d::BatchData batch_left, batch_right;
+  euler2d::BatchArray_NDIM batch_normal;
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    pL[i].gamma=1.4;                                   pR[i].gamma=1.4;
+    pL[i].R=287.05;                                    pR[i].R=287.05;
+    euler2d::RowVector_NEQS prim_left, prim_right;
+    prim_left  << 4.696-i, 100.*i, -50.,      404400-20000.*i; pL[i].compute_from_primitive(prim_left);
+    prim_right << 1.408+i, 700.-300.*i, 30.*i, 101100+5000.*i; pR[i].compute_from_primitive(prim_right);
+    batch_left.set(i,pL[i]);
+    batch_right.set(i,pR[i]);
+    const Real angle = 0.7*i+0.1;
+    batch_normal(i,XX) = std::cos(angle);
+    batch_normal(i,YY) = std::sin(angle);
+  }
+
+  euler2d::BatchArray_NEQS batch_flux;
+  euler2d::BatchArray batch_wave_speed;
+  euler2d::RowVector_NEQS flux;
+  Real wave_speed;
+
+  compute_rusanov_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    euler2d::ColVector_NDIM normal = batch_normal.row(i).transpose().matrix();
+    compute_rusanov_flux( pL[i], pR[i], normal, flux, wave_speed );
+    check_batch_entry( batch_flux, i, flux );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+
+  compute_roe_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    euler2d::ColVector_NDIM normal = batch_normal.row(i).transpose().matrix();
+    compute_roe_flux( pL[i], pR[i], normal, flux, wave_speed );
+    check_batch_entry( batch_flux, i, flux );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+
+  compute_hlle_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    euler2d::ColVector_NDIM normal = batch_normal.row(i).transpose().matrix();
+    compute_hlle_flux( pL[i], pR[i], normal, flux, wave_speed );
+    check_batch_entry( batch_flux, i, flux );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+
+  // Default batched flux of a Riemann solver, looping over the single face flux
+  compute_roe_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  boost::shared_ptr<ScalarRoe> riemann_solver = allocate_component<ScalarRoe>("riemann_solver");
+  euler2d::BatchArray_NEQS solver_flux;
+  euler2d::BatchArray solver_wave_speed;
+  riemann_solver->compute_riemann_flux( batch_left, batch_right, batch_normal, solver_flux, solver_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    check_batch_entry( batch_flux, i, solver_flux.row(i) );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], solver_wave_speed[i], 1e-10 );
+  }
+
+  // Batched conservative to primitive conversion
+  euler2d::BatchData batch_cons;
+  batch_cons.gamma = batch_left.gamma;
+  batch_cons.compute_from_conservative(batch_left.cons);
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    BOOST_CHECK_CLOSE( batch_cons.p[i], pL[i].p, 1e-10 );
+    BOOST_CHECK_CLOSE( batch_cons.c[i], pL[i].c, 1e-10 );
+    BOOST_CHECK_CLOSE( batch_cons.H[i], pL[i].H, 1e-10 );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,8 @@
 #include <iostream>
 #include <boost/test/unit_test.hpp>
 
+#include "math/Defs.hpp"
+
 #include "cf3/common/Log.hpp"
 #include "cf3/common/Core.hpp"
 #include "cf3/common/Environment.hpp"
@@ -105,6 +107,57 @@ BOOST_AUTO_TEST_CASE( Test_LinEuler2d_riemann )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( Test_LinEuler2d_riemann_batch )
+{
+  // Batch of faces with different mean flows, perturbations and normals
+  Data pL[physics::BATCH_SIZE], pR[physics::BATCH_SIZE];
+  BatchData batch_left, batch_right;
+  BatchArray_NDIM batch_normal;
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    pL[i].gamma=4.;                                     pR[i].gamma = pL[i].gamma;
+    pL[i].U0 << 0.5*i, 0.3-0.2*i;                       pR[i].U0    = pL[i].U0;
+    pL[i].rho0 = 1.+0.1*i;                              pR[i].rho0  = pL[i].rho0;
+    pL[i].p0 = 1.;                                      pR[i].p0    = pL[i].p0;
+    pL[i].c0 = std::sqrt(pL[i].gamma*pL[i].p0/pL[i].rho0); pR[i].c0 = pL[i].c0;
+    RowVector_NEQS cons_left, cons_right;
+    cons_left  << 0.1, 0.2*i, 0.3, 0.4+i;   pL[i].compute_from_conservative(cons_left);
+    cons_right << -0.2*i, 0.1, 0.5, 0.3;    pR[i].compute_from_conservative(cons_right);
+    batch_left.set(i,pL[i]);
+    batch_right.set(i,pR[i]);
+    const Real angle = 1.3*i+0.2;
+    batch_normal(i,XX) = std::cos(angle);
+    batch_normal(i,YY) = std::sin(angle);
+  }
+
+  BatchArray_NEQS batch_flux;
+  BatchArray batch_wave_speed;
+  RowVector_NEQS flux;
+  Real wave_speed;
+
+  compute_rusanov_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    ColVector_NDIM normal = batch_normal.row(i).transpose().matrix();
+    compute_rusanov_flux( pL[i], pR[i], normal, flux, wave_speed );
+    for (Uint eq=0; eq<NEQS; ++eq)
+      BOOST_CHECK_SMALL( batch_flux(i,eq) - flux[eq], 1e-12*(1.+std::abs(flux[eq])) );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+
+  compute_cir_flux( batch_left, batch_right, batch_normal, batch_flux, batch_wave_speed );
+  for (Uint i=0; i<physics::BATCH_SIZE; ++i)
+  {
+    ColVector_NDIM normal = batch_normal.row(i).transpose().matrix();
+    compute_cir_flux( pL[i], pR[i], normal, flux, wave_speed );
+    for (Uint eq=0; eq<NEQS; ++eq)
+      BOOST_CHECK_SMALL( batch_flux(i,eq) - flux[eq], 1e-12*(1.+std::abs(flux[eq])) );
+    BOOST_CHECK_CLOSE( batch_wave_speed[i], wave_speed, 1e-10 );
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -10,10 +10,15 @@
 #include <boost/test/unit_test.hpp>
 
 #include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/lexical_cast.hpp>
 
+#include <fstream>
 #include <iostream>
+#include <iterator>
 
+#include "common/BoostFilesystem.hpp"
 #include "common/Log.hpp"
+#include "common/LogAsyncFileSink.hpp"
 
 using namespace std;
 using namespace boost;
@@ -67,4 +72,94 @@ BOOST_AUTO_TEST_CASE( FlushBuffer )
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
+namespace
+{
+  int nb_evaluations = 0;
+
+  int count_evaluation()
+  {
+    return ++nb_evaluations;
+  }
+}
+
+/// Debug messages are not formatted when the debug level is disabled
+BOOST_AUTO_TEST_CASE( DisabledLevel )
+{
+  Logger::instance().set_log_level(INFO);
+  BOOST_CHECK(Logger::instance().is_enabled(INFO));
+  BOOST_CHECK(!Logger::instance().is_enabled(DEBUG));
+
+  CFdebug << "not shown " << count_evaluation() << CFendl;
+  BOOST_CHECK_EQUAL(nb_evaluations, 0);
+
+  if(nb_evaluations == 0)
+    CFdebug << "not shown either" << CFendl;
+  else
+    BOOST_ERROR("dangling else bound to the CFdebug macro");
+
+  Logger::instance().set_log_level(DEBUG);
+  BOOST_CHECK(Logger::instance().is_enabled(DEBUG));
+
+  CFdebug << "shown " << count_evaluation() << CFendl;
+  BOOST_CHECK_EQUAL(nb_evaluations, 1);
+
+  Logger::instance().set_log_level(INFO);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+BOOST_AUTO_TEST_CASE( AsyncFileSink )
+{
+  const std::string filename = "utest-log-async.log";
+
+  std::string expected;
+  {
+    boost::shared_ptr<LogAsyncFileSink> sink(new LogAsyncFileSink(filename));
+    LogAsyncFileSink::Device device(sink);
+    for(Uint i = 0; i != 1000; ++i)
+    {
+      const std::string line = "line " + boost::lexical_cast<std::string>(i) + "\n";
+      device.write(line.c_str(), line.size());
+      expected += line;
+    }
+
+    // all data is in the file after a flush, while the sink is still alive
+    sink->flush();
+    std::ifstream file(filename.c_str());
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    BOOST_CHECK_EQUAL(contents, expected);
+  }
+
+  boost::filesystem::remove(filename);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+/// A stream that waits on flush has each message in the file when the message ends
+BOOST_AUTO_TEST_CASE( AsyncFileSinkStreamFlush )
+{
+  const std::string filename = "utest-log-async-flush.log";
+
+  {
+    boost::shared_ptr<LogAsyncFileSink> sink(new LogAsyncFileSink(filename));
+    LogStream stream("TestError", ERROR);
+    stream.useDestination(LogStream::SCREEN, false);
+    stream.setFile(sink, true);
+    BOOST_CHECK(stream.isFileOpen());
+
+    stream << "error message" << CFendl;
+
+    std::ifstream file(filename.c_str());
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    BOOST_CHECK(contents.find("error message\n") != std::string::npos);
+  }
+
+  boost::filesystem::remove(filename);
+}
+
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
 BOOST_AUTO_TEST_SUITE_END()
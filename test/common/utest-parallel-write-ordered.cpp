@@ -0,0 +1,130 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+//
+// IMPORTANT:
+// run it both on 1 and many cores
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::common::PE::write_ordered"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/StringConversion.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/write_ordered.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct WriteOrderedFixture
+{
+  WriteOrderedFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Segments for the given rank: a header and footer on rank 0, and a body with an empty contribution from rank 1
+  std::vector<std::string> segments(const Uint rank)
+  {
+    std::vector<std::string> result(3);
+    if(rank == 0)
+    {
+      result[0] = "header\n";
+      result[2] = "footer\n";
+    }
+    result[0] += "a" + to_str(rank) + "\n";
+    if(rank != 1)
+      result[1] = "b" + to_str(rank) + "\n";
+    return result;
+  }
+
+  std::string read_file(const std::string& path)
+  {
+    std::ifstream file(path.c_str(), std::ios_base::in | std::ios_base::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( WriteOrderedSuite, WriteOrderedFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init )
+{
+  PE::Comm::instance().init(m_argc,m_argv);
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , true );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( write_segments )
+{
+  const Uint rank = PE::Comm::instance().rank();
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  std::vector<std::string> expected_segments(3);
+  for(Uint p = 0; p != nb_procs; ++p)
+  {
+    const std::vector<std::string> proc_segments = segments(p);
+    for(Uint i = 0; i != 3; ++i)
+      expected_segments[i] += proc_segments[i];
+  }
+  const std::string expected = expected_segments[0] + expected_segments[1] + expected_segments[2];
+
+  // Write twice, so the second write must also truncate the longer file from the first write
+  PE::write_ordered("write-ordered.txt", std::vector<std::string>(1, expected + expected));
+  PE::write_ordered("write-ordered.txt", segments(rank));
+  PE::Comm::instance().barrier();
+  BOOST_CHECK_EQUAL(read_file("write-ordered.txt"), expected);
+  PE::Comm::instance().barrier();
+
+  // Same with explicit aggregators
+  PE::write_ordered("write-ordered.txt", segments(rank), 2);
+  PE::Comm::instance().barrier();
+  BOOST_CHECK_EQUAL(read_file("write-ordered.txt"), expected);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( segment_count_mismatch )
+{
+  if(PE::Comm::instance().size() > 1)
+  {
+    std::vector<std::string> bad_segments(PE::Comm::instance().rank() == 0 ? 2 : 1);
+    BOOST_CHECK_THROW(PE::write_ordered("write-ordered-bad.txt", bad_segments), ParallelError);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( finalize )
+{
+  PE::Comm::instance().finalize();
+  BOOST_CHECK_EQUAL( PE::Comm::instance().is_active() , false );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,105 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::common::Tracer"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "common/Tracer.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( TracerSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Disabled )
+{
+  BOOST_CHECK(!Tracer::is_enabled());
+  {
+    TraceScope trace("untraced", Tracer::ACTION);
+  }
+  BOOST_CHECK_EQUAL(Tracer::instance().nb_events(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE( NestedScopes )
+{
+  Tracer& tracer = Tracer::instance();
+  tracer.enable();
+  {
+    TraceScope outer("outer", Tracer::ACTION);
+    {
+      TraceScope inner("inner", Tracer::ACTION);
+      TraceScope sync("sync", Tracer::SYNCHRONIZE);
+    }
+    TraceScope solve(std::string("solve"), Tracer::SOLVE);
+  }
+  tracer.disable();
+  BOOST_CHECK_EQUAL(tracer.nb_events(), 4u);
+
+  // Disabled scopes are not recorded
+  {
+    TraceScope trace("untraced", Tracer::ACTION);
+  }
+  BOOST_CHECK_EQUAL(tracer.nb_events(), 4u);
+
+  tracer.write_chrome_trace("utest-tracer.json");
+  std::ifstream file("utest-tracer.json");
+  const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  BOOST_CHECK(contents.find("\"traceEvents\"") != std::string::npos);
+  BOOST_CHECK(contents.find("\"name\":\"inner\",\"cat\":\"action\",\"ph\":\"X\"") != std::string::npos);
+  BOOST_CHECK(contents.find("\"name\":\"sync\",\"cat\":\"synchronize\"") != std::string::npos);
+  BOOST_CHECK(contents.find("untraced") == std::string::npos);
+
+  std::stringstream summary;
+  tracer.print_summary(summary);
+  BOOST_CHECK(summary.str().find("outer") != std::string::npos);
+  BOOST_CHECK(summary.str().find("inner") != std::string::npos);
+  BOOST_CHECK(summary.str().find("solve") != std::string::npos);
+  // Communication is only summarized as part of the enclosing actions
+  BOOST_CHECK(summary.str().find("  sync\n") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE( RingBuffer )
+{
+  Tracer& tracer = Tracer::instance();
+  tracer.enable(4);
+  for(Uint i = 0; i != 10; ++i)
+  {
+    TraceScope trace("loop", Tracer::ACTION);
+  }
+  tracer.disable();
+  BOOST_CHECK_EQUAL(tracer.nb_events(), 4u);
+
+  tracer.clear();
+  BOOST_CHECK_EQUAL(tracer.nb_events(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE( WallClock )
+{
+  // Time spent waiting counts, so blocked communication shows up in the trace
+  Tracer& tracer = Tracer::instance();
+  tracer.enable();
+  const Real begin = tracer.time();
+  boost::this_thread::sleep(boost::posix_time::milliseconds(200));
+  const Real waited = tracer.time() - begin;
+  tracer.disable();
+  BOOST_CHECK_GE(waited, 0.15);
+  BOOST_CHECK_LT(waited, 10.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Benchmark of concurrent lookups in the LSS scatter cache"
+
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "common/Log.hpp"
+#include "common/Timer.hpp"
+
+#include "math/LSS/ScatterCache.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::math::LSS;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const Uint nb_nodes = 20000;
+const Uint elements_per_node = 8;
+const Uint nodes_per_element = 8;
+const Uint nb_lookups = 8000000;
+
+/// Node indices of a hexahedron-like element, starting at the given node
+void element_indices(const Uint node, const Uint elem, std::vector<Uint>& indices)
+{
+  indices.resize(nodes_per_element);
+  indices[0] = node;
+  for(Uint i = 1; i != nodes_per_element; ++i)
+    indices[i] = (node + elem*i + 1) % nb_nodes;
+}
+
+/// Look up a range of elements, as one thread of an assembly
+void lookup_range(const ScatterCache<Uint>& cache, const Uint begin, const Uint end, Uint& nb_found)
+{
+  std::vector<Uint> indices;
+  nb_found = 0;
+  for(Uint i = begin; i != end; ++i)
+  {
+    const Uint elem = i % (nb_nodes*elements_per_node);
+    element_indices(elem / elements_per_node, elem % elements_per_node, indices);
+    if(cache.find(indices) != 0)
+      ++nb_found;
+  }
+}
+
+struct ScatterCacheFixture
+{
+  ScatterCacheFixture()
+  {
+    cache.reset(nb_nodes);
+    std::vector<Uint> indices;
+    for(Uint node = 0; node != nb_nodes; ++node)
+    {
+      for(Uint elem = 0; elem != elements_per_node; ++elem)
+      {
+        element_indices(node, elem, indices);
+        cache.insert(indices, std::vector<Uint>(nodes_per_element*nodes_per_element, node));
+      }
+    }
+  }
+
+  /// Divide nb_lookups over nb_threads threads, reporting the wall clock time
+  void run(const Uint nb_threads)
+  {
+    std::vector<Uint> nb_found(nb_threads, 0u);
+    const Uint chunk = nb_lookups / nb_threads;
+
+    WallTimer timer;
+    boost::thread_group threads;
+    for(Uint t = 0; t != nb_threads; ++t)
+      threads.create_thread(boost::bind(&lookup_range, boost::cref(cache), t*chunk, (t+1)*chunk, boost::ref(nb_found[t])));
+    threads.join_all();
+    const Real elapsed = timer.elapsed();
+
+    Uint total_found = 0;
+    for(Uint t = 0; t != nb_threads; ++t)
+      total_found += nb_found[t];
+    BOOST_CHECK_EQUAL(total_found, nb_threads*chunk);
+
+    CFinfo << nb_threads << " threads: " << elapsed << " s for " << nb_threads*chunk << " lookups" << CFendl;
+  }
+
+  ScatterCache<Uint> cache;
+};
+
+}
+
+BOOST_FIXTURE_TEST_SUITE( ScatterCacheBenchmarkSuite, ScatterCacheFixture )
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Lookup1Thread )
+{
+  run(1);
+}
+
+BOOST_AUTO_TEST_CASE( Lookup2Threads )
+{
+  run(2);
+}
+
+BOOST_AUTO_TEST_CASE( Lookup4Threads )
+{
+  run(4);
+}
+
+BOOST_AUTO_TEST_CASE( Lookup8Threads )
+{
+  run(8);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+///////////////////////////////////////////////////////////////////////////////
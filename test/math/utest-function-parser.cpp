@@ -81,7 +81,36 @@ BOOST_AUTO_TEST_CASE( function_2 )
 
 }
 
-
+BOOST_AUTO_TEST_CASE( function_batch )
+{
+  cf3::math::VectorialFunction f ("[x+2*y*t][sin(pi*x)]","x,y,t");
+
+  const Uint nb_points = 5000;
+  VectorialFunction::ArrayT points(boost::extents[nb_points][2]);
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    points[i][0] = 0.001*i;
+    points[i][1] = 1. - 0.0002*i;
+  }
+
+  VectorialFunction::ArrayT values(boost::extents[nb_points][2]);
+  const VectorialFunction::VariablesT t = boost::assign::list_of(0.5);
+  f.evaluate_batch(points, t, values);
+
+  for(Uint i = 0; i != nb_points; ++i)
+  {
+    const VectorialFunction::VariablesT u = boost::assign::list_of(points[i][0])(points[i][1])(0.5);
+    RealVector r = f(u);
+    BOOST_CHECK_EQUAL(values[i][0], r[0]);
+    BOOST_CHECK_EQUAL(values[i][1], r[1]);
+  }
+  BOOST_CHECK_CLOSE( values[1000][0], 1.0 + 2.*0.8*0.5 , 1e-6);
+
+  // Missing the time, or storage with the wrong number of columns
+  BOOST_CHECK_THROW(f.evaluate_batch(points, VectorialFunction::VariablesT(), values), BadValue);
+  VectorialFunction::ArrayT wrong_values(boost::extents[nb_points][1]);
+  BOOST_CHECK_THROW(f.evaluate_batch(points, t, wrong_values), BadValue);
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -17,6 +17,8 @@
 #include <boost/lexical_cast.hpp>
 
 #include "common/Log.hpp"
+#include "common/PropertyList.hpp"
+#include "math/LSS/SolutionStrategy.hpp"
 #include "math/LSS/System.hpp"
 #include "math/VariablesDescriptor.hpp"
 
@@ -321,6 +323,30 @@ BOOST_AUTO_TEST_CASE( test_matrix_only )
         }
   }
 
+  // performant access - repeated assembly of the same indices reuses the cached offsets
+  mat->reset();
+  if (irank==1)
+  {
+    LSS::BlockAccumulator ba;
+    ba.resize(3,neq);
+    ba.mat << 53., 54., 51., 52., 55., 56.,
+              59., 60., 57., 58., 61., 62.,
+              23., 24., 21., 22., 25., 26.,
+              29., 30., 27., 28., 31., 32.,
+              83., 84., 81., 82., 85., 86.,
+              89., 90., 87., 88., 91., 92.;
+    ba.indices[0]=5;
+    ba.indices[1]=2;
+    ba.indices[2]=8;
+    const RealMatrix element_matrix = ba.mat;
+    for (int i=0; i<3; i++) mat->add_values(ba);
+    ba.reset();
+    mat->get_values(ba);
+    for (int i=0; i<6; i++)
+      for (int j=0; j<6; j++)
+        BOOST_CHECK_EQUAL(ba.mat(i,j),3.*element_matrix(i,j));
+  }
+
   // bc-related: dirichlet-condition
   mat->reset(-1.);
   if (irank==0)
@@ -962,6 +988,70 @@ BOOST_AUTO_TEST_CASE( solve_system )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( preconditioner_reuse )
+{
+  // commpattern
+  if (irank==0)
+  {
+    gid += 0,1,2,3,4;
+    rank_updatable += 0,0,0,0,1;
+  } else {
+    gid += 3,4,5,6,7,8,9;
+    rank_updatable += 0,1,1,1,1,1,1;
+  }
+  boost::shared_ptr<common::PE::CommPattern> cp_ptr = common::allocate_component<common::PE::CommPattern>("commpattern");
+  common::PE::CommPattern& cp = *cp_ptr;
+  cp.insert("gid",gid,1,false);
+  cp.setup(Handle<common::PE::CommWrapper>(cp.get_child("gid")),rank_updatable);
+
+  // lss
+  if (irank==0)
+  {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4;
+    starting_indices += 0,2,5,8,11,13;
+  } else {
+    node_connectivity += 0,1,0,1,2,1,2,3,2,3,4,3,4,5,4,5,6,5,6;
+    starting_indices +=  0,2,5,8,11,14,17,19;
+  }
+  boost::shared_ptr<System> sys(common::allocate_component<System>("sys"));
+  sys->options().option("matrix_builder").change_value(matrix_builder);
+  sys->create(cp,2,node_connectivity,starting_indices);
+  sys->solution_strategy()->access_component("Parameters")->options().set("preconditioner_type", std::string("None"));
+
+  sys->matrix()->reset(-0.5);
+  sys->solution()->reset(1.);
+  sys->rhs()->reset(0.);
+  std::vector<Real> diag(irank == 0 ? 10 : 14, 1.);
+  sys->set_diagonal(diag);
+  if (irank==0)
+  {
+    sys->dirichlet(0,0,1.);
+    sys->dirichlet(0,1,1.);
+  } else {
+    sys->dirichlet(6,0,10.);
+    sys->dirichlet(6,1,10.);
+  }
+
+  common::PropertyList& props = sys->solution_strategy()->properties();
+
+  // without a reset schedule, the preconditioner is kept for the next solves
+  sys->solution_strategy()->options().set("preconditioner_reset", 0u);
+  sys->solve();
+  sys->solve();
+  BOOST_CHECK_EQUAL(props.value<Uint>("nb_preconditioner_setups"), 1u);
+
+  // resetting after every solve recomputes it on the next solve
+  sys->solution_strategy()->options().set("preconditioner_reset", 1u);
+  sys->solve();
+  BOOST_CHECK_EQUAL(props.value<Uint>("nb_preconditioner_setups"), 2u);
+
+  // the timings are wall clock times accumulated over the solves
+  BOOST_CHECK(props.value<Real>("solve_time") > 0.);
+  BOOST_CHECK(props.value<Real>("preconditioner_setup_time") >= 0.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( solve_system_blocked )
 {
 
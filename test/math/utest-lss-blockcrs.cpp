@@ -0,0 +1,387 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for the native BlockCrs linear system"
+
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "coolfluid-packages.hpp"
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+#include "common/PE/CommPattern.hpp"
+#include "common/PE/CommWrapper.hpp"
+
+#include "math/LSS/ScatterCache.hpp"
+#include "math/LSS/System.hpp"
+#include "math/LSS/SolutionStrategy.hpp"
+#include "math/LSS/BlockCrs/BlockCrsMatrix.hpp"
+#include "math/LSS/BlockCrs/BlockCrsVector.hpp"
+
+////////////////////////////////////////////////////////////////////////////////
+
+using namespace cf3;
+using namespace cf3::math;
+using namespace cf3::math::LSS;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// A chain of nodes, with line elements between consecutive nodes
+struct BlockCrsFixture
+{
+  BlockCrsFixture() :
+    nb_nodes(20),
+    neq(2)
+  {
+    cp = common::allocate_component<common::PE::CommPattern>("commpattern");
+    for(Uint i = 0; i != nb_nodes; ++i)
+    {
+      gid.push_back(i);
+      rnk.push_back(0);
+      startidx.push_back(conn.size());
+      if(i != 0)
+        conn.push_back(i-1);
+      conn.push_back(i);
+      if(i != nb_nodes-1)
+        conn.push_back(i+1);
+    }
+    startidx.push_back(conn.size());
+    cp->insert("gid",gid,1,false);
+    cp->setup(Handle<common::PE::CommWrapper>(cp->get_child("gid")),rnk);
+
+    sys = common::allocate_component<LSS::System>("system");
+    sys->options().option("matrix_builder").change_value(std::string("cf3.math.LSS.BlockCrsMatrix"));
+    sys->options().option("solution_strategy").change_value(std::string("cf3.math.LSS.BlockCrsStrategy"));
+  }
+
+  /// Element matrix for element e: a diagonally dominant, non-symmetric coupling between its two nodes
+  void element_matrix(const Uint e, BlockAccumulator& ba)
+  {
+    ba.indices[0] = e;
+    ba.indices[1] = e+1;
+    for(Uint i = 0; i != 2*neq; ++i)
+    {
+      for(Uint j = 0; j != 2*neq; ++j)
+      {
+        if(i/neq == j/neq)
+          ba.mat(i,j) = i == j ? 4. : 0.5;
+        else
+          ba.mat(i,j) = i%neq == j%neq ? -1. : 0.1*Real(1 + i%neq) + 0.01*Real(e);
+      }
+      ba.rhs[i] = 1. + 0.1*Real(i + e);
+    }
+  }
+
+  /// Assemble all elements
+  void assemble()
+  {
+    BlockAccumulator ba;
+    ba.resize(2, neq);
+    for(Uint e = 0; e != nb_nodes-1; ++e)
+    {
+      element_matrix(e, ba);
+      sys->matrix()->add_values(ba);
+      sys->rhs()->add_rhs_values(ba);
+    }
+  }
+
+  /// Assemble elements first, first+stride, ... twice, the second time with the nodes swapped
+  void assemble_interleaved(const Uint first, const Uint stride)
+  {
+    BlockAccumulator ba, swapped;
+    ba.resize(2, neq);
+    swapped.resize(2, neq);
+    for(Uint e = first; e < nb_nodes-1; e += stride)
+    {
+      element_matrix(e, ba);
+      sys->matrix()->add_values(ba);
+
+      swapped.indices[0] = ba.indices[1];
+      swapped.indices[1] = ba.indices[0];
+      for(Uint i = 0; i != 2; ++i)
+        for(Uint j = 0; j != 2; ++j)
+          swapped.mat.block(i*neq, j*neq, neq, neq) = ba.mat.block((1-i)*neq, (1-j)*neq, neq, neq);
+      sys->matrix()->add_values(swapped);
+    }
+  }
+
+  /// Dense copy of the matrix
+  RealMatrix dense_matrix()
+  {
+    std::vector<Uint> rows, cols;
+    std::vector<Real> vals;
+    sys->matrix()->debug_data(rows, cols, vals);
+    RealMatrix result(nb_nodes*neq, nb_nodes*neq);
+    result.setZero();
+    for(Uint i = 0; i != vals.size(); ++i)
+      result(rows[i], cols[i]) = vals[i];
+    return result;
+  }
+
+  const Uint nb_nodes;
+  const Uint neq;
+  std::vector<Uint> gid;
+  std::vector<Uint> conn;
+  std::vector<Uint> startidx;
+  std::vector<Uint> rnk;
+  boost::shared_ptr<common::PE::CommPattern> cp;
+  boost::shared_ptr<LSS::System> sys;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( BlockCrsSuite, BlockCrsFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( init_mpi )
+{
+  common::PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK_EQUAL(common::PE::Comm::instance().is_active(),true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( structure )
+{
+  sys->create(*cp, neq, conn, startidx);
+  BOOST_CHECK_EQUAL(sys->solvertype(), "BlockCrs");
+  BOOST_CHECK_EQUAL(sys->matrix()->blockrow_size(), nb_nodes);
+  BOOST_CHECK_EQUAL(sys->matrix()->blockcol_size(), nb_nodes);
+  BOOST_CHECK_EQUAL(sys->solution()->blockrow_size(), nb_nodes);
+
+  const BlockCrsMatrix& mat = dynamic_cast<const BlockCrsMatrix&>(*sys->matrix());
+  BOOST_CHECK_EQUAL(mat.columns().size(), 3*nb_nodes-2);
+  BOOST_CHECK_EQUAL(mat.values().size(), (3*nb_nodes-2)*neq*neq);
+  for(Uint row = 0; row != nb_nodes; ++row)
+  {
+    BOOST_CHECK_EQUAL(mat.columns()[mat.diagonal_positions()[row]], row);
+  }
+  BOOST_CHECK_EQUAL(mat.block_position(0, 5), mat.columns().size());
+}
+
+BOOST_AUTO_TEST_CASE( assembly )
+{
+  sys->create(*cp, neq, conn, startidx);
+  assemble();
+
+  // Reference assembly
+  RealMatrix reference(nb_nodes*neq, nb_nodes*neq);
+  reference.setZero();
+  BlockAccumulator ba;
+  ba.resize(2, neq);
+  for(Uint e = 0; e != nb_nodes-1; ++e)
+  {
+    element_matrix(e, ba);
+    reference.block(e*neq, e*neq, 2*neq, 2*neq) += ba.mat;
+  }
+  BOOST_CHECK_SMALL((dense_matrix() - reference).norm(), 1e-12);
+
+  // get_values returns the assembled blocks
+  ba.indices[0] = 3;
+  ba.indices[1] = 4;
+  sys->matrix()->get_values(ba);
+  BOOST_CHECK_SMALL((RealMatrix(ba.mat) - reference.block(3*neq, 3*neq, 2*neq, 2*neq)).norm(), 1e-12);
+
+  // Assembly using a precomputed scatter map gives the same result
+  BlockCrsMatrix& mat = dynamic_cast<BlockCrsMatrix&>(*sys->matrix());
+  mat.reset(0.);
+  std::vector<Uint> scatter_map;
+  for(Uint e = 0; e != nb_nodes-1; ++e)
+  {
+    element_matrix(e, ba);
+    mat.compute_scatter_map(ba.indices, scatter_map);
+    mat.add_values(ba, scatter_map);
+  }
+  BOOST_CHECK_SMALL((dense_matrix() - reference).norm(), 1e-12);
+
+  // Repeated assembly reuses the cached scatter maps
+  mat.reset(0.);
+  assemble();
+  assemble();
+  BOOST_CHECK_SMALL((dense_matrix() - 2.*reference).norm(), 1e-12);
+
+  // Recreating the matrix discards the cache
+  sys->create(*cp, neq, conn, startidx);
+  assemble();
+  BOOST_CHECK_SMALL((dense_matrix() - reference).norm(), 1e-12);
+
+  // Entries outside of the sparsity pattern are rejected
+  ba.indices[0] = 0;
+  ba.indices[1] = 5;
+  BOOST_CHECK_THROW(sys->matrix()->add_values(ba), common::BadValue);
+}
+
+BOOST_AUTO_TEST_CASE( apply )
+{
+  sys->create(*cp, neq, conn, startidx);
+  assemble();
+
+  boost::shared_ptr<LSS::Vector> x = common::allocate_component<BlockCrsVector>("x");
+  boost::shared_ptr<LSS::Vector> y = common::allocate_component<BlockCrsVector>("y");
+  x->create(*cp, neq);
+  y->create(*cp, neq);
+
+  RealVector x_ref(nb_nodes*neq), y_ref(nb_nodes*neq);
+  for(Uint i = 0; i != nb_nodes*neq; ++i)
+  {
+    x_ref[i] = std::sin(Real(i));
+    y_ref[i] = 1.;
+    x->set_value(i, x_ref[i]);
+    y->set_value(i, y_ref[i]);
+  }
+
+  sys->matrix()->apply(Handle<LSS::Vector>(y), Handle<LSS::Vector const>(x), 2., 0.5);
+  y_ref = 2.*dense_matrix()*x_ref + 0.5*y_ref;
+
+  std::vector<Real> y_data;
+  y->debug_data(y_data);
+  for(Uint i = 0; i != nb_nodes*neq; ++i)
+    BOOST_CHECK_SMALL(y_data[i] - y_ref[i], 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE( solve )
+{
+  sys->create(*cp, neq, conn, startidx);
+  assemble();
+  sys->dirichlet(0, 0, 2., true);
+  sys->dirichlet(nb_nodes-1, 1, -1., true);
+
+  const RealMatrix a = dense_matrix();
+  std::vector<Real> rhs_data;
+  sys->rhs()->debug_data(rhs_data);
+  RealVector b(nb_nodes*neq);
+  for(Uint i = 0; i != nb_nodes*neq; ++i)
+    b[i] = rhs_data[i];
+
+  // Symmetric dirichlet zeroes the column
+  for(Uint i = 1; i != nb_nodes*neq; ++i)
+    BOOST_CHECK_EQUAL(a(i, 0), 0.);
+  BOOST_CHECK_EQUAL(a(0, 0), 1.);
+  BOOST_CHECK_EQUAL(b[0], 2.);
+
+  sys->solution_strategy()->options().set("tolerance", 1e-12);
+  sys->solve();
+  BOOST_CHECK(sys->solution_strategy()->properties().value<Uint>("iterations") > 0);
+
+  std::vector<Real> x_data;
+  sys->solution()->debug_data(x_data);
+  const RealVector x_ref = a.fullPivLu().solve(b);
+  for(Uint i = 0; i != nb_nodes*neq; ++i)
+    BOOST_CHECK_SMALL(x_data[i] - x_ref[i], 1e-8);
+
+  BOOST_CHECK_SMALL(sys->solution_strategy()->compute_residual(), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE( periodic )
+{
+  // Link the last node to the first one
+  std::vector<Uint> periodic_links_nodes(nb_nodes);
+  std::vector<bool> periodic_links_active(nb_nodes, false);
+  for(Uint i = 0; i != nb_nodes; ++i)
+    periodic_links_nodes[i] = i;
+  periodic_links_nodes[nb_nodes-1] = 0;
+  periodic_links_active[nb_nodes-1] = true;
+
+  sys->create(*cp, neq, conn, startidx, periodic_links_nodes, periodic_links_active);
+  BOOST_CHECK_EQUAL(sys->matrix()->blockrow_size(), nb_nodes-1);
+  BOOST_CHECK_EQUAL(sys->matrix()->blockcol_size(), nb_nodes);
+
+  assemble();
+
+  // The contributions of the last element end up in the row of the first node
+  BlockAccumulator ba;
+  ba.resize(2, neq);
+  ba.indices[0] = 0;
+  ba.indices[1] = nb_nodes-2;
+  sys->matrix()->get_values(ba);
+  BOOST_CHECK_CLOSE(ba.mat(0, 0), 8., 1e-10);
+  BOOST_CHECK_CLOSE(ba.mat(0, 2), -1., 1e-10);
+
+  Real first, last;
+  sys->rhs()->get_value(0, 0, first);
+  sys->rhs()->get_value(nb_nodes-1, 0, last);
+  BOOST_CHECK_EQUAL(first, last);
+}
+
+BOOST_AUTO_TEST_CASE( scatter_cache_size )
+{
+  sys->create(*cp, neq, conn, startidx);
+  assemble();
+  const RealMatrix reference = dense_matrix();
+
+  // Disabled cache
+  sys->matrix()->options().set("scatter_cache_size", 0u);
+  sys->matrix()->reset(0.);
+  assemble();
+  assemble();
+  BOOST_CHECK_SMALL((dense_matrix() - 2.*reference).norm(), 1e-12);
+
+  // A full cache stops storing entries, but keeps returning the existing ones
+  ScatterCache<Uint> cache(1);
+  cache.reset(nb_nodes);
+  std::vector<Uint> indices(2, 0u);
+  indices[1] = 1;
+  BOOST_CHECK(is_null(cache.insert(indices, std::vector<Uint>(4, 1u))));
+  BOOST_CHECK(is_null(cache.find(indices)));
+
+  cache.set_max_memory(1024);
+  const std::vector<Uint>* stored = cache.insert(indices, std::vector<Uint>(4, 1u));
+  BOOST_CHECK(is_not_null(stored));
+  BOOST_CHECK_EQUAL(cache.find(indices), stored);
+  BOOST_CHECK_EQUAL(cache.insert(indices, std::vector<Uint>(4, 2u)), stored);
+  BOOST_CHECK_EQUAL((*stored)[0], 1u);
+
+  std::vector<Uint> big_indices(2, 0u);
+  big_indices[1] = 2;
+  BOOST_CHECK(is_null(cache.insert(big_indices, std::vector<Uint>(1024, 1u))));
+  BOOST_CHECK_EQUAL(cache.find(indices), stored);
+
+  // Lowering the maximum below the used memory empties the cache
+  cache.set_max_memory(1);
+  BOOST_CHECK(is_null(cache.find(indices)));
+  BOOST_CHECK_EQUAL(cache.memory(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE( atomic_assembly )
+{
+  sys->create(*cp, neq, conn, startidx);
+  assemble();
+  const RealMatrix reference = dense_matrix();
+
+  // Recreate, so the threads fill the scatter cache concurrently. Each element is added a second time with its nodes
+  // swapped, so different threads insert into the same cache bucket. Plain threads are used, so the atomic additions
+  // are also tested without OpenMP.
+  sys->create(*cp, neq, conn, startidx);
+  sys->matrix()->options().set("atomic_assembly", true);
+
+  const Uint nb_threads = 4;
+  for(Uint pass = 0; pass != 2; ++pass)
+  {
+    sys->matrix()->reset(0.);
+    boost::thread_group threads;
+    for(Uint t = 0; t != nb_threads; ++t)
+      threads.create_thread(boost::bind(&BlockCrsFixture::assemble_interleaved, this, t, nb_threads));
+    threads.join_all();
+
+    BOOST_CHECK_SMALL((dense_matrix() - 2.*reference).norm(), 1e-12);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -11,6 +11,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include "common/Core.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
 
 #include "common/PE/CommPattern.hpp"
 #include "common/PE/CommWrapper.hpp"
@@ -18,6 +20,7 @@
 #include "math/MatrixTypes.hpp"
 #include "math/LSS/SolveLSS.hpp"
 #include "math/LSS/System.hpp"
+#include "math/LSS/SolutionStrategy.hpp"
 
 using namespace boost::assign;
 
@@ -57,6 +60,98 @@ BOOST_AUTO_TEST_CASE( TestSolveSystem )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Solve a symmetric positive definite system for a right hand side that grows linearly with each step,
+/// and return the number of iterations for each step
+std::vector<Uint> solve_steps(const std::string& initial_guess, const Uint nb_steps)
+{
+  Component& root = Core::instance().root();
+  Handle<LSS::SolveLSS> solve_action = root.create_component<LSS::SolveLSS>("solve_" + initial_guess);
+  Handle<LSS::System> lss = root.create_component<LSS::System>("lss_" + initial_guess);
+  Handle<CommPattern> cp = root.create_component<CommPattern>("commpattern_" + initial_guess);
+
+  // Chain of nodes, with line elements between consecutive nodes
+  const Uint nb_nodes = 50;
+  std::vector<Uint> gid, conn, startidx, rnk;
+  for(Uint i = 0; i != nb_nodes; ++i)
+  {
+    gid.push_back(i);
+    rnk.push_back(0);
+    startidx.push_back(conn.size());
+    if(i != 0)
+      conn.push_back(i-1);
+    conn.push_back(i);
+    if(i != nb_nodes-1)
+      conn.push_back(i+1);
+  }
+  startidx.push_back(conn.size());
+  cp->insert("gid",gid,1,false);
+  cp->setup(cp->get_child("gid")->handle<common::PE::CommWrapper>(),rnk);
+
+  lss->options().set("matrix_builder", std::string("cf3.math.LSS.BlockCrsMatrix"));
+  lss->options().set("solution_strategy", std::string("cf3.math.LSS.BlockCrsStrategy"));
+  lss->create(*cp, 1u, conn, startidx);
+
+  LSS::BlockAccumulator ba;
+  ba.resize(2, 1);
+  ba.mat << 1.01, -1., -1., 1.01;
+  for(Uint e = 0; e != nb_nodes-1; ++e)
+  {
+    ba.indices[0] = e;
+    ba.indices[1] = e+1;
+    lss->matrix()->add_values(ba);
+  }
+
+  solve_action->options().set("lss", lss);
+  solve_action->options().set("initial_guess", initial_guess);
+
+  std::vector<Uint> iterations;
+  std::vector<Real> first_solution, solution;
+  for(Uint step = 0; step != nb_steps; ++step)
+  {
+    for(Uint i = 0; i != nb_nodes; ++i)
+      lss->rhs()->set_value(i, Real(step+1) * (1. + 0.1*Real(i)));
+    lss->solution()->reset(0.);
+    solve_action->execute();
+    iterations.push_back(lss->solution_strategy()->properties().value<Uint>("iterations"));
+
+    // The guess must not change the solution
+    lss->solution()->debug_data(solution);
+    if(step == 0)
+      first_solution = solution;
+    for(Uint i = 0; i != nb_nodes; ++i)
+      BOOST_CHECK_CLOSE(solution[i], Real(step+1)*first_solution[i], 1e-4);
+  }
+
+  return iterations;
+}
+
+BOOST_AUTO_TEST_CASE( InitialGuessNone )
+{
+  // Each solve starts from zero
+  const std::vector<Uint> iterations = solve_steps("none", 3);
+  BOOST_CHECK(iterations[0] > 2);
+  BOOST_CHECK(iterations[2] > 2);
+}
+
+BOOST_AUTO_TEST_CASE( InitialGuessExtrapolation )
+{
+  // From the third step on, linear extrapolation is exact up to the solver tolerance
+  const std::vector<Uint> iterations = solve_steps("extrapolation", 4);
+  BOOST_CHECK(iterations[2] < iterations[0]);
+  BOOST_CHECK(iterations[3] < iterations[0]);
+}
+
+BOOST_AUTO_TEST_CASE( InitialGuessProjection )
+{
+  // All right hand sides are parallel, so the projection is exact up to the solver tolerance after the first step
+  const std::vector<Uint> iterations = solve_steps("projection", 4);
+  BOOST_CHECK(iterations[1] < iterations[0]);
+  BOOST_CHECK(iterations[2] < iterations[0]);
+  BOOST_CHECK(iterations[3] < iterations[0]);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_SUITE_END()
 
 ////////////////////////////////////////////////////////////////////////////////
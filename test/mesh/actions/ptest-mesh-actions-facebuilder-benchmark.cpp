@@ -0,0 +1,133 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Compare the face matching algorithms of FaceCellConnectivity"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/List.hpp"
+#include "common/OptionList.hpp"
+#include "common/Table.hpp"
+
+#include "common/PE/Comm.hpp"
+
+#include "mesh/BlockMesh/BlockData.hpp"
+#include "mesh/FaceCellConnectivity.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+#include "Tools/Testing/TimedTestFixture.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct FaceMatchingFixture :
+  public Tools::Testing::TimedTestFixture
+{
+  FaceMatchingFixture()
+  {
+    int argc = boost::unit_test::framework::master_test_suite().argc;
+    char** argv = boost::unit_test::framework::master_test_suite().argv;
+
+    if(!PE::Comm::instance().is_active())
+      PE::Comm::instance().init(argc, argv);
+  }
+
+  static Handle<Mesh> mesh;
+  static Handle<FaceCellConnectivity> sorted;
+  static Handle<FaceCellConnectivity> node_search;
+
+  /// Build the face to cell connectivity for the whole mesh using the given algorithm
+  Handle<FaceCellConnectivity> build(const std::string& face_matching)
+  {
+    Handle<FaceCellConnectivity> result = Core::instance().root().create_component<FaceCellConnectivity>("face_to_cell_" + face_matching);
+    result->options().set("face_matching", face_matching);
+    restart_timer();
+    result->setup(mesh->topology());
+    return result;
+  }
+};
+
+Handle<Mesh> FaceMatchingFixture::mesh;
+Handle<FaceCellConnectivity> FaceMatchingFixture::sorted;
+Handle<FaceCellConnectivity> FaceMatchingFixture::node_search;
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( FaceMatchingSuite, FaceMatchingFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( CreateMesh )
+{
+  Uint x_segs = 60, y_segs = 40, z_segs = 40;
+  const int argc = boost::unit_test::framework::master_test_suite().argc;
+  char** argv = boost::unit_test::framework::master_test_suite().argv;
+  if(argc >= 4)
+  {
+    x_segs = boost::lexical_cast<Uint>(argv[1]);
+    y_segs = boost::lexical_cast<Uint>(argv[2]);
+    z_segs = boost::lexical_cast<Uint>(argv[3]);
+  }
+
+  BlockMesh::BlockArrays& blocks = *Core::instance().root().create_component<BlockMesh::BlockArrays>("blocks");
+  Tools::MeshGeneration::create_channel_3d(blocks, 10., 0.5, 5., x_segs, y_segs/2, z_segs, 0.1);
+  mesh = Core::instance().root().create_component<Mesh>("mesh");
+  blocks.create_mesh(*mesh);
+}
+
+BOOST_AUTO_TEST_CASE( SortMatching )
+{
+  sorted = build("sort");
+}
+
+BOOST_AUTO_TEST_CASE( NodeSearchMatching )
+{
+  node_search = build("node_search");
+}
+
+BOOST_AUTO_TEST_CASE( CompareResults )
+{
+  BOOST_REQUIRE_EQUAL(sorted->size(), node_search->size());
+  const Uint nb_faces = sorted->size();
+  Uint nb_different = 0;
+  Uint nb_inner = 0;
+  for(Uint face = 0; face != nb_faces; ++face)
+  {
+    bool same = sorted->is_bdry_face()[face] == node_search->is_bdry_face()[face];
+    for(Uint side = 0; side != 2; ++side)
+    {
+      same = same && sorted->connectivity()[face][side] == node_search->connectivity()[face][side];
+      same = same && sorted->face_number()[face][side] == node_search->face_number()[face][side];
+      same = same && sorted->cell_rotation()[face][side] == node_search->cell_rotation()[face][side];
+      same = same && sorted->cell_orientation()[face][side] == node_search->cell_orientation()[face][side];
+    }
+    if(!same)
+      ++nb_different;
+    if(!sorted->is_bdry_face()[face])
+      ++nb_inner;
+  }
+  BOOST_CHECK_EQUAL(nb_different, 0u);
+  BOOST_CHECK(nb_inner > 0);
+}
+
+BOOST_AUTO_TEST_CASE( Finalize )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,168 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::ColorElements"
+
+#include <map>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Core.hpp"
+
+#include "mesh/actions/ColorElements.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/ElementColoring.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/Space.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+using namespace boost::assign;
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestColorElements_Fixture
+{
+  /// common setup for each test case
+  TestColorElements_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~TestColorElements_Fixture()
+  {
+  }
+
+  /// Check that each element appears once, and that elements of the same color share no nodes
+  void check_coloring(const Space& space, const ElementColoring& coloring)
+  {
+    BOOST_CHECK(coloring.is_valid());
+    BOOST_CHECK_EQUAL(coloring.elements().size(), space.size());
+    BOOST_CHECK_EQUAL(coloring.color_offsets().back(), space.size());
+
+    std::set<Uint> all_elements(coloring.elements().begin(), coloring.elements().end());
+    BOOST_CHECK_EQUAL(all_elements.size(), space.size());
+
+    const Connectivity& connectivity = space.connectivity();
+    for(Uint color = 0; color != coloring.nb_colors(); ++color)
+    {
+      std::set<Uint> color_nodes;
+      for(Uint i = coloring.color_offsets()[color]; i != coloring.color_offsets()[color+1]; ++i)
+      {
+        BOOST_FOREACH(const Uint node, connectivity[coloring.elements()[i]])
+        {
+          BOOST_CHECK(color_nodes.insert(node).second);
+        }
+      }
+    }
+  }
+
+  /// Largest number of elements in one color
+  Uint max_color_size(const ElementColoring& coloring)
+  {
+    Uint result = 0;
+    for(Uint color = 0; color != coloring.nb_colors(); ++color)
+      result = std::max(result, coloring.color_offsets()[color+1] - coloring.color_offsets()[color]);
+    return result;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestColorElements_TestSuite, TestColorElements_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ColorRect )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("mesh_generator_rect");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"rect");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,10.));
+  std::vector<Uint> nb_cells = list_of(8)(6);
+  mesh_generator->options().set("nb_cells",nb_cells);
+  Mesh& mesh = mesh_generator->generate();
+
+  boost::shared_ptr<MeshTransformer> color_elements = boost::dynamic_pointer_cast<MeshTransformer>(build_component("cf3.mesh.actions.ColorElements","color_elements"));
+  color_elements->transform(mesh);
+
+  // Quads on a structured grid need 4 colors
+  BOOST_CHECK_EQUAL(color_elements->properties().value<Uint>("nb_colors"), 4u);
+
+  std::map<const Space*, Uint> greedy_max_sizes;
+  boost_foreach(const Handle<Space>& space, mesh.geometry_fields().spaces())
+  {
+    const ElementColoring& coloring = ElementColoring::get(*space);
+    check_coloring(*space, coloring);
+    greedy_max_sizes[space.get()] = max_color_size(coloring);
+  }
+
+  color_elements->options().set("algorithm", std::string("balanced"));
+  color_elements->transform(mesh);
+  boost_foreach(const Handle<Space>& space, mesh.geometry_fields().spaces())
+  {
+    const ElementColoring& coloring = ElementColoring::get(*space);
+    check_coloring(*space, coloring);
+    BOOST_CHECK(max_color_size(coloring) <= greedy_max_sizes[space.get()]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Invalidation )
+{
+  Mesh& mesh = *Core::instance().root().get_child("rect")->handle<Mesh>();
+  const Space& space = mesh.elements().front()->geometry_space();
+
+  Handle<ElementColoring const> stored(space.get_child("element_coloring"));
+  BOOST_REQUIRE(is_not_null(stored));
+  BOOST_CHECK(stored->is_valid());
+
+  mesh.raise_mesh_changed();
+  BOOST_CHECK(!stored->is_valid());
+
+  // Accessing the coloring recomputes it, keeping the algorithm
+  const ElementColoring& recomputed = ElementColoring::get(space);
+  BOOST_CHECK_EQUAL(&recomputed, stored.get());
+  BOOST_CHECK_EQUAL(recomputed.options().value<std::string>("algorithm"), std::string("balanced"));
+  check_coloring(space, recomputed);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  Core::instance().terminate();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,213 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::GlobalNumbering"
+
+#include <map>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/List.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Log.hpp"
+#include "common/Builder.hpp"
+
+#include "common/PE/Comm.hpp"
+#include "common/PE/all_gather.hpp"
+
+#include "mesh/actions/GlobalConnectivity.hpp"
+#include "mesh/actions/GlobalNumbering.hpp"
+#include "mesh/actions/GrowOverlap.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/Space.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// Identifies a node or element across ranks: kind 0 for nodes, i+1 for the i-th Entities, followed by the coordinates
+/// of the node or of all element nodes. Ghosts are exact copies of their owner, so the coordinates compare equal.
+typedef std::vector<Real> KeyT;
+typedef std::pair<Uint, Uint> OwnerT; // (glb_idx, rank)
+
+KeyT node_key(const Dictionary& nodes, const Uint i)
+{
+  KeyT key(1, 0.);
+  key.insert(key.end(), nodes.coordinates()[i].begin(), nodes.coordinates()[i].end());
+  return key;
+}
+
+KeyT element_key(const Entities& elements, const Uint entities_idx, const Uint e)
+{
+  RealMatrix coordinates = elements.geometry_space().get_coordinates(e);
+  KeyT key(1, static_cast<Real>(entities_idx+1));
+  for(Uint n = 0; n != coordinates.rows(); ++n)
+    for(Uint d = 0; d != coordinates.cols(); ++d)
+      key.push_back(coordinates(n,d));
+  return key;
+}
+
+void append(std::vector<Real>& send, const KeyT& key, const Uint glb_idx)
+{
+  send.push_back(static_cast<Real>(glb_idx));
+  send.push_back(static_cast<Real>(key.size()));
+  send.insert(send.end(), key.begin(), key.end());
+}
+
+/// Owners of all ranks, gathered to every rank as the numbering did before the rendezvous
+std::map<KeyT, OwnerT> gather_owners(const Mesh& mesh, const std::vector< Handle<Entities> >& entities_list)
+{
+  std::vector<Real> send;
+  const Dictionary& nodes = mesh.geometry_fields();
+  for(Uint i = 0; i != nodes.size(); ++i)
+  {
+    if(!nodes.is_ghost(i))
+      append(send, node_key(nodes, i), nodes.glb_idx()[i]);
+  }
+  for(Uint entities_idx = 0; entities_idx != entities_list.size(); ++entities_idx)
+  {
+    const Entities& elements = *entities_list[entities_idx];
+    for(Uint e = 0; e != elements.size(); ++e)
+    {
+      if(!elements.is_ghost(e))
+        append(send, element_key(elements, entities_idx, e), elements.glb_idx()[e]);
+    }
+  }
+
+  std::vector< std::vector<Real> > received;
+  PE::all_gather(PE::Comm::instance().communicator(), send, received);
+
+  std::map<KeyT, OwnerT> owners;
+  for(Uint p = 0; p != received.size(); ++p)
+  {
+    const std::vector<Real>& recv = received[p];
+    for(Uint i = 0; i < recv.size(); )
+    {
+      const Uint glb_idx = static_cast<Uint>(recv[i]);
+      const Uint key_size = static_cast<Uint>(recv[i+1]);
+      const KeyT key(recv.begin()+i+2, recv.begin()+i+2+key_size);
+      BOOST_CHECK(owners.insert(std::make_pair(key, OwnerT(glb_idx, p))).second);
+      i += 2+key_size;
+    }
+  }
+  return owners;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( GlobalNumberingSuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().environment().options().set("log_level", 1u);
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK(PE::Comm::instance().size() > 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Ghost nodes and elements must get the glb_idx and rank of their owner, as found by looking them up in the
+/// owners gathered from all ranks
+BOOST_AUTO_TEST_CASE( GhostLookup )
+{
+  Handle<Mesh> mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr<MeshGenerator> generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  generate_mesh->options().set("nb_cells",std::vector<Uint>(2,20));
+  generate_mesh->options().set("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().set("mesh",mesh->uri());
+  generate_mesh->execute();
+
+  // Ghost elements
+  boost::shared_ptr<GlobalConnectivity> global_connectivity = allocate_component<GlobalConnectivity>("global_connectivity");
+  global_connectivity->transform(*mesh);
+  boost::shared_ptr<GrowOverlap> grow_overlap = allocate_component<GrowOverlap>("grow_overlap");
+  grow_overlap->transform(*mesh);
+
+  Dictionary& nodes = mesh->geometry_fields();
+  const std::vector<Uint> ranks_before(nodes.rank().array().begin(), nodes.rank().array().end());
+
+  boost::shared_ptr<GlobalNumbering> global_numbering = allocate_component<GlobalNumbering>("global_numbering");
+  global_numbering->transform(*mesh);
+  BOOST_CHECK(global_numbering->properties().value<Real>("rendezvous_time") >= 0.);
+
+  std::vector< Handle<Entities> > entities_list;
+  boost_foreach(Entities& elements, find_components_recursively<Entities>(*mesh))
+    entities_list.push_back(elements.handle<Entities>());
+
+  const std::map<KeyT, OwnerT> owners = gather_owners(*mesh, entities_list);
+
+  Uint nb_ghosts = 0;
+  for(Uint i = 0; i != nodes.size(); ++i)
+  {
+    if(!nodes.is_ghost(i))
+      continue;
+    ++nb_ghosts;
+    const std::map<KeyT, OwnerT>::const_iterator owner = owners.find(node_key(nodes, i));
+    BOOST_REQUIRE(owner != owners.end());
+    BOOST_CHECK_EQUAL(nodes.glb_idx()[i], owner->second.first);
+    BOOST_CHECK_EQUAL(nodes.rank()[i], std::min(owner->second.second, ranks_before[i]));
+  }
+
+  Uint nb_ghost_elements = 0;
+  for(Uint entities_idx = 0; entities_idx != entities_list.size(); ++entities_idx)
+  {
+    const Entities& elements = *entities_list[entities_idx];
+    for(Uint e = 0; e != elements.size(); ++e)
+    {
+      if(!elements.is_ghost(e))
+        continue;
+      ++nb_ghost_elements;
+      const std::map<KeyT, OwnerT>::const_iterator owner = owners.find(element_key(elements, entities_idx, e));
+      BOOST_REQUIRE(owner != owners.end());
+      BOOST_CHECK_EQUAL(elements.glb_idx()[e], owner->second.first);
+      BOOST_CHECK_EQUAL(elements.rank()[e], owner->second.second);
+    }
+  }
+
+  BOOST_CHECK(nb_ghosts > 0);
+  BOOST_CHECK(nb_ghost_elements > 0);
+
+  // Owned items are numbered contiguously, so all global indices are distinct
+  const Uint nb_owned = owners.size();
+  std::set<Uint> distinct_ids;
+  for(std::map<KeyT, OwnerT>::const_iterator it = owners.begin(); it != owners.end(); ++it)
+    distinct_ids.insert(it->second.first);
+  BOOST_CHECK_EQUAL(distinct_ids.size(), nb_owned);
+  BOOST_CHECK_EQUAL(*distinct_ids.rbegin() + 1, nb_owned);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
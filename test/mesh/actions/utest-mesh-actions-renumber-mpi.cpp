@@ -0,0 +1,166 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::Renumber on a parallel, periodic mesh"
+
+#include <map>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Core.hpp"
+#include "common/Log.hpp"
+#include "common/List.hpp"
+#include "common/OptionList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+#include "mesh/BlockMesh/BlockData.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// Value of the test field for the node with the given global index
+Real node_value(const Uint glb_idx)
+{
+  return 2.*static_cast<Real>(glb_idx) + 1.;
+}
+
+/// Global index of each periodic source node, mapped to the global index of its destination
+std::map<Uint, Uint> periodic_links(const Dictionary& nodes)
+{
+  const List<Uint>& links_nodes = *Handle< List<Uint> const >(nodes.get_child("periodic_links_nodes"));
+  const List<bool>& links_active = *Handle< List<bool> const >(nodes.get_child("periodic_links_active"));
+  std::map<Uint, Uint> result;
+  for(Uint i = 0; i != nodes.size(); ++i)
+  {
+    if(links_active[i])
+      result[nodes.glb_idx()[i]] = nodes.glb_idx()[links_nodes[i]];
+  }
+  return result;
+}
+
+/// Coordinates of each node, by global index
+std::map< Uint, std::vector<Real> > node_coordinates(const Dictionary& nodes)
+{
+  std::map< Uint, std::vector<Real> > result;
+  for(Uint i = 0; i != nodes.size(); ++i)
+    result[nodes.glb_idx()[i]] = std::vector<Real>(nodes.coordinates()[i].begin(), nodes.coordinates()[i].end());
+  return result;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( RenumberMPISuite )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK(PE::Comm::instance().size() > 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Renumber a unit square that is periodic in the x direction and partitioned in the y direction, so each rank has
+/// periodic links and ghosts. After each renumbering, a synchronized field must give the ghosts the values of their
+/// owners, and the periodic links must connect the same global nodes as before.
+BOOST_AUTO_TEST_CASE( RenumberPeriodic )
+{
+  const Uint nb_procs = PE::Comm::instance().size();
+
+  BlockMesh::BlockArrays& blocks = *Core::instance().root().create_component<BlockMesh::BlockArrays>("blocks");
+  (*blocks.create_points(2, 4)) << 0. << 0.
+                                << 1. << 0.
+                                << 1. << 1.
+                                << 0. << 1.;
+  (*blocks.create_blocks(1)) << 0 << 1 << 2 << 3;
+  (*blocks.create_block_subdivisions()) << 20 << 10*nb_procs;
+  (*blocks.create_block_gradings()) << 1. << 1. << 1. << 1.;
+  *blocks.create_patch("bottom", 1) << 0 << 1;
+  *blocks.create_patch("right", 1) << 1 << 2;
+  *blocks.create_patch("top", 1) << 2 << 3;
+  *blocks.create_patch("left", 1) << 3 << 0;
+  blocks.partition_blocks(nb_procs, 1);
+
+  Mesh& mesh = *Core::instance().root().create_component<Mesh>("mesh");
+  blocks.create_mesh(mesh);
+
+  boost::shared_ptr<MeshTransformer> link_periodic = boost::dynamic_pointer_cast<MeshTransformer>(build_component("cf3.mesh.actions.LinkPeriodicNodes", "link_periodic"));
+  link_periodic->options().set("source_region", mesh.topology().get_child("right"));
+  link_periodic->options().set("destination_region", mesh.topology().get_child("left"));
+  std::vector<Real> translation(2, 0.);
+  translation[XX] = -1.;
+  link_periodic->options().set("translation_vector", translation);
+  link_periodic->transform(mesh);
+
+  Dictionary& nodes = mesh.geometry_fields();
+  Field& u = nodes.create_field("u");
+  u.parallelize_with(nodes.comm_pattern());
+
+  const std::map<Uint, Uint> links_before = periodic_links(nodes);
+  const std::map< Uint, std::vector<Real> > coordinates_before = node_coordinates(nodes);
+  BOOST_CHECK(!links_before.empty());
+
+  Uint nb_ghosts = 0;
+  for(Uint i = 0; i != nodes.size(); ++i)
+  {
+    if(nodes.is_ghost(i))
+      ++nb_ghosts;
+  }
+  BOOST_CHECK(nb_ghosts > 0);
+
+  const char* orderings[] = { "RCM", "Hilbert" };
+  for(Uint o = 0; o != 2; ++o)
+  {
+    // Owned values are known, ghosts get a value that only the synchronization can fix
+    for(Uint i = 0; i != nodes.size(); ++i)
+      u[i][0] = nodes.is_ghost(i) ? -1. : node_value(nodes.glb_idx()[i]);
+
+    boost::shared_ptr<MeshTransformer> renumber = boost::dynamic_pointer_cast<MeshTransformer>(build_component("cf3.mesh.actions.Renumber", "renumber"));
+    renumber->options().set("ordering", std::string(orderings[o]));
+    renumber->transform(mesh);
+
+    u.synchronize();
+
+    for(Uint i = 0; i != nodes.size(); ++i)
+      BOOST_CHECK_EQUAL(u[i][0], node_value(nodes.glb_idx()[i]));
+
+    BOOST_CHECK(periodic_links(nodes) == links_before);
+    BOOST_CHECK(node_coordinates(nodes) == coordinates_before);
+    BOOST_CHECK(nodes.check_sanity());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  PE::Comm::instance().finalize();
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,161 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests mesh::actions::Renumber"
+
+#include <map>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/Core.hpp"
+#include "common/List.hpp"
+
+#include "mesh/actions/Renumber.hpp"
+
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/Space.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::mesh::actions;
+using namespace boost::assign;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Global node indices of each element, and coordinates of each global node, which must not change when renumbering
+struct MeshSignature
+{
+  MeshSignature(const Mesh& mesh)
+  {
+    const Dictionary& nodes = mesh.geometry_fields();
+    for (Uint i=0; i<nodes.size(); ++i)
+      coordinates[nodes.glb_idx()[i]] = std::vector<Real>(nodes.coordinates()[i].begin(), nodes.coordinates()[i].end());
+    BOOST_FOREACH(const Handle<Entities>& entities, mesh.elements())
+    {
+      const Connectivity& connectivity = entities->geometry_space().connectivity();
+      for (Uint e=0; e<entities->size(); ++e)
+      {
+        std::vector<Uint>& elem_nodes = elements[std::make_pair(entities->uri().path(), entities->glb_idx()[e])];
+        BOOST_FOREACH(const Uint node, connectivity[e])
+          elem_nodes.push_back(nodes.glb_idx()[node]);
+      }
+    }
+  }
+
+  std::map< Uint, std::vector<Real> > coordinates;
+  std::map< std::pair<std::string, Uint>, std::vector<Uint> > elements;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TestRenumber_Fixture
+{
+  /// common setup for each test case
+  TestRenumber_Fixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// common tear-down for each test case
+  ~TestRenumber_Fixture()
+  {
+  }
+
+  /// Apply the given ordering to the mesh and check that it is still the same mesh
+  Uint renumber(Mesh& mesh, const std::string& ordering)
+  {
+    const MeshSignature before(mesh);
+
+    boost::shared_ptr<MeshTransformer> renumber = boost::dynamic_pointer_cast<MeshTransformer>(build_component("cf3.mesh.actions.Renumber","renumber"));
+    renumber->options().set("ordering",ordering);
+    renumber->transform(mesh);
+
+    const MeshSignature after(mesh);
+    BOOST_CHECK(before.coordinates == after.coordinates);
+    BOOST_CHECK(before.elements == after.elements);
+    BOOST_CHECK(mesh.geometry_fields().check_sanity());
+
+    const Uint bandwidth_after = renumber->properties().value<Uint>("bandwidth_after");
+    BOOST_CHECK_EQUAL(bandwidth_after, Renumber::bandwidth(mesh));
+    BOOST_CHECK(bandwidth_after <= mesh.geometry_fields().size());
+    return bandwidth_after;
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TestRenumber_TestSuite, TestRenumber_Fixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( renumber_rect )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("mesh_generator_rect");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"rect");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,10.));
+  std::vector<Uint> nb_cells = list_of(40)(10);
+  mesh_generator->options().set("nb_cells",nb_cells);
+  Mesh& mesh = mesh_generator->generate();
+
+  // The generator numbers the nodes along the long side, so the bandwidth is at least one row of nodes
+  BOOST_CHECK(Renumber::bandwidth(mesh) > 40u);
+
+  renumber(mesh, "Hilbert");
+
+  // RCM numbers along the short side
+  const Uint rcm_bandwidth = renumber(mesh, "RCM");
+  BOOST_CHECK(rcm_bandwidth < 30u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( renumber_box )
+{
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("mesh_generator_box");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"box");
+  mesh_generator->options().set("lengths",std::vector<Real>(3,10.));
+  std::vector<Uint> nb_cells = list_of(10)(5)(4);
+  mesh_generator->options().set("nb_cells",nb_cells);
+  Mesh& mesh = mesh_generator->generate();
+
+  const Uint initial_bandwidth = Renumber::bandwidth(mesh);
+  renumber(mesh, "Hilbert");
+  BOOST_CHECK(renumber(mesh, "RCM") <= initial_bandwidth);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  Core::instance().terminate();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -59,6 +59,10 @@ testfield = source_mesh.geometry.create_field(name = 'test', variables = 'testx,
 for i in range(len(source_coords)):
   testfield[i][0] = 1.+2.*source_coords[i][0]
   testfield[i][1] = 2.+3.*source_coords[i][1]
+# A second field, synchronized while the next one is interpolated
+testfield2 = source_mesh.geometry.create_field(name = 'test2', variables = 'testz')
+for i in range(len(source_coords)):
+  testfield2[i][0] = 3.+4.*source_coords[i][2]
   
 target_mesh = target_domain.create_component('targetmesh','cf3.mesh.Mesh')
 blocks = root.create_component('model', 'cf3.mesh.BlockMesh.BlockArrays')
@@ -105,5 +109,14 @@ interpolator.source_mesh = source_mesh
 interpolator.target_mesh = target_mesh
 interpolator.execute()
 
+# The fields are linear, so they are interpolated exactly, on the ghost nodes as well
+target_coords = target_mesh.geometry.coordinates
+target_test = target_mesh.geometry.get_child('test')
+target_test2 = target_mesh.geometry.get_child('test2')
+for i in range(len(target_coords)):
+  cf.cf_check(abs(target_test[i][0] - (1.+2.*target_coords[i][0])) < 1e-6, 'Bad testx at node ' + str(i))
+  cf.cf_check(abs(target_test[i][1] - (2.+3.*target_coords[i][1])) < 1e-6, 'Bad testy at node ' + str(i))
+  cf.cf_check(abs(target_test2[i][0] - (3.+4.*target_coords[i][2])) < 1e-6, 'Bad testz at node ' + str(i))
+
 source_domain.write_mesh(cf.URI('interpolator-source.pvtu'))
 target_domain.write_mesh(cf.URI('interpolator-target.pvtu'))
\ No newline at end of file
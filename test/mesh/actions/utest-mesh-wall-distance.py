@@ -49,15 +49,31 @@ blocks.partition_blocks(nb_partitions = 2, direction = 0)
 blocks.partition_blocks(nb_partitions = 2, direction = 1)
 blocks.create_mesh(mesh.uri())
 
-make_boundary_global = root.create_component('MakeBoundaryGlobal', 'cf3.mesh.actions.MakeBoundaryGlobal')
-make_boundary_global.mesh = mesh
-make_boundary_global.execute()
-
+# No MakeBoundaryGlobal here: the wall surface of the other partitions is gathered by WallDistance itself
 wall_distance = root.create_component('WallDistance', 'cf3.mesh.actions.WallDistance')
 wall_distance.mesh = mesh
 wall_distance.regions = [mesh.topology.step]
 wall_distance.execute()
 
+# Compare with the exact distance to the step, made of the segments (0.5,0)-(0.5,0.5) and (0.5,0.5)-(1,0.5)
+def step_distance(x, y):
+  dx = x - 0.5
+  dy = y - min(max(y, 0.), 0.5)
+  d_vertical = (dx*dx + dy*dy)**0.5
+  dx = x - min(max(x, 0.5), 1.)
+  dy = y - 0.5
+  d_horizontal = (dx*dx + dy*dy)**0.5
+  return min(d_vertical, d_horizontal)
+
+coords = mesh.geometry.coordinates
+distances = mesh.geometry.wall_distance
+for i in range(len(coords)):
+  expected = step_distance(coords[i][0], coords[i][1])
+  if abs(distances[i][0] - expected) > 1e-10:
+    raise Exception('Wrong wall distance ' + str(distances[i][0]) + ' at (' + str(coords[i][0]) + ', ' + str(coords[i][1]) + '), expected ' + str(expected))
+
+make_boundary_global = root.create_component('MakeBoundaryGlobal', 'cf3.mesh.actions.MakeBoundaryGlobal')
+
 domain.write_mesh(cf.URI('wall-distance-2dstep.pvtu'))
 
 mesh.delete_component()
@@ -23,6 +23,7 @@
 #include "common/List.hpp"
 #include "common/Table.hpp"
 #include "common/DynTable.hpp"
+#include "common/RaggedTable.hpp"
 #include "mesh/ElementType.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/Field.hpp"
@@ -701,6 +702,61 @@ BOOST_AUTO_TEST_CASE ( DynTable_test_hard )
 }
 
 
+BOOST_AUTO_TEST_CASE ( RaggedTable_test )
+{
+//  0:  0
+//  1:  ~
+//  2:  1 4 5
+//  3:  3 2
+  RaggedTable<Uint>& table = *root.create_component< RaggedTable<Uint> >("ragged_table");
+  BOOST_CHECK_EQUAL(table.size(), (Uint) 0);
+
+  RaggedTable<Uint>::Builder builder(table, 4);
+  builder.count(0);
+  builder.count(2, 3);
+  builder.count(3);
+  builder.count(3);
+  builder.allocate();
+  builder.add(2, 1);
+  builder.add(3, 3);
+  builder.add(0, 0);
+  builder.add(2, 4);
+  builder.add(3, 2);
+  builder.add(2, 5);
+  builder.finish();
+
+  BOOST_CHECK_EQUAL(table.size(), (Uint) 4);
+  BOOST_CHECK_EQUAL(table.nb_values(), (Uint) 6);
+  BOOST_CHECK_EQUAL(table.row_size(0), (Uint) 1);
+  BOOST_CHECK_EQUAL(table.row_size(1), (Uint) 0);
+  BOOST_CHECK_EQUAL(table.row_size(2), (Uint) 3);
+  BOOST_CHECK_EQUAL(table.row_size(3), (Uint) 2);
+  BOOST_CHECK(table[1].empty());
+
+  // Values in a row keep the order in which they were added
+  const RaggedTable<Uint>& const_table = table;
+  std::vector<Uint> row(const_table[2].begin(), const_table[2].end());
+  std::vector<Uint> expected = list_of(1)(4)(5);
+  BOOST_CHECK(row == expected);
+  BOOST_CHECK_EQUAL(const_table[3][0], (Uint) 3);
+  BOOST_CHECK_EQUAL(const_table[3][1], (Uint) 2);
+
+  // Rows can be modified in place
+  boost_foreach(Uint& value, table[2])
+    value *= 2;
+  BOOST_CHECK_EQUAL(table[2][2], (Uint) 10);
+
+  // Rebuilding discards the old contents
+  RaggedTable<Uint>::Builder rebuilder(table, 2);
+  rebuilder.count(1);
+  rebuilder.allocate();
+  BOOST_CHECK_THROW(rebuilder.finish(), BadValue);
+
+  table.clear();
+  BOOST_CHECK_EQUAL(table.size(), (Uint) 0);
+  BOOST_CHECK_EQUAL(table.nb_values(), (Uint) 0);
+}
+
 BOOST_AUTO_TEST_CASE ( Mesh_test )
 {
   boost::shared_ptr<Component> root = boost::static_pointer_cast<Component>(allocate_component<Group>("root"));
@@ -15,6 +15,7 @@
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
 #include "common/Core.hpp"
+#include "common/RaggedTable.hpp"
 
 #include "math/MatrixTypes.hpp"
 #include "math/VariablesDescriptor.hpp"
@@ -134,6 +135,22 @@ BOOST_AUTO_TEST_CASE( test_Dictionary )
     }
   }
 
+  // CHECK node to element connectivity: each point belongs to exactly one element
+  BOOST_CHECK_EQUAL( elem_fields.connectivity().size() , elem_fields.size() );
+  BOOST_CHECK_EQUAL( elem_fields.connectivity().nb_values() , elem_fields.size() );
+  boost_foreach(const Handle<Entities>& elements_handle, elem_fields.entities_range())
+  {
+    const Space& space = elem_fields.space(*elements_handle);
+    for (Uint e=0; e<space.size(); ++e)
+    {
+      boost_foreach( const Uint point, space.connectivity()[e] )
+      {
+        BOOST_CHECK_EQUAL( elem_fields.connectivity().row_size(point) , 1u );
+        BOOST_CHECK( elem_fields.connectivity()[point][0] == SpaceElem(space,e) );
+      }
+    }
+  }
+
   // ----------------------------------------------------------------------------------------------
   // CHECK field building inside field groups
 
@@ -8,6 +8,7 @@
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::gmsh::Reader parallel"
 
 #include <iostream>
+#include <map>
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
@@ -18,6 +19,8 @@
 #include "common/Environment.hpp"
 #include "common/BoostAnyConversion.hpp"
 #include "common/List.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 
 #include "mesh/Mesh.hpp"
 #include "mesh/Region.hpp"
@@ -30,6 +33,7 @@
 #include "mesh/Space.hpp"
 #include "mesh/Dictionary.hpp"
 #include "mesh/MeshAdaptor.hpp"
+#include "mesh/Connectivity.hpp"
 
 #include "mesh/actions/LoadBalance.hpp"
 
@@ -41,6 +45,40 @@ using namespace cf3::common;
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// The nodes and elements of the local part of a mesh, by global index, so meshes can be compared independently of
+/// the local numbering
+struct MeshSignature
+{
+  MeshSignature(const Mesh& mesh)
+  {
+    const Dictionary& nodes = mesh.geometry_fields();
+    for (Uint n=0; n<nodes.size(); ++n)
+    {
+      std::vector<Real>& node = this->nodes[nodes.glb_idx()[n]];
+      node.assign(nodes.coordinates()[n].begin(), nodes.coordinates()[n].end());
+      node.push_back(nodes.rank()[n]);
+    }
+    boost_foreach(const Entities& entities, find_components_recursively<Entities>(mesh.topology()))
+    {
+      const Connectivity& connectivity = entities.geometry_space().connectivity();
+      for (Uint e=0; e<entities.size(); ++e)
+      {
+        std::vector<Uint>& element = elements[std::make_pair(entities.uri().path().substr(mesh.uri().path().size()), entities.glb_idx()[e])];
+        element.push_back(entities.rank()[e]);
+        boost_foreach(const Uint node, connectivity[e])
+          element.push_back(nodes.glb_idx()[node]);
+      }
+    }
+  }
+
+  /// coordinates and rank of each node
+  std::map< Uint, std::vector<Real> > nodes;
+  /// rank and global node indices of each element, by entities path relative to the mesh and global element index
+  std::map< std::pair<std::string, Uint>, std::vector<Uint> > elements;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
 struct gmshReaderMPITests_Fixture
 {
   /// common setup for each test case
@@ -226,6 +264,32 @@ BOOST_AUTO_TEST_CASE( test )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+/// Each rank parses a chunk of the file with parallel_read, or the whole file. Both must give the same partition.
+BOOST_AUTO_TEST_CASE( chunked_read )
+{
+  boost::shared_ptr< MeshReader > read_mesh = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","meshreader");
+
+  Mesh& sequential = *Core::instance().root().create_component<Mesh>("sequential");
+  read_mesh->read_mesh_into("../../resources/rectangle-mix-p2.msh",sequential);
+
+  read_mesh->options().set("parallel_read",true);
+  Mesh& chunked = *Core::instance().root().create_component<Mesh>("chunked");
+  read_mesh->read_mesh_into("../../resources/rectangle-mix-p2.msh",chunked);
+
+  BOOST_CHECK_EQUAL(chunked.properties().value<Uint>("global_nb_cells"), sequential.properties().value<Uint>("global_nb_cells"));
+  BOOST_CHECK_EQUAL(chunked.properties().value<Uint>("global_nb_nodes"), sequential.properties().value<Uint>("global_nb_nodes"));
+
+  const MeshSignature sequential_signature(sequential);
+  const MeshSignature chunked_signature(chunked);
+  BOOST_CHECK(!sequential_signature.elements.empty());
+  BOOST_CHECK_EQUAL(chunked_signature.nodes.size(), sequential_signature.nodes.size());
+  BOOST_CHECK_EQUAL(chunked_signature.elements.size(), sequential_signature.elements.size());
+  BOOST_CHECK(chunked_signature.nodes == sequential_signature.nodes);
+  BOOST_CHECK(chunked_signature.elements == sequential_signature.elements);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   PE::Comm::instance().finalize();
@@ -7,10 +7,14 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE "Test module for cf3::mesh::gmsh::Reader"
 
+#include <fstream>
+
 #include <boost/test/unit_test.hpp>
 
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 
 
 #include "common/Core.hpp"
@@ -25,6 +29,8 @@
 #include "mesh/MeshTransformer.hpp"
 #include "mesh/Field.hpp"
 #include "mesh/Entities.hpp"
+#include "mesh/Cells.hpp"
+#include "mesh/Connectivity.hpp"
 #include "mesh/Space.hpp"
 #include "common/DynTable.hpp"
 #include "common/List.hpp"
@@ -311,6 +317,103 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh_mix_p1_out )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( parallel_read )
+{
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","meshreader");
+
+  Mesh& sequential = *Core::instance().root().create_component<Mesh>("mesh_2d_mix_p2_sequential");
+  meshreader->read_mesh_into("../../resources/rectangle-mix-p2.msh",sequential);
+
+  meshreader->options().set("parallel_read",true);
+  Mesh& chunked = *Core::instance().root().create_component<Mesh>("mesh_2d_mix_p2_chunked");
+  meshreader->read_mesh_into("../../resources/rectangle-mix-p2.msh",chunked);
+
+  // Both ways of reading give identical meshes
+  Dictionary& sequential_nodes = sequential.geometry_fields();
+  Dictionary& chunked_nodes = chunked.geometry_fields();
+  BOOST_REQUIRE_EQUAL(chunked_nodes.size(), sequential_nodes.size());
+  for (Uint n=0; n<sequential_nodes.size(); ++n)
+  {
+    BOOST_CHECK_EQUAL(chunked_nodes.glb_idx()[n], sequential_nodes.glb_idx()[n]);
+    BOOST_CHECK_EQUAL(chunked_nodes.rank()[n], sequential_nodes.rank()[n]);
+    for (Uint d=0; d<sequential_nodes.coordinates().row_size(); ++d)
+      BOOST_CHECK_EQUAL(chunked_nodes.coordinates()[n][d], sequential_nodes.coordinates()[n][d]);
+  }
+
+  std::vector< Handle<Entities> > sequential_entities, chunked_entities;
+  boost_foreach(Entities& entities, find_components_recursively<Entities>(sequential.topology()))
+    sequential_entities.push_back(entities.handle<Entities>());
+  boost_foreach(Entities& entities, find_components_recursively<Entities>(chunked.topology()))
+    chunked_entities.push_back(entities.handle<Entities>());
+  BOOST_REQUIRE_EQUAL(chunked_entities.size(), sequential_entities.size());
+  for (Uint i=0; i<sequential_entities.size(); ++i)
+  {
+    const Connectivity& sequential_conn = sequential_entities[i]->geometry_space().connectivity();
+    const Connectivity& chunked_conn = chunked_entities[i]->geometry_space().connectivity();
+    BOOST_CHECK_EQUAL(chunked_entities[i]->parent()->name(), sequential_entities[i]->parent()->name());
+    BOOST_CHECK_EQUAL(chunked_entities[i]->name(), sequential_entities[i]->name());
+    BOOST_REQUIRE_EQUAL(chunked_conn.size(), sequential_conn.size());
+    for (Uint e=0; e<sequential_conn.size(); ++e)
+    {
+      BOOST_CHECK_EQUAL(chunked_entities[i]->glb_idx()[e], sequential_entities[i]->glb_idx()[e]);
+      for (Uint n=0; n<sequential_conn.row_size(); ++n)
+        BOOST_CHECK_EQUAL(chunked_conn[e][n], sequential_conn[e][n]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( read_binary )
+{
+  // Unit square split in two triangles, with a line on its bottom side
+  {
+    std::ofstream file("square-binary.msh", std::ios::binary);
+    file << "$MeshFormat\n2.2 1 8\n";
+    const int one = 1;
+    file.write(reinterpret_cast<const char*>(&one), sizeof(int));
+    file << "\n$EndMeshFormat\n";
+    file << "$PhysicalNames\n2\n1 1 \"bottom\"\n2 2 \"interior\"\n$EndPhysicalNames\n";
+    file << "$Nodes\n4\n";
+    const double coords[4][3] = { {0.,0.,0.}, {1.,0.,0.}, {1.,1.,0.}, {0.,1.,0.} };
+    for (int n=0; n<4; ++n)
+    {
+      const int number = n+1;
+      file.write(reinterpret_cast<const char*>(&number), sizeof(int));
+      file.write(reinterpret_cast<const char*>(coords[n]), 3*sizeof(double));
+    }
+    file << "\n$EndNodes\n";
+    file << "$Elements\n3\n";
+    // blocks of (type, nb_elements, nb_tags), followed by (number, tags, nodes) for each element
+    const int lines[] = { 1, 1, 2,   1, 1, 0, 1, 2 };
+    const int triags[] = { 2, 2, 2,   2, 2, 0, 1, 2, 3,   3, 2, 0, 1, 3, 4 };
+    file.write(reinterpret_cast<const char*>(lines), sizeof(lines));
+    file.write(reinterpret_cast<const char*>(triags), sizeof(triags));
+    file << "\n$EndElements\n";
+  }
+
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","meshreader");
+  Mesh& mesh = *Core::instance().root().create_component<Mesh>("mesh_binary");
+  meshreader->read_mesh_into("square-binary.msh",mesh);
+
+  BOOST_CHECK_EQUAL(mesh.dimension(), 2u);
+  BOOST_CHECK_EQUAL(find_component<Region>(mesh).recursive_elements_count(true), 3u);
+  BOOST_CHECK_EQUAL(find_component<Region>(mesh).recursive_nodes_count(), 4u);
+
+  const Dictionary& nodes = mesh.geometry_fields();
+  BOOST_REQUIRE_EQUAL(nodes.size(), 4u);
+  BOOST_CHECK_EQUAL(nodes.coordinates()[2][0], 1.);
+  BOOST_CHECK_EQUAL(nodes.coordinates()[2][1], 1.);
+  BOOST_CHECK_EQUAL(nodes.glb_idx()[3], 3u);
+
+  const Entities& triags_in_mesh = find_component_recursively<Cells>(mesh.topology());
+  BOOST_REQUIRE_EQUAL(triags_in_mesh.size(), 2u);
+  BOOST_CHECK_EQUAL(triags_in_mesh.geometry_space().connectivity()[1][2], 3u);
+  BOOST_CHECK_EQUAL(triags_in_mesh.glb_idx()[1], 2u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( finalize_mpi )
 {
   Core::instance().terminate();
@@ -305,6 +305,100 @@ BOOST_AUTO_TEST_CASE( test_new_interpolation )
 }
 
 
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( routing )
+{
+  // Source mesh distributed over all processors, covering [0,1]x[0,1]
+  Handle<Mesh> source_mesh = Core::instance().root().create_component<Mesh>("routing_source");
+  boost::shared_ptr<MeshGenerator> mesh_gen = allocate_component<SimpleMeshGenerator>("meshgen");
+  mesh_gen->options().set("nb_cells",std::vector<Uint>(2,8));
+  mesh_gen->options().set("lengths",std::vector<Real>(2,1.));
+  mesh_gen->options().set("mesh",source_mesh->uri());
+  mesh_gen->execute();
+
+  // Linear source field, which is interpolated exactly
+  Field& source_field = source_mesh->geometry_fields().create_field("linear");
+  const Field& source_coords = source_mesh->geometry_fields().coordinates();
+  for (Uint i=0; i<source_field.size(); ++i)
+    source_field[i][0] = 1. + 2.*source_coords[i][XX] + 3.*source_coords[i][YY];
+
+  // The same target points on every processor, the last two outside the box of every processor
+  const Uint nb_inside = 36;
+  boost::shared_ptr< Table<Real> > target_coords = allocate_component< Table<Real> >("target_coords");
+  target_coords->set_row_size(DIM_2D);
+  target_coords->resize(nb_inside+2);
+  for (Uint i=0; i<6; ++i)
+  {
+    for (Uint j=0; j<6; ++j)
+    {
+      (*target_coords)[6*i+j][XX] = 0.05 + 0.18*i;
+      (*target_coords)[6*i+j][YY] = 0.03 + 0.19*j;
+    }
+  }
+  (*target_coords)[nb_inside][XX]   = 2.;   (*target_coords)[nb_inside][YY]   = 0.5;
+  (*target_coords)[nb_inside+1][XX] = -1.;  (*target_coords)[nb_inside+1][YY] = -1.;
+
+  const Real unset = -1000.;
+  std::vector<Uint> vars(1, 0u);
+
+  boost::shared_ptr< Interpolator > interpolator = allocate_component<Interpolator>("routing_interpolator");
+  interpolator->get_child("point_interpolator")->options().set("function",std::string("cf3.mesh.ShapeFunctionInterpolation"));
+
+  const bool store[] = {false, true};
+  for (Uint s=0; s<2; ++s)
+  {
+    interpolator->options().set("store",store[s]);
+
+    // Routed interpolation
+    interpolator->options().set("routing",true);
+    boost::shared_ptr< Table<Real> > routed = allocate_component< Table<Real> >("routed");
+    routed->set_row_size(1);
+    routed->resize(target_coords->size());
+    for (Uint t=0; t<routed->size(); ++t)
+      (*routed)[t][0] = unset;
+    interpolator->interpolate_vars(source_field, *target_coords, *routed, vars, vars);
+
+    // All points offered to all processors in turn
+    interpolator->options().set("routing",false);
+    boost::shared_ptr< Table<Real> > ring = allocate_component< Table<Real> >("ring");
+    ring->set_row_size(1);
+    ring->resize(target_coords->size());
+    for (Uint t=0; t<ring->size(); ++t)
+      (*ring)[t][0] = unset;
+    interpolator->interpolate_vars(source_field, *target_coords, *ring, vars, vars);
+
+    for (Uint t=0; t<nb_inside; ++t)
+    {
+      const Real exact = 1. + 2.*(*target_coords)[t][XX] + 3.*(*target_coords)[t][YY];
+      BOOST_CHECK_CLOSE((*routed)[t][0], exact, 1e-8);
+      BOOST_CHECK_CLOSE((*routed)[t][0], (*ring)[t][0], 1e-10);
+    }
+
+    // Points outside every box are left untouched
+    for (Uint t=nb_inside; t<target_coords->size(); ++t)
+    {
+      BOOST_CHECK_EQUAL((*routed)[t][0], unset);
+      BOOST_CHECK_EQUAL((*ring)[t][0], unset);
+    }
+  }
+
+  // Same for the outside points without ring fallback
+  interpolator->options().set("store",false);
+  interpolator->options().set("routing",true);
+  interpolator->options().set("ring_fallback",false);
+  boost::shared_ptr< Table<Real> > no_fallback = allocate_component< Table<Real> >("no_fallback");
+  no_fallback->set_row_size(1);
+  no_fallback->resize(target_coords->size());
+  for (Uint t=0; t<no_fallback->size(); ++t)
+    (*no_fallback)[t][0] = unset;
+  interpolator->interpolate_vars(source_field, *target_coords, *no_fallback, vars, vars);
+  for (Uint t=0; t<nb_inside; ++t)
+    BOOST_CHECK_CLOSE((*no_fallback)[t][0], 1. + 2.*(*target_coords)[t][XX] + 3.*(*target_coords)[t][YY], 1e-8);
+  for (Uint t=nb_inside; t<target_coords->size(); ++t)
+    BOOST_CHECK_EQUAL((*no_fallback)[t][0], unset);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 BOOST_AUTO_TEST_CASE( finalize_mpi )
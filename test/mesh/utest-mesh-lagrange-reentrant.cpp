@@ -0,0 +1,155 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module checking that the Lagrange element types can be used from several threads"
+
+#include <cmath>
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/test/unit_test.hpp>
+#include <boost/thread/barrier.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "mesh/LagrangeP1/Hexa3D.hpp"
+#include "mesh/LagrangeP1/Quad2D.hpp"
+#include "mesh/LagrangeP2/Quad2D.hpp"
+
+using namespace cf3;
+using namespace cf3::mesh;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+const Uint nb_threads = 4;
+const Uint nb_elements = 200;
+const Uint nb_repeats = 20;
+
+/// Distorted reference element nodes, different for every element index
+template<typename ETYPE>
+typename ETYPE::NodesT distorted_nodes(const Uint elem)
+{
+  typename ETYPE::NodesT nodes;
+  for(Uint i = 0; i != ETYPE::nb_nodes; ++i)
+  {
+    for(Uint d = 0; d != ETYPE::dimension; ++d)
+      nodes(i, d) = 0.5*(ETYPE::SF::local_coordinates()(i, d) + 1.) + 0.05*std::sin(Real(1 + elem + 3*i + 7*d));
+  }
+  return nodes;
+}
+
+/// Mapped coordinates that differ for every element index
+template<typename ETYPE>
+typename ETYPE::MappedCoordsT mapped_coords(const Uint elem)
+{
+  typename ETYPE::MappedCoordsT result;
+  for(Uint d = 0; d != ETYPE::dimensionality; ++d)
+    result[d] = 0.5*std::cos(Real(2*elem + 5*d));
+  return result;
+}
+
+/// Evaluate all functions that used to rely on static scratch data, for one element
+template<typename ETYPE>
+void evaluate(const Uint elem, std::vector<Real>& results)
+{
+  const typename ETYPE::NodesT nodes = distorted_nodes<ETYPE>(elem);
+  const typename ETYPE::MappedCoordsT mapped = mapped_coords<ETYPE>(elem);
+
+  results.push_back(ETYPE::jacobian_determinant(mapped, nodes));
+  results.push_back(ETYPE::volume(nodes));
+
+  for(Uint orientation = 0; orientation != ETYPE::dimensionality; ++orientation)
+  {
+    const typename ETYPE::CoordsT normal = ETYPE::plane_jacobian_normal(mapped, nodes, static_cast<CoordRef>(orientation));
+    for(Uint d = 0; d != ETYPE::dimension; ++d)
+      results.push_back(normal[d]);
+  }
+
+  typename ETYPE::CoordsT centroid;
+  ETYPE::compute_centroid(nodes, centroid);
+  results.push_back(ETYPE::is_coord_in_element(centroid, nodes) ? 1. : 0.);
+
+  const typename ETYPE::MappedCoordsT centroid_mapped = ETYPE::mapped_coordinate(centroid, nodes);
+  for(Uint d = 0; d != ETYPE::dimensionality; ++d)
+    results.push_back(centroid_mapped[d]);
+}
+
+/// Evaluate a range of elements, nb_repeats times, keeping the results of the last pass
+template<typename ETYPE>
+void evaluate_range(const Uint begin, const Uint end, std::vector<Real>& results)
+{
+  for(Uint repeat = 0; repeat != nb_repeats; ++repeat)
+  {
+    results.clear();
+    for(Uint elem = begin; elem != end; ++elem)
+      evaluate<ETYPE>(elem, results);
+  }
+}
+
+/// Start evaluating a range once all threads are ready, so the first calls happen concurrently
+template<typename ETYPE>
+void evaluate_range_together(boost::barrier& start, const Uint begin, const Uint end, std::vector<Real>& results)
+{
+  start.wait();
+  evaluate_range<ETYPE>(begin, end, results);
+}
+
+/// Compare the results of a threaded evaluation with the sequential one. The threads run first,
+/// so static data that is initialized on first use is initialized concurrently.
+template<typename ETYPE>
+void check_threaded()
+{
+  std::vector< std::vector<Real> > reference(nb_threads);
+  std::vector< std::vector<Real> > threaded(nb_threads);
+
+  const Uint chunk = nb_elements / nb_threads;
+  boost::barrier start(nb_threads);
+  boost::thread_group threads;
+  for(Uint t = 0; t != nb_threads; ++t)
+    threads.create_thread(boost::bind(&evaluate_range_together<ETYPE>, boost::ref(start), t*chunk, (t+1)*chunk, boost::ref(threaded[t])));
+  threads.join_all();
+
+  for(Uint t = 0; t != nb_threads; ++t)
+    evaluate_range<ETYPE>(t*chunk, (t+1)*chunk, reference[t]);
+
+  for(Uint t = 0; t != nb_threads; ++t)
+  {
+    BOOST_REQUIRE_EQUAL(threaded[t].size(), reference[t].size());
+    for(Uint i = 0; i != reference[t].size(); ++i)
+      BOOST_CHECK_EQUAL(threaded[t][i], reference[t][i]);
+  }
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( LagrangeReentrantSuite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( LagrangeP1Hexa3D )
+{
+  check_threaded<LagrangeP1::Hexa3D>();
+}
+
+BOOST_AUTO_TEST_CASE( LagrangeP1Quad2D )
+{
+  check_threaded<LagrangeP1::Quad2D>();
+}
+
+BOOST_AUTO_TEST_CASE( LagrangeP2Quad2D )
+{
+  check_threaded<LagrangeP2::Quad2D>();
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
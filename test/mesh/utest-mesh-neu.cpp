@@ -11,6 +11,8 @@
 
 #include "common/Log.hpp"
 #include "common/OptionList.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
 #include "common/Core.hpp"
 #include "common/EventHandler.hpp"
 #include "common/Environment.hpp"
@@ -21,6 +23,9 @@
 #include "mesh/MeshReader.hpp"
 #include "mesh/MeshWriter.hpp"
 #include "mesh/MeshTransformer.hpp"
+#include "mesh/Entities.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/Connectivity.hpp"
 
 #include "common/DynTable.hpp"
 #include "common/List.hpp"
@@ -109,6 +114,49 @@ BOOST_AUTO_TEST_CASE( read_2d_mesh )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( parallel_read )
+{
+  boost::shared_ptr< MeshReader > meshreader = build_component_abstract_type<MeshReader>("cf3.mesh.neu.Reader","meshreader");
+  meshreader->options().set("read_groups",true);
+
+  Mesh& sequential = *Core::instance().root().create_component<Mesh>("quadtriag_sequential");
+  meshreader->read_mesh_into("../../resources/quadtriag.neu",sequential);
+
+  meshreader->options().set("parallel_read",true);
+  Mesh& chunked = *Core::instance().root().create_component<Mesh>("quadtriag_chunked");
+  meshreader->read_mesh_into("../../resources/quadtriag.neu",chunked);
+
+  // Both ways of reading give identical meshes
+  Dictionary& sequential_nodes = sequential.geometry_fields();
+  Dictionary& chunked_nodes = chunked.geometry_fields();
+  BOOST_REQUIRE_EQUAL(chunked_nodes.size(), sequential_nodes.size());
+  for (Uint n=0; n<sequential_nodes.size(); ++n)
+  {
+    BOOST_CHECK_EQUAL(chunked_nodes.glb_idx()[n], sequential_nodes.glb_idx()[n]);
+    for (Uint d=0; d<sequential_nodes.coordinates().row_size(); ++d)
+      BOOST_CHECK_EQUAL(chunked_nodes.coordinates()[n][d], sequential_nodes.coordinates()[n][d]);
+  }
+
+  std::vector< Handle<Entities> > sequential_entities, chunked_entities;
+  boost_foreach(Entities& entities, find_components_recursively<Entities>(sequential.topology()))
+    sequential_entities.push_back(entities.handle<Entities>());
+  boost_foreach(Entities& entities, find_components_recursively<Entities>(chunked.topology()))
+    chunked_entities.push_back(entities.handle<Entities>());
+  BOOST_REQUIRE_EQUAL(chunked_entities.size(), sequential_entities.size());
+  for (Uint i=0; i<sequential_entities.size(); ++i)
+  {
+    const Connectivity& sequential_conn = sequential_entities[i]->geometry_space().connectivity();
+    const Connectivity& chunked_conn = chunked_entities[i]->geometry_space().connectivity();
+    BOOST_CHECK_EQUAL(chunked_entities[i]->parent()->name(), sequential_entities[i]->parent()->name());
+    BOOST_REQUIRE_EQUAL(chunked_conn.size(), sequential_conn.size());
+    for (Uint e=0; e<sequential_conn.size(); ++e)
+      for (Uint n=0; n<sequential_conn.row_size(); ++n)
+        BOOST_CHECK_EQUAL(chunked_conn[e][n], sequential_conn[e][n]);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 #if 0
 // Disabled because there exists a duplicate node inside this hextet mesh
 // The GlobalNumbering algorithm hence gets confused as to who gets to own it.
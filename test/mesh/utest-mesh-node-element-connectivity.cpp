@@ -85,7 +85,7 @@ BOOST_AUTO_TEST_CASE( node_elem_connectivity )
   CFinfo << c->connectivity() << CFendl;
 
   // Output connectivity of node 10
-  DynTable<Uint>::ConstRow elements = c->connectivity()[10];
+  RaggedTable<Uint>::ConstRow elements = c->connectivity()[10];
   CFinfo << CFendl << "node 10 is connected to elements: \n";
   boost_foreach(const Uint elem, elements)
   {
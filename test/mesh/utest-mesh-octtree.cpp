@@ -29,6 +29,7 @@
 #include "mesh/Dictionary.hpp"
 #include "mesh/MeshGenerator.hpp"
 #include "mesh/Octtree.hpp"
+#include "mesh/BoundingBoxTree.hpp"
 #include "mesh/StencilComputerOcttree.hpp"
 #include "mesh/MeshWriter.hpp"
 
@@ -147,6 +148,59 @@ BOOST_AUTO_TEST_CASE( Octtree_creation )
 
 ////////////////////////////////////////////////////////////////////////////////
 
+BOOST_AUTO_TEST_CASE( BoundingBoxTree_creation )
+{
+  Mesh& mesh = *Handle<Mesh>(Core::instance().root().get_child("mesh"));
+  BoundingBoxTree& tree = *mesh.create_component<BoundingBoxTree>("bounding_box_tree");
+  tree.options().set("nb_elems_per_leaf", 2u );
+  tree.options().set("mesh", mesh.handle<Mesh>());
+  tree.create_tree();
+  BOOST_CHECK(tree.is_created());
+
+  Entity element;
+  RealVector2 coord;
+
+  coord << 1. , 1. ;
+  BOOST_CHECK(tree.find_element(coord,element));
+  BOOST_CHECK_EQUAL(element.idx,0u);
+
+  coord << 3. , 1. ;
+  BOOST_CHECK(tree.find_element(coord,element));
+  BOOST_CHECK_EQUAL(element.idx,1u);
+
+  coord << 1 , 3. ;
+  BOOST_CHECK(tree.find_element(coord,element));
+  BOOST_CHECK_EQUAL(element.idx,5u);
+
+  coord << 11. , 1. ;
+  BOOST_CHECK(!tree.find_element(coord,element));
+  BOOST_CHECK(!tree.find_closest_element(coord,element));
+
+  // Batch query, in an order that differs from the Hilbert curve
+  boost::multi_array<Real,2> coordinates(boost::extents[4][2]);
+  coordinates[0][XX] = 9.;   coordinates[0][YY] = 9.;
+  coordinates[1][XX] = 1.;   coordinates[1][YY] = 1.;
+  coordinates[2][XX] = 20.;  coordinates[2][YY] = 20.;
+  coordinates[3][XX] = 3.;   coordinates[3][YY] = 1.;
+
+  std::vector<Entity> elements;
+  BOOST_CHECK_EQUAL(tree.find_elements(coordinates,elements), 3u);
+  BOOST_CHECK_EQUAL(elements.size(), 4u);
+  BOOST_CHECK_EQUAL(elements[0].idx, 24u);
+  BOOST_CHECK_EQUAL(elements[1].idx, 0u);
+  BOOST_CHECK(is_null(elements[2].comp));
+  BOOST_CHECK_EQUAL(elements[3].idx, 1u);
+
+  // First order Hilbert curve in 2D
+  std::vector<Uint> point(2);
+  point[XX] = 0; point[YY] = 0;  BOOST_CHECK_EQUAL(BoundingBoxTree::hilbert_key(point,1), 0u);
+  point[XX] = 0; point[YY] = 1;  BOOST_CHECK_EQUAL(BoundingBoxTree::hilbert_key(point,1), 1u);
+  point[XX] = 1; point[YY] = 1;  BOOST_CHECK_EQUAL(BoundingBoxTree::hilbert_key(point,1), 2u);
+  point[XX] = 1; point[YY] = 0;  BOOST_CHECK_EQUAL(BoundingBoxTree::hilbert_key(point,1), 3u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 BOOST_AUTO_TEST_CASE( Octtree_parallel )
 {
   Handle< MeshGenerator > mesh_generator(Core::instance().root().get_child("mesh_generator"));
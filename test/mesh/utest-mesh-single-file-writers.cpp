@@ -0,0 +1,209 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Tests single file output of the mesh writers on a partitioned mesh"
+
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <boost/test/unit_test.hpp>
+
+#include "common/Builder.hpp"
+#include "common/Core.hpp"
+#include "common/Environment.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Foreach.hpp"
+#include "common/Log.hpp"
+#include "common/OptionList.hpp"
+#include "common/PropertyList.hpp"
+#include "common/PE/Comm.hpp"
+
+#include "mesh/Dictionary.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/MeshGenerator.hpp"
+#include "mesh/MeshReader.hpp"
+#include "mesh/MeshWriter.hpp"
+#include "mesh/Region.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+/// Contents of the file at the given path
+std::string read_file(const std::string& path)
+{
+  std::ifstream file(path.c_str(), std::ios_base::in | std::ios_base::binary);
+  BOOST_REQUIRE(file.is_open());
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/// Sum of the unsigned integers that follow each occurrence of key in text
+Uint sum_values(const std::string& text, const std::string& key)
+{
+  Uint result = 0;
+  for(std::string::size_type pos = text.find(key); pos != std::string::npos; pos = text.find(key, pos))
+  {
+    pos += key.size();
+    Uint value = 0;
+    std::istringstream(text.substr(pos, 32)) >> value;
+    result += value;
+  }
+  return result;
+}
+
+/// Sum over all ranks of a local count
+Uint global_sum(const Uint local)
+{
+  Uint result = 0;
+  PE::Comm::instance().all_reduce(PE::plus(), &local, 1, &result);
+  return result;
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// The mesh is a rectangle of nb_x by nb_y quads without boundary elements, so each rank has ghost nodes but no ghost
+/// elements
+struct SingleFileWritersFixture
+{
+  SingleFileWritersFixture() : nb_x(10), nb_y(8)
+  {
+  }
+
+  Handle<Mesh> mesh()
+  {
+    return Handle<Mesh>(Core::instance().root().get_child("mesh"));
+  }
+
+  const Uint nb_x;
+  const Uint nb_y;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( SingleFileWritersSuite, SingleFileWritersFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().environment().options().set("log_level", 1u);
+  PE::Comm::instance().init(boost::unit_test::framework::master_test_suite().argc, boost::unit_test::framework::master_test_suite().argv);
+  BOOST_CHECK(PE::Comm::instance().size() > 1);
+
+  Handle<Mesh> generated_mesh = Core::instance().root().create_component<Mesh>("mesh");
+  boost::shared_ptr<MeshGenerator> generate_mesh = build_component_abstract_type<MeshGenerator>("cf3.mesh.SimpleMeshGenerator","meshgenerator");
+  std::vector<Uint> nb_cells(2);
+  nb_cells[XX] = nb_x;
+  nb_cells[YY] = nb_y;
+  generate_mesh->options().set("nb_cells",nb_cells);
+  generate_mesh->options().set("lengths",std::vector<Real>(2,1.));
+  generate_mesh->options().set("mesh",generated_mesh->uri());
+  generate_mesh->options().set("bdry",false);
+  generate_mesh->execute();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// The pieces of all ranks end up in one .vtu file, each with its local nodes (ghosts included) and cells
+BOOST_AUTO_TEST_CASE( VTKXML )
+{
+  boost::shared_ptr<MeshWriter> writer = build_component_abstract_type<MeshWriter>("cf3.mesh.VTKXML.Writer","vtkxml_writer");
+  writer->options().set("mesh",mesh());
+  writer->options().set("file",URI("utest-mesh-single-file-writers.vtu"));
+  writer->options().set("single_file",true);
+  writer->execute();
+  PE::Comm::instance().barrier();
+
+  const std::string contents = read_file("utest-mesh-single-file-writers.vtu");
+  const std::string header = contents.substr(0, contents.find("<AppendedData"));
+  BOOST_CHECK_EQUAL(sum_values(header, "NumberOfPoints=\""), global_sum(mesh()->geometry_fields().size()));
+  BOOST_CHECK_EQUAL(sum_values(header, "NumberOfCells=\""), nb_x*nb_y);
+
+  Uint nb_pieces = 0;
+  for(std::string::size_type pos = header.find("<Piece "); pos != std::string::npos; pos = header.find("<Piece ", pos+1))
+    ++nb_pieces;
+  BOOST_CHECK_EQUAL(nb_pieces, PE::Comm::instance().size());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// The zones of all ranks end up in one tecplot file, each with the nodes used by its elements
+BOOST_AUTO_TEST_CASE( Tecplot )
+{
+  boost::shared_ptr<MeshWriter> writer = build_component_abstract_type<MeshWriter>("cf3.mesh.tecplot.Writer","tecplot_writer");
+  writer->options().set("mesh",mesh());
+  writer->options().set("file",URI("utest-mesh-single-file-writers.plt"));
+  writer->options().set("single_file",true);
+  writer->execute();
+  PE::Comm::instance().barrier();
+
+  const std::string contents = read_file("utest-mesh-single-file-writers.plt");
+  BOOST_CHECK_EQUAL(sum_values(contents, ", N="), global_sum(mesh()->geometry_fields().size()));
+  BOOST_CHECK_EQUAL(sum_values(contents, ", E="), nb_x*nb_y);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// The serial gmsh file holds every node and element once, so reading it back gives the original global counts
+BOOST_AUTO_TEST_CASE( GmshSerial )
+{
+  boost::shared_ptr<MeshWriter> writer = build_component_abstract_type<MeshWriter>("cf3.mesh.gmsh.Writer","gmsh_writer");
+  writer->options().set("mesh",mesh());
+  writer->options().set("file",URI("utest-mesh-single-file-writers.msh"));
+  writer->options().set("serial",true);
+  writer->execute();
+  PE::Comm::instance().barrier();
+
+  Handle<Mesh> read_back = Core::instance().root().create_component<Mesh>("read_back");
+  boost::shared_ptr<MeshReader> reader = build_component_abstract_type<MeshReader>("cf3.mesh.gmsh.Reader","gmsh_reader");
+  reader->options().set("mesh",read_back);
+  reader->options().set("file",URI("utest-mesh-single-file-writers.msh"));
+  reader->execute();
+
+  const Dictionary& nodes = read_back->geometry_fields();
+  Uint nb_owned_nodes = 0;
+  for(Uint i = 0; i != nodes.size(); ++i)
+  {
+    if(!nodes.is_ghost(i))
+      ++nb_owned_nodes;
+  }
+  Uint nb_owned_cells = 0;
+  boost_foreach(const Elements& elements, find_components_recursively<Elements>(read_back->topology()))
+  {
+    for(Uint e = 0; e != elements.size(); ++e)
+    {
+      if(!elements.is_ghost(e))
+        ++nb_owned_cells;
+    }
+  }
+
+  BOOST_CHECK_EQUAL(global_sum(nb_owned_nodes), (nb_x+1)*(nb_y+1));
+  BOOST_CHECK_EQUAL(global_sum(nb_owned_cells), nb_x*nb_y);
+  BOOST_CHECK_EQUAL(read_back->properties().value<Uint>("global_nb_cells"), nb_x*nb_y);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  PE::Comm::instance().finalize();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -37,3 +37,27 @@ cf_check_equal(table[0][0],2,'Table increment failed')
 
 print 'Full table:'
 print table
+
+# numpy views share the storage of the table
+import numpy as np
+view = np.asarray(table)
+cf_check_equal(view.shape, (10, 2), 'Incorrect numpy view shape')
+cf_check(view.dtype.kind == 'u', 'Incorrect numpy view dtype')
+view[2] = [5, 6]
+cf_check(table[2][0] == 5 and table[2][1] == 6, 'Assignment through numpy view failed')
+table[3][1] = 7
+cf_check_equal(view[3, 1], 7, 'numpy view does not see changes to the table')
+
+real_table = root.create_component("real_table", "cf3.common.Table<real>")
+real_table.set_row_size(3)
+real_table.resize(4)
+real_view = np.asarray(real_table)
+real_view[:, 1] = np.arange(4.)
+cf_check_equal(real_table[3][1], 3., 'Assignment of a column through numpy view failed')
+
+empty_list = root.create_component("list", "cf3.common.List<unsigned>")
+cf_check_equal(np.asarray(empty_list).shape, (0,), 'Incorrect numpy view shape for an empty list')
+empty_list.resize(5)
+list_view = np.asarray(empty_list)
+list_view[:] = 3
+cf_check_equal(empty_list[4], 3, 'Assignment through numpy view of a list failed')
@@ -488,10 +488,194 @@ BOOST_AUTO_TEST_CASE( NestedCustomOps )
   BOOST_CHECK_SMALL(diff_norm.front(), 1e-10);
 }
 
+// Compare the matrix-free operator with the assembled matrix for the same element expression
+BOOST_AUTO_TEST_CASE( MatrixFree )
+{
+  Handle<math::LSS::System> crs_lss = root.create_component<math::LSS::System>("crs_lss");
+  crs_lss->options().set("matrix_builder", std::string("cf3.math.LSS.TrilinosCrsMatrix"));
+  crs_lss->create(mesh->geometry_fields().comm_pattern(), 1, node_connectivity, starting_indices);
+
+  Handle<math::LSS::System> free_lss = root.create_component<math::LSS::System>("free_lss");
+  free_lss->options().set("matrix_builder", std::string("cf3.math.LSS.TrilinosMatrixFree"));
+  free_lss->create(mesh->geometry_fields().comm_pattern(), 1, node_connectivity, starting_indices);
+
+  FieldVariable<0, ScalarField> T("ScalarVar3", "scalar3");
+  SystemMatrix crs_matrix(*crs_lss);
+  SystemMatrix free_matrix(*free_lss);
+
+  Handle<ProtoAction> crs_assembly = root.create_component<ProtoAction>("CrsAssembly");
+  crs_assembly->set_expression(elements_expression(
+    group
+    (
+      _A = _0,
+      element_quadrature(_A(T,T) += transpose(nabla(T)) * nabla(T)),
+      crs_matrix += _A
+    )
+  ));
+
+  Handle<ProtoAction> free_assembly = root.create_component<ProtoAction>("FreeAssembly");
+  free_assembly->set_expression(elements_expression(
+    group
+    (
+      _A = _0,
+      element_quadrature(_A(T,T) += transpose(nabla(T)) * nabla(T)),
+      free_matrix += _A
+    )
+  ));
+
+  crs_assembly->options().set("physical_model", physical_model);
+  crs_assembly->options().set(solver::Tags::regions(), loop_regions);
+  free_assembly->options().set("physical_model", physical_model);
+  free_assembly->options().set(solver::Tags::regions(), loop_regions);
+  free_lss->matrix()->options().set("assembly", free_assembly->handle<common::Action>());
+
+  field_manager->create_field("scalar3", mesh->geometry_fields());
+
+  // Assembling doesn't touch the matrix-free matrix, it only computes products when it is applied
+  crs_assembly->execute();
+  free_assembly->execute();
+
+  // Same Dirichlet conditions on the first nodes for both
+  for(Uint node = 0; node != 3; ++node)
+  {
+    crs_lss->dirichlet(node, 0, 1. + node, true);
+    free_lss->dirichlet(node, 0, 1. + node, true);
+  }
+
+  Handle<math::LSS::ThyraOperator> crs_op(crs_lss->matrix());
+  Handle<math::LSS::ThyraOperator> free_op(free_lss->matrix());
+  Handle<math::LSS::ThyraVector> solution(crs_lss->solution());
+  Thyra::randomize(0., 1., solution->thyra_vector().ptr());
+
+  Teuchos::RCP< Thyra::MultiVectorBase<Real> > crs_result = Thyra::createMembers(crs_op->thyra_operator()->range(), 1);
+  Teuchos::RCP< Thyra::MultiVectorBase<Real> > free_result = Thyra::createMembers(free_op->thyra_operator()->range(), 1);
+  Thyra::apply(*crs_op->thyra_operator(), Thyra::NOTRANS, *solution->thyra_vector(), crs_result.ptr());
+  Thyra::apply(*free_op->thyra_operator(), Thyra::NOTRANS, *solution->thyra_vector(), free_result.ptr());
+
+  std::vector<Real> norm(1);
+  Thyra::norms(*crs_result, Teuchos::arrayViewFromVector(norm));
+  BOOST_CHECK(norm.front() > 1e-6);
+
+  Thyra::update(-1., *crs_result, free_result.ptr());
+  Thyra::norms(*free_result, Teuchos::arrayViewFromVector(norm));
+  BOOST_CHECK_SMALL(norm.front(), 1e-10);
+
+  // The symmetric Dirichlet RHS correction was applied when requesting the operator
+  Teuchos::RCP< Thyra::MultiVectorBase<Real> > rhs_diff = Thyra::createMembers(crs_op->thyra_operator()->range(), 1);
+  Thyra::assign(rhs_diff.ptr(), *Handle<math::LSS::ThyraVector>(crs_lss->rhs())->thyra_vector());
+  Thyra::update(-1., *Handle<math::LSS::ThyraVector>(free_lss->rhs())->thyra_vector(), rhs_diff.ptr());
+  Thyra::norms(*rhs_diff, Teuchos::arrayViewFromVector(norm));
+  BOOST_CHECK_SMALL(norm.front(), 1e-10);
+
+  std::vector<Real> crs_diag, free_diag;
+  crs_lss->matrix()->get_diagonal(crs_diag);
+  free_lss->matrix()->get_diagonal(free_diag);
+  BOOST_CHECK_EQUAL(crs_diag.size(), free_diag.size());
+  for(Uint i = 0; i != crs_diag.size(); ++i)
+    BOOST_CHECK_CLOSE(crs_diag[i], free_diag[i], 1e-10);
+}
+
+// Threaded assembly into the Trilinos matrices must give the same system as serial assembly
+BOOST_AUTO_TEST_CASE( ThreadedAssembly )
+{
+  FieldVariable<0, ScalarField> T("ScalarVar4", "scalar4");
+  field_manager->create_field("scalar4", mesh->geometry_fields());
+
+  std::vector<std::string> matrix_builders;
+  matrix_builders.push_back("cf3.math.LSS.TrilinosCrsMatrix");
+  matrix_builders.push_back("cf3.math.LSS.TrilinosFEVbrMatrix");
+
+  BOOST_FOREACH(const std::string& matrix_builder, matrix_builders)
+  {
+    Handle<math::LSS::System> serial_lss = root.create_component<math::LSS::System>("serial_lss");
+    serial_lss->options().set("matrix_builder", matrix_builder);
+    serial_lss->create(mesh->geometry_fields().comm_pattern(), 1, node_connectivity, starting_indices);
+
+    Handle<math::LSS::System> threaded_lss = root.create_component<math::LSS::System>("threaded_lss");
+    threaded_lss->options().set("matrix_builder", matrix_builder);
+    threaded_lss->create(mesh->geometry_fields().comm_pattern(), 1, node_connectivity, starting_indices);
+
+    // Random field values
+    SolutionVector sol_vec(*serial_lss);
+    Thyra::randomize(0., 1., Handle<math::LSS::ThyraVector>(serial_lss->solution())->thyra_vector().ptr());
+    for_each_node(mesh->topology(), T = sol_vec(T));
+
+    SystemMatrix serial_matrix(*serial_lss);
+    SystemRHS serial_rhs(*serial_lss);
+    Handle<ProtoAction> serial_assembly = root.create_component<ProtoAction>("SerialAssembly");
+    serial_assembly->set_expression(elements_expression(
+      group
+      (
+        _A = _0,
+        element_quadrature(_A(T,T) += transpose(nabla(T)) * nabla(T)),
+        serial_matrix += _A,
+        serial_rhs += _A * nodal_values(T)
+      )
+    ));
+
+    SystemMatrix threaded_matrix(*threaded_lss);
+    SystemRHS threaded_rhs(*threaded_lss);
+    Handle<ProtoAction> threaded_assembly = root.create_component<ProtoAction>("ThreadedAssembly");
+    threaded_assembly->set_expression(elements_expression(
+      group
+      (
+        _A = _0,
+        element_quadrature(_A(T,T) += transpose(nabla(T)) * nabla(T)),
+        threaded_matrix += _A,
+        threaded_rhs += _A * nodal_values(T)
+      )
+    ));
+    threaded_assembly->options().set("nb_threads", 4u);
+
+    serial_assembly->options().set("physical_model", physical_model);
+    serial_assembly->options().set(solver::Tags::regions(), loop_regions);
+    threaded_assembly->options().set("physical_model", physical_model);
+    threaded_assembly->options().set(solver::Tags::regions(), loop_regions);
+
+    // Assemble twice, so the second assembly uses the cached scatter offsets
+    for(Uint i = 0; i != 2; ++i)
+    {
+      serial_lss->reset();
+      threaded_lss->reset();
+      serial_assembly->execute();
+      threaded_assembly->execute();
+    }
+
+    std::vector<Uint> serial_rows, serial_cols, threaded_rows, threaded_cols;
+    std::vector<Real> serial_vals, threaded_vals;
+    serial_lss->matrix()->debug_data(serial_rows, serial_cols, serial_vals);
+    threaded_lss->matrix()->debug_data(threaded_rows, threaded_cols, threaded_vals);
+    BOOST_REQUIRE_EQUAL(serial_vals.size(), threaded_vals.size());
+    BOOST_CHECK(serial_rows == threaded_rows);
+    BOOST_CHECK(serial_cols == threaded_cols);
+    Real max_val = 0.;
+    for(Uint i = 0; i != serial_vals.size(); ++i)
+    {
+      BOOST_CHECK_SMALL(serial_vals[i] - threaded_vals[i], 1e-12);
+      max_val = std::max(max_val, std::abs(serial_vals[i]));
+    }
+    BOOST_CHECK(max_val > 1e-6);
+
+    std::vector<Real> diff_norm(1);
+    Teuchos::RCP< Thyra::MultiVectorBase<Real> > rhs_diff = Thyra::createMembers(Handle<math::LSS::ThyraOperator>(serial_lss->matrix())->thyra_operator()->range(), 1);
+    Thyra::assign(rhs_diff.ptr(), *Handle<math::LSS::ThyraVector>(serial_lss->rhs())->thyra_vector());
+    Thyra::update(-1., *Handle<math::LSS::ThyraVector>(threaded_lss->rhs())->thyra_vector(), rhs_diff.ptr());
+    Thyra::norms(*rhs_diff, Teuchos::arrayViewFromVector(diff_norm));
+    BOOST_CHECK_SMALL(diff_norm.front(), 1e-10);
+
+    root.remove_component("SerialAssembly");
+    root.remove_component("ThreadedAssembly");
+    root.remove_component("serial_lss");
+    root.remove_component("threaded_lss");
+  }
+}
+
 BOOST_AUTO_TEST_CASE( CleanUp )
 {
   root.remove_component("scalar_lss");
   root.remove_component("vector_lss");
+  root.remove_component("crs_lss");
+  root.remove_component("free_lss");
 }
 
 BOOST_AUTO_TEST_SUITE_END()
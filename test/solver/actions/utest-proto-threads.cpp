@@ -0,0 +1,146 @@
+// Copyright (C) 2010-2011 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for threaded proto element loops"
+
+#include <set>
+
+#include <boost/foreach.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/Core.hpp"
+#include "common/FindComponents.hpp"
+#include "common/Log.hpp"
+
+#include "math/MatrixTypes.hpp"
+
+#include "mesh/Domain.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/Elements.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/FieldManager.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Space.hpp"
+#include "mesh/ElementTypes.hpp"
+#include "mesh/ElementTypePredicates.hpp"
+#include "mesh/LagrangeP0/Quad.hpp"
+
+#include "physics/PhysModel.hpp"
+
+#include "solver/Model.hpp"
+#include "solver/Solver.hpp"
+#include "solver/Tags.hpp"
+
+#include "solver/actions/Proto/ElementColoring.hpp"
+#include "solver/actions/Proto/ProtoAction.hpp"
+#include "solver/actions/Proto/Expression.hpp"
+#include "solver/actions/Proto/Terminals.hpp"
+
+#include "Tools/MeshGeneration/MeshGeneration.hpp"
+
+using namespace cf3;
+using namespace cf3::solver;
+using namespace cf3::solver::actions;
+using namespace cf3::solver::actions::Proto;
+using namespace cf3::mesh;
+using namespace cf3::common;
+
+////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE( ProtoThreadsSuite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ColoringIsConflictFree )
+{
+  Mesh& mesh = *Core::instance().root().create_component<Mesh>("ColoringMesh");
+  Tools::MeshGeneration::create_rectangle(mesh, 1., 1., 20, 20);
+
+  BOOST_FOREACH(const Elements& elements, find_components_recursively<Elements>(mesh.topology()))
+  {
+    const ElementColoring coloring(elements);
+    const Connectivity& connectivity = elements.geometry_space().connectivity();
+
+    // Every element appears exactly once
+    BOOST_CHECK_EQUAL(coloring.elements().size(), elements.size());
+    BOOST_CHECK_EQUAL(std::set<Uint>(coloring.elements().begin(), coloring.elements().end()).size(), elements.size());
+    BOOST_CHECK_EQUAL(coloring.color_offsets().back(), elements.size());
+
+    // Elements of the same color never share a node
+    for(Uint color = 0; color != coloring.nb_colors(); ++color)
+    {
+      std::set<Uint> color_nodes;
+      Uint nb_color_nodes = 0;
+      for(Uint i = coloring.color_offsets()[color]; i != coloring.color_offsets()[color+1]; ++i)
+      {
+        BOOST_FOREACH(const Uint node, connectivity[coloring.elements()[i]])
+        {
+          color_nodes.insert(node);
+          ++nb_color_nodes;
+        }
+      }
+      BOOST_CHECK_EQUAL(color_nodes.size(), nb_color_nodes);
+    }
+
+    // A cell of a structured quad mesh has at most 8 neighbours
+    if(elements.element_type().dimensionality() == 2)
+    {
+      BOOST_CHECK(coloring.nb_colors() <= 9);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE( ThreadedElementLoop )
+{
+  Model& model = *Core::instance().root().create_component<Model>("Model");
+  physics::PhysModel& phys_model = model.create_physics("cf3.physics.DynamicModel");
+  Domain& dom = model.create_domain("Domain");
+  Solver& solver = model.create_solver("cf3.solver.SimpleSolver");
+
+  Mesh& mesh = *dom.create_component<Mesh>("mesh");
+  Tools::MeshGeneration::create_rectangle(mesh, 2., 1., 40, 20);
+
+  FieldVariable<0, ScalarField> V("CellVolume", "volumes");
+
+  boost::mpl::vector2<mesh::LagrangeP0::Quad, mesh::LagrangeP1::Quad2D> allowed_elements;
+
+  boost::shared_ptr<Expression> volumes = elements_expression(allowed_elements, V = volume);
+  volumes->register_variables(phys_model);
+
+  boost::shared_ptr<ProtoAction> volumes_action = create_proto_action("Volumes", volumes);
+  volumes_action->options().set("nb_threads", 2u);
+  solver << volumes_action;
+
+  Dictionary& elems_P0 = mesh.create_discontinuous_space("elems_P0","cf3.mesh.LagrangeP0");
+  solver.field_manager().create_field("volumes", elems_P0);
+
+  std::vector<URI> root_regions;
+  root_regions.push_back(mesh.topology().uri());
+  solver.configure_option_recursively(solver::Tags::regions(), root_regions);
+
+  model.simulate();
+
+  // All elements must have been visited exactly once, whether threads are available or not
+  const Field& volumes_field = *find_component_ptr_recursively_with_name<Field>(elems_P0, "volumes");
+  Real total_volume = 0.;
+  BOOST_FOREACH(const Elements& elements, find_components_recursively_with_filter<Elements>(mesh.topology(), IsElementsVolume()))
+  {
+    const Connectivity& field_connectivity = elems_P0.space(elements).connectivity();
+    for(Uint elem = 0; elem != elements.size(); ++elem)
+    {
+      const Real elem_volume = volumes_field[field_connectivity[elem][0]][0];
+      BOOST_CHECK_CLOSE(elem_volume, 0.0025, 1e-8);
+      total_volume += elem_volume;
+    }
+  }
+  BOOST_CHECK_CLOSE(total_volume, 2., 1e-8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+//////////////////////////////////////////////////////////////////////////////
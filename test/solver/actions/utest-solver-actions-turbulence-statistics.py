@@ -73,4 +73,18 @@ writer = domain.create_component('PVWriter', 'cf3.mesh.VTKXML.Writer')
 writer.fields = [velocity.uri(), mesh.geometry.coordinates.uri(), mesh.geometry.turbulence_statistics.uri()]
 writer.mesh = mesh
 writer.file = cf.URI('turbulence-statistics.pvtu')
-writer.execute()
\ No newline at end of file
+writer.execute()
+
+# Probe output is written in blocks, close the file on all ranks and read it back on the rank that writes it
+stats.probe_output.close()
+if cf.Core.rank() == 0:
+  import timeseries
+  probes = timeseries.read_time_series('turbulence-statistics-probes.cf3ts')
+  for name in ['probe-0/U', 'probe-0/U_rolling', 'probe-1/uv']:
+    if len(probes[name]) != 1000:
+      raise Exception('Expected 1000 values for ' + name + ', got ' + str(len(probes[name])))
+  index = timeseries.read_index('turbulence-statistics-probes.cf3ts')
+  if index is None or sum([entry[2] for entry in index]) != 1000:
+    raise Exception('Missing or incomplete block index in the probe output')
+  if len(timeseries.read_blocks('turbulence-statistics-probes.cf3ts', first_row=999)) != 1:
+    raise Exception('Expected the last row in a single block')
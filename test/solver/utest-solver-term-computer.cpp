@@ -0,0 +1,311 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for batched term computers"
+
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/assign/list_of.hpp>
+
+#include "common/Core.hpp"
+#include "common/Foreach.hpp"
+#include "common/OptionList.hpp"
+
+#include "mesh/Cells.hpp"
+#include "mesh/Connectivity.hpp"
+#include "mesh/Dictionary.hpp"
+#include "mesh/Field.hpp"
+#include "mesh/Mesh.hpp"
+#include "mesh/Region.hpp"
+#include "mesh/ShapeFunction.hpp"
+#include "mesh/SimpleMeshGenerator.hpp"
+#include "mesh/Space.hpp"
+
+#include "solver/ComputeRHS.hpp"
+#include "solver/TermBatch.hpp"
+#include "solver/TermComputerT.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::mesh;
+using namespace cf3::solver;
+using namespace boost::assign;
+
+////////////////////////////////////////////////////////////////////////////////
+
+/// Value that differs in each element and solution point, so misplaced results are detected
+inline Real point_value(const Uint elem_idx, const Uint sol_pt)
+{
+  return 1. + 0.5*static_cast<Real>(elem_idx) + 0.25*static_cast<Real>(sol_pt);
+}
+
+/// Term scale*v*(1,2,-1), with wave speed scale*v, where v is the point_value of the solution point
+class FixedSizeTerm : public TermComputerT<FixedSizeTerm,2,3>
+{
+public:
+  FixedSizeTerm(const std::string& name) : TermComputerT<FixedSizeTerm,2,3>(name), m_nb_sol_pts(0), m_scale(1.)
+  {
+    options().add("scale", m_scale).link_to(&m_scale);
+  }
+
+  static std::string type_name () { return "FixedSizeTerm"; }
+
+  virtual bool loop_cells(const Handle<Entities const>& cells)
+  {
+    if(is_null(Handle<Cells const>(cells)))
+      return false;
+    m_nb_sol_pts = cells->geometry_space().shape_function().nb_nodes();
+    return true;
+  }
+
+  Uint nb_sol_pts() const { return m_nb_sol_pts; }
+
+  void compute_element_term(const Uint elem_idx, RowVector_NEQS* term, Real* wave_speed)
+  {
+    for(Uint s = 0; s != m_nb_sol_pts; ++s)
+    {
+      const Real value = m_scale*point_value(elem_idx, s);
+      term[s] << value, 2.*value, -value;
+      wave_speed[s] = value;
+    }
+  }
+
+private:
+  Uint m_nb_sol_pts;
+  Real m_scale;
+};
+
+/// A different term, only implementing the per-element interface: (v^2,1,v), with wave speed 20-v
+class DynamicSizeTerm : public TermComputer
+{
+public:
+  DynamicSizeTerm(const std::string& name) : TermComputer(name), m_nb_sol_pts(0) {}
+
+  static std::string type_name () { return "DynamicSizeTerm"; }
+
+  virtual bool loop_cells(const Handle<Entities const>& cells)
+  {
+    if(is_null(Handle<Cells const>(cells)))
+      return false;
+    m_nb_sol_pts = cells->geometry_space().shape_function().nb_nodes();
+    return true;
+  }
+
+  virtual void compute_term(const Uint elem_idx, std::vector<RealVector>& term, std::vector<Real>& wave_speed)
+  {
+    term.resize(m_nb_sol_pts, RealVector(3));
+    wave_speed.resize(m_nb_sol_pts);
+    for(Uint s = 0; s != m_nb_sol_pts; ++s)
+    {
+      const Real value = point_value(elem_idx, s);
+      term[s] << value*value, 1., value;
+      wave_speed[s] = 20. - value;
+    }
+  }
+
+private:
+  Uint m_nb_sol_pts;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+struct TermComputerFixture
+{
+  TermComputerFixture()
+  {
+    m_argc = boost::unit_test::framework::master_test_suite().argc;
+    m_argv = boost::unit_test::framework::master_test_suite().argv;
+  }
+
+  /// Check each solution point of the fields against the sum of the terms and the maximum of the wave speeds of
+  /// the given term computers, computed element by element with compute_term
+  void check_fields(const Field& term, const Field& wave_speed, const std::vector< Handle<TermComputer> >& term_computers)
+  {
+    std::vector<RealVector> elem_term;
+    std::vector<Real> elem_ws;
+    Uint nb_checked = 0;
+    boost_foreach(const Handle<Entities>& entities, term.entities_range())
+    {
+      bool loop_all = true;
+      boost_foreach(const Handle<TermComputer>& term_computer, term_computers)
+        loop_all &= term_computer->loop_cells(entities);
+      if(!loop_all)
+        continue;
+
+      const Space& space = term.space(*entities);
+      for(Uint e = 0; e != entities->size(); ++e)
+      {
+        const Uint nb_sol_pts = space.shape_function().nb_nodes();
+        std::vector<RealVector> ref_term(nb_sol_pts, RealVector::Zero(term.row_size()));
+        std::vector<Real> ref_ws(nb_sol_pts, 0.);
+        boost_foreach(const Handle<TermComputer>& term_computer, term_computers)
+        {
+          term_computer->compute_term(e, elem_term, elem_ws);
+          for(Uint s = 0; s != nb_sol_pts; ++s)
+          {
+            ref_term[s] += elem_term[s];
+            ref_ws[s] = std::max(ref_ws[s], elem_ws[s]);
+          }
+        }
+
+        for(Uint s = 0; s != nb_sol_pts; ++s)
+        {
+          const Uint pt = space.connectivity()[e][s];
+          for(Uint eq = 0; eq != term.row_size(); ++eq)
+            BOOST_CHECK_CLOSE(term[pt][eq], ref_term[s][eq], 1e-12);
+          BOOST_CHECK_CLOSE(wave_speed[pt][0], ref_ws[s], 1e-12);
+          ++nb_checked;
+        }
+      }
+    }
+    BOOST_CHECK_EQUAL(nb_checked, term.size());
+  }
+
+  int m_argc;
+  char** m_argv;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_FIXTURE_TEST_SUITE( TermComputerSuite, TermComputerFixture )
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Init )
+{
+  Core::instance().initiate(m_argc,m_argv);
+
+  Handle<MeshGenerator> mesh_generator = Core::instance().root().create_component<SimpleMeshGenerator>("mesh_generator");
+  mesh_generator->options().set("mesh",Core::instance().root().uri()/"mesh");
+  mesh_generator->options().set("lengths",std::vector<Real>(2,1.));
+  std::vector<Uint> nb_cells = list_of(7)(5);
+  mesh_generator->options().set("nb_cells",nb_cells);
+  Mesh& mesh = mesh_generator->generate();
+
+  // Each element has its own solution points, so the result of every element can be checked
+  Dictionary& sol_pts = mesh.create_discontinuous_space("solution_points", "cf3.mesh.LagrangeP1", std::vector< Handle<Region> >(1, Handle<Region>(mesh.topology().get_child("interior"))));
+  sol_pts.create_field("rhs", 3u);
+  sol_pts.create_field("wave_speed", 1u);
+  sol_pts.create_field("term", 3u);
+  sol_pts.create_field("term_wave_speed", 1u);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( TermBatchLayout )
+{
+  TermBatch batch;
+  batch.resize(3, 4, 2);
+  BOOST_CHECK_EQUAL(batch.nb_points(), 12u);
+
+  batch.set_zero();
+  batch.term(1)[5] = 2.;
+  batch.wave_speed()[5] = 1.;
+
+  TermBatch other;
+  other.resize(3, 4, 2);
+  other.set_zero();
+  other.term(1)[5] = 3.;
+  other.wave_speed()[5] = 0.5;
+  other.wave_speed()[6] = 4.;
+
+  batch.add(other);
+  BOOST_CHECK_EQUAL(batch.term(1)[5], 5.);
+  BOOST_CHECK_EQUAL(batch.term(0)[5], 0.);
+  BOOST_CHECK_EQUAL(batch.wave_speed()[5], 1.);
+  BOOST_CHECK_EQUAL(batch.wave_speed()[6], 4.);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( ComputeRHSBatches )
+{
+  Mesh& mesh = *Core::instance().root().get_child("mesh")->handle<Mesh>();
+  Dictionary& sol_pts = *mesh.get_child("solution_points")->handle<Dictionary>();
+  Field& rhs = *sol_pts.get_child("rhs")->handle<Field>();
+  Field& wave_speed = *sol_pts.get_child("wave_speed")->handle<Field>();
+
+  Handle<ComputeRHS> rhs_computer = Core::instance().root().create_component<ComputeRHS>("rhs_computer");
+  rhs_computer->options().set("rhs", rhs.handle<Field>());
+  rhs_computer->options().set("wave_speed", wave_speed.handle<Field>());
+  Handle<FixedSizeTerm> fixed_size_term = rhs_computer->create_component<FixedSizeTerm>("fixed_size_term");
+  fixed_size_term->options().set("scale", 2.);
+  Handle<DynamicSizeTerm> dynamic_size_term = rhs_computer->create_component<DynamicSizeTerm>("dynamic_size_term");
+
+  std::vector< Handle<TermComputer> > term_computers;
+  term_computers.push_back(fixed_size_term);
+  term_computers.push_back(dynamic_size_term);
+
+  // The result must not depend on the batch size, including batches that don't divide the number of elements
+  const std::vector<Uint> batch_sizes = list_of(1)(4)(64);
+  boost_foreach(const Uint batch_size, batch_sizes)
+  {
+    rhs = 0.;
+    wave_speed = 0.;
+    rhs_computer->options().set("batch_size", batch_size);
+    rhs_computer->execute();
+    check_fields(rhs, wave_speed, term_computers);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( TermComputerBatches )
+{
+  Mesh& mesh = *Core::instance().root().get_child("mesh")->handle<Mesh>();
+  Dictionary& sol_pts = *mesh.get_child("solution_points")->handle<Dictionary>();
+  Field& term = *sol_pts.get_child("term")->handle<Field>();
+  Field& term_ws = *sol_pts.get_child("term_wave_speed")->handle<Field>();
+
+  Handle<FixedSizeTerm> fixed_size_term = Core::instance().root().create_component<FixedSizeTerm>("fixed_size_term");
+  fixed_size_term->options().set("field", term.handle<Field>());
+  fixed_size_term->options().set("term_wave_speed_field", term_ws.handle<Field>());
+  fixed_size_term->options().set("batch_size", 3u);
+  fixed_size_term->execute();
+
+  check_fields(term, term_ws, std::vector< Handle<TermComputer> >(1, fixed_size_term));
+
+  // The per-element interface gives the same values as the batch
+  std::vector<RealVector> elem_term;
+  std::vector<Real> elem_ws;
+  TermBatch batch;
+  bool found_cells = false;
+  boost_foreach(const Handle<Entities>& entities, mesh.elements())
+  {
+    if(fixed_size_term->loop_cells(entities))
+    {
+      found_cells = true;
+      break;
+    }
+  }
+  BOOST_REQUIRE(found_cells);
+  fixed_size_term->compute_terms(2, 5, batch);
+  for(Uint e = 2; e != 5; ++e)
+  {
+    fixed_size_term->compute_term(e, elem_term, elem_ws);
+    for(Uint s = 0; s != batch.nb_sol_pts(); ++s)
+    {
+      for(Uint eq = 0; eq != batch.nb_eqs(); ++eq)
+        BOOST_CHECK_EQUAL(elem_term[s][eq], batch.term(eq)[(e-2)*batch.nb_sol_pts()+s]);
+      BOOST_CHECK_EQUAL(elem_ws[s], batch.wave_speed()[(e-2)*batch.nb_sol_pts()+s]);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Terminate )
+{
+  Core::instance().terminate();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,209 @@
+// Copyright (C) 2010-2013 von Karman Institute for Fluid Dynamics, Belgium
+//
+// This software is distributed under the terms of the
+// GNU Lesser General Public License version 3 (LGPLv3).
+// See doc/lgpl.txt and doc/gpl.txt for the license text.
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE "Test module for cf3::solver::TimeSeriesWriter"
+
+#include <boost/assign/list_of.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "common/BasicExceptions.hpp"
+#include "common/BoostFilesystem.hpp"
+#include "common/OptionList.hpp"
+
+#include "solver/TimeSeriesWriter.hpp"
+
+using namespace cf3;
+using namespace cf3::common;
+using namespace cf3::solver;
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  template<typename T>
+  T read_binary(boost::filesystem::fstream& file)
+  {
+    T result;
+    file.read(reinterpret_cast<char*>(&result), sizeof(T));
+    return result;
+  }
+
+  std::string read_string(boost::filesystem::fstream& file, const Uint size)
+  {
+    std::string result(size, ' ');
+    file.read(&result[0], size);
+    return result;
+  }
+}
+
+BOOST_AUTO_TEST_SUITE( TimeSeriesWriterSuite )
+
+//////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_CASE( Buffering )
+{
+  boost::shared_ptr<TimeSeriesWriter> writer = allocate_component<TimeSeriesWriter>("writer");
+  writer->options().set("file", URI("utest-solver-timeseries-writer.cf3ts"));
+  writer->options().set("flush_interval", 3u);
+
+  writer->set_columns(boost::assign::list_of<std::string>("time")("u"));
+  BOOST_CHECK_THROW(writer->add_row(boost::assign::list_of(1.)), BadValue);
+
+  writer->add_row(boost::assign::list_of(0.)(10.));
+  writer->add_row(boost::assign::list_of(1.)(11.));
+  BOOST_CHECK_EQUAL(writer->nb_buffered_rows(), 2);
+  writer->add_row(boost::assign::list_of(2.)(12.));
+  BOOST_CHECK_EQUAL(writer->nb_buffered_rows(), 0);
+
+  writer->add_row(boost::assign::list_of(3.)(13.));
+  writer->set_columns(boost::assign::list_of<std::string>("time"));
+  BOOST_CHECK_EQUAL(writer->nb_buffered_rows(), 0);
+  writer->add_row(boost::assign::list_of(4.));
+
+  writer.reset();
+}
+
+BOOST_AUTO_TEST_CASE( FileLayout )
+{
+  boost::filesystem::fstream file(boost::filesystem::path("utest-solver-timeseries-writer.cf3ts"), std::ios_base::in | std::ios_base::binary);
+  BOOST_REQUIRE(file);
+
+  BOOST_CHECK_EQUAL(read_string(file, 8), std::string("CF3TSER\0", 8));
+  BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), TimeSeriesWriter::version());
+  BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), 0x01020304u);
+  const boost::uint64_t index_position = read_binary<boost::uint64_t>(file);
+  BOOST_CHECK(index_position != 0);
+
+  // Blocks with 3, 1 and 1 rows
+  const Uint expected_rows[] = {3, 1, 1};
+  const Uint expected_cols[] = {2, 2, 1};
+  const Real expected_first[] = {0., 3., 4.};
+  std::vector<boost::uint64_t> block_positions;
+  for(Uint block = 0; block != 3; ++block)
+  {
+    block_positions.push_back(file.tellg());
+    BOOST_CHECK_EQUAL(read_string(file, 4), "BLCK");
+    read_binary<boost::uint64_t>(file);
+    const Uint nb_cols = read_binary<boost::uint32_t>(file);
+    const Uint nb_rows = read_binary<boost::uint32_t>(file);
+    BOOST_CHECK_EQUAL(nb_cols, expected_cols[block]);
+    BOOST_CHECK_EQUAL(nb_rows, expected_rows[block]);
+    for(Uint col = 0; col != nb_cols; ++col)
+    {
+      const Uint length = read_binary<boost::uint32_t>(file);
+      BOOST_CHECK_EQUAL(read_string(file, length), col == 0 ? "time" : "u");
+    }
+    std::vector<double> values(nb_cols*nb_rows);
+    file.read(reinterpret_cast<char*>(&values[0]), values.size()*sizeof(double));
+    BOOST_CHECK_EQUAL(values[0], expected_first[block]);
+    if(block == 0)
+    {
+      // Column-oriented storage
+      BOOST_CHECK_EQUAL(values[2], 2.);
+      BOOST_CHECK_EQUAL(values[3], 10.);
+    }
+  }
+
+  // Block index
+  BOOST_CHECK_EQUAL(static_cast<boost::uint64_t>(file.tellg()), index_position);
+  BOOST_CHECK_EQUAL(read_string(file, 4), "INDX");
+  BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), 3u);
+  const Uint expected_first_row[] = {0, 3, 4};
+  for(Uint block = 0; block != 3; ++block)
+  {
+    BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), block_positions[block]);
+    BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), expected_first_row[block]);
+    BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), expected_rows[block]);
+    BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), expected_cols[block]);
+  }
+
+  file.peek();
+  BOOST_CHECK(file.eof());
+}
+
+BOOST_AUTO_TEST_CASE( UnclosedProbeWriter )
+{
+  const boost::filesystem::path path("utest-solver-timeseries-writer-parallel.cf3ts");
+  boost::filesystem::remove(path);
+
+  // Like the probe output of TurbulenceStatistics: in a serial run, the destructor writes all rows and the index
+  boost::shared_ptr<TimeSeriesWriter> writer = allocate_component<TimeSeriesWriter>("writer");
+  writer->options().set("file", URI(path.string()));
+  writer->options().set("parallel", true);
+  writer->options().set("flush_interval", 4u);
+  writer->set_columns(boost::assign::list_of<std::string>("time"));
+  for(Uint i = 0; i != 6; ++i)
+    writer->add_row(boost::assign::list_of(Real(i)));
+  writer.reset();
+
+  boost::filesystem::fstream file(path, std::ios_base::in | std::ios_base::binary);
+  BOOST_REQUIRE(file);
+  file.seekg(16);
+  const boost::uint64_t index_position = read_binary<boost::uint64_t>(file);
+  BOOST_REQUIRE(index_position != 0);
+  file.seekg(index_position);
+  BOOST_CHECK_EQUAL(read_string(file, 4), "INDX");
+  BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), 2u);
+  const Uint expected_first_row[] = {0, 4};
+  const Uint expected_rows[] = {4, 2};
+  std::vector<boost::uint64_t> block_positions;
+  for(Uint block = 0; block != 2; ++block)
+  {
+    block_positions.push_back(read_binary<boost::uint64_t>(file));
+    BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), expected_first_row[block]);
+    BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), expected_rows[block]);
+    BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), 1u);
+  }
+
+  // The last block holds the last two rows
+  file.seekg(block_positions[1] + 4 + 8 + 4 + 4 + 4 + 4);
+  BOOST_CHECK_EQUAL(read_binary<double>(file), 4.);
+  BOOST_CHECK_EQUAL(read_binary<double>(file), 5.);
+}
+
+BOOST_AUTO_TEST_CASE( AppendAfterClose )
+{
+  const boost::filesystem::path path("utest-solver-timeseries-writer-parallel.cf3ts");
+  boost::filesystem::remove(path);
+
+  // close() writes the rows and the index, rows added afterwards are appended
+  boost::shared_ptr<TimeSeriesWriter> writer = allocate_component<TimeSeriesWriter>("writer");
+  writer->options().set("file", URI(path.string()));
+  writer->options().set("parallel", true);
+  writer->set_columns(boost::assign::list_of<std::string>("time"));
+  writer->add_row(boost::assign::list_of(0.));
+  writer->add_row(boost::assign::list_of(1.));
+  writer->close();
+  BOOST_CHECK_EQUAL(writer->nb_buffered_rows(), 0);
+  writer->add_row(boost::assign::list_of(2.));
+  writer->close();
+
+  boost::filesystem::fstream file(path, std::ios_base::in | std::ios_base::binary);
+  BOOST_REQUIRE(file);
+  file.seekg(16);
+  const boost::uint64_t index_position = read_binary<boost::uint64_t>(file);
+  file.seekg(index_position);
+  BOOST_CHECK_EQUAL(read_string(file, 4), "INDX");
+  BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), 2u);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), 24u);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), 0u);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), 2u);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), 1u);
+  read_binary<boost::uint64_t>(file);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint64_t>(file), 2u);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), 1u);
+  BOOST_CHECK_EQUAL(read_binary<boost::uint32_t>(file), 1u);
+  file.peek();
+  BOOST_CHECK(file.eof());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+BOOST_AUTO_TEST_SUITE_END()
+
+////////////////////////////////////////////////////////////////////////////////